@@ -195,10 +195,75 @@
 #error "MBEDTLS_SSL_CLI_C defined, but not all prerequisites"
 #endif
 
+#if defined(MBEDTLS_SSL_CLIENT_HELLO_C) && !defined(MBEDTLS_SSL_TLS_C)
+#error "MBEDTLS_SSL_CLIENT_HELLO_C defined, but not all prerequisites"
+#endif
+
 #if defined(MBEDTLS_SSL_ASYNC_PRIVATE) && !defined(MBEDTLS_X509_CRT_PARSE_C)
 #error "MBEDTLS_SSL_ASYNC_PRIVATE defined, but not all prerequisites"
 #endif
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO) && !defined(MBEDTLS_X509_CRT_PARSE_C)
+#error "MBEDTLS_SSL_ASYNC_CRYPTO defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_ASYNC_POOL_C) &&                               \
+    (!defined(MBEDTLS_SSL_ASYNC_CRYPTO) || !defined(MBEDTLS_THREADING_C) || \
+    !defined(MBEDTLS_THREADING_PTHREAD))
+#error "MBEDTLS_SSL_ASYNC_POOL_C defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_CONF_FINALIZE) && !defined(MBEDTLS_SSL_TLS_C)
+#error "MBEDTLS_SSL_CONF_FINALIZE defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_GROUP_CACHE_C) && \
+    (!defined(MBEDTLS_SSL_CLI_C) || !defined(MBEDTLS_SSL_PROTO_TLS1_3))
+#error "MBEDTLS_SSL_GROUP_CACHE_C defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_HANDSHAKE_ARENA) && !defined(MBEDTLS_SSL_TLS_C)
+#error "MBEDTLS_SSL_HANDSHAKE_ARENA defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_KEY_SHARE_POOL_C) && !defined(MBEDTLS_SSL_TLS_C)
+#error "MBEDTLS_SSL_KEY_SHARE_POOL_C defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_MEMORY_ACCOUNTING) && !defined(MBEDTLS_SSL_TLS_C)
+#error "MBEDTLS_SSL_MEMORY_ACCOUNTING defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS) && !defined(MBEDTLS_X509_CRT_PARSE_C)
+#error "MBEDTLS_SSL_PREENCODE_CERTS defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_SNI_MAP_C) &&                                   \
+    (!defined(MBEDTLS_SSL_SRV_C) || !defined(MBEDTLS_SSL_SERVER_NAME_INDICATION) || \
+     !defined(MBEDTLS_X509_CRT_PARSE_C))
+#error "MBEDTLS_SSL_SNI_MAP_C defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_VERIFY_CACHE_C) &&                              \
+    (!defined(MBEDTLS_SSL_TLS_C) || !defined(MBEDTLS_X509_CRT_PARSE_C) || \
+     !defined(PSA_WANT_ALG_SHA_256))
+#error "MBEDTLS_SSL_VERIFY_CACHE_C defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION) && \
+    !(defined(MBEDTLS_SSL_PROTO_TLS1_3) && defined(MBEDTLS_X509_CRT_PARSE_C))
+#error "MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE) && \
+    !defined(MBEDTLS_SSL_PROTO_TLS1_3)
+#error "MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE) && !defined(MBEDTLS_SSL_PROTO_TLS1_3)
+#error "MBEDTLS_SSL_TLS1_3_KEY_UPDATE defined, but not all prerequisites"
+#endif
+
 /* TLS 1.2 and 1.3 require SHA-256 or SHA-384 (running handshake hash) */
 #if defined(MBEDTLS_SSL_TLS_C) && \
     !(defined(PSA_WANT_ALG_SHA_256) || defined(PSA_WANT_ALG_SHA_384))
@@ -223,6 +288,21 @@
 #error "MBEDTLS_SSL_DTLS_CLIENT_PORT_REUSE  defined, but not all prerequisites"
 #endif
 
+#if defined(MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT) &&                      \
+    ( !defined(MBEDTLS_SSL_PROTO_DTLS) || !defined(MBEDTLS_HAVE_TIME) )
+#error "MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_DTLS_DEMUX_C) &&                                \
+    ( !defined(MBEDTLS_NET_C) || !defined(MBEDTLS_SSL_SRV_C) ||          \
+      !defined(MBEDTLS_SSL_DTLS_HELLO_VERIFY) )
+#error "MBEDTLS_SSL_DTLS_DEMUX_C defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY) && !defined(MBEDTLS_SSL_PROTO_DTLS)
+#error "MBEDTLS_SSL_DTLS_PMTU_DISCOVERY defined, but not all prerequisites"
+#endif
+
 #if defined(MBEDTLS_SSL_DTLS_ANTI_REPLAY) &&                              \
     ( !defined(MBEDTLS_SSL_TLS_C) || !defined(MBEDTLS_SSL_PROTO_DTLS) )
 #error "MBEDTLS_SSL_DTLS_ANTI_REPLAY  defined, but not all prerequisites"
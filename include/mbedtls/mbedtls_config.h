@@ -408,6 +408,33 @@
  */
 #define MBEDTLS_SSL_ALPN
 
+/**
+ * \def MBEDTLS_SSL_ASYNC_CRYPTO
+ *
+ * Enable asynchronous public key operations in SSL. This allows an
+ * application to run the ephemeral key exchange and the verification of the
+ * peer's signatures outside of mbedtls_ssl_handshake(), for example on a
+ * pool of worker threads, while the handshake returns
+ * #MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS. See mbedtls_ssl_conf_async_crypto_cb().
+ *
+ * Requires: MBEDTLS_X509_CRT_PARSE_C
+ */
+//#define MBEDTLS_SSL_ASYNC_CRYPTO
+
+/**
+ * \def MBEDTLS_SSL_ASYNC_POOL_C
+ *
+ * Enable a pool of worker threads that can be used as the backend of
+ * mbedtls_ssl_conf_async_crypto_cb().
+ *
+ * Module:  library/ssl_async_pool.c
+ * Caller:
+ *
+ * Requires: MBEDTLS_SSL_ASYNC_CRYPTO, MBEDTLS_THREADING_C,
+ *           MBEDTLS_THREADING_PTHREAD
+ */
+//#define MBEDTLS_SSL_ASYNC_POOL_C
+
 /**
  * \def MBEDTLS_SSL_ASYNC_PRIVATE
  *
@@ -448,6 +475,34 @@
  */
 #define MBEDTLS_SSL_CLI_C
 
+/**
+ * \def MBEDTLS_SSL_CLIENT_HELLO_C
+ *
+ * Enable mbedtls_ssl_client_hello_parse(), which reads the server name, ALPN
+ * protocols, versions and cipher suites of a ClientHello from the raw bytes
+ * of a connection, without an SSL context. This lets a front-end route or
+ * reject connections before setting up a handshake.
+ *
+ * Module:  library/ssl_client_hello.c
+ * Caller:
+ *
+ * Requires: MBEDTLS_SSL_TLS_C
+ */
+//#define MBEDTLS_SSL_CLIENT_HELLO_C
+
+/**
+ * \def MBEDTLS_SSL_CONF_FINALIZE
+ *
+ * Enable mbedtls_ssl_conf_finalize(), which compiles the ciphersuite, group
+ * and signature algorithm lists of a configuration into hash tables, so that
+ * negotiation looks up each identifier offered by the peer in constant time
+ * instead of scanning these lists. The tables take a few bytes per list
+ * entry.
+ *
+ * Requires: MBEDTLS_SSL_TLS_C
+ */
+//#define MBEDTLS_SSL_CONF_FINALIZE
+
 /**
  * \def MBEDTLS_SSL_CONTEXT_SERIALIZATION
  *
@@ -503,6 +558,22 @@
  */
 //#define MBEDTLS_SSL_DEBUG_ALL
 
+/**
+ * \def MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT
+ *
+ * Derive DTLS handshake retransmission timeouts from the measured round-trip
+ * time of previous flights of the same handshake (smoothed as in RFC 6298),
+ * instead of always starting from the minimum configured with
+ * mbedtls_ssl_conf_handshake_timeout(). Timeouts stay within the configured
+ * minimum and maximum, and still double on each retransmission.
+ *
+ * Requires: MBEDTLS_SSL_PROTO_DTLS
+ *           MBEDTLS_HAVE_TIME
+ *
+ * Uncomment this to derive retransmission timeouts from the flight RTT.
+ */
+//#define MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT
+
 /**
  * \def MBEDTLS_SSL_DTLS_ANTI_REPLAY
  *
@@ -580,6 +651,23 @@
  */
 #define MBEDTLS_SSL_DTLS_CONNECTION_ID_COMPAT 0
 
+/**
+ * \def MBEDTLS_SSL_DTLS_DEMUX_C
+ *
+ * Enable the DTLS server demultiplexer, which serves many clients from a
+ * single bound UDP socket by routing each datagram to the SSL context of its
+ * peer, by source address or by DTLS Connection ID. SSL contexts are only
+ * created for clients that passed the HelloVerifyRequest cookie exchange.
+ *
+ * Module:  library/ssl_dtls_demux.c
+ * Caller:
+ *
+ * Requires: MBEDTLS_NET_C, MBEDTLS_SSL_SRV_C, MBEDTLS_SSL_DTLS_HELLO_VERIFY
+ *
+ * Uncomment to enable the DTLS server demultiplexer.
+ */
+//#define MBEDTLS_SSL_DTLS_DEMUX_C
+
 /**
  * \def MBEDTLS_SSL_DTLS_HELLO_VERIFY
  *
@@ -598,6 +686,23 @@
  */
 #define MBEDTLS_SSL_DTLS_HELLO_VERIFY
 
+/**
+ * \def MBEDTLS_SSL_DTLS_PMTU_DISCOVERY
+ *
+ * Enable DTLS path MTU discovery, see mbedtls_ssl_set_pmtu_discovery().
+ *
+ * When enabled at runtime, the datagram size limit of a connection is
+ * searched between configured bounds: it is raised when a handshake flight
+ * made of larger datagrams is answered by the peer, and lowered when the
+ * transport reports MBEDTLS_ERR_SSL_DATAGRAM_TOO_BIG or a flight has to be
+ * retransmitted more than once.
+ *
+ * Requires: MBEDTLS_SSL_PROTO_DTLS
+ *
+ * Uncomment this to enable support for path MTU discovery.
+ */
+//#define MBEDTLS_SSL_DTLS_PMTU_DISCOVERY
+
 /**
  * \def MBEDTLS_SSL_DTLS_SRTP
  *
@@ -679,6 +784,39 @@
  */
 #define MBEDTLS_SSL_EXTENDED_MASTER_SECRET
 
+/**
+ * \def MBEDTLS_SSL_GROUP_CACHE_C
+ *
+ * Enable a client-side cache of the key exchange groups selected by TLS 1.3
+ * servers, which saves the HelloRetryRequest round trip on repeat
+ * connections. See mbedtls_ssl_conf_group_cache().
+ *
+ * Module:  library/ssl_group_cache.c
+ * Caller:  library/ssl_tls13_client.c
+ *
+ * Requires: MBEDTLS_SSL_CLI_C, MBEDTLS_SSL_PROTO_TLS1_3
+ */
+//#define MBEDTLS_SSL_GROUP_CACHE_C
+
+/**
+ * \def MBEDTLS_SSL_HANDSHAKE_ARENA
+ *
+ * Allocate the memory that only lives as long as a handshake from an arena,
+ * instead of one heap allocation each: the copies of configuration lists,
+ * cookies, the TLS 1.3 handshake keys and the DTLS flights and reassembly
+ * buffers. The arena is allocated with the handshake context, in the same
+ * heap block, and released with it at the end of the handshake. Allocations
+ * that do not fit fall back to the heap.
+ *
+ * This trades #MBEDTLS_SSL_HANDSHAKE_ARENA_SIZE bytes of RAM per running
+ * handshake for fewer calls to the allocator.
+ *
+ * Requires: MBEDTLS_SSL_TLS_C
+ *
+ * Uncomment this to allocate handshake memory from an arena.
+ */
+//#define MBEDTLS_SSL_HANDSHAKE_ARENA
+
 /**
  * \def MBEDTLS_SSL_KEEP_PEER_CERTIFICATE
  *
@@ -703,6 +841,20 @@
  */
 #define MBEDTLS_SSL_KEEP_PEER_CERTIFICATE
 
+/**
+ * \def MBEDTLS_SSL_KEY_SHARE_POOL_C
+ *
+ * Enable a pool of pre-generated ephemeral (EC)DH key pairs, which takes
+ * the key generation of TLS 1.3 key shares and TLS 1.2 ECDHE off the
+ * handshake. See mbedtls_ssl_conf_key_share_pool().
+ *
+ * Module:  library/ssl_key_share_pool.c
+ * Caller:
+ *
+ * Requires: MBEDTLS_SSL_TLS_C
+ */
+//#define MBEDTLS_SSL_KEY_SHARE_POOL_C
+
 /**
  * \def MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
  *
@@ -712,6 +864,32 @@
  */
 #define MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
 
+/**
+ * \def MBEDTLS_SSL_MEMORY_ACCOUNTING
+ *
+ * Account for the memory that the SSL module allocates for each connection
+ * and each configuration, see mbedtls_ssl_get_memory_usage() and
+ * mbedtls_ssl_conf_get_memory_usage(), and allow to cap the memory of a
+ * connection with mbedtls_ssl_conf_memory_limit().
+ *
+ * Requires: MBEDTLS_SSL_TLS_C
+ *
+ * Uncomment this macro to enable memory accounting.
+ */
+//#define MBEDTLS_SSL_MEMORY_ACCOUNTING
+
+/**
+ * \def MBEDTLS_SSL_PREENCODE_CERTS
+ *
+ * Enable mbedtls_ssl_conf_preencode_certs(), which encodes the Certificate
+ * messages of the own certificate chains and the CA list of the TLS 1.2
+ * CertificateRequest once per configuration, so that handshakes only copy
+ * them. This costs about as much RAM as the certificates themselves.
+ *
+ * Requires: MBEDTLS_X509_CRT_PARSE_C
+ */
+//#define MBEDTLS_SSL_PREENCODE_CERTS
+
 /**
  * \def MBEDTLS_SSL_PROTO_DTLS
  *
@@ -811,6 +989,20 @@
  */
 #define MBEDTLS_SSL_SESSION_TICKETS
 
+/**
+ * \def MBEDTLS_SSL_SNI_MAP_C
+ *
+ * Enable a map of server names to certificates for servers of many virtual
+ * hosts, with exact and wildcard names. See mbedtls_ssl_sni_map_callback().
+ *
+ * Module:  library/ssl_sni_map.c
+ * Caller:
+ *
+ * Requires: MBEDTLS_SSL_SRV_C, MBEDTLS_SSL_SERVER_NAME_INDICATION,
+ *           MBEDTLS_X509_CRT_PARSE_C
+ */
+//#define MBEDTLS_SSL_SNI_MAP_C
+
 /**
  * \def MBEDTLS_SSL_SRV_C
  *
@@ -839,6 +1031,24 @@
  */
 #define MBEDTLS_SSL_TICKET_C
 
+/**
+ * \def MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE
+ *
+ * Pack consecutive TLS 1.3 handshake messages into shared records.
+ *
+ * Without this option, each handshake message is sent in a record of its
+ * own. With it, the messages that are protected with the same keys, such as
+ * the EncryptedExtensions, Certificate, CertificateVerify and Finished
+ * messages of a server, are written to the same record up to the maximum
+ * record size, and the whole flight is sent at once. This saves record
+ * headers, AEAD tags and calls to the network layer.
+ *
+ * Requires: MBEDTLS_SSL_PROTO_TLS1_3
+ *
+ * Uncomment this to coalesce TLS 1.3 handshake messages.
+ */
+//#define MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE
+
 /**
  * \def MBEDTLS_SSL_TLS1_3_COMPATIBILITY_MODE
  *
@@ -861,6 +1071,21 @@
  */
 #define MBEDTLS_SSL_TLS1_3_COMPATIBILITY_MODE
 
+/**
+ * \def MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION
+ *
+ * Enable TLS 1.3 certificate compression (RFC 8879).
+ *
+ * The compression algorithms are not part of the library: they are provided
+ * by the application through mbedtls_ssl_conf_cert_compression().
+ *
+ * Requires: MBEDTLS_SSL_PROTO_TLS1_3
+ *           MBEDTLS_X509_CRT_PARSE_C
+ *
+ * Uncomment this to enable certificate compression.
+ */
+//#define MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION
+
 /**
  * \def MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED
  *
@@ -905,6 +1130,23 @@
  */
 #define MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_PSK_EPHEMERAL_ENABLED
 
+/**
+ * \def MBEDTLS_SSL_TLS1_3_KEY_UPDATE
+ *
+ * Enable the TLS 1.3 KeyUpdate message (RFC 8446 section 4.6.3).
+ *
+ * Without this option, a KeyUpdate from the peer ends the connection.
+ * With it, KeyUpdate messages from the peer are honored, and the traffic
+ * keys can be updated with mbedtls_ssl_key_update() or automatically with
+ * mbedtls_ssl_conf_key_update_interval(), so that long-lived connections
+ * stay within the usage limits of their AEAD keys.
+ *
+ * Requires: MBEDTLS_SSL_PROTO_TLS1_3
+ *
+ * Uncomment this to enable KeyUpdate support.
+ */
+//#define MBEDTLS_SSL_TLS1_3_KEY_UPDATE
+
 /**
  * \def MBEDTLS_SSL_TLS_C
  *
@@ -931,6 +1173,20 @@
  */
 //#define MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH
 
+/**
+ * \def MBEDTLS_SSL_VERIFY_CACHE_C
+ *
+ * Enable a cache of verified peer certificate chains, which saves the
+ * signature checks of the chains that peers present again.
+ * See mbedtls_ssl_conf_verify_cache().
+ *
+ * Module:  library/ssl_verify_cache.c
+ * Caller:
+ *
+ * Requires: MBEDTLS_SSL_TLS_C, MBEDTLS_X509_CRT_PARSE_C, PSA_WANT_ALG_SHA_256
+ */
+//#define MBEDTLS_SSL_VERIFY_CACHE_C
+
 //#define MBEDTLS_PSK_MAX_LEN               32 /**< Max size of TLS pre-shared keys, in bytes (default 256 or 384 bits) */
 //#define MBEDTLS_SSL_CACHE_DEFAULT_MAX_ENTRIES      50 /**< Maximum entries in cache */
 //#define MBEDTLS_SSL_CACHE_DEFAULT_TIMEOUT       86400 /**< 1 day  */
@@ -981,6 +1237,10 @@
 
 //#define MBEDTLS_SSL_COOKIE_TIMEOUT        60 /**< Default expiration delay of DTLS cookies, in seconds if HAVE_TIME, or in number of cookies issued */
 
+//#define MBEDTLS_SSL_DTLS_DEMUX_BATCH_SIZE         8 /**< Datagrams read per system call by the DTLS demultiplexer */
+//#define MBEDTLS_SSL_DTLS_DEMUX_DEFAULT_MAX_PEERS 1024 /**< Default maximum number of peers of the DTLS demultiplexer */
+//#define MBEDTLS_SSL_DTLS_DEMUX_DEFAULT_IDLE_TIMEOUT 300000 /**< Default idle time in milliseconds after which the DTLS demultiplexer evicts a peer */
+
 /** \def MBEDTLS_SSL_DTLS_MAX_BUFFERING
  *
  * Maximum number of heap-allocated bytes for the purpose of
@@ -998,6 +1258,8 @@
  */
 //#define MBEDTLS_SSL_DTLS_MAX_BUFFERING             32768
 
+//#define MBEDTLS_SSL_HANDSHAKE_ARENA_SIZE            4096 /**< Size of the arena of a handshake, in bytes, see MBEDTLS_SSL_HANDSHAKE_ARENA */
+
 /** \def MBEDTLS_SSL_IN_CONTENT_LEN
  *
  * Maximum length (in bytes) of incoming plaintext fragments.
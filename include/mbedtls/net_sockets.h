@@ -69,6 +69,10 @@
 #define MBEDTLS_NET_POLL_READ  1 /**< Used in \c mbedtls_net_poll to check for pending data  */
 #define MBEDTLS_NET_POLL_WRITE 2 /**< Used in \c mbedtls_net_poll to check if write possible */
 
+#define MBEDTLS_NET_ADDR_MAX_LEN 128 /**< Room for any socket address (sockaddr_storage) */
+
+#define MBEDTLS_NET_BATCH_MAX  32 /**< Most datagrams moved by one batch call */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -88,9 +92,44 @@ typedef struct mbedtls_net_context {
      * meaning, or be absent altogether.
      */
     int fd;
+
+    /** Set once the kernel or network device has rejected a UDP
+     * segmentation offload send on this socket. */
+    int MBEDTLS_PRIVATE(gso_failed);
 }
 mbedtls_net_context;
 
+/**
+ * Opaque socket address of a datagram peer, as filled by
+ * mbedtls_net_recv_from() and consumed by mbedtls_net_send_to().
+ *
+ * Two addresses refer to the same peer if and only if their first
+ * \c len bytes are identical: unused parts of the underlying socket
+ * address structure are always zeroed.
+ */
+typedef struct mbedtls_net_addr {
+    unsigned char MBEDTLS_PRIVATE(addr)[MBEDTLS_NET_ADDR_MAX_LEN];
+    size_t MBEDTLS_PRIVATE(len);
+}
+mbedtls_net_addr;
+
+/**
+ * One datagram of a batch, see mbedtls_net_recv_batch() and
+ * mbedtls_net_send_batch().
+ */
+typedef struct mbedtls_net_dgram {
+    unsigned char *buf;     /**< Datagram payload */
+    size_t size;            /**< Receive: size of \c buf. Unused for send. */
+    size_t len;             /**< Receive: bytes received. Send: bytes to send. */
+    /** Receive: 0, or the segment size if the kernel coalesced several
+     *  datagrams of the same flow into \c buf (UDP GRO).
+     *  Send: 0, or the size of the datagrams to split \c buf into, the
+     *  last one being possibly shorter (UDP GSO where available). */
+    size_t segment_size;
+    mbedtls_net_addr addr;  /**< Receive: sender. Send: destination. */
+}
+mbedtls_net_dgram;
+
 /**
  * \brief          Initialize a context
  *                 Just makes the context ready to be used or freed safely.
@@ -241,6 +280,187 @@ int mbedtls_net_recv(void *ctx, unsigned char *buf, size_t len);
  */
 int mbedtls_net_send(void *ctx, const unsigned char *buf, size_t len);
 
+/**
+ * \brief          Receive one datagram on an unconnected (bound) UDP socket
+ *                 and report the address it was sent from.
+ *
+ * \param ctx      Socket, typically set up with mbedtls_net_bind()
+ * \param buf      The buffer to write to
+ * \param len      Maximum length of the buffer
+ * \param peer     On success, the address of the sender
+ *
+ * \return         the number of bytes received,
+ *                 or a non-zero error code; with a non-blocking socket,
+ *                 MBEDTLS_ERR_SSL_WANT_READ indicates recvfrom() would block.
+ *
+ * \note           A datagram larger than \p len is truncated.
+ */
+int mbedtls_net_recv_from(mbedtls_net_context *ctx, unsigned char *buf,
+                          size_t len, mbedtls_net_addr *peer);
+
+/**
+ * \brief          Send one datagram to the given address on an unconnected
+ *                 (bound) UDP socket.
+ *
+ * \param ctx      Socket, typically set up with mbedtls_net_bind()
+ * \param buf      The buffer to read from
+ * \param len      The length of the buffer
+ * \param peer     The destination, as filled by mbedtls_net_recv_from()
+ *
+ * \return         the number of bytes sent,
+ *                 or a non-zero error code; with a non-blocking socket,
+ *                 MBEDTLS_ERR_SSL_WANT_WRITE indicates sendto() would block.
+ */
+int mbedtls_net_send_to(mbedtls_net_context *ctx, const unsigned char *buf,
+                        size_t len, const mbedtls_net_addr *peer);
+
+/**
+ * \brief          Receive several datagrams in one call on an unconnected
+ *                 (bound) UDP socket.
+ *
+ *                 This uses recvmmsg() where available, reducing the number
+ *                 of system calls under load. Elsewhere, it receives a
+ *                 single datagram.
+ *
+ * \param ctx      Socket, typically set up with mbedtls_net_bind()
+ * \param dgrams   Array of \p count datagram descriptors. For each of them,
+ *                 \c buf and \c size must be set on input. On success, the
+ *                 first N entries (N being the return value) have \c len,
+ *                 \c segment_size and \c addr filled.
+ * \param count    Number of entries in \p dgrams. At most
+ *                 #MBEDTLS_NET_BATCH_MAX are used.
+ *
+ * \return         the number of datagrams received (at least 1),
+ *                 or a non-zero error code; with a non-blocking socket,
+ *                 MBEDTLS_ERR_SSL_WANT_READ indicates the call would block.
+ *
+ * \note           On a blocking socket, this blocks until the first
+ *                 datagram arrives, then returns whatever else is
+ *                 already queued.
+ *
+ * \note           If a buffer of coalesced datagrams (UDP GRO) does not
+ *                 fit in \c buf, only the datagrams received whole are
+ *                 reported in \c len.
+ */
+int mbedtls_net_recv_batch(mbedtls_net_context *ctx,
+                           mbedtls_net_dgram *dgrams, size_t count);
+
+/**
+ * \brief          Send several datagrams in one call on an unconnected
+ *                 (bound) UDP socket.
+ *
+ *                 This uses sendmmsg() where available, and UDP generic
+ *                 segmentation offload for entries with a non-zero
+ *                 \c segment_size where the kernel supports it. Elsewhere,
+ *                 datagrams and segments are sent one at a time.
+ *
+ *                 An entry is only offloaded if it has at most 64 segments
+ *                 and 65507 bytes; larger ones are split into segments
+ *                 before sending. If the kernel or network device rejects
+ *                 an offloaded send, segments are sent one at a time on
+ *                 this socket from then on.
+ *
+ * \param ctx      Socket, typically set up with mbedtls_net_bind()
+ * \param dgrams   Array of \p count datagram descriptors with \c buf,
+ *                 \c len, \c segment_size and \c addr set.
+ * \param count    Number of entries in \p dgrams. At most
+ *                 #MBEDTLS_NET_BATCH_MAX are used.
+ *
+ * \return         the number of entries of \p dgrams fully sent (at least
+ *                 1), or a non-zero error code; with a non-blocking socket,
+ *                 MBEDTLS_ERR_SSL_WANT_WRITE indicates the call would block.
+ */
+int mbedtls_net_send_batch(mbedtls_net_context *ctx,
+                           const mbedtls_net_dgram *dgrams, size_t count);
+
+/**
+ * \brief          Enable or disable UDP generic receive offload, which lets
+ *                 the kernel coalesce consecutive datagrams of a flow into
+ *                 one buffer reported by mbedtls_net_recv_batch() with a
+ *                 non-zero \c segment_size.
+ *
+ * \param ctx      UDP socket
+ * \param enable   1 to enable, 0 to disable
+ *
+ * \return         0 if successful, or
+ *                 MBEDTLS_ERR_NET_SOCKET_FAILED if the platform or kernel
+ *                 does not support it.
+ */
+int mbedtls_net_set_udp_gro(mbedtls_net_context *ctx, int enable);
+
+/**
+ * \brief          Make the kernel report datagrams that exceed the known
+ *                 path MTU instead of fragmenting them.
+ *
+ *                 This sets the IP Don't Fragment bit on outgoing
+ *                 datagrams. Once an ICMP "fragmentation needed" or
+ *                 "packet too big" message has lowered the path MTU known
+ *                 to the kernel, mbedtls_net_send() and
+ *                 mbedtls_net_send_to() fail with
+ *                 MBEDTLS_ERR_SSL_DATAGRAM_TOO_BIG for larger datagrams,
+ *                 which DTLS path MTU discovery (see
+ *                 mbedtls_ssl_set_pmtu_discovery()) uses to lower its
+ *                 estimate. On sockets that were not set up with this
+ *                 function, oversized datagrams fail with
+ *                 MBEDTLS_ERR_NET_SEND_FAILED as before.
+ *
+ * \param ctx      UDP socket
+ *
+ * \return         0 if successful, or
+ *                 MBEDTLS_ERR_NET_SOCKET_FAILED if the platform does not
+ *                 support it.
+ */
+int mbedtls_net_set_pmtu_discovery(mbedtls_net_context *ctx);
+
+/**
+ * \brief          Pass a socket to another process over a Unix domain
+ *                 socket, together with a message such as the output of
+ *                 mbedtls_ssl_context_save().
+ *
+ *                 The descriptor is sent as SCM_RIGHTS ancillary data. The
+ *                 receiving process gets it with mbedtls_net_recv_fd().
+ *
+ * \param ctx      Connected Unix domain stream socket (blocking)
+ * \param conn     Socket to pass. It stays open in this process: release
+ *                 it with mbedtls_net_close(), not mbedtls_net_free(),
+ *                 which would shut the connection down for the receiver
+ *                 too.
+ * \param buf      The message to send along with the socket
+ * \param len      Length of \p buf, at most 2^32 - 1 bytes
+ *
+ * \return         0 if successful, or
+ *                 MBEDTLS_ERR_NET_SOCKET_FAILED if the platform does not
+ *                 support passing descriptors, or another negative error
+ *                 code (MBEDTLS_ERR_NET_xxx).
+ */
+int mbedtls_net_send_fd(mbedtls_net_context *ctx,
+                        const mbedtls_net_context *conn,
+                        const unsigned char *buf, size_t len);
+
+/**
+ * \brief          Receive a socket and its message sent by
+ *                 mbedtls_net_send_fd().
+ *
+ * \param ctx      Connected Unix domain stream socket (blocking)
+ * \param conn     Context to hold the received socket. Its previous
+ *                 descriptor, if any, is overwritten.
+ * \param buf      The buffer to write the message to
+ * \param buf_len  Length of \p buf
+ * \param olen     On success, the length of the message
+ *
+ * \return         0 if successful, or
+ *                 MBEDTLS_ERR_NET_BUFFER_TOO_SMALL if the message does not
+ *                 fit in \p buf, or
+ *                 MBEDTLS_ERR_NET_SOCKET_FAILED if the platform does not
+ *                 support passing descriptors, or another negative error
+ *                 code (MBEDTLS_ERR_NET_xxx). On error, the received
+ *                 socket, if any, is closed, and \p ctx should not be used
+ *                 for further messages.
+ */
+int mbedtls_net_recv_fd(mbedtls_net_context *ctx,
+                        mbedtls_net_context *conn,
+                        unsigned char *buf, size_t buf_len, size_t *olen);
+
 /**
  * \brief          Read at most 'len' characters, blocking for at most
  *                 'timeout' seconds. If no error occurs, the actual amount
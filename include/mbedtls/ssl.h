@@ -155,7 +155,8 @@
 #define MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS                 -0x6500
 /** Internal-only message signaling that a message arrived early. */
 #define MBEDTLS_ERR_SSL_EARLY_MESSAGE                     -0x6480
-/* Error space gap */
+/** A datagram was larger than the path MTU and could not be sent. */
+#define MBEDTLS_ERR_SSL_DATAGRAM_TOO_BIG                  -0x6400
 /* Error space gap */
 /* Error space gap */
 /* Error space gap */
@@ -324,6 +325,9 @@
 #define MBEDTLS_SSL_SESSION_TICKETS_DISABLED     0
 #define MBEDTLS_SSL_SESSION_TICKETS_ENABLED      1
 
+#define MBEDTLS_SSL_NEW_SESSION_TICKETS_IMMEDIATE   0
+#define MBEDTLS_SSL_NEW_SESSION_TICKETS_DEFERRED    1
+
 #define MBEDTLS_SSL_PRESET_DEFAULT              0
 #define MBEDTLS_SSL_PRESET_SUITEB               2
 
@@ -333,6 +337,9 @@
 #define MBEDTLS_SSL_EARLY_DATA_DISABLED        0
 #define MBEDTLS_SSL_EARLY_DATA_ENABLED         1
 
+#define MBEDTLS_SSL_KEY_UPDATE_NOT_REQUESTED     0
+#define MBEDTLS_SSL_KEY_UPDATE_REQUESTED         1
+
 #define MBEDTLS_SSL_DTLS_SRTP_MKI_UNSUPPORTED    0
 #define MBEDTLS_SSL_DTLS_SRTP_MKI_SUPPORTED      1
 
@@ -408,6 +415,13 @@
 #define MBEDTLS_SSL_DTLS_MAX_BUFFERING 32768
 #endif
 
+/*
+ * Size of the memory arena of a handshake.
+ */
+#if !defined(MBEDTLS_SSL_HANDSHAKE_ARENA_SIZE)
+#define MBEDTLS_SSL_HANDSHAKE_ARENA_SIZE 4096
+#endif
+
 /*
  * Maximum length of CIDs for incoming and outgoing messages.
  */
@@ -439,6 +453,14 @@
 #define MBEDTLS_SSL_TLS1_3_DEFAULT_NEW_SESSION_TICKETS 1
 #endif
 
+#if !defined(MBEDTLS_SSL_CERT_COMPRESSION_MAX_ALGS)
+#define MBEDTLS_SSL_CERT_COMPRESSION_MAX_ALGS   3
+#endif
+
+#if !defined(MBEDTLS_SSL_CERT_COMPRESSION_MAX_LEN)
+#define MBEDTLS_SSL_CERT_COMPRESSION_MAX_LEN    65536
+#endif
+
 /** \} name SECTION: Module settings */
 
 /*
@@ -575,6 +597,8 @@
 #define MBEDTLS_SSL_HS_CERTIFICATE_VERIFY      15
 #define MBEDTLS_SSL_HS_CLIENT_KEY_EXCHANGE     16
 #define MBEDTLS_SSL_HS_FINISHED                20
+#define MBEDTLS_SSL_HS_KEY_UPDATE              24 /* TLS 1.3 */
+#define MBEDTLS_SSL_HS_COMPRESSED_CERTIFICATE  25 /* RFC 8879 TLS 1.3 */
 #define MBEDTLS_SSL_HS_MESSAGE_HASH           254
 
 /*
@@ -604,6 +628,7 @@
 #define MBEDTLS_TLS_EXT_ENCRYPT_THEN_MAC            22 /* 0x16 */
 #define MBEDTLS_TLS_EXT_EXTENDED_MASTER_SECRET  0x0017 /* 23 */
 
+#define MBEDTLS_TLS_EXT_COMPRESS_CERTIFICATE        27 /* RFC 8879 TLS 1.3 */
 #define MBEDTLS_TLS_EXT_RECORD_SIZE_LIMIT           28 /* RFC 8449 (implemented for TLS 1.3 only) */
 
 #define MBEDTLS_TLS_EXT_SESSION_TICKET              35
@@ -630,6 +655,13 @@
 
 #define MBEDTLS_TLS_EXT_RENEGOTIATION_INFO      0xFF01
 
+/*
+ * Certificate compression algorithms (RFC 8879)
+ */
+#define MBEDTLS_SSL_CERT_COMPRESSION_ZLIB           1
+#define MBEDTLS_SSL_CERT_COMPRESSION_BROTLI         2
+#define MBEDTLS_SSL_CERT_COMPRESSION_ZSTD           3
+
 /*
  * Size defines
  */
@@ -864,6 +896,18 @@ typedef struct mbedtls_ssl_key_cert mbedtls_ssl_key_cert;
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
 typedef struct mbedtls_ssl_flight_item mbedtls_ssl_flight_item;
 #endif
+#if defined(MBEDTLS_SSL_KEY_SHARE_POOL_C)
+typedef struct mbedtls_ssl_key_share_pool mbedtls_ssl_key_share_pool;
+#endif
+#if defined(MBEDTLS_SSL_VERIFY_CACHE_C)
+typedef struct mbedtls_ssl_verify_cache mbedtls_ssl_verify_cache;
+#endif
+#if defined(MBEDTLS_SSL_GROUP_CACHE_C)
+typedef struct mbedtls_ssl_group_cache mbedtls_ssl_group_cache;
+#endif
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+typedef struct mbedtls_ssl_suite_slot mbedtls_ssl_suite_slot;
+#endif
 
 #if defined(MBEDTLS_SSL_PROTO_TLS1_3) && defined(MBEDTLS_SSL_SESSION_TICKETS)
 #define MBEDTLS_SSL_TLS1_3_TICKET_ALLOW_PSK_RESUMPTION                          \
@@ -972,6 +1016,16 @@ typedef int mbedtls_ssl_cache_set_t(void *data,
  *                  `Ecdsa-Sig-Value` defined in
  *                  [RFC 4492 section 5.4](https://tools.ietf.org/html/rfc4492#section-5.4).
  *
+ * \note            In TLS 1.3, this callback signs the CertificateVerify
+ *                  message, both on a server and on a client that
+ *                  authenticates with a certificate. TLS 1.3 does not use
+ *                  PKCS#1 v1.5 signatures: when
+ *                  mbedtls_ssl_get_version_number() returns
+ *                  #MBEDTLS_SSL_VERSION_TLS1_3, RSA signatures must instead
+ *                  use RSASSA-PSS with \p md_alg as the hash and MGF1 hash
+ *                  and a salt as long as the hash, like
+ *                  mbedtls_pk_sign_ext() with #MBEDTLS_PK_RSASSA_PSS.
+ *
  * \param ssl             The SSL connection instance. It should not be
  *                        modified other than via
  *                        mbedtls_ssl_set_async_operation_data().
@@ -1140,6 +1194,151 @@ typedef int mbedtls_ssl_async_resume_t(mbedtls_ssl_context *ssl,
 typedef void mbedtls_ssl_async_cancel_t(mbedtls_ssl_context *ssl);
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+/**
+ * \brief           A cryptographic operation of a handshake that may be run
+ *                  outside of the handshake, possibly on another thread.
+ *
+ *                  The structure is opaque. It is owned by the SSL context
+ *                  and remains valid until the operation has been reported
+ *                  complete by the ::mbedtls_ssl_async_job_poll_t callback
+ *                  or cancelled by the ::mbedtls_ssl_async_job_cancel_t
+ *                  callback.
+ */
+typedef struct mbedtls_ssl_async_job mbedtls_ssl_async_job;
+
+/**
+ * \brief           Kinds of operations passed to the asynchronous
+ *                  cryptography callbacks.
+ */
+typedef enum {
+    MBEDTLS_SSL_ASYNC_JOB_NONE = 0,
+    MBEDTLS_SSL_ASYNC_JOB_KEY_GENERATION,   /*!< (EC)DHE key share generation */
+    MBEDTLS_SSL_ASYNC_JOB_KEY_AGREEMENT,    /*!< (EC)DHE shared secret        */
+    MBEDTLS_SSL_ASYNC_JOB_VERIFY,           /*!< peer signature verification  */
+} mbedtls_ssl_async_job_type;
+
+/**
+ * \brief           Callback type: start an asynchronous cryptographic job.
+ *
+ *                  This callback is called during an SSL handshake instead
+ *                  of performing an expensive operation inline. It typically
+ *                  enqueues \p job for a worker thread, which calls
+ *                  mbedtls_ssl_async_job_run() on it, and returns at once.
+ *                  The handshake then returns
+ *                  #MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS and calls the poll
+ *                  callback each time it is resumed, until the job is done.
+ *
+ * \note            A handshake has at most one job at a time.
+ *                  mbedtls_ssl_async_job_run() must not be called on a job
+ *                  after the poll callback has reported it done, or after
+ *                  the cancel callback has returned.
+ *
+ * \param p_ctx     The context passed to mbedtls_ssl_conf_async_crypto_cb().
+ * \param job       The job to run.
+ *
+ * \return          0 if the job was queued.
+ * \return          #MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH to have the library
+ *                  run the job inline instead.
+ * \return          Any other error aborts the handshake.
+ */
+typedef int mbedtls_ssl_async_job_start_t(void *p_ctx,
+                                          mbedtls_ssl_async_job *job);
+
+/**
+ * \brief           Callback type: check whether an asynchronous job is done.
+ *
+ *                  The poll callback must not block. Once it has returned 0,
+ *                  the library reads the results of the job, so the
+ *                  callback must ensure that the worker's writes to \p job
+ *                  are visible to the calling thread, for example by
+ *                  synchronizing on the same mutex as the worker.
+ *
+ * \param p_ctx     The context passed to mbedtls_ssl_conf_async_crypto_cb().
+ * \param job       A job accepted by the start callback.
+ *
+ * \return          0 if mbedtls_ssl_async_job_run() has returned for \p job.
+ * \return          #MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS if it has not.
+ * \return          Any other error aborts the handshake.
+ */
+typedef int mbedtls_ssl_async_job_poll_t(void *p_ctx,
+                                         mbedtls_ssl_async_job *job);
+
+/**
+ * \brief           Callback type: cancel an asynchronous job.
+ *
+ *                  This callback is called when the handshake is freed or
+ *                  reset while a job that was accepted by the start callback
+ *                  has not been reported done. When it returns, the job must
+ *                  not be running and must never be run, since its memory is
+ *                  released right after.
+ *
+ * \param p_ctx     The context passed to mbedtls_ssl_conf_async_crypto_cb().
+ * \param job       The job to cancel.
+ */
+typedef void mbedtls_ssl_async_job_cancel_t(void *p_ctx,
+                                            mbedtls_ssl_async_job *job);
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
+
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+/**
+ * \brief           Callback type: compress a TLS 1.3 Certificate message.
+ *
+ * \param p_ctx     The context passed to mbedtls_ssl_conf_cert_compression().
+ * \param input     The encoded Certificate message, without its handshake
+ *                  header.
+ * \param input_len The length of \p input in bytes.
+ * \param output    The buffer to write the compressed data to.
+ * \param output_size The size of \p output in bytes. This is
+ *                  \p input_len: compression that does not save space is
+ *                  pointless.
+ * \param output_len On success, the length of the compressed data.
+ *
+ * \return          0 on success,
+ *                  #MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL if the compressed data
+ *                  does not fit, in which case the certificate is sent
+ *                  uncompressed, or another negative error code, which
+ *                  aborts the handshake.
+ */
+typedef int mbedtls_ssl_cert_compress_t(void *p_ctx,
+                                        const unsigned char *input,
+                                        size_t input_len,
+                                        unsigned char *output,
+                                        size_t output_size,
+                                        size_t *output_len);
+
+/**
+ * \brief           Callback type: decompress a TLS 1.3 Certificate message.
+ *
+ * \param p_ctx     The context passed to mbedtls_ssl_conf_cert_compression().
+ * \param input     The compressed data.
+ * \param input_len The length of \p input in bytes.
+ * \param output    The buffer to write the Certificate message to.
+ * \param output_len The length of the Certificate message announced by the
+ *                  peer. The decompressed data must have exactly this
+ *                  length.
+ *
+ * \return          0 on success, or a negative error code if the data
+ *                  cannot be decompressed or has a different length. The
+ *                  handshake is then aborted with a bad_certificate alert.
+ */
+typedef int mbedtls_ssl_cert_decompress_t(void *p_ctx,
+                                          const unsigned char *input,
+                                          size_t input_len,
+                                          unsigned char *output,
+                                          size_t output_len);
+
+/**
+ * \brief           A certificate compression algorithm
+ */
+typedef struct mbedtls_ssl_cert_compression {
+    uint16_t MBEDTLS_PRIVATE(alg);                          /*!< IANA identifier */
+    mbedtls_ssl_cert_compress_t *MBEDTLS_PRIVATE(f_compress);     /*!< may be NULL */
+    mbedtls_ssl_cert_decompress_t *MBEDTLS_PRIVATE(f_decompress); /*!< may be NULL */
+    void *MBEDTLS_PRIVATE(p_ctx);                           /*!< callback context */
+} mbedtls_ssl_cert_compression;
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
+
 #if defined(MBEDTLS_KEY_EXCHANGE_WITH_CERT_ENABLED) &&        \
     !defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
 #define MBEDTLS_SSL_PEER_CERT_DIGEST_MAX_LEN  48
@@ -1229,6 +1428,9 @@ struct mbedtls_ssl_session {
 #endif /* MBEDTLS_SSL_RECORD_SIZE_LIMIT */
 
     unsigned char MBEDTLS_PRIVATE(exported);
+    /*! Non-zero if the variable-length fields point into a serialized
+     *  session, see mbedtls_ssl_session_load_borrowed(). */
+    unsigned char MBEDTLS_PRIVATE(borrowed);
     uint8_t MBEDTLS_PRIVATE(endpoint);          /*!< 0: client, 1: server */
 
     /** TLS version negotiated in the session. Used if and when renegotiating
@@ -1443,6 +1645,14 @@ struct mbedtls_ssl_config {
     defined(MBEDTLS_SSL_SRV_C) && \
     defined(MBEDTLS_SSL_PROTO_TLS1_3)
     uint16_t MBEDTLS_PRIVATE(new_session_tickets_count);   /*!< number of NewSessionTicket */
+    uint8_t MBEDTLS_PRIVATE(new_session_tickets_mode);     /*!< when to send them        */
+#endif
+
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+    uint64_t MBEDTLS_PRIVATE(key_update_max_records); /*!< records sent before an
+                                                           automatic KeyUpdate */
+    uint64_t MBEDTLS_PRIVATE(key_update_max_bytes);   /*!< bytes sent before an
+                                                           automatic KeyUpdate */
 #endif
 
 #if defined(MBEDTLS_SSL_SRV_C)
@@ -1540,6 +1750,9 @@ struct mbedtls_ssl_config {
     mbedtls_x509_crt_ca_cb_t MBEDTLS_PRIVATE(f_ca_cb);
     void *MBEDTLS_PRIVATE(p_ca_cb);
 #endif /* MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK */
+#if defined(MBEDTLS_SSL_VERIFY_CACHE_C)
+    mbedtls_ssl_verify_cache *MBEDTLS_PRIVATE(verify_cache); /*!< verified peer chains */
+#endif
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
 
 #if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
@@ -1552,6 +1765,19 @@ struct mbedtls_ssl_config {
     void *MBEDTLS_PRIVATE(p_async_config_data); /*!< Configuration data set by mbedtls_ssl_conf_async_private_cb(). */
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+    mbedtls_ssl_async_job_start_t *MBEDTLS_PRIVATE(f_async_job_start);   /*!< queue a crypto job    */
+    mbedtls_ssl_async_job_poll_t *MBEDTLS_PRIVATE(f_async_job_poll);     /*!< check a crypto job    */
+    mbedtls_ssl_async_job_cancel_t *MBEDTLS_PRIVATE(f_async_job_cancel); /*!< cancel a crypto job   */
+    void *MBEDTLS_PRIVATE(p_async_job);                 /*!< context for async job callbacks */
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
+
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+    /** Certificate compression algorithms, by order of preference */
+    mbedtls_ssl_cert_compression MBEDTLS_PRIVATE(cert_compression)[MBEDTLS_SSL_CERT_COMPRESSION_MAX_ALGS];
+    unsigned char MBEDTLS_PRIVATE(cert_compression_count); /*!< entries in cert_compression */
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
+
 #if defined(MBEDTLS_SSL_HANDSHAKE_WITH_CERT_ENABLED)
 
 #if !defined(MBEDTLS_DEPRECATED_REMOVED)
@@ -1561,6 +1787,12 @@ struct mbedtls_ssl_config {
 #endif /* MBEDTLS_SSL_HANDSHAKE_WITH_CERT_ENABLED */
 
     const uint16_t *MBEDTLS_PRIVATE(group_list);     /*!< allowed IANA NamedGroups */
+#if defined(MBEDTLS_SSL_KEY_SHARE_POOL_C)
+    mbedtls_ssl_key_share_pool *MBEDTLS_PRIVATE(key_share_pool); /*!< pre-generated key pairs */
+#endif
+#if defined(MBEDTLS_SSL_GROUP_CACHE_C)
+    mbedtls_ssl_group_cache *MBEDTLS_PRIVATE(group_cache); /*!< groups selected by servers */
+#endif
 
 #if defined(MBEDTLS_DHM_C)
     mbedtls_mpi MBEDTLS_PRIVATE(dhm_P);              /*!< prime modulus for DHM              */
@@ -1642,6 +1874,10 @@ struct mbedtls_ssl_config {
 
     unsigned int MBEDTLS_PRIVATE(badmac_limit);      /*!< limit of records with a bad MAC    */
 
+#if defined(MBEDTLS_SSL_MEMORY_ACCOUNTING)
+    size_t MBEDTLS_PRIVATE(memory_limit);            /*!< memory ceiling of a connection     */
+#endif
+
 #if defined(MBEDTLS_DHM_C) && defined(MBEDTLS_SSL_CLI_C)
     unsigned int MBEDTLS_PRIVATE(dhm_min_bitlen);    /*!< min. bit length of the DHM prime   */
 #endif
@@ -1659,6 +1895,23 @@ struct mbedtls_ssl_config {
 
 #if defined(MBEDTLS_KEY_EXCHANGE_CERT_REQ_ALLOWED_ENABLED)
     const mbedtls_x509_crt *MBEDTLS_PRIVATE(dn_hints);/*!< acceptable client cert issuers    */
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS) && defined(MBEDTLS_SSL_SRV_C)
+    const mbedtls_x509_crt *MBEDTLS_PRIVATE(dn_list_src); /*!< chain dn_list encodes */
+    unsigned char *MBEDTLS_PRIVATE(dn_list);         /*!< encoded CertificateRequest DNs     */
+    size_t MBEDTLS_PRIVATE(dn_list_len);             /*!< length of dn_list                  */
+#endif
+#endif
+
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+    const int *MBEDTLS_PRIVATE(suite_table_src);    /*!< list suite_table indexes   */
+    mbedtls_ssl_suite_slot *MBEDTLS_PRIVATE(suite_table); /*!< ciphersuite hash table */
+    const uint16_t *MBEDTLS_PRIVATE(group_table_src); /*!< list group_table indexes */
+    uint16_t *MBEDTLS_PRIVATE(group_table);         /*!< group hash table           */
+    const uint16_t *MBEDTLS_PRIVATE(sig_alg_table_src); /*!< list sig_alg_table indexes */
+    uint16_t *MBEDTLS_PRIVATE(sig_alg_table);       /*!< signature algorithm table  */
+    unsigned char MBEDTLS_PRIVATE(suite_table_bits); /*!< log2 of table sizes       */
+    unsigned char MBEDTLS_PRIVATE(group_table_bits);
+    unsigned char MBEDTLS_PRIVATE(sig_alg_table_bits);
 #endif
 };
 
@@ -1752,6 +2005,16 @@ struct mbedtls_ssl_context {
     mbedtls_ssl_transform *MBEDTLS_PRIVATE(transform_application);
 #endif /* MBEDTLS_SSL_PROTO_TLS1_3 */
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+    uint8_t MBEDTLS_PRIVATE(key_update_state);   /*!< KeyUpdate to send or flush */
+    uint8_t MBEDTLS_PRIVATE(key_update_request); /*!< request_update of the
+                                                      pending KeyUpdate        */
+    uint64_t MBEDTLS_PRIVATE(key_update_records); /*!< records sent with the
+                                                       current traffic key     */
+    uint64_t MBEDTLS_PRIVATE(key_update_bytes);  /*!< bytes sent with the
+                                                      current traffic key      */
+#endif
+
     /*
      * Timers
      */
@@ -1816,6 +2079,18 @@ struct mbedtls_ssl_context {
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
     uint8_t MBEDTLS_PRIVATE(disable_datagram_packing);  /*!< Disable packing multiple records
                                                          *   within a single datagram.  */
+    uint8_t MBEDTLS_PRIVATE(app_data_packing);  /*!< Pack application records
+                                                 *   until flushed.         */
+    size_t MBEDTLS_PRIVATE(app_data_held_len);  /*!< Bytes of packed
+                                                 *   application records
+                                                 *   in out_left.           */
+#if defined(MBEDTLS_HAVE_TIME)
+    uint32_t MBEDTLS_PRIVATE(app_data_max_delay); /*!< Longest time (ms) a packed
+                                                   *   record is held back, or 0 */
+    mbedtls_ms_time_t MBEDTLS_PRIVATE(app_data_held_since); /*!< When the oldest
+                                                             *   held record was
+                                                             *   written            */
+#endif /* MBEDTLS_HAVE_TIME */
 #endif /* MBEDTLS_SSL_PROTO_DTLS */
 
 #if defined(MBEDTLS_SSL_EARLY_DATA)
@@ -1856,6 +2131,13 @@ struct mbedtls_ssl_context {
 
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
     uint16_t MBEDTLS_PRIVATE(mtu);               /*!< path mtu, used to fragment outgoing messages */
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+    uint16_t MBEDTLS_PRIVATE(pmtu_min);          /*!< lower bound of the PMTU search,
+                                                    or 0 if discovery is off      */
+    uint16_t MBEDTLS_PRIVATE(pmtu_max);          /*!< upper bound of the PMTU search */
+    uint16_t MBEDTLS_PRIVATE(pmtu_ceiling);      /*!< largest size not known to fail */
+    uint16_t MBEDTLS_PRIVATE(pmtu_confirmed);    /*!< largest size known to get through */
+#endif /* MBEDTLS_SSL_DTLS_PMTU_DISCOVERY */
 #endif /* MBEDTLS_SSL_PROTO_DTLS */
 
     /*
@@ -2434,6 +2716,57 @@ int mbedtls_ssl_get_peer_cid(mbedtls_ssl_context *ssl,
  * \param mtu      Value of the path MTU in bytes
  */
 void mbedtls_ssl_set_mtu(mbedtls_ssl_context *ssl, uint16_t mtu);
+
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+/**
+ * \brief          Enable or disable path MTU discovery for a DTLS
+ *                 connection. (DTLS only, no effect on TLS.)
+ *
+ *                 When enabled, the library manages the value set with
+ *                 mbedtls_ssl_set_mtu() itself. Each handshake starts at
+ *                 the largest size not known to fail, initially
+ *                 \p max_mtu, so that the fragments of its flights probe
+ *                 the path. A size is confirmed once the peer has answered
+ *                 a flight containing a datagram of that size.
+ *
+ *                 The estimate is lowered, within \p min_mtu and the
+ *                 largest confirmed size, when:
+ *                 - the \c f_send callback returns
+ *                   #MBEDTLS_ERR_SSL_DATAGRAM_TOO_BIG, for example from
+ *                   an \c EMSGSIZE error on a socket set up with
+ *                   mbedtls_net_set_pmtu_discovery(). Sizes at least as
+ *                   large as the failed datagram are not tried again on
+ *                   this connection;
+ *                 - a handshake flight containing datagrams larger than
+ *                   the confirmed size times out for the second time.
+ *
+ * \note           A datagram rejected with
+ *                 #MBEDTLS_ERR_SSL_DATAGRAM_TOO_BIG is dropped. During a
+ *                 handshake it is recovered by the usual retransmission.
+ *                 Otherwise the error is returned by the function that was
+ *                 sending, for example mbedtls_ssl_write(), and is not
+ *                 fatal: the data may be written again in records that
+ *                 fit the new limit, see
+ *                 mbedtls_ssl_get_max_out_record_payload().
+ *
+ * \note           Discovery only raises the limit during handshakes,
+ *                 which are the only acknowledged exchanges in DTLS 1.2.
+ *                 Larger datagrams are probed again on renegotiation or
+ *                 after mbedtls_ssl_session_reset().
+ *
+ * \param ssl      SSL context
+ * \param min_mtu  Smallest datagram size to fall back to, or 0 to disable
+ *                 discovery. When disabling, the current estimate stays
+ *                 set as with mbedtls_ssl_set_mtu().
+ * \param max_mtu  Largest datagram size to try. Must not be smaller than
+ *                 \p min_mtu.
+ *
+ * \return         0 on success, or #MBEDTLS_ERR_SSL_BAD_INPUT_DATA if
+ *                 \p max_mtu is smaller than \p min_mtu.
+ */
+int mbedtls_ssl_set_pmtu_discovery(mbedtls_ssl_context *ssl,
+                                   uint16_t min_mtu, uint16_t max_mtu);
+#endif /* MBEDTLS_SSL_DTLS_PMTU_DISCOVERY */
 #endif /* MBEDTLS_SSL_PROTO_DTLS */
 
 #if defined(MBEDTLS_X509_CRT_PARSE_C)
@@ -2608,6 +2941,12 @@ typedef int mbedtls_ssl_ticket_write_t(void *p_ticket,
  *                  bytes of the input buffer, eg to use it as a temporary
  *                  area for the decrypted ticket contents.
  *
+ * \note            The server keeps the input buffer until the end of the
+ *                  handshake, so the implementation may load the session
+ *                  with mbedtls_ssl_session_load_borrowed() from the
+ *                  decrypted contents. The server detaches the session
+ *                  before it stores it.
+ *
  * \param p_ticket  Context for the callback
  * \param session   SSL session to be loaded
  * \param buf       Start of the buffer containing the ticket
@@ -2936,6 +3275,96 @@ void mbedtls_ssl_set_async_operation_data(mbedtls_ssl_context *ssl,
                                           void *ctx);
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+/**
+ * \brief           Configure callbacks to run the expensive public key
+ *                  operations of handshakes asynchronously.
+ *
+ *                  With these callbacks, the following operations are
+ *                  handed over as ::mbedtls_ssl_async_job objects instead of
+ *                  being performed inside mbedtls_ssl_handshake(), which
+ *                  returns #MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS until they are
+ *                  done:
+ *                  - generation of the TLS 1.3 (EC)DHE key share;
+ *                  - computation of the TLS 1.3 (EC)DHE shared secret;
+ *                  - verification of the peer's TLS 1.3 CertificateVerify
+ *                    and TLS 1.2 ServerKeyExchange signatures.
+ *
+ *                  Private key signatures are offloaded separately with
+ *                  mbedtls_ssl_conf_async_private_cb().
+ *                  See mbedtls_ssl_async_pool_setup() for a ready-made
+ *                  backend using a pool of worker threads.
+ *
+ * \note            The jobs use PSA keys and mbedtls_pk contexts from other
+ *                  threads, so with a multithreaded backend the library must
+ *                  be built with #MBEDTLS_THREADING_C.
+ *
+ * \param conf      The SSL configuration.
+ * \param f_start   Callback to start a job, or \c NULL to run all
+ *                  operations inline (the default).
+ * \param f_poll    Callback to check whether a job is done. This must not
+ *                  be \c NULL if \p f_start is not \c NULL.
+ * \param f_cancel  Callback to cancel a job. This must not be \c NULL if
+ *                  \p f_start is not \c NULL.
+ * \param p_ctx     Context passed to the callbacks.
+ */
+void mbedtls_ssl_conf_async_crypto_cb(mbedtls_ssl_config *conf,
+                                      mbedtls_ssl_async_job_start_t *f_start,
+                                      mbedtls_ssl_async_job_poll_t *f_poll,
+                                      mbedtls_ssl_async_job_cancel_t *f_cancel,
+                                      void *p_ctx);
+
+/**
+ * \brief           Perform the operation described by an asynchronous job.
+ *
+ *                  This is meant to be called by the backend behind
+ *                  mbedtls_ssl_conf_async_crypto_cb(), on any thread. It
+ *                  does not access the SSL context.
+ *
+ * \param job       A job passed to the ::mbedtls_ssl_async_job_start_t
+ *                  callback.
+ *
+ * \return          0 if the operation succeeded, or the error code of the
+ *                  operation. The handshake reads the outcome from \p job
+ *                  itself, so the backend may ignore the return value.
+ */
+int mbedtls_ssl_async_job_run(mbedtls_ssl_async_job *job);
+
+/**
+ * \brief           Get the kind of operation of an asynchronous job, for
+ *                  example to prioritize some kinds over others.
+ *
+ * \param job       A job passed to the ::mbedtls_ssl_async_job_start_t
+ *                  callback.
+ *
+ * \return          The type of operation.
+ */
+mbedtls_ssl_async_job_type mbedtls_ssl_async_job_get_type(
+    const mbedtls_ssl_async_job *job);
+
+/**
+ * \brief           Attach backend data to an asynchronous job.
+ *
+ * \param job       A job passed to the ::mbedtls_ssl_async_job_start_t
+ *                  callback.
+ * \param data      Pointer stored in the job for the backend's own use.
+ *                  The library does not dereference it.
+ */
+void mbedtls_ssl_async_job_set_backend_data(mbedtls_ssl_async_job *job,
+                                            void *data);
+
+/**
+ * \brief           Retrieve the backend data of an asynchronous job.
+ *
+ * \param job       A job passed to the ::mbedtls_ssl_async_job_start_t
+ *                  callback.
+ *
+ * \return          The pointer set with
+ *                  mbedtls_ssl_async_job_set_backend_data(), or \c NULL.
+ */
+void *mbedtls_ssl_async_job_get_backend_data(const mbedtls_ssl_async_job *job);
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
+
 /**
  * \brief          Callback type: generate a cookie
  *
@@ -3074,6 +3503,30 @@ void mbedtls_ssl_conf_dtls_anti_replay(mbedtls_ssl_config *conf, char mode);
  */
 void mbedtls_ssl_conf_dtls_badmac_limit(mbedtls_ssl_config *conf, unsigned limit);
 
+#if defined(MBEDTLS_SSL_MEMORY_ACCOUNTING)
+/**
+ * \brief          Set a limit on the memory that the library allocates for
+ *                 each connection using this configuration, as counted by
+ *                 mbedtls_ssl_get_memory_usage().
+ *                 Default: 0 (disabled).
+ *
+ * \param conf     SSL configuration
+ * \param limit    Limit in bytes, or 0 to disable.
+ *
+ * \note           An allocation that would take a connection over the
+ *                 limit fails as if the heap were exhausted: the function
+ *                 that needed it returns #MBEDTLS_ERR_SSL_ALLOC_FAILED and,
+ *                 during a handshake, the connection is aborted with a fatal
+ *                 alert. A DTLS record of the next epoch that arrives
+ *                 early is dropped instead of buffered.
+ *
+ * \note           The limit applies from mbedtls_ssl_setup() on, which
+ *                 fails if the limit is below the size of the I/O buffers
+ *                 and of the first handshake context.
+ */
+void mbedtls_ssl_conf_memory_limit(mbedtls_ssl_config *conf, size_t limit);
+#endif /* MBEDTLS_SSL_MEMORY_ACCOUNTING */
+
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
 
 /**
@@ -3100,13 +3553,59 @@ void mbedtls_ssl_conf_dtls_badmac_limit(mbedtls_ssl_config *conf, unsigned limit
  *                 or flight retransmission (if no buffering is used) as
  *                 means to deal with reordering are needed less frequently.
  *
- * \note           Application records are not affected by this option and
- *                 are currently always sent in separate datagrams.
+ * \note           Application records are not affected by this option,
+ *                 see mbedtls_ssl_set_app_data_packing().
  *
  */
 void mbedtls_ssl_set_datagram_packing(mbedtls_ssl_context *ssl,
                                       unsigned allow_packing);
 
+/**
+ * \brief          Allow or disallow packing of multiple application data
+ *                 records within a single datagram.
+ *                 (DTLS only, no effect on TLS.)
+ *
+ *                 When enabled, mbedtls_ssl_write() encrypts the data into
+ *                 a record and appends it to the current outgoing datagram
+ *                 instead of sending it right away. The datagram is sent
+ *                 when the next record would not fit into it (see
+ *                 mbedtls_ssl_get_max_out_record_payload() and
+ *                 mbedtls_ssl_set_mtu()), when mbedtls_ssl_flush() is
+ *                 called, when any other record such as an alert is sent,
+ *                 or once the oldest record in it has been held back for
+ *                 \p max_delay milliseconds.
+ *
+ * \param ssl           The SSL context to configure.
+ * \param allow_packing \c 1 to pack application records, \c 0 to send
+ *                      every application record in its own datagram (the
+ *                      default).
+ * \param max_delay     The longest time in milliseconds a record may be
+ *                      held back, or \c 0 for no time bound, in which
+ *                      case the datagram is also sent by the next call to
+ *                      mbedtls_ssl_read(). Ignored, as if \c 0, if
+ *                      #MBEDTLS_HAVE_TIME is not defined.
+ *
+ * \note           The delay bound is only enforced when the application
+ *                 calls into the library: mbedtls_ssl_write(),
+ *                 mbedtls_ssl_read() and mbedtls_ssl_flush() send the
+ *                 datagram if it is due. Event loops should use
+ *                 mbedtls_ssl_get_flush_timeout() to wake up in time.
+ *                 Records other than application data that are pending
+ *                 after a #MBEDTLS_ERR_SSL_WANT_WRITE are always sent by
+ *                 mbedtls_ssl_read().
+ *
+ * \note           This trades latency for fewer, larger datagrams, which
+ *                 suits streams of small messages such as telemetry. A
+ *                 lost datagram loses all of the records packed into it.
+ *
+ * \note           Disabling packing does not send a pending datagram
+ *                 right away: the next call to mbedtls_ssl_write() sends
+ *                 it before the new record, or call mbedtls_ssl_flush().
+ */
+void mbedtls_ssl_set_app_data_packing(mbedtls_ssl_context *ssl,
+                                      unsigned allow_packing,
+                                      uint32_t max_delay);
+
 /**
  * \brief          Set retransmit timeout values for the DTLS handshake.
  *                 (DTLS only, no effect on TLS.)
@@ -3210,6 +3709,12 @@ void mbedtls_ssl_conf_session_cache(mbedtls_ssl_config *conf,
  *                 with a TLS 1.3 session, will not have any effect on the next
  *                 handshake for the SSL context \p ssl.
  *
+ * \note           A session loaded with mbedtls_ssl_session_load_borrowed()
+ *                 is not copied: the SSL context borrows from the same
+ *                 serialized buffer, which must then remain valid and
+ *                 unmodified until the handshake completes or the SSL
+ *                 context is reset or freed.
+ *
  * \param ssl      The SSL context representing the connection which should
  *                 be attempted to be setup using session resumption. This
  *                 must be initialized via mbedtls_ssl_init() and bound to
@@ -3271,6 +3776,60 @@ int mbedtls_ssl_session_load(mbedtls_ssl_session *session,
                              const unsigned char *buf,
                              size_t len);
 
+/**
+ * \brief          Load serialized session data into a session structure
+ *                 without copying it.
+ *
+ *                 This behaves like mbedtls_ssl_session_load(), except that
+ *                 the variable-length fields of the session (session ticket,
+ *                 host name, ticket ALPN, peer certificate digest) point
+ *                 into \p buf instead of being allocated on the heap. With
+ *                 #MBEDTLS_SSL_KEEP_PEER_CERTIFICATE, the certificate
+ *                 structure is still allocated but refers to the DER data
+ *                 in \p buf.
+ *
+ * \warning        \p buf must remain valid and unmodified until the
+ *                 session is freed with mbedtls_ssl_session_free() or
+ *                 detached with mbedtls_ssl_session_detach(). Freeing the
+ *                 session does not free or wipe \p buf. This extends to an
+ *                 SSL context the session is passed to with
+ *                 mbedtls_ssl_set_session(), until its handshake completes.
+ *
+ * \see            mbedtls_ssl_session_load()
+ * \see            mbedtls_ssl_session_detach()
+ *
+ * \param session  The session structure to be populated. It must have been
+ *                 initialised with mbedtls_ssl_session_init() but not
+ *                 populated yet.
+ * \param buf      The buffer holding the serialized session data. It must be a
+ *                 readable buffer of at least \p len bytes.
+ * \param len      The size of the serialized data in bytes.
+ *
+ * \return         \c 0 if successful.
+ * \return         The same error codes as mbedtls_ssl_session_load().
+ */
+int mbedtls_ssl_session_load_borrowed(mbedtls_ssl_session *session,
+                                      const unsigned char *buf,
+                                      size_t len);
+
+/**
+ * \brief          Make a session loaded with
+ *                 mbedtls_ssl_session_load_borrowed() independent of the
+ *                 serialized buffer, by copying the fields it borrows.
+ *
+ * \note           This function does nothing on a session that does not
+ *                 borrow any data.
+ *
+ * \param session  The session to detach.
+ *
+ * \return         \c 0 if successful. The session no longer refers to the
+ *                 serialized buffer, which may then be reused.
+ * \return         #MBEDTLS_ERR_SSL_ALLOC_FAILED if memory allocation failed.
+ *                 The session is unchanged and still borrows its data.
+ * \return         Another negative error code on other kinds of failure.
+ */
+int mbedtls_ssl_session_detach(mbedtls_ssl_session *session);
+
 /**
  * \brief          Save session structure as serialized data in a buffer.
  *                 On client, this can be used for saving session data,
@@ -3353,6 +3912,34 @@ int mbedtls_ssl_session_save(const mbedtls_ssl_session *session,
 void mbedtls_ssl_conf_ciphersuites(mbedtls_ssl_config *conf,
                                    const int *ciphersuites);
 
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+/**
+ * \brief          Compile the lists of ciphersuites, groups and signature
+ *                 algorithms of a configuration into lookup tables.
+ *
+ *                 Handshakes using \p conf then find each ciphersuite, group
+ *                 and signature algorithm offered by the peer in constant
+ *                 time, rather than by scanning the lists of the
+ *                 configuration and the table of all ciphersuites, which
+ *                 matters for servers that accept long lists.
+ *
+ * \note           Call this function when the configuration is complete, in
+ *                 particular after mbedtls_ssl_conf_ciphersuites(),
+ *                 mbedtls_ssl_conf_groups() and mbedtls_ssl_conf_sig_algs().
+ *                 A list that is set afterwards is scanned as usual, but a
+ *                 list that is modified in place must be compiled again.
+ *
+ * \param conf     SSL configuration
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_ALLOC_FAILED on allocation failure, or
+ *                 MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the ciphersuite list
+ *                 has more than 65535 entries, in which case handshakes
+ *                 scan the lists as usual.
+ */
+int mbedtls_ssl_conf_finalize(mbedtls_ssl_config *conf);
+#endif /* MBEDTLS_SSL_CONF_FINALIZE */
+
 #if defined(MBEDTLS_SSL_PROTO_TLS1_3)
 /**
  * \brief Set the supported key exchange modes for TLS 1.3 connections.
@@ -3545,6 +4132,34 @@ void mbedtls_ssl_conf_ca_cb(mbedtls_ssl_config *conf,
                             void *p_ca_cb);
 #endif /* MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK */
 
+#if defined(MBEDTLS_SSL_VERIFY_CACHE_C)
+/**
+ * \brief          Set a cache of verified peer certificate chains.
+ *
+ *                 A chain that was verified successfully against the CA
+ *                 chain and CRLs of the configuration is accepted from the
+ *                 cache on later handshakes, after checking only the
+ *                 validity period of its certificates and the expected
+ *                 hostname. See mbedtls_ssl_verify_cache_setup().
+ *
+ * \note           The cache is not used when a verification callback is
+ *                 set with mbedtls_ssl_conf_verify() or
+ *                 mbedtls_ssl_set_verify(), since it must see every chain,
+ *                 nor with a CA callback set with mbedtls_ssl_conf_ca_cb().
+ *
+ * \note           Entries are tied to the contents of the trusted CAs,
+ *                 CRLs and certificate profile they were verified against,
+ *                 and expire with the first certificate of the chain or
+ *                 trust anchor that does.
+ *
+ * \param conf     SSL configuration
+ * \param cache    The cache, which must remain valid as long as \p conf is
+ *                 in use, or \c NULL to verify every chain (the default).
+ */
+void mbedtls_ssl_conf_verify_cache(mbedtls_ssl_config *conf,
+                                   mbedtls_ssl_verify_cache *cache);
+#endif /* MBEDTLS_SSL_VERIFY_CACHE_C */
+
 /**
  * \brief          Set own certificate chain and private key
  *
@@ -3584,6 +4199,93 @@ void mbedtls_ssl_conf_ca_cb(mbedtls_ssl_config *conf,
 int mbedtls_ssl_conf_own_cert(mbedtls_ssl_config *conf,
                               mbedtls_x509_crt *own_cert,
                               mbedtls_pk_context *pk_key);
+
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS)
+/**
+ * \brief          Encode the Certificate messages of the own certificate
+ *                 chains, and the list of CA distinguished names of the
+ *                 TLS 1.2 CertificateRequest message, once and for all.
+ *
+ *                 Handshakes using \p conf then copy these encodings into
+ *                 their messages instead of walking the certificate chains
+ *                 each time, which matters for long CA lists.
+ *
+ * \note           Call this function after mbedtls_ssl_conf_own_cert(),
+ *                 mbedtls_ssl_conf_ca_chain() and mbedtls_ssl_conf_dn_hints(),
+ *                 and call it again if any of these chains changes,
+ *                 including when certificates are parsed into them. A
+ *                 certificate/key pair or CA list that was set afterwards
+ *                 is encoded on each handshake, as usual.
+ *
+ * \note           Certificate chains selected in the SNI callback or the
+ *                 certificate selection callback are not affected.
+ *
+ * \param conf     SSL configuration
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_ALLOC_FAILED on allocation failure, in
+ *                 which case handshakes encode the messages as usual,
+ *                 MBEDTLS_ERR_SSL_BAD_INPUT_DATA if a certificate chain is
+ *                 too long to be sent.
+ */
+int mbedtls_ssl_conf_preencode_certs(mbedtls_ssl_config *conf);
+#endif /* MBEDTLS_SSL_PREENCODE_CERTS */
+
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+/**
+ * \brief          Add a TLS 1.3 certificate compression algorithm (RFC 8879).
+ *
+ *                 A client offers the algorithms that have a decompression
+ *                 callback in its ClientHello. A server compresses its
+ *                 Certificate message with the first algorithm, in the
+ *                 order of the calls to this function, that has a
+ *                 compression callback and that the client offers.
+ *
+ * \note           The library does not implement any compression
+ *                 algorithm itself.
+ *
+ * \param conf     SSL configuration
+ * \param alg      The algorithm, for example
+ *                 #MBEDTLS_SSL_CERT_COMPRESSION_ZLIB.
+ * \param f_compress   The compression callback, or \c NULL if the
+ *                 algorithm is only used to receive certificates.
+ * \param f_decompress The decompression callback, or \c NULL if the
+ *                 algorithm is only used to send certificates.
+ * \param p_ctx    The opaque context passed to both callbacks.
+ *
+ * \return         0 on success,
+ *                 #MBEDTLS_ERR_SSL_BAD_INPUT_DATA if both callbacks are
+ *                 \c NULL, if \p alg was already added or if
+ *                 #MBEDTLS_SSL_CERT_COMPRESSION_MAX_ALGS algorithms were
+ *                 already added.
+ */
+int mbedtls_ssl_conf_cert_compression(mbedtls_ssl_config *conf,
+                                      uint16_t alg,
+                                      mbedtls_ssl_cert_compress_t *f_compress,
+                                      mbedtls_ssl_cert_decompress_t *f_decompress,
+                                      void *p_ctx);
+
+/**
+ * \brief          Compress the Certificate messages of the own certificate
+ *                 chains of a server once and for all.
+ *
+ *                 Without this, a server compresses its certificate chain
+ *                 on every handshake that negotiates certificate
+ *                 compression.
+ *
+ * \note           Call this function after mbedtls_ssl_conf_own_cert() and
+ *                 mbedtls_ssl_conf_cert_compression(), and again if a
+ *                 certificate chain changes. Certificate chains selected in
+ *                 the SNI callback or the certificate selection callback
+ *                 are compressed on each handshake.
+ *
+ * \param conf     SSL configuration
+ *
+ * \return         0 on success, or a negative error code returned by a
+ *                 compression callback or MBEDTLS_ERR_SSL_ALLOC_FAILED.
+ */
+int mbedtls_ssl_conf_compress_certs(mbedtls_ssl_config *conf);
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
 
 #if defined(MBEDTLS_SSL_HANDSHAKE_WITH_PSK_ENABLED)
@@ -3829,6 +4531,46 @@ void mbedtls_ssl_conf_dhm_min_bitlen(mbedtls_ssl_config *conf,
 void mbedtls_ssl_conf_groups(mbedtls_ssl_config *conf,
                              const uint16_t *groups);
 
+#if defined(MBEDTLS_SSL_KEY_SHARE_POOL_C)
+/**
+ * \brief          Set a pool of pre-generated ephemeral key pairs.
+ *
+ *                 Handshakes take their TLS 1.3 key share, or their TLS 1.2
+ *                 ECDHE key pair, from the pool when it holds one for the
+ *                 group, instead of generating it. They generate it as
+ *                 usual when the pool is empty. See
+ *                 mbedtls_ssl_key_share_pool_setup().
+ *
+ * \param conf     SSL configuration
+ * \param pool     The pool, which must remain valid as long as \p conf is
+ *                 in use, or \c NULL to always generate key pairs (the
+ *                 default).
+ */
+void mbedtls_ssl_conf_key_share_pool(mbedtls_ssl_config *conf,
+                                     mbedtls_ssl_key_share_pool *pool);
+#endif /* MBEDTLS_SSL_KEY_SHARE_POOL_C */
+
+#if defined(MBEDTLS_SSL_GROUP_CACHE_C)
+/**
+ * \brief          Set a cache of the groups selected by TLS 1.3 servers
+ *                 (client only).
+ *
+ *                 When a server answers with a HelloRetryRequest for
+ *                 another group, the group is remembered for the hostname
+ *                 set with mbedtls_ssl_set_hostname(). The next ClientHello
+ *                 to that hostname sends its key share for that group, if
+ *                 it is still in the list set with mbedtls_ssl_conf_groups().
+ *                 See mbedtls_ssl_group_cache_setup().
+ *
+ * \param conf     SSL configuration
+ * \param cache    The cache, which must remain valid as long as \p conf is
+ *                 in use, or \c NULL to always start with the first
+ *                 configured group (the default).
+ */
+void mbedtls_ssl_conf_group_cache(mbedtls_ssl_config *conf,
+                                  mbedtls_ssl_group_cache *cache);
+#endif /* MBEDTLS_SSL_GROUP_CACHE_C */
+
 #if defined(MBEDTLS_SSL_HANDSHAKE_WITH_CERT_ENABLED)
 #if !defined(MBEDTLS_DEPRECATED_REMOVED) && defined(MBEDTLS_SSL_PROTO_TLS1_2)
 /**
@@ -4427,10 +5169,60 @@ void mbedtls_ssl_conf_session_tickets(mbedtls_ssl_config *conf, int use_tickets)
  */
 void mbedtls_ssl_conf_new_session_tickets(mbedtls_ssl_config *conf,
                                           uint16_t num_tickets);
+
+/**
+ * \brief   Choose when the server sends its NewSessionTicket messages.
+ *
+ *          With #MBEDTLS_SSL_NEW_SESSION_TICKETS_IMMEDIATE (the default),
+ *          the tickets are created and sent by mbedtls_ssl_handshake(),
+ *          before the server reads the first request of the client.
+ *
+ *          With #MBEDTLS_SSL_NEW_SESSION_TICKETS_DEFERRED, the handshake
+ *          completes without them. They are sent right after the data of
+ *          the first call to mbedtls_ssl_write(), or by
+ *          mbedtls_ssl_send_new_session_tickets() if the application calls
+ *          it first, for example when it is idle. Creating the tickets then
+ *          no longer delays the answer to the first request.
+ *
+ * \note    The number of tickets is set with
+ *          mbedtls_ssl_conf_new_session_tickets(), and is one at most on a
+ *          resumed session, whatever the mode.
+ *
+ * \param conf    SSL configuration
+ * \param mode    #MBEDTLS_SSL_NEW_SESSION_TICKETS_IMMEDIATE or
+ *                #MBEDTLS_SSL_NEW_SESSION_TICKETS_DEFERRED
+ */
+void mbedtls_ssl_conf_new_session_tickets_mode(mbedtls_ssl_config *conf,
+                                               int mode);
 #endif /* MBEDTLS_SSL_SESSION_TICKETS &&
           MBEDTLS_SSL_SRV_C &&
           MBEDTLS_SSL_PROTO_TLS1_3*/
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+/**
+ * \brief   Update the TLS 1.3 traffic keys automatically after a number of
+ *          records or bytes of application data.
+ *
+ *          When either limit is reached, mbedtls_ssl_write() sends a
+ *          KeyUpdate message before the next record and continues with a
+ *          new sending key. The peer's sending key is not affected; use
+ *          mbedtls_ssl_key_update() to ask the peer to update it too.
+ *
+ * \note    AEAD keys have usage limits, see RFC 8446 section 5.5. For
+ *          AES-GCM, the limit is 2^24.5 full-size records. The default is
+ *          0 for both limits, which disables automatic updates.
+ *
+ * \param conf          SSL configuration
+ * \param max_records   Maximum number of records sent with one key, or 0
+ *                      for no limit.
+ * \param max_bytes     Maximum number of bytes of application data sent with
+ *                      one key, or 0 for no limit.
+ */
+void mbedtls_ssl_conf_key_update_interval(mbedtls_ssl_config *conf,
+                                          uint64_t max_records,
+                                          uint64_t max_bytes);
+#endif /* MBEDTLS_SSL_TLS1_3_KEY_UPDATE */
+
 #if defined(MBEDTLS_SSL_RENEGOTIATION)
 /**
  * \brief          Enable / Disable renegotiation support for connection when
@@ -4723,6 +5515,43 @@ int mbedtls_ssl_get_max_out_record_payload(const mbedtls_ssl_context *ssl);
  */
 int mbedtls_ssl_get_max_in_record_payload(const mbedtls_ssl_context *ssl);
 
+#if defined(MBEDTLS_SSL_MEMORY_ACCOUNTING)
+/**
+ * \brief          Return the memory that the library currently holds for a
+ *                 connection, in bytes.
+ *
+ * \note           This counts the I/O buffers, the handshake context and the
+ *                 buffers of the handshake in progress, the transforms, the
+ *                 sessions with their peer certificate chain and ticket, and
+ *                 the host name. It does not count the SSL context itself,
+ *                 the memory of PSA keys and operations, and allocations
+ *                 made by callbacks.
+ *
+ * \param ssl      SSL context
+ *
+ * \return         The number of bytes allocated for \p ssl.
+ */
+size_t mbedtls_ssl_get_memory_usage(const mbedtls_ssl_context *ssl);
+
+/**
+ * \brief          Return the memory that the library holds for a
+ *                 configuration, in bytes.
+ *
+ * \note           This counts the copies and tables that the library builds
+ *                 from the settings, such as the PSK, the lookup tables of
+ *                 mbedtls_ssl_conf_finalize() and the encoded certificates.
+ *                 It does not count the configuration structure itself, nor
+ *                 the objects that the configuration refers to without
+ *                 owning them, such as certificates and keys, caches and
+ *                 pools.
+ *
+ * \param conf     SSL configuration
+ *
+ * \return         The number of bytes allocated for \p conf.
+ */
+size_t mbedtls_ssl_conf_get_memory_usage(const mbedtls_ssl_config *conf);
+#endif /* MBEDTLS_SSL_MEMORY_ACCOUNTING */
+
 #if defined(MBEDTLS_X509_CRT_PARSE_C)
 /**
  * \brief          Return the peer certificate from the current connection.
@@ -5085,9 +5914,50 @@ int mbedtls_ssl_read(mbedtls_ssl_context *ssl, unsigned char *buf, size_t len);
  *
  * \note           Attempting to write 0 bytes will result in an empty TLS
  *                 application record being sent.
+ *
+ * \note           With DTLS application data packing (see
+ *                 mbedtls_ssl_set_app_data_packing()), a successful return
+ *                 means that the data was encrypted into the outgoing
+ *                 datagram, which may not have been sent yet.
  */
 int mbedtls_ssl_write(mbedtls_ssl_context *ssl, const unsigned char *buf, size_t len);
 
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+/**
+ * \brief          Send any application records held back by DTLS
+ *                 application data packing.
+ *                 (DTLS only, no effect on TLS.)
+ *
+ * \param ssl      SSL context
+ *
+ * \return         0 if there was nothing to send or it was sent.
+ * \return         #MBEDTLS_ERR_SSL_WANT_WRITE if the underlying transport
+ *                 is not ready - in this case you must call this function
+ *                 again when it is.
+ * \return         Another SSL error code - in this case you must stop using
+ *                 the context, as for mbedtls_ssl_write().
+ *
+ * \note           This must be called before mbedtls_ssl_context_save() if
+ *                 records may be pending.
+ */
+int mbedtls_ssl_flush(mbedtls_ssl_context *ssl);
+
+/**
+ * \brief          Get the time until held back application records must
+ *                 be sent by calling mbedtls_ssl_flush().
+ *                 (DTLS only.)
+ *
+ * \param ssl      SSL context
+ *
+ * \return         -1 if no records are held back, or if they have no
+ *                 deadline (a \c max_delay of 0 in
+ *                 mbedtls_ssl_set_app_data_packing()).
+ * \return         The number of milliseconds until the deadline, 0 if it
+ *                 has passed.
+ */
+int mbedtls_ssl_get_flush_timeout(const mbedtls_ssl_context *ssl);
+#endif /* MBEDTLS_SSL_PROTO_DTLS */
+
 /**
  * \brief           Send an alert message
  *
@@ -5122,6 +5992,67 @@ int mbedtls_ssl_send_alert_message(mbedtls_ssl_context *ssl,
  */
 int mbedtls_ssl_close_notify(mbedtls_ssl_context *ssl);
 
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && \
+    defined(MBEDTLS_SSL_SRV_C) && \
+    defined(MBEDTLS_SSL_PROTO_TLS1_3)
+/**
+ * \brief          Send the NewSessionTicket messages that were deferred with
+ *                 #MBEDTLS_SSL_NEW_SESSION_TICKETS_DEFERRED.
+ *
+ *                 Without this call, the tickets are sent by the first call
+ *                 to mbedtls_ssl_write().
+ *
+ * \param ssl      SSL context
+ *
+ * \return         0 if the tickets were sent or there was none to send.
+ * \return         #MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the handshake is not
+ *                 over.
+ * \return         #MBEDTLS_ERR_SSL_WANT_WRITE if the underlying transport
+ *                 is not ready. Call this function, mbedtls_ssl_read() or
+ *                 mbedtls_ssl_write() again to continue.
+ * \return         Another SSL error code - in this case you must stop using
+ *                 the context, as for mbedtls_ssl_write().
+ */
+int mbedtls_ssl_send_new_session_tickets(mbedtls_ssl_context *ssl);
+#endif /* MBEDTLS_SSL_SESSION_TICKETS &&
+          MBEDTLS_SSL_SRV_C &&
+          MBEDTLS_SSL_PROTO_TLS1_3 */
+
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+/**
+ * \brief          Update the traffic key used to send data on a TLS 1.3
+ *                 connection.
+ *
+ *                 A KeyUpdate message is sent with the current key, and the
+ *                 following records are protected with the next generation
+ *                 of the sending traffic secret. With
+ *                 #MBEDTLS_SSL_KEY_UPDATE_REQUESTED, the peer is asked to
+ *                 update its own sending key as well; it answers with a
+ *                 KeyUpdate of its own, which mbedtls_ssl_read() processes.
+ *
+ * \param ssl      SSL context
+ * \param request  #MBEDTLS_SSL_KEY_UPDATE_NOT_REQUESTED or
+ *                 #MBEDTLS_SSL_KEY_UPDATE_REQUESTED.
+ *
+ * \return         0 if successful.
+ * \return         #MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the handshake is not
+ *                 over, the connection does not use TLS 1.3, or
+ *                 \p request is not valid.
+ * \return         #MBEDTLS_ERR_SSL_WANT_WRITE if the underlying transport
+ *                 is not ready. The key has already been updated: call
+ *                 this function or mbedtls_ssl_write() again to finish
+ *                 sending the message.
+ * \return         Another SSL error code - in this case you must stop using
+ *                 the context, as for mbedtls_ssl_write().
+ *
+ * \note           If a call to mbedtls_ssl_write() returned
+ *                 #MBEDTLS_ERR_SSL_WANT_WRITE and has not been retried yet,
+ *                 this function returns 0 and the KeyUpdate is sent by the
+ *                 first call to mbedtls_ssl_write() after the pending data.
+ */
+int mbedtls_ssl_key_update(mbedtls_ssl_context *ssl, int request);
+#endif /* MBEDTLS_SSL_TLS1_3_KEY_UPDATE */
+
 #if defined(MBEDTLS_SSL_EARLY_DATA)
 
 #if defined(MBEDTLS_SSL_SRV_C)
@@ -5317,7 +6248,14 @@ void mbedtls_ssl_free(mbedtls_ssl_context *ssl);
  *                 Loading a saved SSL context does not restore settings and
  *                 state related to how the application accesses the context,
  *                 such as configured callback functions, user data, pending
- *                 incoming or outgoing data, etc.
+ *                 outgoing data, etc.
+ *
+ * \note           Over TLS, the serialized data also holds the incoming
+ *                 data that the context has received but the application
+ *                 has not read yet, so that the connection can be handed
+ *                 over to another process along with its socket, see
+ *                 mbedtls_net_send_fd(). Over DTLS, there must be no
+ *                 pending incoming data.
  *
  * \note           This feature is currently only available under certain
  *                 conditions, see the documentation of the return value
@@ -5355,9 +6293,10 @@ void mbedtls_ssl_free(mbedtls_ssl_context *ssl);
  * \return         #MBEDTLS_ERR_SSL_ALLOC_FAILED if memory allocation failed
  *                 while resetting the context.
  * \return         #MBEDTLS_ERR_SSL_BAD_INPUT_DATA if a handshake is in
- *                 progress, or there is pending data for reading or sending,
- *                 or the connection does not use DTLS 1.2 with an AEAD
- *                 ciphersuite, or renegotiation is enabled.
+ *                 progress, or there is pending data for sending, or pending
+ *                 incoming data over DTLS, or the connection does not use
+ *                 TLS 1.2 or DTLS 1.2 with an AEAD ciphersuite, or
+ *                 renegotiation is enabled.
  */
 int mbedtls_ssl_context_save(mbedtls_ssl_context *ssl,
                              unsigned char *buf,
@@ -5430,7 +6369,9 @@ int mbedtls_ssl_context_save(mbedtls_ssl_context *ssl,
  * \return         #MBEDTLS_ERR_SSL_ALLOC_FAILED if memory allocation failed.
  * \return         #MBEDTLS_ERR_SSL_VERSION_MISMATCH if the serialized data
  *                 comes from a different Mbed TLS version or build.
- * \return         #MBEDTLS_ERR_SSL_BAD_INPUT_DATA if input data is invalid.
+ * \return         #MBEDTLS_ERR_SSL_BAD_INPUT_DATA if input data is invalid,
+ *                 including when it was saved from a connection over the
+ *                 other transport (TLS or DTLS) than \p ssl is set up for.
  */
 int mbedtls_ssl_context_load(mbedtls_ssl_context *ssl,
                              const unsigned char *buf,
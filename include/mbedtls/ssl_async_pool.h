@@ -0,0 +1,189 @@
+/**
+ * \file ssl_async_pool.h
+ *
+ * \brief Worker thread pool for asynchronous SSL crypto operations
+ *
+ *        The pool runs the jobs handed over by the SSL handshake through
+ *        mbedtls_ssl_conf_async_crypto_cb() on a fixed set of POSIX
+ *        threads, so that one thread can drive many handshakes while the
+ *        expensive public key operations run in parallel:
+ *
+ *        \code
+ *        mbedtls_ssl_async_pool_init(&pool);
+ *        mbedtls_ssl_async_pool_setup(&pool, 4);
+ *        mbedtls_ssl_conf_async_crypto_cb(&conf,
+ *                                         mbedtls_ssl_async_pool_start,
+ *                                         mbedtls_ssl_async_pool_poll,
+ *                                         mbedtls_ssl_async_pool_cancel,
+ *                                         &pool);
+ *        \endcode
+ */
+/*
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+#ifndef MBEDTLS_SSL_ASYNC_POOL_H
+#define MBEDTLS_SSL_ASYNC_POOL_H
+#include "mbedtls/private_access.h"
+
+#include "mbedtls/build_info.h"
+
+#include "mbedtls/ssl.h"
+
+#if defined(MBEDTLS_SSL_ASYNC_POOL_C)
+#include <pthread.h>
+
+/**
+ * \name SECTION: Module settings
+ *
+ * The configuration options you can set for this module are in this section.
+ * Either change them in mbedtls_config.h or define them on the compiler command line.
+ * \{
+ */
+
+#if !defined(MBEDTLS_SSL_ASYNC_POOL_DEFAULT_THREADS)
+#define MBEDTLS_SSL_ASYNC_POOL_DEFAULT_THREADS      4   /*!< Worker threads if none are specified */
+#endif
+
+/** \} name SECTION: Module settings */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mbedtls_ssl_async_pool_entry mbedtls_ssl_async_pool_entry;
+
+/**
+ * \brief          Callback type: a job of the pool has completed.
+ *
+ *                 This is called on the worker thread, typically to wake up
+ *                 the thread that drives the handshakes (for example by
+ *                 writing to a pipe) so that it resumes them.
+ *
+ * \note           The callback must not call any function of the pool.
+ *
+ * \param p_ctx    The context passed to mbedtls_ssl_async_pool_set_notify().
+ */
+typedef void mbedtls_ssl_async_pool_notify_t(void *p_ctx);
+
+/**
+ * \brief          Worker thread pool context
+ */
+typedef struct mbedtls_ssl_async_pool {
+    pthread_mutex_t MBEDTLS_PRIVATE(mutex);             /*!< protects all fields  */
+    pthread_cond_t MBEDTLS_PRIVATE(work);               /*!< a job was queued     */
+    pthread_cond_t MBEDTLS_PRIVATE(done);               /*!< a job has completed  */
+
+    mbedtls_ssl_async_pool_entry *MBEDTLS_PRIVATE(head);  /*!< next job to run    */
+    mbedtls_ssl_async_pool_entry *MBEDTLS_PRIVATE(tail);  /*!< last queued job    */
+    mbedtls_ssl_async_pool_entry *MBEDTLS_PRIVATE(live);  /*!< all unfreed jobs   */
+
+    pthread_t *MBEDTLS_PRIVATE(threads);                /*!< worker threads       */
+    size_t MBEDTLS_PRIVATE(thread_count);               /*!< entries in threads   */
+    int MBEDTLS_PRIVATE(shutdown);                      /*!< workers must exit    */
+
+    mbedtls_ssl_async_pool_notify_t *MBEDTLS_PRIVATE(f_notify); /*!< completion hook */
+    void *MBEDTLS_PRIVATE(p_notify);                    /*!< context for f_notify */
+}
+mbedtls_ssl_async_pool;
+
+/**
+ * \brief          Initialize a worker thread pool context.
+ *
+ * \param pool     The context to initialize
+ */
+void mbedtls_ssl_async_pool_init(mbedtls_ssl_async_pool *pool);
+
+/**
+ * \brief          Start the worker threads of a pool.
+ *
+ * \param pool     The context to set up
+ * \param threads  The number of worker threads, or 0 for
+ *                 #MBEDTLS_SSL_ASYNC_POOL_DEFAULT_THREADS.
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the pool is already set up,
+ *                 MBEDTLS_ERR_SSL_ALLOC_FAILED if the threads cannot be
+ *                 created.
+ */
+int mbedtls_ssl_async_pool_setup(mbedtls_ssl_async_pool *pool, size_t threads);
+
+/**
+ * \brief          Register a callback invoked each time a job completes.
+ *
+ * \note           Call this before passing the pool to
+ *                 mbedtls_ssl_conf_async_crypto_cb().
+ *
+ * \param pool     The pool
+ * \param f_notify The callback, or \c NULL to remove it
+ * \param p_notify The opaque context passed to \p f_notify
+ */
+void mbedtls_ssl_async_pool_set_notify(mbedtls_ssl_async_pool *pool,
+                                       mbedtls_ssl_async_pool_notify_t *f_notify,
+                                       void *p_notify);
+
+/**
+ * \brief          Start callback for mbedtls_ssl_conf_async_crypto_cb(),
+ *                 with the pool as context. Queues \p job for the workers.
+ *
+ *                 (Thread-safe)
+ *
+ * \param p_ctx    The pool
+ * \param job      The job to run
+ *
+ * \return         0 if the job was queued,
+ *                 MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH if the pool has no
+ *                 worker threads, so that the job runs inline,
+ *                 MBEDTLS_ERR_SSL_ALLOC_FAILED on allocation failure.
+ */
+int mbedtls_ssl_async_pool_start(void *p_ctx, mbedtls_ssl_async_job *job);
+
+/**
+ * \brief          Poll callback for mbedtls_ssl_conf_async_crypto_cb(),
+ *                 with the pool as context.
+ *
+ *                 (Thread-safe)
+ *
+ * \param p_ctx    The pool
+ * \param job      A job queued by mbedtls_ssl_async_pool_start()
+ *
+ * \return         0 if the job has completed,
+ *                 MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS if it has not.
+ */
+int mbedtls_ssl_async_pool_poll(void *p_ctx, mbedtls_ssl_async_job *job);
+
+/**
+ * \brief          Cancel callback for mbedtls_ssl_conf_async_crypto_cb(),
+ *                 with the pool as context. A job that is already running
+ *                 is waited for.
+ *
+ *                 (Thread-safe)
+ *
+ * \param p_ctx    The pool
+ * \param job      A job queued by mbedtls_ssl_async_pool_start()
+ */
+void mbedtls_ssl_async_pool_cancel(void *p_ctx, mbedtls_ssl_async_job *job);
+
+/**
+ * \brief          Stop the worker threads and free a pool.
+ *
+ *                 Jobs still queued are run before the workers exit. A
+ *                 handshake whose job was started on the pool may then
+ *                 still be continued or freed: its next poll reports the
+ *                 job as completed without using the pool.
+ *
+ * \note           No new job may be started on the pool once this has
+ *                 been called, so the configurations that use the pool
+ *                 must not be used for new handshakes.
+ *
+ * \param pool     The context to free
+ */
+void mbedtls_ssl_async_pool_free(mbedtls_ssl_async_pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBEDTLS_SSL_ASYNC_POOL_C */
+
+#endif /* ssl_async_pool.h */
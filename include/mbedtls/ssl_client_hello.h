@@ -0,0 +1,100 @@
+/**
+ * \file ssl_client_hello.h
+ *
+ * \brief Context-free parsing of a TLS ClientHello
+ *
+ *        A front-end that routes TLS connections, for example by server
+ *        name, needs a few fields of the first message of the client before
+ *        it commits any resource to the connection. This module reads them
+ *        from the raw bytes received on the connection, without an SSL
+ *        context and without allocating memory: the results point into the
+ *        input buffer.
+ */
+/*
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+#ifndef MBEDTLS_SSL_CLIENT_HELLO_H
+#define MBEDTLS_SSL_CLIENT_HELLO_H
+
+#include "mbedtls/build_info.h"
+
+#include "mbedtls/ssl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief   Fields of a ClientHello
+ *
+ *          All pointers point into the buffer given to
+ *          mbedtls_ssl_client_hello_parse(), and are \c NULL with a length
+ *          of 0 when the client did not send the field.
+ */
+typedef struct mbedtls_ssl_client_hello {
+    mbedtls_ssl_protocol_version max_version;   /*!< highest version offered
+                                                     that this library knows,
+                                                     or
+                                                     #MBEDTLS_SSL_VERSION_UNKNOWN */
+    const unsigned char *random;                /*!< 32 bytes of random     */
+    const unsigned char *session_id;            /*!< legacy session id      */
+    size_t session_id_len;                      /*!< length of session_id   */
+    const unsigned char *ciphersuites;          /*!< 2-byte suite ids       */
+    size_t ciphersuites_len;                    /*!< length in bytes        */
+    const unsigned char *versions;              /*!< 2-byte versions of the
+                                                     supported_versions
+                                                     extension              */
+    size_t versions_len;                        /*!< length in bytes        */
+    const unsigned char *server_name;           /*!< host name, not
+                                                     null-terminated        */
+    size_t server_name_len;                     /*!< length of server_name  */
+    const unsigned char *alpn_list;             /*!< ALPN protocol names,
+                                                     each prefixed with its
+                                                     1-byte length          */
+    size_t alpn_list_len;                       /*!< length in bytes        */
+    const unsigned char *session_ticket;        /*!< TLS 1.2 ticket, non-NULL
+                                                     if the extension is
+                                                     present, even empty    */
+    size_t session_ticket_len;                  /*!< length of the ticket   */
+    int has_pre_shared_key;                     /*!< TLS 1.3 pre_shared_key
+                                                     extension present      */
+} mbedtls_ssl_client_hello;
+
+/**
+ * \brief          Parse the ClientHello at the start of a TLS connection.
+ *
+ *                 This checks the framing of the record, of the handshake
+ *                 message and of the extensions that are returned, but not
+ *                 their semantics: the handshake that follows still does.
+ *
+ * \note           Only the stream transport is supported, and the
+ *                 ClientHello must fit in the first record, which is the
+ *                 case for all common clients.
+ *
+ * \param buf      The bytes received on the connection so far
+ * \param len      Length of \p buf
+ * \param hello    The fields of the ClientHello, on success
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_WANT_READ if \p buf is shorter than the
+ *                 first record,
+ *                 MBEDTLS_ERR_SSL_INVALID_RECORD if \p buf does not start
+ *                 with a handshake record,
+ *                 MBEDTLS_ERR_SSL_UNEXPECTED_MESSAGE if the record does not
+ *                 start with a ClientHello,
+ *                 MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE if the ClientHello
+ *                 continues in the next record,
+ *                 MBEDTLS_ERR_SSL_DECODE_ERROR if the ClientHello is
+ *                 malformed,
+ *                 MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER if one of the
+ *                 extensions that are returned is present more than once.
+ */
+int mbedtls_ssl_client_hello_parse(const unsigned char *buf, size_t len,
+                                   mbedtls_ssl_client_hello *hello);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ssl_client_hello.h */
@@ -0,0 +1,280 @@
+/**
+ * \file ssl_dtls_demux.h
+ *
+ * \brief DTLS server demultiplexer: many peers on one bound UDP socket
+ *
+ *        The demultiplexer reads datagrams from a single unconnected UDP
+ *        socket and routes each of them to the SSL context of the peer it
+ *        belongs to, looked up by source address or, for records carrying
+ *        a DTLS Connection ID, by that CID. SSL contexts are only created
+ *        for clients that returned a valid cookie, so spoofed ClientHello
+ *        floods cost one stateless HelloVerifyRequest each and no memory.
+ *
+ *        This replaces the "hijack the listening socket with connect()"
+ *        pattern of mbedtls_net_accept(), which needs one file descriptor
+ *        per peer and a re-bind per new client.
+ */
+/*
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+#ifndef MBEDTLS_SSL_DTLS_DEMUX_H
+#define MBEDTLS_SSL_DTLS_DEMUX_H
+#include "mbedtls/private_access.h"
+
+#include "mbedtls/build_info.h"
+
+#include "mbedtls/ssl.h"
+#include "mbedtls/net_sockets.h"
+
+/**
+ * \name SECTION: Module settings
+ *
+ * The configuration options you can set for this module are in this section.
+ * Either change them in mbedtls_config.h or define them on the compiler command line.
+ * \{
+ */
+#ifndef MBEDTLS_SSL_DTLS_DEMUX_DEFAULT_MAX_PEERS
+#define MBEDTLS_SSL_DTLS_DEMUX_DEFAULT_MAX_PEERS   1024 /**< Default maximum number of peers with a context */
+#endif
+
+#ifndef MBEDTLS_SSL_DTLS_DEMUX_DEFAULT_IDLE_TIMEOUT
+#define MBEDTLS_SSL_DTLS_DEMUX_DEFAULT_IDLE_TIMEOUT 300000 /**< Default idle time in milliseconds after which a peer is evicted */
+#endif
+
+#ifndef MBEDTLS_SSL_DTLS_DEMUX_BATCH_SIZE
+#define MBEDTLS_SSL_DTLS_DEMUX_BATCH_SIZE             8 /**< Datagrams read per system call, at most MBEDTLS_NET_BATCH_MAX */
+#endif
+
+/** \} name SECTION: Module settings */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mbedtls_ssl_dtls_demux_peer mbedtls_ssl_dtls_demux_peer;
+
+/**
+ * \brief          Callback type: prepare the SSL context of a new peer.
+ *
+ *                 Called once the context has been set up with the
+ *                 demultiplexer's configuration, bound to the peer and
+ *                 given its transport ID, just before it is returned by
+ *                 mbedtls_ssl_dtls_demux_recv() for the first time.
+ *                 Typical uses are mbedtls_ssl_set_timer_cb() and
+ *                 mbedtls_ssl_set_user_data_p().
+ *
+ * \note           The callback must not call mbedtls_ssl_set_bio() or
+ *                 mbedtls_ssl_set_client_transport_id() on \p ssl.
+ *
+ * \param p_ctx    The opaque context passed to
+ *                 mbedtls_ssl_dtls_demux_set_peer_cb()
+ * \param ssl      The SSL context of the new peer
+ *
+ * \return         0 on success, or a negative error code, in which case
+ *                 the peer is discarded.
+ */
+typedef int mbedtls_ssl_dtls_demux_peer_cb_t(void *p_ctx,
+                                             mbedtls_ssl_context *ssl);
+
+/**
+ * \brief          Callback type: a peer is about to be evicted.
+ *
+ *                 Called just before the demultiplexer frees the SSL
+ *                 context of a peer it evicted, either because the peer
+ *                 was idle for too long or to make room for a new one.
+ *                 The application must drop any reference it holds to
+ *                 \p ssl, which is no longer valid after the callback.
+ *
+ * \param p_ctx    The opaque context passed to
+ *                 mbedtls_ssl_dtls_demux_set_evict_cb()
+ * \param ssl      The SSL context of the evicted peer
+ */
+typedef void mbedtls_ssl_dtls_demux_evict_cb_t(void *p_ctx,
+                                               mbedtls_ssl_context *ssl);
+
+/**
+ * \brief          DTLS server demultiplexer context
+ *
+ * \note           A demultiplexer is meant to be driven by a single
+ *                 thread and has no internal locking.
+ */
+typedef struct mbedtls_ssl_dtls_demux {
+    const mbedtls_ssl_config *MBEDTLS_PRIVATE(conf);    /*!< config of new peers    */
+    mbedtls_net_context *MBEDTLS_PRIVATE(net);          /*!< bound UDP socket       */
+
+    mbedtls_ssl_dtls_demux_peer **MBEDTLS_PRIVATE(by_addr); /*!< buckets by address */
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    mbedtls_ssl_dtls_demux_peer **MBEDTLS_PRIVATE(by_cid);  /*!< buckets by CID     */
+#endif
+    size_t MBEDTLS_PRIVATE(bucket_mask);                /*!< number of buckets - 1  */
+    uint32_t MBEDTLS_PRIVATE(hash_key);                 /*!< secret hash seed       */
+
+    size_t MBEDTLS_PRIVATE(peer_count);                 /*!< peers with a context   */
+    size_t MBEDTLS_PRIVATE(max_peers);                  /*!< limit on peer_count    */
+    mbedtls_ssl_dtls_demux_peer *MBEDTLS_PRIVATE(lru_head); /*!< most recently seen */
+    mbedtls_ssl_dtls_demux_peer *MBEDTLS_PRIVATE(lru_tail); /*!< least recently seen */
+    uint32_t MBEDTLS_PRIVATE(idle_timeout);             /*!< eviction delay in ms   */
+
+    unsigned char *MBEDTLS_PRIVATE(buf);                /*!< receive buffers        */
+    mbedtls_net_dgram *MBEDTLS_PRIVATE(batch);          /*!< datagrams read at once */
+    size_t MBEDTLS_PRIVATE(batch_size);                 /*!< capacity of batch      */
+    size_t MBEDTLS_PRIVATE(batch_len);                  /*!< entries read in batch  */
+    size_t MBEDTLS_PRIVATE(batch_next);                 /*!< next entry to route    */
+    size_t MBEDTLS_PRIVATE(batch_off);                  /*!< GRO segment offset     */
+    mbedtls_ssl_dtls_demux_peer *MBEDTLS_PRIVATE(last); /*!< peer of last datagram  */
+
+    mbedtls_ssl_dtls_demux_peer_cb_t *MBEDTLS_PRIVATE(f_peer); /*!< new peer hook   */
+    void *MBEDTLS_PRIVATE(p_peer);                      /*!< context for f_peer     */
+    mbedtls_ssl_dtls_demux_evict_cb_t *MBEDTLS_PRIVATE(f_evict); /*!< eviction hook */
+    void *MBEDTLS_PRIVATE(p_evict);                     /*!< context for f_evict    */
+}
+mbedtls_ssl_dtls_demux;
+
+/**
+ * \brief          Initialize a demultiplexer context.
+ *
+ * \param demux    The context to initialize
+ */
+void mbedtls_ssl_dtls_demux_init(mbedtls_ssl_dtls_demux *demux);
+
+/**
+ * \brief          Set up a demultiplexer on a bound UDP socket.
+ *
+ * \param demux    The context to set up
+ * \param conf     The configuration used for the SSL context of every
+ *                 peer. It must be a DTLS server configuration with
+ *                 cookie callbacks (see mbedtls_ssl_conf_dtls_cookies()).
+ *                 If it has a non-zero Connection ID length (see
+ *                 mbedtls_ssl_conf_cid()), every peer is assigned a
+ *                 random CID of that length which the demultiplexer
+ *                 also uses for routing.
+ *                 It must remain valid until mbedtls_ssl_dtls_demux_free().
+ * \param net      A UDP socket set up with mbedtls_net_bind(), normally
+ *                 non-blocking. It must remain valid until
+ *                 mbedtls_ssl_dtls_demux_free() and is not closed by it.
+ * \param max_peers The maximum number of peers that may have a context
+ *                 at the same time, or 0 for
+ *                 MBEDTLS_SSL_DTLS_DEMUX_DEFAULT_MAX_PEERS. When a new
+ *                 peer returns a valid cookie beyond that limit, the
+ *                 least recently seen peer is evicted to make room.
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_BAD_CONFIG if \p conf is not suitable,
+ *                 MBEDTLS_ERR_SSL_ALLOC_FAILED on allocation failure,
+ *                 or another negative error code.
+ */
+int mbedtls_ssl_dtls_demux_setup(mbedtls_ssl_dtls_demux *demux,
+                                 const mbedtls_ssl_config *conf,
+                                 mbedtls_net_context *net,
+                                 size_t max_peers);
+
+/**
+ * \brief          Register a callback to prepare new peer contexts.
+ *
+ * \param demux    The demultiplexer
+ * \param f_peer   The callback, or \c NULL to remove it
+ * \param p_peer   The opaque context passed to \p f_peer
+ */
+void mbedtls_ssl_dtls_demux_set_peer_cb(mbedtls_ssl_dtls_demux *demux,
+                                        mbedtls_ssl_dtls_demux_peer_cb_t *f_peer,
+                                        void *p_peer);
+
+/**
+ * \brief          Register a callback notified of evicted peers.
+ *
+ * \param demux    The demultiplexer
+ * \param f_evict  The callback, or \c NULL to remove it
+ * \param p_evict  The opaque context passed to \p f_evict
+ */
+void mbedtls_ssl_dtls_demux_set_evict_cb(mbedtls_ssl_dtls_demux *demux,
+                                         mbedtls_ssl_dtls_demux_evict_cb_t *f_evict,
+                                         void *p_evict);
+
+/**
+ * \brief          Set the time after which a peer that sent nothing is
+ *                 evicted.
+ *
+ *                 Idle peers are evicted by mbedtls_ssl_dtls_demux_recv().
+ *                 The default is
+ *                 #MBEDTLS_SSL_DTLS_DEMUX_DEFAULT_IDLE_TIMEOUT.
+ *
+ * \note           This requires #MBEDTLS_HAVE_TIME. Without it, peers are
+ *                 only evicted when the table is full.
+ *
+ * \param demux    The demultiplexer
+ * \param timeout_ms The idle time in milliseconds, or 0 to never evict
+ *                 peers for being idle.
+ */
+void mbedtls_ssl_dtls_demux_set_idle_timeout(mbedtls_ssl_dtls_demux *demux,
+                                             uint32_t timeout_ms);
+
+/**
+ * \brief          Read datagrams from the socket until one is routed to
+ *                 a peer.
+ *
+ *                 Datagrams are read from the socket up to
+ *                 #MBEDTLS_SSL_DTLS_DEMUX_BATCH_SIZE at a time with
+ *                 mbedtls_net_recv_batch(), then handed out one per call.
+ *                 Buffers coalesced by UDP GRO (see
+ *                 mbedtls_net_set_udp_gro()) are split back into datagrams.
+ *
+ *                 Datagrams from unknown peers are answered with a
+ *                 HelloVerifyRequest unless they carry a valid cookie, in
+ *                 which case a new SSL context is created for the peer.
+ *                 Datagrams that cannot be routed are silently dropped,
+ *                 as DTLS expects of invalid records.
+ *
+ *                 Peers that have been idle for longer than the idle
+ *                 timeout (see mbedtls_ssl_dtls_demux_set_idle_timeout())
+ *                 are evicted first, which frees their SSL context.
+ *
+ * \param demux    The demultiplexer
+ * \param ssl      On success, the SSL context the datagram was routed to.
+ *                 The caller should then call mbedtls_ssl_handshake() or
+ *                 mbedtls_ssl_read() on it, which consume the datagram.
+ *                 The datagram is discarded by the next call to this
+ *                 function if it has not been consumed by then.
+ *
+ * \return         0 if a datagram was routed to \p *ssl,
+ *                 MBEDTLS_ERR_SSL_WANT_READ if the socket has no more
+ *                 pending datagrams,
+ *                 or another negative error code from the socket layer.
+ */
+int mbedtls_ssl_dtls_demux_recv(mbedtls_ssl_dtls_demux *demux,
+                                mbedtls_ssl_context **ssl);
+
+/**
+ * \brief          Forget a peer and free its SSL context.
+ *
+ * \param demux    The demultiplexer
+ * \param ssl      A context returned by mbedtls_ssl_dtls_demux_recv().
+ *                 It must not be used after this call. Send a
+ *                 close_notify with mbedtls_ssl_close_notify() first if
+ *                 appropriate.
+ */
+void mbedtls_ssl_dtls_demux_close(mbedtls_ssl_dtls_demux *demux,
+                                  mbedtls_ssl_context *ssl);
+
+/**
+ * \brief          Get the number of peers that currently have a context.
+ *
+ * \param demux    The demultiplexer
+ *
+ * \return         The number of peers.
+ */
+size_t mbedtls_ssl_dtls_demux_get_peer_count(const mbedtls_ssl_dtls_demux *demux);
+
+/**
+ * \brief          Free a demultiplexer and the SSL contexts of all of its
+ *                 peers.
+ *
+ * \param demux    The context to free
+ */
+void mbedtls_ssl_dtls_demux_free(mbedtls_ssl_dtls_demux *demux);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ssl_dtls_demux.h */
@@ -0,0 +1,106 @@
+/**
+ * \file ssl_group_cache.h
+ *
+ * \brief Cache of the key exchange groups selected by TLS 1.3 servers
+ *
+ *        A TLS 1.3 client sends a key share for a single group in its
+ *        ClientHello. When the server prefers another group that the client
+ *        supports, it answers with a HelloRetryRequest, which costs a full
+ *        round trip. A group cache remembers, for each server hostname, the
+ *        group the server asked for, so that the next connection to the
+ *        same server sends a key share for that group right away.
+ */
+/*
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+#ifndef MBEDTLS_SSL_GROUP_CACHE_H
+#define MBEDTLS_SSL_GROUP_CACHE_H
+#include "mbedtls/private_access.h"
+
+#include "mbedtls/build_info.h"
+
+#include "mbedtls/ssl.h"
+
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif
+
+/**
+ * \name SECTION: Module settings
+ *
+ * The configuration options you can set for this module are in this section.
+ * Either change them in mbedtls_config.h or define them on the compiler command line.
+ * \{
+ */
+
+#if !defined(MBEDTLS_SSL_GROUP_CACHE_DEFAULT_SIZE)
+#define MBEDTLS_SSL_GROUP_CACHE_DEFAULT_SIZE    64  /*!< Maximum number of servers */
+#endif
+
+/** \} name SECTION: Module settings */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief   The group selected by one server
+ */
+typedef struct mbedtls_ssl_group_cache_entry {
+    uint32_t MBEDTLS_PRIVATE(hostname_hash);            /*!< server identity    */
+    uint16_t MBEDTLS_PRIVATE(group);                    /*!< TLS group ID       */
+} mbedtls_ssl_group_cache_entry;
+
+/**
+ * \brief   Group cache context
+ */
+struct mbedtls_ssl_group_cache {
+    mbedtls_ssl_group_cache_entry *MBEDTLS_PRIVATE(entries); /*!< hash table */
+    size_t MBEDTLS_PRIVATE(size);                       /*!< entries in table   */
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_threading_mutex_t MBEDTLS_PRIVATE(mutex);   /*!< mutex              */
+#endif
+};
+
+/**
+ * \brief          Initialize a group cache.
+ *
+ * \param cache    The cache to initialize
+ */
+void mbedtls_ssl_group_cache_init(mbedtls_ssl_group_cache *cache);
+
+/**
+ * \brief          Allocate the table of a group cache.
+ *
+ *                 The table is indexed by a hash of the server hostname,
+ *                 and a server replaces the one that had the same index. A
+ *                 wrong entry only costs a HelloRetryRequest: the server
+ *                 always has the last word on the group.
+ *
+ * \param cache    The cache to set up
+ * \param size     Number of entries of the table, or 0 for
+ *                 #MBEDTLS_SSL_GROUP_CACHE_DEFAULT_SIZE.
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the cache is already set
+ *                 up,
+ *                 MBEDTLS_ERR_SSL_ALLOC_FAILED on allocation failure.
+ */
+int mbedtls_ssl_group_cache_setup(mbedtls_ssl_group_cache *cache,
+                                  size_t size);
+
+/**
+ * \brief          Free a group cache.
+ *
+ * \note           No SSL configuration may use the cache any longer.
+ *
+ * \param cache    The cache to free
+ */
+void mbedtls_ssl_group_cache_free(mbedtls_ssl_group_cache *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ssl_group_cache.h */
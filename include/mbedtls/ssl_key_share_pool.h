@@ -0,0 +1,167 @@
+/**
+ * \file ssl_key_share_pool.h
+ *
+ * \brief Pool of pre-generated ephemeral (EC)DH key pairs
+ *
+ *        Generating the ephemeral key pair of a TLS 1.3 key_share or of a
+ *        TLS 1.2 ECDHE key exchange is on the critical path of every
+ *        handshake. A key share pool holds key pairs that were generated
+ *        ahead of time, for example by a background thread or when the
+ *        application is idle, so that handshakes only have to take one.
+ *        Each key pair is still used for a single handshake and destroyed
+ *        after it, exactly as a key generated on the spot.
+ */
+/*
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+#ifndef MBEDTLS_SSL_KEY_SHARE_POOL_H
+#define MBEDTLS_SSL_KEY_SHARE_POOL_H
+#include "mbedtls/private_access.h"
+
+#include "mbedtls/build_info.h"
+
+#include "mbedtls/ssl.h"
+
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif
+
+/**
+ * \name SECTION: Module settings
+ *
+ * The configuration options you can set for this module are in this section.
+ * Either change them in mbedtls_config.h or define them on the compiler command line.
+ * \{
+ */
+
+#if !defined(MBEDTLS_SSL_KEY_SHARE_POOL_DEFAULT_SIZE)
+#define MBEDTLS_SSL_KEY_SHARE_POOL_DEFAULT_SIZE     8   /*!< Key pairs kept per group */
+#endif
+
+/** \} name SECTION: Module settings */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief   Pre-generated key pairs of one group
+ */
+typedef struct mbedtls_ssl_key_share_pool_slot {
+    uint16_t MBEDTLS_PRIVATE(tls_id);                   /*!< TLS group ID       */
+    psa_key_type_t MBEDTLS_PRIVATE(type);               /*!< PSA key type       */
+    size_t MBEDTLS_PRIVATE(bits);                       /*!< key size           */
+    psa_algorithm_t MBEDTLS_PRIVATE(alg);               /*!< ECDH or FFDH       */
+    mbedtls_svc_key_id_t *MBEDTLS_PRIVATE(keys);        /*!< ready key pairs    */
+    size_t MBEDTLS_PRIVATE(count);                      /*!< entries in keys    */
+} mbedtls_ssl_key_share_pool_slot;
+
+/**
+ * \brief   Key share pool context
+ */
+struct mbedtls_ssl_key_share_pool {
+    mbedtls_ssl_key_share_pool_slot *MBEDTLS_PRIVATE(slots); /*!< one per group */
+    size_t MBEDTLS_PRIVATE(slot_count);                 /*!< number of groups   */
+    size_t MBEDTLS_PRIVATE(size);                       /*!< capacity per group */
+    size_t MBEDTLS_PRIVATE(taken);                      /*!< keys handed out    */
+    size_t MBEDTLS_PRIVATE(misses);                     /*!< pool was empty     */
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_threading_mutex_t MBEDTLS_PRIVATE(mutex);   /*!< mutex              */
+#endif
+};
+
+/**
+ * \brief          Initialize a key share pool.
+ *
+ * \param pool     The pool to initialize
+ */
+void mbedtls_ssl_key_share_pool_init(mbedtls_ssl_key_share_pool *pool);
+
+/**
+ * \brief          Set the groups a key share pool holds key pairs for.
+ *
+ *                 The pool starts empty; call
+ *                 mbedtls_ssl_key_share_pool_refill() to fill it.
+ *
+ * \param pool     The pool to set up
+ * \param groups   List of TLS group IDs (MBEDTLS_SSL_IANA_TLS_GROUP_XXX),
+ *                 terminated by #MBEDTLS_SSL_IANA_TLS_GROUP_NONE. This is
+ *                 typically the list passed to mbedtls_ssl_conf_groups(),
+ *                 or its first entries, which clients send key shares for.
+ * \param size     Number of key pairs to keep for each group, or 0 for
+ *                 #MBEDTLS_SSL_KEY_SHARE_POOL_DEFAULT_SIZE.
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the pool is already set
+ *                 up or a group is not supported,
+ *                 MBEDTLS_ERR_SSL_ALLOC_FAILED on allocation failure.
+ */
+int mbedtls_ssl_key_share_pool_setup(mbedtls_ssl_key_share_pool *pool,
+                                     const uint16_t *groups,
+                                     size_t size);
+
+/**
+ * \brief          Generate key pairs until the pool is full, or until
+ *                 \p max key pairs have been generated.
+ *
+ *                 This is meant to be called from a background thread, or
+ *                 periodically when the application is idle. The key
+ *                 pairs of the emptiest group are generated first.
+ *                 (Thread-safe if MBEDTLS_THREADING_C is enabled. The
+ *                 generation itself runs without holding the pool's lock,
+ *                 so handshakes are not delayed by a refill.)
+ *
+ * \param pool     The pool to refill
+ * \param max      Maximum number of key pairs to generate, or 0 for no
+ *                 limit.
+ *
+ * \return         The number of key pairs generated, 0 if the pool was
+ *                 already full, or a negative error code if a key
+ *                 generation failed.
+ */
+int mbedtls_ssl_key_share_pool_refill(mbedtls_ssl_key_share_pool *pool,
+                                      size_t max);
+
+/**
+ * \brief          Get the number of ready key pairs for a group.
+ *                 (Thread-safe if MBEDTLS_THREADING_C is enabled)
+ *
+ * \param pool     The pool
+ * \param tls_id   The TLS group ID
+ *
+ * \return         The number of key pairs, 0 if the pool does not hold
+ *                 the group.
+ */
+size_t mbedtls_ssl_key_share_pool_get_count(mbedtls_ssl_key_share_pool *pool,
+                                            uint16_t tls_id);
+
+/**
+ * \brief          Get usage statistics of a key share pool.
+ *                 (Thread-safe if MBEDTLS_THREADING_C is enabled)
+ *
+ * \param pool     The pool
+ * \param taken    If not \c NULL, the number of key pairs taken by
+ *                 handshakes.
+ * \param misses   If not \c NULL, the number of handshakes that had to
+ *                 generate a key pair because the pool was empty. A
+ *                 growing value calls for a larger pool or more frequent
+ *                 refills.
+ */
+void mbedtls_ssl_key_share_pool_get_stats(mbedtls_ssl_key_share_pool *pool,
+                                          size_t *taken, size_t *misses);
+
+/**
+ * \brief          Destroy the key pairs of a pool and free it.
+ *
+ * \note           No SSL configuration may use the pool any longer.
+ *
+ * \param pool     The pool to free
+ */
+void mbedtls_ssl_key_share_pool_free(mbedtls_ssl_key_share_pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ssl_key_share_pool.h */
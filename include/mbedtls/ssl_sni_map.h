@@ -0,0 +1,185 @@
+/**
+ * \file ssl_sni_map.h
+ *
+ * \brief Map of server names to certificates, for servers of many virtual
+ *        hosts
+ *
+ *        An SNI map is a hash table from host names, as sent by clients in
+ *        the server_name extension, to the certificate, the trusted CAs and
+ *        the authentication mode to use for them. It is installed with
+ *        mbedtls_ssl_conf_sni() and mbedtls_ssl_sni_map_callback(), and
+ *        entries can be added and removed while handshakes are running.
+ */
+/*
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+#ifndef MBEDTLS_SSL_SNI_MAP_H
+#define MBEDTLS_SSL_SNI_MAP_H
+#include "mbedtls/private_access.h"
+
+#include "mbedtls/build_info.h"
+
+#include "mbedtls/ssl.h"
+
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif
+
+/**
+ * \name SECTION: Module settings
+ *
+ * The configuration options you can set for this module are in this section.
+ * Either change them in mbedtls_config.h or define them on the compiler command line.
+ * \{
+ */
+
+#if !defined(MBEDTLS_SSL_SNI_MAP_DEFAULT_BUCKETS)
+#define MBEDTLS_SSL_SNI_MAP_DEFAULT_BUCKETS     1024   /*!< Hash table size */
+#endif
+
+/** \} name SECTION: Module settings */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief   A virtual host
+ */
+typedef struct mbedtls_ssl_sni_map_entry mbedtls_ssl_sni_map_entry;
+
+struct mbedtls_ssl_sni_map_entry {
+    char *MBEDTLS_PRIVATE(name);                        /*!< lower-case name    */
+    size_t MBEDTLS_PRIVATE(name_len);                   /*!< length of name     */
+    uint32_t MBEDTLS_PRIVATE(hash);                     /*!< hash of name       */
+    mbedtls_x509_crt *MBEDTLS_PRIVATE(cert);            /*!< own certificate    */
+    mbedtls_pk_context *MBEDTLS_PRIVATE(key);           /*!< own private key    */
+    mbedtls_x509_crt *MBEDTLS_PRIVATE(ca_chain);        /*!< trusted CAs or NULL */
+    mbedtls_x509_crl *MBEDTLS_PRIVATE(ca_crl);          /*!< CRLs               */
+    int MBEDTLS_PRIVATE(authmode);                      /*!< authmode override  */
+    mbedtls_ssl_sni_map_entry *MBEDTLS_PRIVATE(next);   /*!< next in bucket     */
+};
+
+/**
+ * \brief   SNI map context
+ */
+typedef struct mbedtls_ssl_sni_map {
+    mbedtls_ssl_sni_map_entry **MBEDTLS_PRIVATE(buckets); /*!< hash table     */
+    size_t MBEDTLS_PRIVATE(bucket_count);               /*!< size of table      */
+    size_t MBEDTLS_PRIVATE(count);                      /*!< number of hosts    */
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_threading_mutex_t MBEDTLS_PRIVATE(mutex);   /*!< mutex              */
+#endif
+} mbedtls_ssl_sni_map;
+
+/**
+ * \brief          Initialize an SNI map.
+ *
+ * \param map      The map to initialize
+ */
+void mbedtls_ssl_sni_map_init(mbedtls_ssl_sni_map *map);
+
+/**
+ * \brief          Allocate the hash table of an SNI map.
+ *
+ * \param map      The map to set up
+ * \param buckets  Size of the hash table, or 0 for
+ *                 #MBEDTLS_SSL_SNI_MAP_DEFAULT_BUCKETS. The table does not
+ *                 grow: lookups stay in constant time as long as it is of
+ *                 the order of the number of hosts.
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the map is already set
+ *                 up,
+ *                 MBEDTLS_ERR_SSL_ALLOC_FAILED on allocation failure.
+ */
+int mbedtls_ssl_sni_map_setup(mbedtls_ssl_sni_map *map, size_t buckets);
+
+/**
+ * \brief          Add a host to an SNI map, or replace its settings.
+ *                 (Thread-safe if MBEDTLS_THREADING_C is enabled)
+ *
+ *                 A name of the form \c "*.example.com" matches the names
+ *                 with exactly one more label, such as \c "www.example.com"
+ *                 but not \c "example.com" nor \c "a.b.example.com". An
+ *                 exact entry takes precedence over a wildcard one. Names
+ *                 are compared without regard to case.
+ *
+ * \note           The certificates, key and CRLs are not copied: they
+ *                 must stay valid as long as they are in the map, and after
+ *                 their removal until the handshakes that selected them are
+ *                 over.
+ *
+ * \param map      The map
+ * \param name     The host name, null-terminated
+ * \param cert     The certificate chain to present to the clients
+ * \param key      The private key of \p cert
+ * \param ca_chain The trusted CAs for client certificates, or \c NULL to
+ *                 keep the ones of the configuration
+ * \param ca_crl   The CRLs of \p ca_chain, or \c NULL
+ * \param authmode The client authentication mode (MBEDTLS_SSL_VERIFY_XXX),
+ *                 or #MBEDTLS_SSL_VERIFY_UNSET to keep the one of the
+ *                 configuration
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the name is empty or
+ *                 too long or the map is not set up,
+ *                 MBEDTLS_ERR_SSL_ALLOC_FAILED on allocation failure.
+ */
+int mbedtls_ssl_sni_map_add(mbedtls_ssl_sni_map *map,
+                            const char *name,
+                            mbedtls_x509_crt *cert,
+                            mbedtls_pk_context *key,
+                            mbedtls_x509_crt *ca_chain,
+                            mbedtls_x509_crl *ca_crl,
+                            int authmode);
+
+/**
+ * \brief          Remove a host from an SNI map.
+ *                 (Thread-safe if MBEDTLS_THREADING_C is enabled)
+ *
+ * \param map      The map
+ * \param name     The host name, as given to mbedtls_ssl_sni_map_add()
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND if the name is not
+ *                 in the map.
+ */
+int mbedtls_ssl_sni_map_remove(mbedtls_ssl_sni_map *map, const char *name);
+
+/**
+ * \brief          SNI callback that selects the settings of the host the
+ *                 client asked for. Pass it to mbedtls_ssl_conf_sni() with
+ *                 the map as its context.
+ *                 (Thread-safe if MBEDTLS_THREADING_C is enabled)
+ *
+ *                 A name that is not in the map gets the certificate of the
+ *                 configuration.
+ *
+ * \param p_map    The map
+ * \param ssl      The SSL context of the handshake
+ * \param name     The server name sent by the client
+ * \param name_len Length of \p name
+ *
+ * \return         0 on success,
+ *                 a negative error code if the settings of the host could
+ *                 not be applied, which aborts the handshake.
+ */
+int mbedtls_ssl_sni_map_callback(void *p_map, mbedtls_ssl_context *ssl,
+                                 const unsigned char *name, size_t name_len);
+
+/**
+ * \brief          Free an SNI map.
+ *
+ * \note           No SSL configuration may use the map any longer.
+ *
+ * \param map      The map to free
+ */
+void mbedtls_ssl_sni_map_free(mbedtls_ssl_sni_map *map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ssl_sni_map.h */
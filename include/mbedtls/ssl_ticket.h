@@ -174,6 +174,10 @@ mbedtls_ssl_ticket_write_t mbedtls_ssl_ticket_write;
  * \brief           Implementation of the ticket parse callback
  *
  * \note            See \c mbedtls_ssl_ticket_parse_t for description
+ *
+ * \note            The session is loaded with
+ *                  mbedtls_ssl_session_load_borrowed(): it refers to the
+ *                  decrypted ticket in \p buf until it is detached.
  */
 mbedtls_ssl_ticket_parse_t mbedtls_ssl_ticket_parse;
 
@@ -0,0 +1,148 @@
+/**
+ * \file ssl_verify_cache.h
+ *
+ * \brief Cache of verified peer certificate chains
+ *
+ *        Verifying a peer certificate chain builds the chain up to a trust
+ *        anchor and checks the signature of each certificate in it. Peers
+ *        that reconnect often, such as the clients of a server that
+ *        requires client authentication, present the same chains again and
+ *        again. A verify cache remembers the chains that verified
+ *        successfully, by a hash of their DER encoding, so that the
+ *        signature checks are done once per chain instead of once per
+ *        handshake. The validity period of the certificates and the
+ *        expected hostname are still checked on every handshake.
+ */
+/*
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+#ifndef MBEDTLS_SSL_VERIFY_CACHE_H
+#define MBEDTLS_SSL_VERIFY_CACHE_H
+#include "mbedtls/private_access.h"
+
+#include "mbedtls/build_info.h"
+
+#include "mbedtls/ssl.h"
+
+#if defined(MBEDTLS_THREADING_C)
+#include "mbedtls/threading.h"
+#endif
+
+/**
+ * \name SECTION: Module settings
+ *
+ * The configuration options you can set for this module are in this section.
+ * Either change them in mbedtls_config.h or define them on the compiler command line.
+ * \{
+ */
+
+#if !defined(MBEDTLS_SSL_VERIFY_CACHE_DEFAULT_SIZE)
+#define MBEDTLS_SSL_VERIFY_CACHE_DEFAULT_SIZE   1024   /*!< Maximum number of chains */
+#endif
+
+/** \} name SECTION: Module settings */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MBEDTLS_SSL_VERIFY_CACHE_DIGEST_LEN     32     /*!< SHA-256 of the chain */
+
+/**
+ * \brief   A verified chain
+ */
+typedef struct mbedtls_ssl_verify_cache_entry {
+    unsigned char MBEDTLS_PRIVATE(digest)[MBEDTLS_SSL_VERIFY_CACHE_DIGEST_LEN]; /*!< chain hash */
+    unsigned char MBEDTLS_PRIVATE(trust_digest)[MBEDTLS_SSL_VERIFY_CACHE_DIGEST_LEN]; /*!< anchors, CRLs, profile */
+    uint32_t MBEDTLS_PRIVATE(trust_version);            /*!< trust store version */
+    mbedtls_x509_time MBEDTLS_PRIVATE(valid_to);        /*!< earliest expiry,
+                                                             anchor included */
+    int MBEDTLS_PRIVATE(in_use);                        /*!< entry is valid     */
+} mbedtls_ssl_verify_cache_entry;
+
+/**
+ * \brief   Verify cache context
+ */
+struct mbedtls_ssl_verify_cache {
+    mbedtls_ssl_verify_cache_entry *MBEDTLS_PRIVATE(entries); /*!< hash table */
+    size_t MBEDTLS_PRIVATE(size);                       /*!< entries in table   */
+    uint32_t MBEDTLS_PRIVATE(trust_version);            /*!< current version    */
+    size_t MBEDTLS_PRIVATE(hits);                       /*!< verifications saved */
+    size_t MBEDTLS_PRIVATE(misses);                     /*!< full verifications */
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_threading_mutex_t MBEDTLS_PRIVATE(mutex);   /*!< mutex              */
+#endif
+};
+
+/**
+ * \brief          Initialize a verify cache.
+ *
+ * \param cache    The cache to initialize
+ */
+void mbedtls_ssl_verify_cache_init(mbedtls_ssl_verify_cache *cache);
+
+/**
+ * \brief          Allocate the table of a verify cache.
+ *
+ *                 The table is indexed by the hash of the chains, and a
+ *                 chain replaces the one that had the same index.
+ *
+ * \param cache    The cache to set up
+ * \param size     Number of entries of the table, or 0 for
+ *                 #MBEDTLS_SSL_VERIFY_CACHE_DEFAULT_SIZE. Each entry takes
+ *                 about 100 bytes.
+ *
+ * \return         0 on success,
+ *                 MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the cache is already set
+ *                 up,
+ *                 MBEDTLS_ERR_SSL_ALLOC_FAILED on allocation failure.
+ */
+int mbedtls_ssl_verify_cache_setup(mbedtls_ssl_verify_cache *cache,
+                                   size_t size);
+
+/**
+ * \brief          Set the version of the trust store.
+ *
+ *                 Chains verified under another version are verified again.
+ *                 Entries are keyed on the contents of the trusted CAs
+ *                 that can anchor the chain, of the CRLs and of the
+ *                 profile, so changes to these are detected without it.
+ *                 Call this to force a new verification of every chain
+ *                 for any other reason, for example with a counter
+ *                 incremented on each reload.
+ *                 (Thread-safe if MBEDTLS_THREADING_C is enabled)
+ *
+ * \param cache    The cache
+ * \param version  The new version
+ */
+void mbedtls_ssl_verify_cache_set_trust_version(mbedtls_ssl_verify_cache *cache,
+                                                uint32_t version);
+
+/**
+ * \brief          Get usage statistics of a verify cache.
+ *                 (Thread-safe if MBEDTLS_THREADING_C is enabled)
+ *
+ * \param cache    The cache
+ * \param hits     If not \c NULL, the number of chains accepted from the
+ *                 cache.
+ * \param misses   If not \c NULL, the number of chains that were not found
+ *                 in the cache.
+ */
+void mbedtls_ssl_verify_cache_get_stats(mbedtls_ssl_verify_cache *cache,
+                                        size_t *hits, size_t *misses);
+
+/**
+ * \brief          Free a verify cache.
+ *
+ * \note           No SSL configuration may use the cache any longer.
+ *
+ * \param cache    The cache to free
+ */
+void mbedtls_ssl_verify_cache_free(mbedtls_ssl_verify_cache *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ssl_verify_cache.h */
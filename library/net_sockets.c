@@ -14,6 +14,9 @@
 #ifndef _XOPEN_SOURCE
 #define _XOPEN_SOURCE 600 /* sockaddr_storage */
 #endif
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* recvmmsg(), sendmmsg() */
+#endif
 
 #include "ssl_misc.h"
 
@@ -71,10 +74,33 @@ static int wsa_init_done = 0;
 #include <fcntl.h>
 #include <netdb.h>
 #include <errno.h>
+#if defined(__linux__)
+#include <netinet/udp.h>
+#endif
 
 #define IS_EINTR(ret) ((ret) == EINTR)
 #define SOCKET int
 
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+#define NET_HAVE_MMSG
+#endif
+
+#if defined(NET_HAVE_MMSG) && defined(UDP_SEGMENT)
+#define NET_HAVE_GSO
+/* Kernel limits on one segmentation offload send: number of segments, and
+ * total length, that of the largest UDP payload over IPv4 */
+#define NET_GSO_MAX_SEGMENTS    64
+#define NET_GSO_MAX_LEN         65507
+#endif
+
+#if defined(SCM_RIGHTS) && defined(CMSG_SPACE)
+#define NET_HAVE_FD_PASSING
+#endif
+
+#if defined(__linux__) && defined(IP_MTU_DISCOVER) && defined(IP_PMTUDISC_DO)
+#define NET_HAVE_PMTU_DISCOVERY
+#endif
+
 #endif /* ( _WIN32 || _WIN32_WCE ) && !EFIX64 && !EFI32 */
 
 /* Some MS functions want int and MSVC warns if we pass size_t,
@@ -150,6 +176,7 @@ static int check_fd(int fd, int for_select)
 void mbedtls_net_init(mbedtls_net_context *ctx)
 {
     ctx->fd = -1;
+    ctx->gso_failed = 0;
 }
 
 /*
@@ -309,6 +336,34 @@ static int net_would_block(const mbedtls_net_context *ctx)
     }
     return 0;
 }
+
+#if defined(NET_HAVE_PMTU_DISCOVERY)
+/*
+ * Check if a socket was set up with mbedtls_net_set_pmtu_discovery(): only
+ * then is EMSGSIZE reported as MBEDTLS_ERR_SSL_DATAGRAM_TOO_BIG.
+ */
+static int net_pmtu_discovery_enabled(int fd)
+{
+    int val = 0;
+    socklen_t n = (socklen_t) sizeof(val);
+    struct sockaddr_storage addr;
+    socklen_t addr_len = (socklen_t) sizeof(addr);
+
+    if (getsockname(fd, (struct sockaddr *) &addr, &addr_len) != 0) {
+        return 0;
+    }
+
+#if defined(IPV6_MTU_DISCOVER) && defined(IPV6_PMTUDISC_DO)
+    if (addr.ss_family == AF_INET6) {
+        return getsockopt(fd, IPPROTO_IPV6, IPV6_MTU_DISCOVER, &val, &n) == 0 &&
+               val == IPV6_PMTUDISC_DO;
+    }
+#endif
+
+    return getsockopt(fd, IPPROTO_IP, IP_MTU_DISCOVER, &val, &n) == 0 &&
+           val == IP_PMTUDISC_DO;
+}
+#endif /* NET_HAVE_PMTU_DISCOVERY */
 #endif /* ( _WIN32 || _WIN32_WCE ) && !EFIX64 && !EFI32 */
 
 /*
@@ -379,7 +434,9 @@ int mbedtls_net_accept(mbedtls_net_context *bind_ctx,
         }
 
         client_ctx->fd = bind_ctx->fd;
+        client_ctx->gso_failed = bind_ctx->gso_failed;
         bind_ctx->fd   = -1; /* In case we exit early */
+        bind_ctx->gso_failed = 0;
 
         n = sizeof(struct sockaddr_storage);
         if (getsockname(client_ctx->fd,
@@ -656,12 +713,676 @@ int mbedtls_net_send(void *ctx, const unsigned char *buf, size_t len)
         if (errno == EINTR) {
             return MBEDTLS_ERR_SSL_WANT_WRITE;
         }
+
+#if defined(NET_HAVE_PMTU_DISCOVERY)
+        if (errno == EMSGSIZE && net_pmtu_discovery_enabled(fd)) {
+            return MBEDTLS_ERR_SSL_DATAGRAM_TOO_BIG;
+        }
+#endif
+#endif
+
+        return MBEDTLS_ERR_NET_SEND_FAILED;
+    }
+
+    return ret;
+}
+
+/*
+ * Copy a socket address into its opaque form, zero-padded
+ */
+static int net_addr_store(mbedtls_net_addr *peer,
+                          const struct sockaddr_storage *addr, size_t len)
+{
+    if (len > sizeof(peer->addr)) {
+        return -1;
+    }
+
+    memset(peer->addr, 0, sizeof(peer->addr));
+    memcpy(peer->addr, addr, len);
+    peer->len = len;
+
+    return 0;
+}
+
+/*
+ * Receive one datagram and remember where it came from
+ */
+int mbedtls_net_recv_from(mbedtls_net_context *ctx, unsigned char *buf,
+                          size_t len, mbedtls_net_addr *peer)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    struct sockaddr_storage peer_addr;
+#if defined(__socklen_t_defined) || defined(_SOCKLEN_T) ||  \
+    defined(_SOCKLEN_T_DECLARED) || defined(__DEFINED_socklen_t) || \
+    defined(socklen_t) || (defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L)
+    socklen_t n = (socklen_t) sizeof(peer_addr);
+#else
+    int n = (int) sizeof(peer_addr);
+#endif
+
+    ret = check_fd(ctx->fd, 0);
+    if (ret != 0) {
+        return ret;
+    }
+
+    /* Zeroize so that padding never makes equal addresses compare different */
+    memset(&peer_addr, 0, sizeof(peer_addr));
+
+    ret = (int) recvfrom(ctx->fd, (char *) buf, MSVC_INT_CAST len, 0,
+                         (struct sockaddr *) &peer_addr, &n);
+
+    if (ret < 0) {
+        if (net_would_block(ctx) != 0) {
+            return MBEDTLS_ERR_SSL_WANT_READ;
+        }
+
+#if (defined(_WIN32) || defined(_WIN32_WCE)) && !defined(EFIX64) && \
+        !defined(EFI32)
+        if (WSAGetLastError() == WSAEMSGSIZE) {
+            /* Truncated datagram: report what fits, like on POSIX */
+            ret = (int) len;
+        } else {
+            return MBEDTLS_ERR_NET_RECV_FAILED;
+        }
+#else
+        if (errno == EINTR) {
+            return MBEDTLS_ERR_SSL_WANT_READ;
+        }
+
+        return MBEDTLS_ERR_NET_RECV_FAILED;
+#endif
+    }
+
+    if (net_addr_store(peer, &peer_addr, (size_t) n) != 0) {
+        return MBEDTLS_ERR_NET_BUFFER_TOO_SMALL;
+    }
+
+    return ret;
+}
+
+/*
+ * Send one datagram to the given peer
+ */
+int mbedtls_net_send_to(mbedtls_net_context *ctx, const unsigned char *buf,
+                        size_t len, const mbedtls_net_addr *peer)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    struct sockaddr_storage peer_addr;
+
+    ret = check_fd(ctx->fd, 0);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (peer->len == 0 || peer->len > sizeof(peer_addr)) {
+        return MBEDTLS_ERR_NET_BAD_INPUT_DATA;
+    }
+
+    /* Copy out to get the alignment sendto() expects */
+    memcpy(&peer_addr, peer->addr, peer->len);
+
+    ret = (int) sendto(ctx->fd, (const char *) buf, MSVC_INT_CAST len, 0,
+                       (const struct sockaddr *) &peer_addr,
+                       MSVC_INT_CAST peer->len);
+
+    if (ret < 0) {
+        if (net_would_block(ctx) != 0) {
+            return MBEDTLS_ERR_SSL_WANT_WRITE;
+        }
+
+#if !((defined(_WIN32) || defined(_WIN32_WCE)) && !defined(EFIX64) && \
+        !defined(EFI32))
+        if (errno == EINTR) {
+            return MBEDTLS_ERR_SSL_WANT_WRITE;
+        }
+
+#if defined(NET_HAVE_PMTU_DISCOVERY)
+        if (errno == EMSGSIZE && net_pmtu_discovery_enabled(ctx->fd)) {
+            return MBEDTLS_ERR_SSL_DATAGRAM_TOO_BIG;
+        }
+#endif
+#endif
+
+        return MBEDTLS_ERR_NET_SEND_FAILED;
+    }
+
+    return ret;
+}
+
+/*
+ * Receive up to 'count' datagrams
+ */
+int mbedtls_net_recv_batch(mbedtls_net_context *ctx,
+                           mbedtls_net_dgram *dgrams, size_t count)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+#if defined(NET_HAVE_MMSG)
+    struct mmsghdr msgs[MBEDTLS_NET_BATCH_MAX];
+    struct iovec iov[MBEDTLS_NET_BATCH_MAX];
+    struct sockaddr_storage addrs[MBEDTLS_NET_BATCH_MAX];
+#if defined(UDP_GRO)
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } ctrl[MBEDTLS_NET_BATCH_MAX];
+    struct cmsghdr *cmsg;
+    int gso_size;
+#endif
+    size_t i;
+
+    ret = check_fd(ctx->fd, 0);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (count == 0) {
+        return MBEDTLS_ERR_NET_BAD_INPUT_DATA;
+    }
+    if (count > MBEDTLS_NET_BATCH_MAX) {
+        count = MBEDTLS_NET_BATCH_MAX;
+    }
+
+    memset(msgs, 0, count * sizeof(msgs[0]));
+    memset(addrs, 0, count * sizeof(addrs[0]));
+
+    for (i = 0; i < count; i++) {
+        iov[i].iov_base = dgrams[i].buf;
+        iov[i].iov_len = dgrams[i].size;
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+#if defined(UDP_GRO)
+        msgs[i].msg_hdr.msg_control = ctrl[i].buf;
+        msgs[i].msg_hdr.msg_controllen = sizeof(ctrl[i].buf);
+#endif
+    }
+
+    /* Block (if the socket does) for the first datagram only */
+    ret = recvmmsg(ctx->fd, msgs, (unsigned int) count, MSG_WAITFORONE, NULL);
+
+    if (ret < 0) {
+        if (net_would_block(ctx) != 0 || errno == EINTR) {
+            return MBEDTLS_ERR_SSL_WANT_READ;
+        }
+
+        return MBEDTLS_ERR_NET_RECV_FAILED;
+    }
+
+    for (i = 0; i < (size_t) ret; i++) {
+        dgrams[i].len = msgs[i].msg_len;
+        dgrams[i].segment_size = 0;
+
+#if defined(UDP_GRO)
+        for (cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg != NULL;
+             cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                if (gso_size > 0 && (size_t) gso_size < dgrams[i].len) {
+                    dgrams[i].segment_size = (size_t) gso_size;
+                }
+            }
+        }
+
+        /* A coalesced buffer cut short by the size of buf: keep the
+         * datagrams that were received whole, the others are lost. */
+        if ((msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0 &&
+            dgrams[i].segment_size != 0 &&
+            dgrams[i].len >= dgrams[i].segment_size) {
+            dgrams[i].len -= dgrams[i].len % dgrams[i].segment_size;
+            if (dgrams[i].len == dgrams[i].segment_size) {
+                dgrams[i].segment_size = 0;
+            }
+        }
+#endif
+
+        if (net_addr_store(&dgrams[i].addr, &addrs[i],
+                           msgs[i].msg_hdr.msg_namelen) != 0) {
+            return MBEDTLS_ERR_NET_BUFFER_TOO_SMALL;
+        }
+    }
+
+    return ret;
+#else /* NET_HAVE_MMSG */
+    if (count == 0) {
+        return MBEDTLS_ERR_NET_BAD_INPUT_DATA;
+    }
+
+    ret = mbedtls_net_recv_from(ctx, dgrams[0].buf, dgrams[0].size,
+                                &dgrams[0].addr);
+    if (ret < 0) {
+        return ret;
+    }
+
+    dgrams[0].len = (size_t) ret;
+    dgrams[0].segment_size = 0;
+
+    return 1;
+#endif /* NET_HAVE_MMSG */
+}
+
+/*
+ * Send a datagram, splitting it into segments in user space if needed
+ */
+static int net_send_dgram(mbedtls_net_context *ctx,
+                          const mbedtls_net_dgram *dgram)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    size_t seg = dgram->segment_size != 0 ? dgram->segment_size : dgram->len;
+    size_t off = 0;
+
+    do {
+        size_t n = dgram->len - off < seg ? dgram->len - off : seg;
+
+        ret = mbedtls_net_send_to(ctx, dgram->buf + off, n, &dgram->addr);
+        if (ret < 0) {
+            return ret;
+        }
+
+        off += n;
+    } while (off < dgram->len);
+
+    return 0;
+}
+
+/*
+ * Send up to 'count' datagrams
+ */
+int mbedtls_net_send_batch(mbedtls_net_context *ctx,
+                           const mbedtls_net_dgram *dgrams, size_t count)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    size_t i;
+#if defined(NET_HAVE_MMSG)
+    struct mmsghdr msgs[MBEDTLS_NET_BATCH_MAX];
+    struct iovec iov[MBEDTLS_NET_BATCH_MAX];
+    struct sockaddr_storage addrs[MBEDTLS_NET_BATCH_MAX];
+#if defined(NET_HAVE_GSO)
+    union {
+        char buf[CMSG_SPACE(sizeof(uint16_t))];
+        struct cmsghdr align;
+    } ctrl[MBEDTLS_NET_BATCH_MAX];
+    struct cmsghdr *cmsg;
+    uint16_t gso_size;
+#endif
+
+    ret = check_fd(ctx->fd, 0);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (count == 0) {
+        return MBEDTLS_ERR_NET_BAD_INPUT_DATA;
+    }
+    if (count > MBEDTLS_NET_BATCH_MAX) {
+        count = MBEDTLS_NET_BATCH_MAX;
+    }
+
+    memset(msgs, 0, count * sizeof(msgs[0]));
+
+    for (i = 0; i < count; i++) {
+        const mbedtls_net_dgram *d = &dgrams[i];
+
+        if (d->addr.len == 0 || d->addr.len > sizeof(addrs[i])) {
+            return MBEDTLS_ERR_NET_BAD_INPUT_DATA;
+        }
+
+        if (d->segment_size != 0 && d->segment_size < d->len) {
+#if defined(NET_HAVE_GSO)
+            if (ctx->gso_failed == 0 && d->segment_size <= UINT16_MAX &&
+                d->len <= NET_GSO_MAX_LEN &&
+                d->len <= d->segment_size * NET_GSO_MAX_SEGMENTS) {
+                msgs[i].msg_hdr.msg_control = ctrl[i].buf;
+                msgs[i].msg_hdr.msg_controllen = sizeof(ctrl[i].buf);
+                cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(gso_size));
+                gso_size = (uint16_t) d->segment_size;
+                memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+            } else
+#endif
+            {
+                /* No kernel segmentation: send what precedes, or split
+                 * this one by hand if it comes first */
+                if (i == 0) {
+                    ret = net_send_dgram(ctx, d);
+                    return ret != 0 ? ret : 1;
+                }
+                count = i;
+                break;
+            }
+        }
+
+        memcpy(&addrs[i], d->addr.addr, d->addr.len);
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = (socklen_t) d->addr.len;
+        iov[i].iov_base = d->buf;
+        iov[i].iov_len = d->len;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    ret = sendmmsg(ctx->fd, msgs, (unsigned int) count, 0);
+
+    if (ret < 0) {
+        if (net_would_block(ctx) != 0 || errno == EINTR) {
+            return MBEDTLS_ERR_SSL_WANT_WRITE;
+        }
+
+#if defined(NET_HAVE_GSO)
+        /* The first datagram failed: if the kernel or the device cannot
+         * segment it, stop asking on this socket and split it by hand. */
+        if ((errno == EIO || errno == EINVAL) &&
+            msgs[0].msg_hdr.msg_control != NULL) {
+            ctx->gso_failed = 1;
+            ret = net_send_dgram(ctx, &dgrams[0]);
+            return ret != 0 ? ret : 1;
+        }
 #endif
 
         return MBEDTLS_ERR_NET_SEND_FAILED;
     }
 
     return ret;
+#else /* NET_HAVE_MMSG */
+    if (count == 0) {
+        return MBEDTLS_ERR_NET_BAD_INPUT_DATA;
+    }
+    if (count > MBEDTLS_NET_BATCH_MAX) {
+        count = MBEDTLS_NET_BATCH_MAX;
+    }
+
+    for (i = 0; i < count; i++) {
+        ret = net_send_dgram(ctx, &dgrams[i]);
+        if (ret != 0) {
+            /* Report progress if any, the error will come again */
+            return i == 0 ? ret : (int) i;
+        }
+    }
+
+    return (int) count;
+#endif /* NET_HAVE_MMSG */
+}
+
+/*
+ * Let the kernel coalesce received datagrams
+ */
+int mbedtls_net_set_udp_gro(mbedtls_net_context *ctx, int enable)
+{
+#if defined(__linux__) && defined(UDP_GRO)
+    int ret = check_fd(ctx->fd, 0);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (setsockopt(ctx->fd, SOL_UDP, UDP_GRO,
+                   (const char *) &enable, sizeof(enable)) != 0) {
+        return MBEDTLS_ERR_NET_SOCKET_FAILED;
+    }
+
+    return 0;
+#else
+    ((void) ctx);
+    ((void) enable);
+    return MBEDTLS_ERR_NET_SOCKET_FAILED;
+#endif
+}
+
+/*
+ * Set the Don't Fragment bit and report EMSGSIZE for oversized datagrams
+ */
+int mbedtls_net_set_pmtu_discovery(mbedtls_net_context *ctx)
+{
+#if defined(NET_HAVE_PMTU_DISCOVERY)
+    int ret = check_fd(ctx->fd, 0);
+    int val = IP_PMTUDISC_DO;
+    struct sockaddr_storage addr;
+    socklen_t n = (socklen_t) sizeof(addr);
+
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (getsockname(ctx->fd, (struct sockaddr *) &addr, &n) != 0) {
+        return MBEDTLS_ERR_NET_SOCKET_FAILED;
+    }
+
+#if defined(IPV6_MTU_DISCOVER) && defined(IPV6_PMTUDISC_DO)
+    if (addr.ss_family == AF_INET6) {
+        val = IPV6_PMTUDISC_DO;
+        ret = setsockopt(ctx->fd, IPPROTO_IPV6, IPV6_MTU_DISCOVER,
+                         (const char *) &val, sizeof(val));
+    } else
+#endif
+    {
+        ret = setsockopt(ctx->fd, IPPROTO_IP, IP_MTU_DISCOVER,
+                         (const char *) &val, sizeof(val));
+    }
+
+    if (ret != 0) {
+        return MBEDTLS_ERR_NET_SOCKET_FAILED;
+    }
+
+    return 0;
+#else
+    ((void) ctx);
+    return MBEDTLS_ERR_NET_SOCKET_FAILED;
+#endif
+}
+
+#if defined(NET_HAVE_FD_PASSING)
+/*
+ * Write or read exactly len bytes on a blocking socket
+ */
+static int net_send_all(int fd, const unsigned char *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = write(fd, buf, len);
+        if (n < 0 && IS_EINTR(errno)) {
+            continue;
+        }
+        if (n < 0) {
+            return (errno == EPIPE || errno == ECONNRESET) ?
+                   MBEDTLS_ERR_NET_CONN_RESET : MBEDTLS_ERR_NET_SEND_FAILED;
+        }
+        buf += n;
+        len -= (size_t) n;
+    }
+
+    return 0;
+}
+
+static int net_recv_all(int fd, unsigned char *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = read(fd, buf, len);
+        if (n < 0 && IS_EINTR(errno)) {
+            continue;
+        }
+        if (n == 0) {
+            return MBEDTLS_ERR_NET_CONN_RESET;
+        }
+        if (n < 0) {
+            return (errno == ECONNRESET) ?
+                   MBEDTLS_ERR_NET_CONN_RESET : MBEDTLS_ERR_NET_RECV_FAILED;
+        }
+        buf += n;
+        len -= (size_t) n;
+    }
+
+    return 0;
+}
+#endif /* NET_HAVE_FD_PASSING */
+
+/*
+ * Hand a socket over to another process, along with a message.
+ *
+ * The message is sent as a 4-byte length followed by the data, and the
+ * descriptor travels as SCM_RIGHTS ancillary data with the first byte.
+ */
+int mbedtls_net_send_fd(mbedtls_net_context *ctx,
+                        const mbedtls_net_context *conn,
+                        const unsigned char *buf, size_t len)
+{
+#if defined(NET_HAVE_FD_PASSING)
+    int ret = check_fd(ctx->fd, 0);
+    unsigned char hdr[4];
+    struct iovec iov;
+    struct msghdr msg;
+    struct cmsghdr *cmsg;
+    union {
+        struct cmsghdr align;
+        unsigned char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    ssize_t n;
+
+    if (ret != 0) {
+        return ret;
+    }
+    if ((ret = check_fd(conn->fd, 0)) != 0) {
+        return ret;
+    }
+    if ((uint64_t) len > 0xFFFFFFFF) {
+        return MBEDTLS_ERR_NET_BAD_INPUT_DATA;
+    }
+
+    MBEDTLS_PUT_UINT32_BE(len, hdr, 0);
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&control, 0, sizeof(control));
+    iov.iov_base = hdr;
+    iov.iov_len = 1;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &conn->fd, sizeof(int));
+
+    do {
+        n = sendmsg(ctx->fd, &msg, 0);
+    } while (n < 0 && IS_EINTR(errno));
+
+    if (n != 1) {
+        return (n < 0 && (errno == EPIPE || errno == ECONNRESET)) ?
+               MBEDTLS_ERR_NET_CONN_RESET : MBEDTLS_ERR_NET_SEND_FAILED;
+    }
+
+    if ((ret = net_send_all(ctx->fd, hdr + 1, sizeof(hdr) - 1)) != 0) {
+        return ret;
+    }
+
+    return net_send_all(ctx->fd, buf, len);
+#else
+    ((void) ctx);
+    ((void) conn);
+    ((void) buf);
+    ((void) len);
+    return MBEDTLS_ERR_NET_SOCKET_FAILED;
+#endif
+}
+
+/*
+ * Take over a socket sent by mbedtls_net_send_fd(), along with its message
+ */
+int mbedtls_net_recv_fd(mbedtls_net_context *ctx,
+                        mbedtls_net_context *conn,
+                        unsigned char *buf, size_t buf_len, size_t *olen)
+{
+#if defined(NET_HAVE_FD_PASSING)
+    int ret = check_fd(ctx->fd, 0);
+    int fd = -1;
+    unsigned char hdr[4];
+    struct iovec iov;
+    struct msghdr msg;
+    struct cmsghdr *cmsg;
+    union {
+        struct cmsghdr align;
+        unsigned char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    size_t len;
+    ssize_t n;
+
+    if (ret != 0) {
+        return ret;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&control, 0, sizeof(control));
+    iov.iov_base = hdr;
+    iov.iov_len = 1;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    do {
+        n = recvmsg(ctx->fd, &msg, 0);
+    } while (n < 0 && IS_EINTR(errno));
+
+    if (n == 0) {
+        return MBEDTLS_ERR_NET_CONN_RESET;
+    }
+    if (n < 0) {
+        return MBEDTLS_ERR_NET_RECV_FAILED;
+    }
+
+    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET &&
+            cmsg->cmsg_type == SCM_RIGHTS &&
+            cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+            memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+    if (fd < 0 || (msg.msg_flags & MSG_CTRUNC) != 0) {
+        ret = MBEDTLS_ERR_NET_RECV_FAILED;
+        goto cleanup;
+    }
+
+    if ((ret = net_recv_all(ctx->fd, hdr + 1, sizeof(hdr) - 1)) != 0) {
+        goto cleanup;
+    }
+
+    len = MBEDTLS_GET_UINT32_BE(hdr, 0);
+    if (len > buf_len) {
+        ret = MBEDTLS_ERR_NET_BUFFER_TOO_SMALL;
+        goto cleanup;
+    }
+
+    if ((ret = net_recv_all(ctx->fd, buf, len)) != 0) {
+        goto cleanup;
+    }
+
+    conn->fd = fd;
+    conn->gso_failed = 0;
+    *olen = len;
+
+    return 0;
+
+cleanup:
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    return ret;
+#else
+    ((void) ctx);
+    ((void) conn);
+    ((void) buf);
+    ((void) buf_len);
+    ((void) olen);
+    return MBEDTLS_ERR_NET_SOCKET_FAILED;
+#endif
 }
 
 /*
@@ -676,6 +1397,7 @@ void mbedtls_net_close(mbedtls_net_context *ctx)
     close(ctx->fd);
 
     ctx->fd = -1;
+    ctx->gso_failed = 0;
 }
 
 /*
@@ -691,6 +1413,7 @@ void mbedtls_net_free(mbedtls_net_context *ctx)
     close(ctx->fd);
 
     ctx->fd = -1;
+    ctx->gso_failed = 0;
 }
 
 #endif /* MBEDTLS_NET_C */
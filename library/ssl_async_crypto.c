@@ -0,0 +1,336 @@
+/*
+ *  Asynchronous public key operations in the SSL handshake
+ *
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+/*
+ * The handshake describes an expensive operation in its
+ * mbedtls_ssl_async_job and passes it to the application's start callback,
+ * which typically queues it for a worker thread running
+ * mbedtls_ssl_async_job_run(). The handshake step then returns
+ * MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS and, each time it is resumed, polls the
+ * job until it is done and consumes its result.
+ */
+
+#include "ssl_misc.h"
+
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/error.h"
+#include "debug_internal.h"
+#include "psa_util_internal.h"
+
+#include <string.h>
+
+int mbedtls_ssl_async_job_run(mbedtls_ssl_async_job *job)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    const void *options = NULL;
+
+    switch (job->type) {
+        case MBEDTLS_SSL_ASYNC_JOB_KEY_GENERATION:
+            ret = PSA_TO_MBEDTLS_ERR(psa_generate_key(&job->attributes,
+                                                      &job->key));
+            break;
+
+        case MBEDTLS_SSL_ASYNC_JOB_KEY_AGREEMENT:
+            ret = PSA_TO_MBEDTLS_ERR(psa_raw_key_agreement(
+                                         job->alg, job->key,
+                                         job->peer, job->peer_len,
+                                         job->output, job->output_size,
+                                         &job->output_len));
+            break;
+
+        case MBEDTLS_SSL_ASYNC_JOB_VERIFY:
+#if defined(MBEDTLS_X509_RSASSA_PSS_SUPPORT)
+            if (job->use_pss_options) {
+                options = &job->pss_options;
+            }
+#endif
+            ret = mbedtls_pk_verify_ext(job->pk_type, options, job->pk,
+                                        job->md_alg, job->hash, job->hash_len,
+                                        job->sig, job->sig_len);
+            break;
+
+        default:
+            ret = MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+            break;
+    }
+
+    job->ret = ret;
+    return ret;
+}
+
+mbedtls_ssl_async_job_type mbedtls_ssl_async_job_get_type(
+    const mbedtls_ssl_async_job *job)
+{
+    return job->type;
+}
+
+void mbedtls_ssl_async_job_set_backend_data(mbedtls_ssl_async_job *job,
+                                            void *data)
+{
+    job->backend_data = data;
+}
+
+void *mbedtls_ssl_async_job_get_backend_data(const mbedtls_ssl_async_job *job)
+{
+    return job->backend_data;
+}
+
+/* Release what the job owns and return it to the idle state. */
+static void ssl_async_job_reset(mbedtls_ssl_async_job *job)
+{
+    /* A generated key that was never handed to the handshake. For key
+     * agreement, job->key is the handshake's own key and is left alone. */
+    if (job->type == MBEDTLS_SSL_ASYNC_JOB_KEY_GENERATION &&
+        !mbedtls_svc_key_id_is_null(job->key)) {
+        (void) psa_destroy_key(job->key);
+    }
+    if (job->output != NULL) {
+        mbedtls_zeroize_and_free(job->output, job->output_size);
+    }
+    mbedtls_free(job->sig);
+    psa_reset_key_attributes(&job->attributes);
+
+    mbedtls_platform_zeroize(job, sizeof(*job));
+}
+
+/*
+ * Start the prepared job of the handshake, or poll it if it was started
+ * by an earlier call.
+ *
+ * Returns 0 once job->ret holds the outcome of the operation,
+ * MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS while it is running, or the error
+ * returned by a callback.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_async_job_step(mbedtls_ssl_context *ssl)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_async_job *job = &ssl->handshake->async_job;
+
+    if (job->state == MBEDTLS_SSL_ASYNC_JOB_IDLE) {
+        ret = ssl->conf->f_async_job_start(ssl->conf->p_async_job, job);
+        if (ret == MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH) {
+            MBEDTLS_SSL_DEBUG_MSG(3, ("async crypto job %d: run inline",
+                                      (int) job->type));
+            (void) mbedtls_ssl_async_job_run(job);
+            job->state = MBEDTLS_SSL_ASYNC_JOB_DONE;
+            return 0;
+        }
+        if (ret != 0) {
+            MBEDTLS_SSL_DEBUG_RET(1, "f_async_job_start", ret);
+            ssl_async_job_reset(job);
+            return ret;
+        }
+
+        MBEDTLS_SSL_DEBUG_MSG(2, ("async crypto job %d: started",
+                                  (int) job->type));
+        job->state = MBEDTLS_SSL_ASYNC_JOB_QUEUED;
+        return MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS;
+    }
+
+    if (job->state == MBEDTLS_SSL_ASYNC_JOB_QUEUED) {
+        ret = ssl->conf->f_async_job_poll(ssl->conf->p_async_job, job);
+        if (ret != 0) {
+            /* The job stays queued, mbedtls_ssl_async_job_free() cancels
+             * it if the handshake is abandoned. */
+            if (ret != MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
+                MBEDTLS_SSL_DEBUG_RET(1, "f_async_job_poll", ret);
+            }
+            return ret;
+        }
+
+        MBEDTLS_SSL_DEBUG_MSG(2, ("async crypto job %d: done, ret=%d",
+                                  (int) job->type, job->ret));
+        job->state = MBEDTLS_SSL_ASYNC_JOB_DONE;
+    }
+
+    return 0;
+}
+
+int mbedtls_ssl_async_generate_key(mbedtls_ssl_context *ssl,
+                                   const psa_key_attributes_t *attributes,
+                                   mbedtls_svc_key_id_t *key)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_async_job *job = &ssl->handshake->async_job;
+
+    if (job->state == MBEDTLS_SSL_ASYNC_JOB_IDLE) {
+#if defined(MBEDTLS_SSL_KEY_SHARE_POOL_C)
+        /* A pre-generated key pair is cheaper than any offloading. */
+        if (ssl->conf->key_share_pool != NULL &&
+            mbedtls_ssl_key_share_pool_take(ssl->conf->key_share_pool,
+                                            attributes, key) == 0) {
+            return 0;
+        }
+#endif
+        if (ssl->conf->f_async_job_start == NULL) {
+            return PSA_TO_MBEDTLS_ERR(psa_generate_key(attributes, key));
+        }
+
+        job->type = MBEDTLS_SSL_ASYNC_JOB_KEY_GENERATION;
+        job->attributes = *attributes;
+    } else if (job->type != MBEDTLS_SSL_ASYNC_JOB_KEY_GENERATION) {
+        return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+
+    ret = ssl_async_job_step(ssl);
+    if (ret != 0) {
+        return ret;
+    }
+
+    ret = job->ret;
+    if (ret == 0) {
+        *key = job->key;
+        job->key = MBEDTLS_SVC_KEY_ID_INIT;
+    }
+    ssl_async_job_reset(job);
+
+    return ret;
+}
+
+int mbedtls_ssl_async_key_agreement(mbedtls_ssl_context *ssl,
+                                    psa_algorithm_t alg,
+                                    mbedtls_svc_key_id_t key,
+                                    const unsigned char *peer, size_t peer_len,
+                                    unsigned char **secret, size_t *secret_len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_async_job *job = &ssl->handshake->async_job;
+    psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+
+    if (job->state == MBEDTLS_SSL_ASYNC_JOB_IDLE) {
+        if (ssl->conf->f_async_job_start == NULL && secret == NULL) {
+            /* Nothing to gain from computing it early. */
+            return 0;
+        }
+
+        status = psa_get_key_attributes(key, &attributes);
+        if (status != PSA_SUCCESS) {
+            return PSA_TO_MBEDTLS_ERR(status);
+        }
+        job->output_size = PSA_BITS_TO_BYTES(psa_get_key_bits(&attributes));
+        psa_reset_key_attributes(&attributes);
+
+        job->output = mbedtls_calloc(1, job->output_size);
+        if (job->output == NULL) {
+            ssl_async_job_reset(job);
+            return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+        }
+        job->type = MBEDTLS_SSL_ASYNC_JOB_KEY_AGREEMENT;
+        job->alg = alg;
+        job->key = key;
+        job->peer = peer;
+        job->peer_len = peer_len;
+
+        if (ssl->conf->f_async_job_start == NULL) {
+            (void) mbedtls_ssl_async_job_run(job);
+            job->state = MBEDTLS_SSL_ASYNC_JOB_DONE;
+        }
+    } else if (job->type != MBEDTLS_SSL_ASYNC_JOB_KEY_AGREEMENT) {
+        return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+
+    ret = ssl_async_job_step(ssl);
+    if (ret != 0) {
+        return ret;
+    }
+
+    ret = job->ret;
+    if (ret == 0 && secret == NULL) {
+        /* Keep the result for the call that consumes it. */
+        return 0;
+    }
+
+    if (ret == 0) {
+        *secret = job->output;
+        *secret_len = job->output_len;
+        job->output = NULL;
+    }
+    ssl_async_job_reset(job);
+
+    return ret;
+}
+
+int mbedtls_ssl_async_verify(mbedtls_ssl_context *ssl,
+                             mbedtls_pk_type_t type, const void *options,
+                             mbedtls_pk_context *pk, mbedtls_md_type_t md_alg,
+                             const unsigned char *hash, size_t hash_len,
+                             const unsigned char *sig, size_t sig_len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_async_job *job = &ssl->handshake->async_job;
+
+    if (job->state == MBEDTLS_SSL_ASYNC_JOB_IDLE) {
+        /* An empty signature is rejected at once, no need to queue it. */
+        if (ssl->conf->f_async_job_start == NULL || sig_len == 0) {
+            return mbedtls_pk_verify_ext(type, options, pk, md_alg,
+                                         hash, hash_len, sig, sig_len);
+        }
+        if (hash_len > sizeof(job->hash)) {
+            return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+        }
+
+        /* The signature lives in the input buffer, which may be reused
+         * while the job is running. */
+        job->sig = mbedtls_calloc(1, sig_len);
+        if (job->sig == NULL) {
+            return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+        }
+        memcpy(job->sig, sig, sig_len);
+        job->sig_len = sig_len;
+
+        job->type = MBEDTLS_SSL_ASYNC_JOB_VERIFY;
+        job->pk = pk;
+        job->pk_type = type;
+#if defined(MBEDTLS_X509_RSASSA_PSS_SUPPORT)
+        if (options != NULL) {
+            job->pss_options = *(const mbedtls_pk_rsassa_pss_options *) options;
+            job->use_pss_options = 1;
+        }
+#endif
+        job->md_alg = md_alg;
+        memcpy(job->hash, hash, hash_len);
+        job->hash_len = hash_len;
+    } else if (job->type != MBEDTLS_SSL_ASYNC_JOB_VERIFY) {
+        return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+
+    ret = ssl_async_job_step(ssl);
+    if (ret != 0) {
+        return ret;
+    }
+
+    ret = job->ret;
+    ssl_async_job_reset(job);
+
+    return ret;
+}
+
+int mbedtls_ssl_async_job_is_pending(const mbedtls_ssl_context *ssl,
+                                     mbedtls_ssl_async_job_type type)
+{
+    return ssl->handshake != NULL &&
+           ssl->handshake->async_job.type == type &&
+           ssl->handshake->async_job.state != MBEDTLS_SSL_ASYNC_JOB_IDLE;
+}
+
+void mbedtls_ssl_async_job_free(mbedtls_ssl_context *ssl)
+{
+    mbedtls_ssl_async_job *job = &ssl->handshake->async_job;
+
+    if (job->state == MBEDTLS_SSL_ASYNC_JOB_QUEUED &&
+        ssl->conf->f_async_job_cancel != NULL) {
+        ssl->conf->f_async_job_cancel(ssl->conf->p_async_job, job);
+    }
+
+    ssl_async_job_reset(job);
+}
+
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
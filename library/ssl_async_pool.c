@@ -0,0 +1,314 @@
+/*
+ *  Worker thread pool for asynchronous SSL crypto operations
+ *
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+/*
+ * Jobs are kept in a FIFO of entries allocated by the start callback and
+ * freed by the poll callback once the job has run, or by the cancel
+ * callback. The entry is found from the job through its backend data.
+ *
+ * Every entry is also on the list of live entries of the pool until it is
+ * freed. When the pool is freed, the workers first run the jobs left in the
+ * queue, then the live entries are marked orphaned: the job keeps pointing
+ * to its entry, and a later poll or cancel frees the entry without touching
+ * the pool.
+ */
+
+#include "ssl_misc.h"
+
+#if defined(MBEDTLS_SSL_ASYNC_POOL_C)
+
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/ssl_async_pool.h"
+#include "mbedtls/error.h"
+
+#include <string.h>
+
+#define SSL_ASYNC_POOL_QUEUED   0
+#define SSL_ASYNC_POOL_RUNNING  1
+#define SSL_ASYNC_POOL_DONE     2
+
+struct mbedtls_ssl_async_pool_entry {
+    mbedtls_ssl_async_job *job;
+    int state;
+    int orphaned;                           /* only set once workers exit */
+    mbedtls_ssl_async_pool_entry *next;     /* in the queue               */
+    mbedtls_ssl_async_pool_entry *live_prev;
+    mbedtls_ssl_async_pool_entry *live_next;
+};
+
+/* Unlink an entry from the live list. Called with the mutex held. */
+static void ssl_async_pool_unlink(mbedtls_ssl_async_pool *pool,
+                                  mbedtls_ssl_async_pool_entry *entry)
+{
+    if (entry->live_prev != NULL) {
+        entry->live_prev->live_next = entry->live_next;
+    } else {
+        pool->live = entry->live_next;
+    }
+    if (entry->live_next != NULL) {
+        entry->live_next->live_prev = entry->live_prev;
+    }
+}
+
+/* Free the entry of a job whose pool has been freed. Since the workers have
+ * run all queued jobs before exiting, the job has completed. */
+static void ssl_async_pool_release_orphan(mbedtls_ssl_async_job *job,
+                                          mbedtls_ssl_async_pool_entry *entry)
+{
+    mbedtls_ssl_async_job_set_backend_data(job, NULL);
+    mbedtls_free(entry);
+}
+
+void mbedtls_ssl_async_pool_init(mbedtls_ssl_async_pool *pool)
+{
+    memset(pool, 0, sizeof(mbedtls_ssl_async_pool));
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+}
+
+static void *ssl_async_pool_worker(void *arg)
+{
+    mbedtls_ssl_async_pool *pool = arg;
+    mbedtls_ssl_async_pool_entry *entry;
+    mbedtls_ssl_async_pool_notify_t *f_notify;
+    void *p_notify;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (pool->head == NULL && !pool->shutdown) {
+            pthread_cond_wait(&pool->work, &pool->mutex);
+        }
+        if (pool->head == NULL) {
+            break;
+        }
+
+        entry = pool->head;
+        pool->head = entry->next;
+        if (pool->head == NULL) {
+            pool->tail = NULL;
+        }
+        entry->next = NULL;
+        entry->state = SSL_ASYNC_POOL_RUNNING;
+        pthread_mutex_unlock(&pool->mutex);
+
+        (void) mbedtls_ssl_async_job_run(entry->job);
+
+        pthread_mutex_lock(&pool->mutex);
+        entry->state = SSL_ASYNC_POOL_DONE;
+        pthread_cond_broadcast(&pool->done);
+
+        /* Once the job is marked done, the entry may be freed by a poll on
+         * another thread, so only the pool is used from here on. */
+        f_notify = pool->f_notify;
+        p_notify = pool->p_notify;
+        if (f_notify != NULL) {
+            pthread_mutex_unlock(&pool->mutex);
+            f_notify(p_notify);
+            pthread_mutex_lock(&pool->mutex);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+/* Stop and join the first count threads. Called without the mutex held. */
+static void ssl_async_pool_stop(mbedtls_ssl_async_pool *pool, size_t count)
+{
+    size_t i;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (i = 0; i < count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+}
+
+int mbedtls_ssl_async_pool_setup(mbedtls_ssl_async_pool *pool, size_t threads)
+{
+    size_t i;
+
+    if (pool->threads != NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (threads == 0) {
+        threads = MBEDTLS_SSL_ASYNC_POOL_DEFAULT_THREADS;
+    }
+
+    pool->threads = mbedtls_calloc(threads, sizeof(pthread_t));
+    if (pool->threads == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    for (i = 0; i < threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL,
+                           ssl_async_pool_worker, pool) != 0) {
+            ssl_async_pool_stop(pool, i);
+            mbedtls_free(pool->threads);
+            pool->threads = NULL;
+            pool->shutdown = 0;
+            return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+        }
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->thread_count = threads;
+    pthread_mutex_unlock(&pool->mutex);
+
+    return 0;
+}
+
+void mbedtls_ssl_async_pool_set_notify(mbedtls_ssl_async_pool *pool,
+                                       mbedtls_ssl_async_pool_notify_t *f_notify,
+                                       void *p_notify)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->f_notify = f_notify;
+    pool->p_notify = p_notify;
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+int mbedtls_ssl_async_pool_start(void *p_ctx, mbedtls_ssl_async_job *job)
+{
+    mbedtls_ssl_async_pool *pool = p_ctx;
+    mbedtls_ssl_async_pool_entry *entry;
+
+    entry = mbedtls_calloc(1, sizeof(mbedtls_ssl_async_pool_entry));
+    if (entry == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+    entry->job = job;
+    entry->state = SSL_ASYNC_POOL_QUEUED;
+
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->thread_count == 0 || pool->shutdown) {
+        pthread_mutex_unlock(&pool->mutex);
+        mbedtls_free(entry);
+        return MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH;
+    }
+
+    mbedtls_ssl_async_job_set_backend_data(job, entry);
+    entry->live_next = pool->live;
+    if (pool->live != NULL) {
+        pool->live->live_prev = entry;
+    }
+    pool->live = entry;
+    if (pool->tail != NULL) {
+        pool->tail->next = entry;
+    } else {
+        pool->head = entry;
+    }
+    pool->tail = entry;
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->mutex);
+
+    return 0;
+}
+
+int mbedtls_ssl_async_pool_poll(void *p_ctx, mbedtls_ssl_async_job *job)
+{
+    mbedtls_ssl_async_pool *pool = p_ctx;
+    mbedtls_ssl_async_pool_entry *entry;
+    int ret = MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS;
+
+    /* The backend data is only changed by the thread driving the job. */
+    entry = mbedtls_ssl_async_job_get_backend_data(job);
+    if (entry == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    if (entry->orphaned) {
+        ssl_async_pool_release_orphan(job, entry);
+        return 0;
+    }
+
+    /* Taking the mutex also makes the worker's results visible here. */
+    pthread_mutex_lock(&pool->mutex);
+    if (entry->state == SSL_ASYNC_POOL_DONE) {
+        ssl_async_pool_unlink(pool, entry);
+        mbedtls_ssl_async_job_set_backend_data(job, NULL);
+        mbedtls_free(entry);
+        ret = 0;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return ret;
+}
+
+void mbedtls_ssl_async_pool_cancel(void *p_ctx, mbedtls_ssl_async_job *job)
+{
+    mbedtls_ssl_async_pool *pool = p_ctx;
+    mbedtls_ssl_async_pool_entry *entry, **prev, *before = NULL;
+
+    entry = mbedtls_ssl_async_job_get_backend_data(job);
+    if (entry == NULL) {
+        return;
+    }
+    if (entry->orphaned) {
+        ssl_async_pool_release_orphan(job, entry);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    if (entry->state == SSL_ASYNC_POOL_QUEUED) {
+        /* Not picked up by a worker yet: unlink it. */
+        for (prev = &pool->head; *prev != entry; prev = &(*prev)->next) {
+            before = *prev;
+        }
+        *prev = entry->next;
+        if (pool->tail == entry) {
+            pool->tail = before;
+        }
+    } else {
+        while (entry->state != SSL_ASYNC_POOL_DONE) {
+            pthread_cond_wait(&pool->done, &pool->mutex);
+        }
+    }
+
+    ssl_async_pool_unlink(pool, entry);
+    mbedtls_ssl_async_job_set_backend_data(job, NULL);
+    mbedtls_free(entry);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+void mbedtls_ssl_async_pool_free(mbedtls_ssl_async_pool *pool)
+{
+    mbedtls_ssl_async_pool_entry *entry, *next;
+
+    if (pool == NULL) {
+        return;
+    }
+
+    /* The workers only exit once the queue is empty, so every job that was
+     * started has completed after this. */
+    if (pool->threads != NULL) {
+        ssl_async_pool_stop(pool, pool->thread_count);
+        mbedtls_free(pool->threads);
+    }
+
+    /* The jobs still point to their entry: leave it to their poll or
+     * cancel, which will no longer use the pool. */
+    for (entry = pool->live; entry != NULL; entry = next) {
+        next = entry->live_next;
+        entry->live_prev = NULL;
+        entry->live_next = NULL;
+        entry->orphaned = 1;
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->mutex);
+
+    mbedtls_platform_zeroize(pool, sizeof(mbedtls_ssl_async_pool));
+}
+
+#endif /* MBEDTLS_SSL_ASYNC_POOL_C */
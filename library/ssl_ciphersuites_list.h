@@ -0,0 +1,1211 @@
+/**
+ * \file ssl_ciphersuites_list.h
+ *
+ * \brief Definitions of the ciphersuites supported by the build
+ *
+ * This file is included several times by ssl_ciphersuites.c, each time with
+ * a different definition of MBEDTLS_SSL_CIPHERSUITE(), to build the table of
+ * definitions and the index of their positions from the same list. It has
+ * no include guard on purpose.
+ */
+/*
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+
+/* MBEDTLS_SSL_CIPHERSUITE(id, name, cipher, mac, key_exchange, flags,
+ *                         min_tls_version, max_tls_version) */
+
+#if defined(MBEDTLS_CIPHER_NULL_CIPHER) && \
+    defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && defined(PSA_WANT_ALG_MD5)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_NULL_MD5,
+                        "TLS-RSA-WITH-NULL-MD5",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_MD5,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_CIPHER_NULL_CIPHER) && \
+    defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && defined(PSA_WANT_ALG_SHA_1)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_NULL_SHA,
+                        "TLS-RSA-WITH-NULL-SHA",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_CIPHER_NULL_CIPHER) && \
+    defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && defined(PSA_WANT_ALG_SHA_1)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_NULL_SHA,
+                        "TLS-PSK-WITH-NULL-SHA",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_1) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_AES_128_CBC_SHA,
+                        "TLS-RSA-WITH-AES-128-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_AES_256_CBC_SHA,
+                        "TLS-RSA-WITH-AES-256-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_CIPHER_NULL_CIPHER) && \
+    defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_NULL_SHA256,
+                        "TLS-RSA-WITH-NULL-SHA256",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_256) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_AES_128_CBC_SHA256,
+                        "TLS-RSA-WITH-AES-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_AES_256_CBC_SHA256,
+                        "TLS-RSA-WITH-AES-256-CBC-SHA256",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_1)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_CAMELLIA_128_CBC_SHA,
+                        "TLS-RSA-WITH-CAMELLIA-128-CBC-SHA",
+                        MBEDTLS_CIPHER_CAMELLIA_128_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_CAMELLIA_256_CBC_SHA,
+                        "TLS-RSA-WITH-CAMELLIA-256-CBC-SHA",
+                        MBEDTLS_CIPHER_CAMELLIA_256_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_CBC_NO_PADDING) && \
+    defined(PSA_WANT_ALG_SHA_1)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_AES_128_CBC_SHA,
+                        "TLS-PSK-WITH-AES-128-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_AES_256_CBC_SHA,
+                        "TLS-PSK-WITH-AES-256-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_256) && \
+    defined(PSA_WANT_ALG_GCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_AES_128_GCM_SHA256,
+                        "TLS-RSA-WITH-AES-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_AES_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_384) && \
+    defined(PSA_WANT_ALG_GCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_AES_256_GCM_SHA384,
+                        "TLS-RSA-WITH-AES-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_AES_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_AES_128_GCM_SHA256,
+                        "TLS-PSK-WITH-AES-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_AES_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_AES_256_GCM_SHA384,
+                        "TLS-PSK-WITH-AES-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_AES_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_CBC_NO_PADDING) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_AES_128_CBC_SHA256,
+                        "TLS-PSK-WITH-AES-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_CBC_NO_PADDING) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_AES_256_CBC_SHA384,
+                        "TLS-PSK-WITH-AES-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_CIPHER_NULL_CIPHER) && \
+    defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_NULL_SHA256,
+                        "TLS-PSK-WITH-NULL-SHA256",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_CIPHER_NULL_CIPHER) && \
+    defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_NULL_SHA384,
+                        "TLS-PSK-WITH-NULL-SHA384",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_CAMELLIA_128_CBC_SHA256,
+                        "TLS-RSA-WITH-CAMELLIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_CAMELLIA_256_CBC_SHA256,
+                        "TLS-RSA-WITH-CAMELLIA-256-CBC-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_256_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3) && defined(PSA_WANT_KEY_TYPE_AES) && \
+    defined(PSA_WANT_ALG_GCM) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS1_3_AES_128_GCM_SHA256,
+                        "TLS1-3-AES-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_AES_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_NONE, /* not part of the ciphersuite in TLS 1.3 */
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_3, MBEDTLS_SSL_VERSION_TLS1_3)
+#endif
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3) && defined(PSA_WANT_KEY_TYPE_AES) && \
+    defined(PSA_WANT_ALG_GCM) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS1_3_AES_256_GCM_SHA384,
+                        "TLS1-3-AES-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_AES_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_NONE, /* not part of the ciphersuite in TLS 1.3 */
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_3, MBEDTLS_SSL_VERSION_TLS1_3)
+#endif
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3) && \
+    defined(PSA_WANT_ALG_CHACHA20_POLY1305) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS1_3_CHACHA20_POLY1305_SHA256,
+                        "TLS1-3-CHACHA20-POLY1305-SHA256",
+                        MBEDTLS_CIPHER_CHACHA20_POLY1305, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_NONE, /* not part of the ciphersuite in TLS 1.3 */
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_3, MBEDTLS_SSL_VERSION_TLS1_3)
+#endif
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3) && defined(PSA_WANT_KEY_TYPE_AES) && \
+    defined(PSA_WANT_ALG_CCM) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS1_3_AES_128_CCM_SHA256,
+                        "TLS1-3-AES-128-CCM-SHA256",
+                        MBEDTLS_CIPHER_AES_128_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_NONE, /* not part of the ciphersuite in TLS 1.3 */
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_3, MBEDTLS_SSL_VERSION_TLS1_3)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS1_3_AES_128_CCM_8_SHA256,
+                        "TLS1-3-AES-128-CCM-8-SHA256",
+                        MBEDTLS_CIPHER_AES_128_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_NONE, /* not part of the ciphersuite in TLS 1.3 */
+                        MBEDTLS_CIPHERSUITE_SHORT_TAG,
+                        MBEDTLS_SSL_VERSION_TLS1_3, MBEDTLS_SSL_VERSION_TLS1_3)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(MBEDTLS_CIPHER_NULL_CIPHER) && defined(PSA_WANT_ALG_SHA_1)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_NULL_SHA,
+                        "TLS-ECDH-ECDSA-WITH-NULL-SHA",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_1) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_AES_128_CBC_SHA,
+                        "TLS-ECDH-ECDSA-WITH-AES-128-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_AES_256_CBC_SHA,
+                        "TLS-ECDH-ECDSA-WITH-AES-256-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(MBEDTLS_CIPHER_NULL_CIPHER) && defined(PSA_WANT_ALG_SHA_1)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_NULL_SHA,
+                        "TLS-ECDHE-ECDSA-WITH-NULL-SHA",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_1) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA,
+                        "TLS-ECDHE-ECDSA-WITH-AES-128-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA,
+                        "TLS-ECDHE-ECDSA-WITH-AES-256-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(MBEDTLS_CIPHER_NULL_CIPHER) && defined(PSA_WANT_ALG_SHA_1)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_NULL_SHA,
+                        "TLS-ECDH-RSA-WITH-NULL-SHA",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_1) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_AES_128_CBC_SHA,
+                        "TLS-ECDH-RSA-WITH-AES-128-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_AES_256_CBC_SHA,
+                        "TLS-ECDH-RSA-WITH-AES-256-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(MBEDTLS_CIPHER_NULL_CIPHER) && defined(PSA_WANT_ALG_SHA_1)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_NULL_SHA,
+                        "TLS-ECDHE-RSA-WITH-NULL-SHA",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_1) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA,
+                        "TLS-ECDHE-RSA-WITH-AES-128-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA,
+                        "TLS-ECDHE-RSA-WITH-AES-256-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_256) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256,
+                        "TLS-ECDHE-ECDSA-WITH-AES-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_384) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA384,
+                        "TLS-ECDHE-ECDSA-WITH-AES-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_256) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_AES_128_CBC_SHA256,
+                        "TLS-ECDH-ECDSA-WITH-AES-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_384) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_AES_256_CBC_SHA384,
+                        "TLS-ECDH-ECDSA-WITH-AES-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_256) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256,
+                        "TLS-ECDHE-RSA-WITH-AES-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_384) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA384,
+                        "TLS-ECDHE-RSA-WITH-AES-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_256) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_AES_128_CBC_SHA256,
+                        "TLS-ECDH-RSA-WITH-AES-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_384) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_AES_256_CBC_SHA384,
+                        "TLS-ECDH-RSA-WITH-AES-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_256) && \
+    defined(PSA_WANT_ALG_GCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+                        "TLS-ECDHE-ECDSA-WITH-AES-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_AES_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_384) && \
+    defined(PSA_WANT_ALG_GCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384,
+                        "TLS-ECDHE-ECDSA-WITH-AES-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_AES_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_256) && \
+    defined(PSA_WANT_ALG_GCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_AES_128_GCM_SHA256,
+                        "TLS-ECDH-ECDSA-WITH-AES-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_AES_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_384) && \
+    defined(PSA_WANT_ALG_GCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_AES_256_GCM_SHA384,
+                        "TLS-ECDH-ECDSA-WITH-AES-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_AES_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_256) && \
+    defined(PSA_WANT_ALG_GCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+                        "TLS-ECDHE-RSA-WITH-AES-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_AES_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_384) && \
+    defined(PSA_WANT_ALG_GCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384,
+                        "TLS-ECDHE-RSA-WITH-AES-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_AES_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_256) && \
+    defined(PSA_WANT_ALG_GCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_AES_128_GCM_SHA256,
+                        "TLS-ECDH-RSA-WITH-AES-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_AES_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_SHA_384) && \
+    defined(PSA_WANT_ALG_GCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_AES_256_GCM_SHA384,
+                        "TLS-ECDH-RSA-WITH-AES-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_AES_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_CBC_NO_PADDING) && \
+    defined(PSA_WANT_ALG_SHA_1)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA,
+                        "TLS-ECDHE-PSK-WITH-AES-128-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_AES_256_CBC_SHA,
+                        "TLS-ECDHE-PSK-WITH-AES-256-CBC-SHA",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_CBC_NO_PADDING) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256,
+                        "TLS-ECDHE-PSK-WITH-AES-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_AES_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_CBC_NO_PADDING) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_AES_256_CBC_SHA384,
+                        "TLS-ECDHE-PSK-WITH-AES-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_AES_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_CIPHER_NULL_CIPHER) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED) && \
+    defined(PSA_WANT_ALG_SHA_1)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_NULL_SHA,
+                        "TLS-ECDHE-PSK-WITH-NULL-SHA",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA1,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_CIPHER_NULL_CIPHER) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_NULL_SHA256,
+                        "TLS-ECDHE-PSK-WITH-NULL-SHA256",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_CIPHER_NULL_CIPHER) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_NULL_SHA384,
+                        "TLS-ECDHE-PSK-WITH-NULL-SHA384",
+                        MBEDTLS_CIPHER_NULL, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        MBEDTLS_CIPHERSUITE_WEAK,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_ARIA_128_CBC_SHA256,
+                        "TLS-RSA-WITH-ARIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_ARIA_256_CBC_SHA384,
+                        "TLS-RSA-WITH-ARIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_ARIA_128_CBC_SHA256,
+                        "TLS-ECDHE-ECDSA-WITH-ARIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_ARIA_256_CBC_SHA384,
+                        "TLS-ECDHE-ECDSA-WITH-ARIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_ARIA_128_CBC_SHA256,
+                        "TLS-ECDH-ECDSA-WITH-ARIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_ARIA_256_CBC_SHA384,
+                        "TLS-ECDH-ECDSA-WITH-ARIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_ARIA_128_CBC_SHA256,
+                        "TLS-ECDHE-RSA-WITH-ARIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_ARIA_256_CBC_SHA384,
+                        "TLS-ECDHE-RSA-WITH-ARIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_ARIA_128_CBC_SHA256,
+                        "TLS-ECDH-RSA-WITH-ARIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_ARIA_256_CBC_SHA384,
+                        "TLS-ECDH-RSA-WITH-ARIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_ARIA_128_GCM_SHA256,
+                        "TLS-RSA-WITH-ARIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_ARIA_256_GCM_SHA384,
+                        "TLS-RSA-WITH-ARIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_ALG_GCM) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_ARIA_128_GCM_SHA256,
+                        "TLS-ECDHE-ECDSA-WITH-ARIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_ALG_GCM) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_ARIA_256_GCM_SHA384,
+                        "TLS-ECDHE-ECDSA-WITH-ARIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_ALG_GCM) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_ARIA_128_GCM_SHA256,
+                        "TLS-ECDH-ECDSA-WITH-ARIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_ALG_GCM) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_ARIA_256_GCM_SHA384,
+                        "TLS-ECDH-ECDSA-WITH-ARIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_ALG_GCM) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_ARIA_128_GCM_SHA256,
+                        "TLS-ECDHE-RSA-WITH-ARIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_ALG_GCM) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_ARIA_256_GCM_SHA384,
+                        "TLS-ECDHE-RSA-WITH-ARIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_ALG_GCM) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_ARIA_128_GCM_SHA256,
+                        "TLS-ECDH-RSA-WITH-ARIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_ALG_GCM) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_ARIA_256_GCM_SHA384,
+                        "TLS-ECDH-RSA-WITH-ARIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_ARIA_128_CBC_SHA256,
+                        "TLS-PSK-WITH-ARIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_ARIA_256_CBC_SHA384,
+                        "TLS-PSK-WITH-ARIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_ARIA_128_GCM_SHA256,
+                        "TLS-PSK-WITH-ARIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_ARIA_256_GCM_SHA384,
+                        "TLS-PSK-WITH-ARIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_ARIA_128_CBC_SHA256,
+                        "TLS-ECDHE-PSK-WITH-ARIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_ARIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_KEY_TYPE_ARIA) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_ARIA_256_CBC_SHA384,
+                        "TLS-ECDHE-PSK-WITH-ARIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_ARIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_CAMELLIA_128_CBC_SHA256,
+                        "TLS-ECDHE-ECDSA-WITH-CAMELLIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_CAMELLIA_256_CBC_SHA384,
+                        "TLS-ECDHE-ECDSA-WITH-CAMELLIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_CAMELLIA_128_CBC_SHA256,
+                        "TLS-ECDH-ECDSA-WITH-CAMELLIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_CAMELLIA_256_CBC_SHA384,
+                        "TLS-ECDH-ECDSA-WITH-CAMELLIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_CAMELLIA_128_CBC_SHA256,
+                        "TLS-ECDHE-RSA-WITH-CAMELLIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_CAMELLIA_256_CBC_SHA384,
+                        "TLS-ECDHE-RSA-WITH-CAMELLIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_CAMELLIA_128_CBC_SHA256,
+                        "TLS-ECDH-RSA-WITH-CAMELLIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_CAMELLIA_256_CBC_SHA384,
+                        "TLS-ECDH-RSA-WITH-CAMELLIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_CAMELLIA_128_GCM_SHA256,
+                        "TLS-RSA-WITH-CAMELLIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_CAMELLIA_256_GCM_SHA384,
+                        "TLS-RSA-WITH-CAMELLIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_CAMELLIA_128_GCM_SHA256,
+                        "TLS-ECDHE-ECDSA-WITH-CAMELLIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_CAMELLIA_256_GCM_SHA384,
+                        "TLS-ECDHE-ECDSA-WITH-CAMELLIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_CAMELLIA_128_GCM_SHA256,
+                        "TLS-ECDH-ECDSA-WITH-CAMELLIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_ECDSA_WITH_CAMELLIA_256_GCM_SHA384,
+                        "TLS-ECDH-ECDSA-WITH-CAMELLIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_CAMELLIA_128_GCM_SHA256,
+                        "TLS-ECDHE-RSA-WITH-CAMELLIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_CAMELLIA_256_GCM_SHA384,
+                        "TLS-ECDHE-RSA-WITH-CAMELLIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_CAMELLIA_128_GCM_SHA256,
+                        "TLS-ECDH-RSA-WITH-CAMELLIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDH_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDH_RSA_WITH_CAMELLIA_256_GCM_SHA384,
+                        "TLS-ECDH-RSA-WITH-CAMELLIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDH_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_CAMELLIA_128_GCM_SHA256,
+                        "TLS-PSK-WITH-CAMELLIA-128-GCM-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_GCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && defined(PSA_WANT_ALG_GCM) && \
+    defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_CAMELLIA_256_GCM_SHA384,
+                        "TLS-PSK-WITH-CAMELLIA-256-GCM-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_GCM, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_CAMELLIA_128_CBC_SHA256,
+                        "TLS-PSK-WITH-CAMELLIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_CAMELLIA_256_CBC_SHA384,
+                        "TLS-PSK-WITH-CAMELLIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_256)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_CAMELLIA_128_CBC_SHA256,
+                        "TLS-ECDHE-PSK-WITH-CAMELLIA-128-CBC-SHA256",
+                        MBEDTLS_CIPHER_CAMELLIA_128_CBC, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_CAMELLIA) && \
+    defined(PSA_WANT_ALG_CBC_NO_PADDING) && defined(PSA_WANT_ALG_SHA_384)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_CAMELLIA_256_CBC_SHA384,
+                        "TLS-ECDHE-PSK-WITH-CAMELLIA-256-CBC-SHA384",
+                        MBEDTLS_CIPHER_CAMELLIA_256_CBC, MBEDTLS_MD_SHA384,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_RSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_CCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_AES_128_CCM,
+                        "TLS-RSA-WITH-AES-128-CCM",
+                        MBEDTLS_CIPHER_AES_128_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_AES_256_CCM,
+                        "TLS-RSA-WITH-AES-256-CCM",
+                        MBEDTLS_CIPHER_AES_256_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_AES_128_CCM_8,
+                        "TLS-RSA-WITH-AES-128-CCM-8",
+                        MBEDTLS_CIPHER_AES_128_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        MBEDTLS_CIPHERSUITE_SHORT_TAG,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_RSA_WITH_AES_256_CCM_8,
+                        "TLS-RSA-WITH-AES-256-CCM-8",
+                        MBEDTLS_CIPHER_AES_256_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_RSA,
+                        MBEDTLS_CIPHERSUITE_SHORT_TAG,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_CCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_AES_128_CCM,
+                        "TLS-PSK-WITH-AES-128-CCM",
+                        MBEDTLS_CIPHER_AES_128_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_AES_256_CCM,
+                        "TLS-PSK-WITH-AES-256-CCM",
+                        MBEDTLS_CIPHER_AES_256_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_AES_128_CCM_8,
+                        "TLS-PSK-WITH-AES-128-CCM-8",
+                        MBEDTLS_CIPHER_AES_128_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        MBEDTLS_CIPHERSUITE_SHORT_TAG,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_AES_256_CCM_8,
+                        "TLS-PSK-WITH-AES-256-CCM-8",
+                        MBEDTLS_CIPHER_AES_256_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        MBEDTLS_CIPHERSUITE_SHORT_TAG,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_CCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM,
+                        "TLS-ECDHE-ECDSA-WITH-AES-128-CCM",
+                        MBEDTLS_CIPHER_AES_128_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_256_CCM,
+                        "TLS-ECDHE-ECDSA-WITH-AES-256-CCM",
+                        MBEDTLS_CIPHER_AES_256_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8,
+                        "TLS-ECDHE-ECDSA-WITH-AES-128-CCM-8",
+                        MBEDTLS_CIPHER_AES_128_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        MBEDTLS_CIPHERSUITE_SHORT_TAG,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_256_CCM_8,
+                        "TLS-ECDHE-ECDSA-WITH-AES-256-CCM-8",
+                        MBEDTLS_CIPHER_AES_256_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        MBEDTLS_CIPHERSUITE_SHORT_TAG,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECJPAKE_ENABLED) && \
+    defined(PSA_WANT_KEY_TYPE_AES) && defined(PSA_WANT_ALG_CCM)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECJPAKE_WITH_AES_128_CCM_8,
+                        "TLS-ECJPAKE-WITH-AES-128-CCM-8",
+                        MBEDTLS_CIPHER_AES_128_CCM, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECJPAKE,
+                        MBEDTLS_CIPHERSUITE_SHORT_TAG,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_ALG_CHACHA20_POLY1305) && \
+    defined(PSA_WANT_ALG_SHA_256) && defined(MBEDTLS_SSL_PROTO_TLS1_2) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256,
+                        "TLS-ECDHE-RSA-WITH-CHACHA20-POLY1305-SHA256",
+                        MBEDTLS_CIPHER_CHACHA20_POLY1305, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_RSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_ALG_CHACHA20_POLY1305) && \
+    defined(PSA_WANT_ALG_SHA_256) && defined(MBEDTLS_SSL_PROTO_TLS1_2) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
+                        "TLS-ECDHE-ECDSA-WITH-CHACHA20-POLY1305-SHA256",
+                        MBEDTLS_CIPHER_CHACHA20_POLY1305, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_ALG_CHACHA20_POLY1305) && \
+    defined(PSA_WANT_ALG_SHA_256) && defined(MBEDTLS_SSL_PROTO_TLS1_2) && \
+    defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_PSK_WITH_CHACHA20_POLY1305_SHA256,
+                        "TLS-PSK-WITH-CHACHA20-POLY1305-SHA256",
+                        MBEDTLS_CIPHER_CHACHA20_POLY1305, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+#if defined(PSA_WANT_ALG_CHACHA20_POLY1305) && \
+    defined(PSA_WANT_ALG_SHA_256) && defined(MBEDTLS_SSL_PROTO_TLS1_2) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDHE_PSK_ENABLED)
+MBEDTLS_SSL_CIPHERSUITE(MBEDTLS_TLS_ECDHE_PSK_WITH_CHACHA20_POLY1305_SHA256,
+                        "TLS-ECDHE-PSK-WITH-CHACHA20-POLY1305-SHA256",
+                        MBEDTLS_CIPHER_CHACHA20_POLY1305, MBEDTLS_MD_SHA256,
+                        MBEDTLS_KEY_EXCHANGE_ECDHE_PSK,
+                        0,
+                        MBEDTLS_SSL_VERSION_TLS1_2, MBEDTLS_SSL_VERSION_TLS1_2)
+#endif
+
@@ -0,0 +1,325 @@
+/*
+ *  Context-free parsing of a TLS ClientHello
+ *
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+
+#include "ssl_misc.h"
+
+#if defined(MBEDTLS_SSL_CLIENT_HELLO_C)
+
+#include "mbedtls/ssl_client_hello.h"
+#include "mbedtls/error.h"
+
+#include <string.h>
+
+/* Check that at least n bytes are left between p and end. */
+#define SSL_CH_CHK(p, end, n)                                       \
+    do {                                                            \
+        if ((size_t) ((end) - (p)) < (size_t) (n)) {                \
+            return MBEDTLS_ERR_SSL_DECODE_ERROR;                    \
+        }                                                           \
+    } while (0)
+
+/* Extensions whose contents are returned to the caller. */
+#define SSL_CH_RETURNED_EXTS                                        \
+    (MBEDTLS_SSL_EXT_MASK(SERVERNAME) |                             \
+     MBEDTLS_SSL_EXT_MASK(ALPN) |                                   \
+     MBEDTLS_SSL_EXT_MASK(SUPPORTED_VERSIONS) |                     \
+     MBEDTLS_SSL_EXT_MASK(SESSION_TICKET) |                         \
+     MBEDTLS_SSL_EXT_MASK(PRE_SHARED_KEY))
+
+/*
+ * struct {
+ *     ServerNameList server_name_list<1..2^16-1>;
+ * } ServerNameList;
+ *
+ * Return the first host_name of the list.
+ */
+static int ssl_ch_parse_server_name(const unsigned char *p,
+                                    const unsigned char *end,
+                                    mbedtls_ssl_client_hello *hello)
+{
+    size_t list_len, name_len;
+
+    SSL_CH_CHK(p, end, 2);
+    list_len = MBEDTLS_GET_UINT16_BE(p, 0);
+    p += 2;
+    if (list_len != (size_t) (end - p)) {
+        return MBEDTLS_ERR_SSL_DECODE_ERROR;
+    }
+
+    while (p < end) {
+        SSL_CH_CHK(p, end, 3);
+        name_len = MBEDTLS_GET_UINT16_BE(p, 1);
+        SSL_CH_CHK(p + 3, end, name_len);
+        if (p[0] == MBEDTLS_TLS_EXT_SERVERNAME_HOSTNAME &&
+            hello->server_name == NULL) {
+            hello->server_name = p + 3;
+            hello->server_name_len = name_len;
+        }
+        p += 3 + name_len;
+    }
+
+    return 0;
+}
+
+/*
+ * opaque ProtocolName<1..2^8-1>;
+ *
+ * struct {
+ *     ProtocolName protocol_name_list<2..2^16-1>
+ * } ProtocolNameList;
+ */
+static int ssl_ch_parse_alpn(const unsigned char *p,
+                             const unsigned char *end,
+                             mbedtls_ssl_client_hello *hello)
+{
+    size_t list_len;
+
+    SSL_CH_CHK(p, end, 2);
+    list_len = MBEDTLS_GET_UINT16_BE(p, 0);
+    p += 2;
+    if (list_len < 2 || list_len != (size_t) (end - p)) {
+        return MBEDTLS_ERR_SSL_DECODE_ERROR;
+    }
+
+    hello->alpn_list = p;
+    hello->alpn_list_len = list_len;
+
+    while (p < end) {
+        if (p[0] == 0) {
+            return MBEDTLS_ERR_SSL_DECODE_ERROR;
+        }
+        SSL_CH_CHK(p + 1, end, p[0]);
+        p += 1 + p[0];
+    }
+
+    return 0;
+}
+
+/*
+ * struct {
+ *     ProtocolVersion versions<2..254>;
+ * } SupportedVersions;
+ */
+static int ssl_ch_parse_supported_versions(const unsigned char *p,
+                                           const unsigned char *end,
+                                           mbedtls_ssl_client_hello *hello)
+{
+    size_t list_len;
+
+    SSL_CH_CHK(p, end, 1);
+    list_len = p[0];
+    p += 1;
+    if (list_len < 2 || list_len % 2 != 0 ||
+        list_len != (size_t) (end - p)) {
+        return MBEDTLS_ERR_SSL_DECODE_ERROR;
+    }
+
+    hello->versions = p;
+    hello->versions_len = list_len;
+
+    return 0;
+}
+
+static mbedtls_ssl_protocol_version ssl_ch_max_version(
+    const mbedtls_ssl_client_hello *hello, unsigned int legacy_version)
+{
+    mbedtls_ssl_protocol_version max = MBEDTLS_SSL_VERSION_UNKNOWN;
+    unsigned int version;
+    size_t i;
+
+    if (hello->versions == NULL) {
+        return legacy_version >= MBEDTLS_SSL_VERSION_TLS1_2 ?
+               MBEDTLS_SSL_VERSION_TLS1_2 : MBEDTLS_SSL_VERSION_UNKNOWN;
+    }
+
+    /* Ignore the versions that we do not know, such as GREASE values. */
+    for (i = 0; i < hello->versions_len; i += 2) {
+        version = MBEDTLS_GET_UINT16_BE(hello->versions, i);
+        if ((version == MBEDTLS_SSL_VERSION_TLS1_2 ||
+             version == MBEDTLS_SSL_VERSION_TLS1_3) && version > max) {
+            max = (mbedtls_ssl_protocol_version) version;
+        }
+    }
+
+    return max;
+}
+
+int mbedtls_ssl_client_hello_parse(const unsigned char *buf, size_t len,
+                                   mbedtls_ssl_client_hello *hello)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    const unsigned char *p, *end;
+    size_t record_len, msg_len, n;
+    unsigned int legacy_version;
+    uint32_t received_exts = MBEDTLS_SSL_EXT_MASK_NONE;
+
+    memset(hello, 0, sizeof(mbedtls_ssl_client_hello));
+
+    /*
+     * struct {
+     *     ContentType type;
+     *     ProtocolVersion legacy_record_version;
+     *     uint16 length;
+     *     opaque fragment[TLSPlaintext.length];
+     * } TLSPlaintext;
+     */
+    if (len < 5) {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    }
+    record_len = MBEDTLS_GET_UINT16_BE(buf, 3);
+    /* RFC 8446 section 5.1: the length MUST NOT exceed 2^14 bytes. */
+    if (buf[0] != MBEDTLS_SSL_MSG_HANDSHAKE || buf[1] != 0x03 ||
+        record_len == 0 || record_len > 16384) {
+        return MBEDTLS_ERR_SSL_INVALID_RECORD;
+    }
+    if (len - 5 < record_len) {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    }
+    p = buf + 5;
+    end = p + record_len;
+
+    /*
+     * struct {
+     *     HandshakeType msg_type;
+     *     uint24 length;
+     *     ...
+     * } Handshake;
+     */
+    if (p[0] != MBEDTLS_SSL_HS_CLIENT_HELLO) {
+        return MBEDTLS_ERR_SSL_UNEXPECTED_MESSAGE;
+    }
+    SSL_CH_CHK(p, end, 4);
+    msg_len = MBEDTLS_GET_UINT24_BE(p, 1);
+    p += 4;
+    if (msg_len > (size_t) (end - p)) {
+        return MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE;
+    }
+    end = p + msg_len;
+
+    /*
+     * struct {
+     *     ProtocolVersion legacy_version;
+     *     Random random;
+     *     opaque legacy_session_id<0..32>;
+     *     CipherSuite cipher_suites<2..2^16-2>;
+     *     opaque legacy_compression_methods<1..2^8-1>;
+     *     Extension extensions<0..2^16-1>;
+     * } ClientHello;
+     */
+    SSL_CH_CHK(p, end, 2 + 32 + 1);
+    legacy_version = MBEDTLS_GET_UINT16_BE(p, 0);
+    hello->random = p + 2;
+    p += 2 + 32;
+
+    n = p[0];
+    if (n > 32) {
+        return MBEDTLS_ERR_SSL_DECODE_ERROR;
+    }
+    SSL_CH_CHK(p + 1, end, n + 2);
+    if (n != 0) {
+        hello->session_id = p + 1;
+        hello->session_id_len = n;
+    }
+    p += 1 + n;
+
+    n = MBEDTLS_GET_UINT16_BE(p, 0);
+    if (n < 2 || n % 2 != 0) {
+        return MBEDTLS_ERR_SSL_DECODE_ERROR;
+    }
+    SSL_CH_CHK(p + 2, end, n + 1);
+    hello->ciphersuites = p + 2;
+    hello->ciphersuites_len = n;
+    p += 2 + n;
+
+    n = p[0];
+    if (n == 0) {
+        return MBEDTLS_ERR_SSL_DECODE_ERROR;
+    }
+    SSL_CH_CHK(p + 1, end, n);
+    p += 1 + n;
+
+    /* The extensions are optional before TLS 1.3. */
+    if (p < end) {
+        SSL_CH_CHK(p, end, 2);
+        n = MBEDTLS_GET_UINT16_BE(p, 0);
+        p += 2;
+        if (n != (size_t) (end - p)) {
+            return MBEDTLS_ERR_SSL_DECODE_ERROR;
+        }
+    }
+
+    /*
+     * struct {
+     *     ExtensionType extension_type;
+     *     opaque extension_data<0..2^16-1>;
+     * } Extension;
+     */
+    while (p < end) {
+        unsigned int extension_type;
+        uint32_t extension_mask;
+        const unsigned char *extension_data_end;
+
+        SSL_CH_CHK(p, end, 4);
+        extension_type = MBEDTLS_GET_UINT16_BE(p, 0);
+        n = MBEDTLS_GET_UINT16_BE(p, 2);
+        p += 4;
+        SSL_CH_CHK(p, end, n);
+        extension_data_end = p + n;
+
+        /* RFC 5246 section 7.4.1.4 and RFC 8446 section 4.2: there MUST
+         * NOT be more than one extension of the same type. Enforce it for
+         * the extensions that are returned, so that the caller cannot act
+         * on another occurrence than the handshake. */
+        extension_mask = mbedtls_ssl_get_extension_mask(extension_type) &
+                         SSL_CH_RETURNED_EXTS;
+        if ((received_exts & extension_mask) != 0) {
+            return MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER;
+        }
+        received_exts |= extension_mask;
+
+        switch (extension_type) {
+            case MBEDTLS_TLS_EXT_SERVERNAME:
+                ret = ssl_ch_parse_server_name(p, extension_data_end, hello);
+                break;
+
+            case MBEDTLS_TLS_EXT_ALPN:
+                ret = ssl_ch_parse_alpn(p, extension_data_end, hello);
+                break;
+
+            case MBEDTLS_TLS_EXT_SUPPORTED_VERSIONS:
+                ret = ssl_ch_parse_supported_versions(p, extension_data_end,
+                                                      hello);
+                break;
+
+            case MBEDTLS_TLS_EXT_SESSION_TICKET:
+                hello->session_ticket = p;
+                hello->session_ticket_len = n;
+                ret = 0;
+                break;
+
+            case MBEDTLS_TLS_EXT_PRE_SHARED_KEY:
+                hello->has_pre_shared_key = 1;
+                ret = 0;
+                break;
+
+            default:
+                ret = 0;
+                break;
+        }
+        if (ret != 0) {
+            return ret;
+        }
+
+        p = extension_data_end;
+    }
+
+    hello->max_version = ssl_ch_max_version(hello, legacy_version);
+
+    return 0;
+}
+
+#endif /* MBEDTLS_SSL_CLIENT_HELLO_C */
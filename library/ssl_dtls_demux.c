@@ -0,0 +1,744 @@
+/*
+ *  DTLS server demultiplexer
+ *
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+/*
+ * Peers are kept in two chained hash tables sharing the same nodes: one
+ * keyed by the socket address of the peer, one keyed by the Connection ID
+ * the peer was told to put in its records. The hash is seeded with a
+ * secret so that bucket placement is not predictable, although inserting
+ * a peer already requires a cookie round-trip from its address.
+ *
+ * The same nodes are also on a list ordered by the time their last datagram
+ * arrived, so that idle peers can be evicted from its tail, as well as the
+ * least recently seen peer when the table is full.
+ */
+
+#include "ssl_misc.h"
+
+#if defined(MBEDTLS_SSL_DTLS_DEMUX_C)
+
+#include "mbedtls/platform.h"
+
+#include "mbedtls/ssl_dtls_demux.h"
+#include "mbedtls/debug.h"
+#include "mbedtls/error.h"
+#include "mbedtls/platform_util.h"
+
+#include "debug_internal.h"
+
+#include <string.h>
+
+/* Largest HelloVerifyRequest: 13 (record header) + 12 (handshake header)
+ * + 2 (version) + 1 (cookie length) + 255 (cookie) */
+#define DEMUX_HVR_MAX_LEN   283
+
+/* DTLS 1.2 record header up to the Connection ID */
+#define DEMUX_CID_OFFSET    11
+
+struct mbedtls_ssl_dtls_demux_peer {
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_dtls_demux *demux;
+    mbedtls_net_addr addr;
+    mbedtls_ssl_dtls_demux_peer *next_by_addr;
+
+    mbedtls_ssl_dtls_demux_peer *lru_prev;  /* seen more recently */
+    mbedtls_ssl_dtls_demux_peer *lru_next;  /* seen less recently */
+#if defined(MBEDTLS_HAVE_TIME)
+    mbedtls_ms_time_t last_seen;
+#endif
+
+    const unsigned char *in;                /* datagram routed to this peer */
+    size_t in_len;
+
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    mbedtls_ssl_dtls_demux_peer *next_by_cid;
+    unsigned char cid[MBEDTLS_SSL_CID_IN_LEN_MAX];
+    size_t cid_len;
+
+#if defined(MBEDTLS_SSL_DTLS_ANTI_REPLAY)
+    /* A record with our CID arrived from another address. The peer is
+     * moved there only once that record has been authenticated. */
+    int migrating;
+    mbedtls_net_addr new_addr;
+    uint16_t new_addr_epoch;
+    uint64_t new_addr_seq;
+#endif
+#endif /* MBEDTLS_SSL_DTLS_CONNECTION_ID */
+};
+
+/*
+ * Seeded FNV-1a
+ */
+static size_t demux_hash(const mbedtls_ssl_dtls_demux *demux,
+                         const unsigned char *p, size_t len)
+{
+    uint32_t h = 2166136261u ^ demux->hash_key;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+
+    return (size_t) h & demux->bucket_mask;
+}
+
+static int demux_addr_equal(const mbedtls_net_addr *a,
+                            const mbedtls_net_addr *b)
+{
+    return a->len == b->len && memcmp(a->addr, b->addr, a->len) == 0;
+}
+
+static void demux_link_addr(mbedtls_ssl_dtls_demux *demux,
+                            mbedtls_ssl_dtls_demux_peer *peer)
+{
+    size_t h = demux_hash(demux, peer->addr.addr, peer->addr.len);
+
+    peer->next_by_addr = demux->by_addr[h];
+    demux->by_addr[h] = peer;
+}
+
+static void demux_unlink_addr(mbedtls_ssl_dtls_demux *demux,
+                              mbedtls_ssl_dtls_demux_peer *peer)
+{
+    size_t h = demux_hash(demux, peer->addr.addr, peer->addr.len);
+    mbedtls_ssl_dtls_demux_peer **pp;
+
+    for (pp = &demux->by_addr[h]; *pp != NULL; pp = &(*pp)->next_by_addr) {
+        if (*pp == peer) {
+            *pp = peer->next_by_addr;
+            break;
+        }
+    }
+}
+
+static mbedtls_ssl_dtls_demux_peer *demux_find_addr(
+    const mbedtls_ssl_dtls_demux *demux,
+    const mbedtls_net_addr *addr)
+{
+    mbedtls_ssl_dtls_demux_peer *peer;
+
+    peer = demux->by_addr[demux_hash(demux, addr->addr, addr->len)];
+    while (peer != NULL && !demux_addr_equal(&peer->addr, addr)) {
+        peer = peer->next_by_addr;
+    }
+
+    return peer;
+}
+
+static void demux_lru_unlink(mbedtls_ssl_dtls_demux *demux,
+                             mbedtls_ssl_dtls_demux_peer *peer)
+{
+    if (peer->lru_prev != NULL) {
+        peer->lru_prev->lru_next = peer->lru_next;
+    } else if (demux->lru_head == peer) {
+        demux->lru_head = peer->lru_next;
+    }
+
+    if (peer->lru_next != NULL) {
+        peer->lru_next->lru_prev = peer->lru_prev;
+    } else if (demux->lru_tail == peer) {
+        demux->lru_tail = peer->lru_prev;
+    }
+
+    peer->lru_prev = peer->lru_next = NULL;
+}
+
+/*
+ * Record that a datagram from the peer just arrived
+ */
+static void demux_lru_touch(mbedtls_ssl_dtls_demux *demux,
+                            mbedtls_ssl_dtls_demux_peer *peer)
+{
+#if defined(MBEDTLS_HAVE_TIME)
+    peer->last_seen = mbedtls_ms_time();
+#endif
+
+    if (demux->lru_head == peer) {
+        return;
+    }
+
+    demux_lru_unlink(demux, peer);
+
+    peer->lru_next = demux->lru_head;
+    if (demux->lru_head != NULL) {
+        demux->lru_head->lru_prev = peer;
+    }
+    demux->lru_head = peer;
+    if (demux->lru_tail == NULL) {
+        demux->lru_tail = peer;
+    }
+}
+
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+static mbedtls_ssl_dtls_demux_peer *demux_find_cid(
+    const mbedtls_ssl_dtls_demux *demux,
+    const unsigned char *cid, size_t cid_len)
+{
+    mbedtls_ssl_dtls_demux_peer *peer;
+
+    peer = demux->by_cid[demux_hash(demux, cid, cid_len)];
+    while (peer != NULL &&
+           (peer->cid_len != cid_len ||
+            memcmp(peer->cid, cid, cid_len) != 0)) {
+        peer = peer->next_by_cid;
+    }
+
+    return peer;
+}
+
+/*
+ * Pick a fresh random CID for a new peer and index it.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int demux_assign_cid(mbedtls_ssl_dtls_demux *demux,
+                            mbedtls_ssl_dtls_demux_peer *peer)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    size_t h;
+
+    peer->cid_len = demux->conf->cid_len;
+
+    do {
+        ret = demux->conf->f_rng(demux->conf->p_rng, peer->cid, peer->cid_len);
+        if (ret != 0) {
+            return ret;
+        }
+    } while (demux_find_cid(demux, peer->cid, peer->cid_len) != NULL);
+
+    h = demux_hash(demux, peer->cid, peer->cid_len);
+    peer->next_by_cid = demux->by_cid[h];
+    demux->by_cid[h] = peer;
+
+    return mbedtls_ssl_set_cid(&peer->ssl, MBEDTLS_SSL_CID_ENABLED,
+                               peer->cid, peer->cid_len);
+}
+
+static void demux_unlink_cid(mbedtls_ssl_dtls_demux *demux,
+                             mbedtls_ssl_dtls_demux_peer *peer)
+{
+    size_t h;
+    mbedtls_ssl_dtls_demux_peer **pp;
+
+    if (peer->cid_len == 0) {
+        return;
+    }
+
+    h = demux_hash(demux, peer->cid, peer->cid_len);
+    for (pp = &demux->by_cid[h]; *pp != NULL; pp = &(*pp)->next_by_cid) {
+        if (*pp == peer) {
+            *pp = peer->next_by_cid;
+            break;
+        }
+    }
+}
+
+#if defined(MBEDTLS_SSL_DTLS_ANTI_REPLAY)
+/*
+ * Return 1 if the record with the given epoch and sequence number has
+ * been authenticated by the SSL context, as shown by its replay window.
+ */
+static int demux_record_seen(const mbedtls_ssl_context *ssl,
+                             uint16_t epoch, uint64_t seq)
+{
+    uint64_t bit;
+
+    if (ssl->in_epoch != epoch || seq > ssl->in_window_top) {
+        return 0;
+    }
+
+    bit = ssl->in_window_top - seq;
+
+    return bit < 64 && (ssl->in_window & ((uint64_t) 1 << bit)) != 0;
+}
+
+static void demux_migrate_prepare(mbedtls_ssl_dtls_demux_peer *peer,
+                                  const mbedtls_net_addr *addr,
+                                  const unsigned char *hdr)
+{
+    uint16_t epoch = MBEDTLS_GET_UINT16_BE(hdr, 3);
+    uint64_t seq = ((uint64_t) MBEDTLS_GET_UINT16_BE(hdr, 5) << 32) |
+                   MBEDTLS_GET_UINT32_BE(hdr, 7);
+
+    if (peer->ssl.conf->anti_replay == MBEDTLS_SSL_ANTI_REPLAY_DISABLED ||
+        demux_record_seen(&peer->ssl, epoch, seq)) {
+        /* No way to tell a fresh record from a replayed one */
+        return;
+    }
+
+    peer->migrating = 1;
+    peer->new_addr = *addr;
+    peer->new_addr_epoch = epoch;
+    peer->new_addr_seq = seq;
+}
+
+static void demux_migrate_commit(mbedtls_ssl_dtls_demux_peer *peer)
+{
+    mbedtls_ssl_dtls_demux *demux = peer->demux;
+    const mbedtls_ssl_context *ssl = &peer->ssl;
+
+    if (peer->migrating == 0 ||
+        !demux_record_seen(ssl, peer->new_addr_epoch, peer->new_addr_seq)) {
+        return;
+    }
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("demux: peer moved to a new address"));
+
+    demux_unlink_addr(demux, peer);
+    peer->addr = peer->new_addr;
+    demux_link_addr(demux, peer);
+    peer->migrating = 0;
+}
+#endif /* MBEDTLS_SSL_DTLS_ANTI_REPLAY */
+#endif /* MBEDTLS_SSL_DTLS_CONNECTION_ID */
+
+/*
+ * BIO callbacks of peer contexts
+ */
+static int demux_peer_send(void *ctx, const unsigned char *buf, size_t len)
+{
+    mbedtls_ssl_dtls_demux_peer *peer = (mbedtls_ssl_dtls_demux_peer *) ctx;
+
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID) && \
+    defined(MBEDTLS_SSL_DTLS_ANTI_REPLAY)
+    /* Answer the record that just authenticated at its new address */
+    demux_migrate_commit(peer);
+#endif
+
+    return mbedtls_net_send_to(peer->demux->net, buf, len, &peer->addr);
+}
+
+static int demux_peer_recv(void *ctx, unsigned char *buf, size_t len)
+{
+    mbedtls_ssl_dtls_demux_peer *peer = (mbedtls_ssl_dtls_demux_peer *) ctx;
+    size_t n;
+
+    if (peer->in == NULL) {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    }
+
+    /* Like recv() on a datagram socket: excess bytes are lost */
+    n = peer->in_len < len ? peer->in_len : len;
+    memcpy(buf, peer->in, n);
+    peer->in = NULL;
+    peer->in_len = 0;
+
+    return (int) n;
+}
+
+/*
+ * Stop routing the previous datagram, which the application either
+ * consumed or chose to ignore.
+ */
+static void demux_release_last(mbedtls_ssl_dtls_demux *demux)
+{
+    mbedtls_ssl_dtls_demux_peer *peer = demux->last;
+
+    if (peer == NULL) {
+        return;
+    }
+
+    peer->in = NULL;
+    peer->in_len = 0;
+
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID) && \
+    defined(MBEDTLS_SSL_DTLS_ANTI_REPLAY)
+    demux_migrate_commit(peer);
+    peer->migrating = 0;
+#endif
+
+    demux->last = NULL;
+}
+
+static void demux_peer_free(mbedtls_ssl_dtls_demux *demux,
+                            mbedtls_ssl_dtls_demux_peer *peer)
+{
+    demux_unlink_addr(demux, peer);
+    demux_lru_unlink(demux, peer);
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    demux_unlink_cid(demux, peer);
+#endif
+
+    if (demux->last == peer) {
+        demux->last = NULL;
+    }
+
+    mbedtls_ssl_free(&peer->ssl);
+    mbedtls_zeroize_and_free(peer, sizeof(*peer));
+}
+
+/*
+ * Forget a peer the application did not close itself
+ */
+static void demux_evict(mbedtls_ssl_dtls_demux *demux,
+                        mbedtls_ssl_dtls_demux_peer *peer)
+{
+    /* Named ssl for the debug macros */
+    mbedtls_ssl_context *ssl = &peer->ssl;
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("demux: evicting peer"));
+
+    if (demux->f_evict != NULL) {
+        demux->f_evict(demux->p_evict, ssl);
+    }
+
+    demux_peer_free(demux, peer);
+    demux->peer_count--;
+}
+
+static void demux_evict_idle(mbedtls_ssl_dtls_demux *demux)
+{
+#if defined(MBEDTLS_HAVE_TIME)
+    mbedtls_ms_time_t now;
+
+    if (demux->idle_timeout == 0) {
+        return;
+    }
+
+    now = mbedtls_ms_time();
+    while (demux->lru_tail != NULL &&
+           now - demux->lru_tail->last_seen >= demux->idle_timeout) {
+        demux_evict(demux, demux->lru_tail);
+    }
+#else
+    (void) demux;
+#endif
+}
+
+/*
+ * A datagram from an address we have no context for: it must be a
+ * ClientHello with a valid cookie, otherwise answer statelessly.
+ */
+static mbedtls_ssl_dtls_demux_peer *demux_new_peer(mbedtls_ssl_dtls_demux *demux,
+                                                   const mbedtls_net_addr *addr,
+                                                   const unsigned char *in,
+                                                   size_t len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    /* Named ssl for the debug macros, once there is a context */
+    mbedtls_ssl_context *ssl;
+    mbedtls_ssl_dtls_demux_peer *peer;
+    unsigned char hvr[DEMUX_HVR_MAX_LEN];
+    size_t hvr_len = 0;
+
+    ret = mbedtls_ssl_check_dtls_clihlo_cookie(demux->conf, NULL,
+                                               addr->addr, addr->len,
+                                               in, len,
+                                               hvr, sizeof(hvr), &hvr_len);
+    if (ret == MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED) {
+        /* Don't check write errors: the client will retransmit its
+         * ClientHello if the HelloVerifyRequest is lost. */
+        (void) mbedtls_net_send_to(demux->net, hvr, hvr_len, addr);
+        return NULL;
+    }
+    if (ret != 0) {
+        return NULL;
+    }
+
+    /* The cookie proves the peer is reachable at its address, which makes
+     * it worth more than the peer that has been silent the longest. */
+    if (demux->peer_count >= demux->max_peers) {
+        if (demux->lru_tail == NULL) {
+            return NULL;
+        }
+        demux_evict(demux, demux->lru_tail);
+    }
+
+    peer = mbedtls_calloc(1, sizeof(*peer));
+    if (peer == NULL) {
+        return NULL;
+    }
+
+    mbedtls_ssl_init(&peer->ssl);
+    ssl = &peer->ssl;
+    peer->demux = demux;
+    peer->addr = *addr;
+
+    if ((ret = mbedtls_ssl_setup(ssl, demux->conf)) != 0) {
+        goto cleanup;
+    }
+
+    mbedtls_ssl_set_bio(&peer->ssl, peer, demux_peer_send, demux_peer_recv,
+                        NULL);
+
+    /* Same ID as above, so that the handshake accepts the cookie again */
+    if ((ret = mbedtls_ssl_set_client_transport_id(&peer->ssl, addr->addr,
+                                                   addr->len)) != 0) {
+        goto cleanup;
+    }
+
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    if (demux->conf->cid_len > 0 &&
+        (ret = demux_assign_cid(demux, peer)) != 0) {
+        goto cleanup;
+    }
+#endif
+
+    if (demux->f_peer != NULL &&
+        (ret = demux->f_peer(demux->p_peer, &peer->ssl)) != 0) {
+        goto cleanup;
+    }
+
+    demux_link_addr(demux, peer);
+    demux_lru_touch(demux, peer);
+    demux->peer_count++;
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("demux: new peer (%" MBEDTLS_PRINTF_SIZET
+                              " in total)", demux->peer_count));
+
+    return peer;
+
+cleanup:
+    MBEDTLS_SSL_DEBUG_RET(1, "demux: new peer setup", ret);
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    demux_unlink_cid(demux, peer);
+#endif
+    mbedtls_ssl_free(&peer->ssl);
+    mbedtls_zeroize_and_free(peer, sizeof(*peer));
+    return NULL;
+}
+
+/*
+ * Find the peer a datagram belongs to, creating it if appropriate.
+ * Return NULL if the datagram should be dropped.
+ */
+static mbedtls_ssl_dtls_demux_peer *demux_route(mbedtls_ssl_dtls_demux *demux,
+                                                const mbedtls_net_addr *addr,
+                                                const unsigned char *in,
+                                                size_t len)
+{
+    mbedtls_ssl_dtls_demux_peer *peer;
+
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    size_t cid_len = demux->conf->cid_len;
+
+    if (cid_len > 0 && len >= DEMUX_CID_OFFSET + cid_len &&
+        in[0] == MBEDTLS_SSL_MSG_CID) {
+        peer = demux_find_cid(demux, in + DEMUX_CID_OFFSET, cid_len);
+        if (peer == NULL) {
+            return NULL;
+        }
+
+#if defined(MBEDTLS_SSL_DTLS_ANTI_REPLAY)
+        if (!demux_addr_equal(&peer->addr, addr)) {
+            demux_migrate_prepare(peer, addr, in);
+        }
+#endif
+        return peer;
+    }
+#endif /* MBEDTLS_SSL_DTLS_CONNECTION_ID */
+
+    peer = demux_find_addr(demux, addr);
+    if (peer != NULL) {
+        return peer;
+    }
+
+    return demux_new_peer(demux, addr, in, len);
+}
+
+void mbedtls_ssl_dtls_demux_init(mbedtls_ssl_dtls_demux *demux)
+{
+    memset(demux, 0, sizeof(mbedtls_ssl_dtls_demux));
+    demux->idle_timeout = MBEDTLS_SSL_DTLS_DEMUX_DEFAULT_IDLE_TIMEOUT;
+}
+
+int mbedtls_ssl_dtls_demux_setup(mbedtls_ssl_dtls_demux *demux,
+                                 const mbedtls_ssl_config *conf,
+                                 mbedtls_net_context *net,
+                                 size_t max_peers)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    size_t buckets = 1;
+    size_t i;
+
+    if (conf->endpoint != MBEDTLS_SSL_IS_SERVER ||
+        conf->transport != MBEDTLS_SSL_TRANSPORT_DATAGRAM ||
+        conf->f_cookie_write == NULL || conf->f_cookie_check == NULL ||
+        conf->f_rng == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_CONFIG;
+    }
+
+    if (max_peers == 0) {
+        max_peers = MBEDTLS_SSL_DTLS_DEMUX_DEFAULT_MAX_PEERS;
+    }
+
+    /* Power of two, keeping the load factor at most 1 */
+    while (buckets < max_peers && buckets <= (SIZE_MAX >> 2)) {
+        buckets <<= 1;
+    }
+
+    demux->by_addr = mbedtls_calloc(buckets, sizeof(*demux->by_addr));
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    demux->by_cid = mbedtls_calloc(buckets, sizeof(*demux->by_cid));
+#endif
+    demux->batch_size = MBEDTLS_SSL_DTLS_DEMUX_BATCH_SIZE;
+    if (demux->batch_size > MBEDTLS_NET_BATCH_MAX) {
+        demux->batch_size = MBEDTLS_NET_BATCH_MAX;
+    }
+    demux->buf = mbedtls_calloc(demux->batch_size, MBEDTLS_SSL_IN_BUFFER_LEN);
+    demux->batch = mbedtls_calloc(demux->batch_size, sizeof(*demux->batch));
+
+    if (demux->by_addr == NULL ||
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+        demux->by_cid == NULL ||
+#endif
+        demux->buf == NULL || demux->batch == NULL) {
+        ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
+        goto cleanup;
+    }
+
+    for (i = 0; i < demux->batch_size; i++) {
+        demux->batch[i].buf = demux->buf + i * MBEDTLS_SSL_IN_BUFFER_LEN;
+        demux->batch[i].size = MBEDTLS_SSL_IN_BUFFER_LEN;
+    }
+
+    ret = conf->f_rng(conf->p_rng, (unsigned char *) &demux->hash_key,
+                      sizeof(demux->hash_key));
+    if (ret != 0) {
+        goto cleanup;
+    }
+
+    demux->conf = conf;
+    demux->net = net;
+    demux->bucket_mask = buckets - 1;
+    demux->max_peers = max_peers;
+
+    return 0;
+
+cleanup:
+    mbedtls_free(demux->by_addr);
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    mbedtls_free(demux->by_cid);
+#endif
+    mbedtls_free(demux->buf);
+    mbedtls_free(demux->batch);
+    mbedtls_ssl_dtls_demux_init(demux);
+    return ret;
+}
+
+void mbedtls_ssl_dtls_demux_set_peer_cb(mbedtls_ssl_dtls_demux *demux,
+                                        mbedtls_ssl_dtls_demux_peer_cb_t *f_peer,
+                                        void *p_peer)
+{
+    demux->f_peer = f_peer;
+    demux->p_peer = p_peer;
+}
+
+void mbedtls_ssl_dtls_demux_set_evict_cb(mbedtls_ssl_dtls_demux *demux,
+                                         mbedtls_ssl_dtls_demux_evict_cb_t *f_evict,
+                                         void *p_evict)
+{
+    demux->f_evict = f_evict;
+    demux->p_evict = p_evict;
+}
+
+void mbedtls_ssl_dtls_demux_set_idle_timeout(mbedtls_ssl_dtls_demux *demux,
+                                             uint32_t timeout_ms)
+{
+    demux->idle_timeout = timeout_ms;
+}
+
+int mbedtls_ssl_dtls_demux_recv(mbedtls_ssl_dtls_demux *demux,
+                                mbedtls_ssl_context **ssl)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_dtls_demux_peer *peer = NULL;
+    const mbedtls_net_dgram *d;
+    const unsigned char *in = NULL;
+    size_t len = 0;
+
+    *ssl = NULL;
+
+    if (demux->conf == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    demux_release_last(demux);
+    demux_evict_idle(demux);
+
+    while (peer == NULL) {
+        if (demux->batch_next == demux->batch_len) {
+            demux->batch_len = demux->batch_next = demux->batch_off = 0;
+
+            ret = mbedtls_net_recv_batch(demux->net, demux->batch,
+                                         demux->batch_size);
+            if (ret < 0) {
+                return ret;
+            }
+            demux->batch_len = (size_t) ret;
+        }
+
+        /* One datagram, or one segment of a GRO-coalesced buffer */
+        d = &demux->batch[demux->batch_next];
+        in = d->buf + demux->batch_off;
+        len = d->len - demux->batch_off;
+        if (d->segment_size != 0 && d->segment_size < len) {
+            len = d->segment_size;
+        }
+
+        demux->batch_off += len;
+        if (demux->batch_off >= d->len) {
+            demux->batch_next++;
+            demux->batch_off = 0;
+        }
+
+        peer = demux_route(demux, &d->addr, in, len);
+    }
+
+    demux_lru_touch(demux, peer);
+    peer->in = in;
+    peer->in_len = len;
+    demux->last = peer;
+
+    *ssl = &peer->ssl;
+
+    return 0;
+}
+
+void mbedtls_ssl_dtls_demux_close(mbedtls_ssl_dtls_demux *demux,
+                                  mbedtls_ssl_context *ssl)
+{
+    if (ssl == NULL) {
+        return;
+    }
+
+    /* Peer contexts always have their demux node as BIO context */
+    demux_peer_free(demux, (mbedtls_ssl_dtls_demux_peer *) ssl->p_bio);
+    demux->peer_count--;
+}
+
+size_t mbedtls_ssl_dtls_demux_get_peer_count(const mbedtls_ssl_dtls_demux *demux)
+{
+    return demux->peer_count;
+}
+
+void mbedtls_ssl_dtls_demux_free(mbedtls_ssl_dtls_demux *demux)
+{
+    size_t i;
+
+    if (demux == NULL) {
+        return;
+    }
+
+    if (demux->by_addr != NULL) {
+        for (i = 0; i <= demux->bucket_mask; i++) {
+            while (demux->by_addr[i] != NULL) {
+                demux_peer_free(demux, demux->by_addr[i]);
+            }
+        }
+    }
+
+    mbedtls_free(demux->by_addr);
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+    mbedtls_free(demux->by_cid);
+#endif
+    mbedtls_free(demux->buf);
+    mbedtls_free(demux->batch);
+
+    mbedtls_platform_zeroize(demux, sizeof(mbedtls_ssl_dtls_demux));
+}
+
+#endif /* MBEDTLS_SSL_DTLS_DEMUX_C */
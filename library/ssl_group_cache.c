@@ -0,0 +1,143 @@
+/*
+ *  Cache of the key exchange groups selected by TLS 1.3 servers
+ *
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+
+#include "ssl_misc.h"
+
+#if defined(MBEDTLS_SSL_GROUP_CACHE_C)
+
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/ssl_group_cache.h"
+#include "mbedtls/error.h"
+
+#include <string.h>
+
+void mbedtls_ssl_group_cache_init(mbedtls_ssl_group_cache *cache)
+{
+    memset(cache, 0, sizeof(mbedtls_ssl_group_cache));
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_init(&cache->mutex);
+#endif
+}
+
+int mbedtls_ssl_group_cache_setup(mbedtls_ssl_group_cache *cache,
+                                  size_t size)
+{
+    mbedtls_ssl_group_cache_entry *entries;
+
+    if (cache->entries != NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (size == 0) {
+        size = MBEDTLS_SSL_GROUP_CACHE_DEFAULT_SIZE;
+    }
+
+    entries = mbedtls_calloc(size, sizeof(mbedtls_ssl_group_cache_entry));
+    if (entries == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&cache->mutex) != 0) {
+        mbedtls_free(entries);
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    cache->entries = entries;
+    cache->size = size;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_unlock(&cache->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    return 0;
+}
+
+/* FNV-1a: collisions only cost a HelloRetryRequest. */
+static uint32_t ssl_group_cache_hash(const char *hostname)
+{
+    uint32_t hash = 0x811C9DC5;
+
+    for (; *hostname != '\0'; hostname++) {
+        hash = (hash ^ (unsigned char) *hostname) * 0x01000193;
+    }
+
+    return hash;
+}
+
+uint16_t mbedtls_ssl_group_cache_get(mbedtls_ssl_group_cache *cache,
+                                     const char *hostname)
+{
+    uint32_t hash = ssl_group_cache_hash(hostname);
+    const mbedtls_ssl_group_cache_entry *entry;
+    uint16_t group = 0;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&cache->mutex) != 0) {
+        return 0;
+    }
+#endif
+
+    if (cache->size != 0) {
+        entry = &cache->entries[hash % cache->size];
+        if (entry->hostname_hash == hash) {
+            group = entry->group;
+        }
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    (void) mbedtls_mutex_unlock(&cache->mutex);
+#endif
+
+    return group;
+}
+
+void mbedtls_ssl_group_cache_set(mbedtls_ssl_group_cache *cache,
+                                 const char *hostname,
+                                 uint16_t group)
+{
+    uint32_t hash = ssl_group_cache_hash(hostname);
+    mbedtls_ssl_group_cache_entry *entry;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&cache->mutex) != 0) {
+        return;
+    }
+#endif
+
+    if (cache->size != 0) {
+        entry = &cache->entries[hash % cache->size];
+        entry->hostname_hash = hash;
+        entry->group = group;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    (void) mbedtls_mutex_unlock(&cache->mutex);
+#endif
+}
+
+void mbedtls_ssl_group_cache_free(mbedtls_ssl_group_cache *cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+
+    mbedtls_free(cache->entries);
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_free(&cache->mutex);
+#endif
+
+    mbedtls_platform_zeroize(cache, sizeof(mbedtls_ssl_group_cache));
+}
+
+#endif /* MBEDTLS_SSL_GROUP_CACHE_C */
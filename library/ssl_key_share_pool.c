@@ -0,0 +1,318 @@
+/*
+ *  Pool of pre-generated ephemeral (EC)DH key pairs
+ *
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+
+#include "ssl_misc.h"
+
+#if defined(MBEDTLS_SSL_KEY_SHARE_POOL_C)
+
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/ssl_key_share_pool.h"
+#include "mbedtls/error.h"
+#include "psa_util_internal.h"
+
+#include <limits.h>
+#include <string.h>
+
+void mbedtls_ssl_key_share_pool_init(mbedtls_ssl_key_share_pool *pool)
+{
+    memset(pool, 0, sizeof(mbedtls_ssl_key_share_pool));
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_init(&pool->mutex);
+#endif
+}
+
+static int ssl_key_share_pool_group_info(uint16_t tls_id,
+                                         mbedtls_ssl_key_share_pool_slot *slot)
+{
+#if defined(PSA_WANT_ALG_ECDH)
+    if (mbedtls_ssl_get_psa_curve_info_from_tls_id(tls_id, &slot->type,
+                                                   &slot->bits) == PSA_SUCCESS) {
+        slot->alg = PSA_ALG_ECDH;
+        return 0;
+    }
+#endif
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED) && \
+    defined(PSA_WANT_ALG_FFDH)
+    if (mbedtls_ssl_get_psa_ffdh_info_from_tls_id(tls_id, &slot->bits,
+                                                  &slot->type) == PSA_SUCCESS) {
+        slot->alg = PSA_ALG_FFDH;
+        return 0;
+    }
+#endif
+    (void) tls_id;
+    (void) slot;
+
+    return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+}
+
+int mbedtls_ssl_key_share_pool_setup(mbedtls_ssl_key_share_pool *pool,
+                                     const uint16_t *groups,
+                                     size_t size)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_key_share_pool_slot *slots;
+    size_t count = 0, i;
+
+    if (pool->slots != NULL || groups == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (size == 0) {
+        size = MBEDTLS_SSL_KEY_SHARE_POOL_DEFAULT_SIZE;
+    }
+
+    while (groups[count] != MBEDTLS_SSL_IANA_TLS_GROUP_NONE) {
+        count++;
+    }
+    if (count == 0) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    slots = mbedtls_calloc(count, sizeof(mbedtls_ssl_key_share_pool_slot));
+    if (slots == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    for (i = 0; i < count; i++) {
+        slots[i].tls_id = groups[i];
+        ret = ssl_key_share_pool_group_info(groups[i], &slots[i]);
+        if (ret != 0) {
+            goto cleanup;
+        }
+
+        slots[i].keys = mbedtls_calloc(size, sizeof(mbedtls_svc_key_id_t));
+        if (slots[i].keys == NULL) {
+            ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
+            goto cleanup;
+        }
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if ((ret = mbedtls_mutex_lock(&pool->mutex)) != 0) {
+        goto cleanup;
+    }
+#endif
+
+    pool->slots = slots;
+    pool->slot_count = count;
+    pool->size = size;
+    slots = NULL;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_unlock(&pool->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    ret = 0;
+
+cleanup:
+    if (slots != NULL) {
+        for (i = 0; i < count; i++) {
+            mbedtls_free(slots[i].keys);
+        }
+        mbedtls_free(slots);
+    }
+
+    return ret;
+}
+
+int mbedtls_ssl_key_share_pool_refill(mbedtls_ssl_key_share_pool *pool,
+                                      size_t max)
+{
+    int ret = 0;
+    psa_status_t status;
+    psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+    mbedtls_ssl_key_share_pool_slot *slot;
+    mbedtls_svc_key_id_t key;
+    size_t generated = 0, i;
+
+    while (max == 0 || generated < max) {
+#if defined(MBEDTLS_THREADING_C)
+        if ((ret = mbedtls_mutex_lock(&pool->mutex)) != 0) {
+            return ret;
+        }
+#endif
+
+        /* Serve the group closest to running out first. */
+        slot = NULL;
+        for (i = 0; i < pool->slot_count; i++) {
+            if (pool->slots[i].count < pool->size &&
+                (slot == NULL || pool->slots[i].count < slot->count)) {
+                slot = &pool->slots[i];
+            }
+        }
+
+        if (slot != NULL) {
+            psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_DERIVE);
+            psa_set_key_algorithm(&attributes, slot->alg);
+            psa_set_key_type(&attributes, slot->type);
+            psa_set_key_bits(&attributes, slot->bits);
+        }
+
+#if defined(MBEDTLS_THREADING_C)
+        if (mbedtls_mutex_unlock(&pool->mutex) != 0) {
+            return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+        }
+#endif
+
+        if (slot == NULL) {
+            break;
+        }
+
+        key = MBEDTLS_SVC_KEY_ID_INIT;
+        status = psa_generate_key(&attributes, &key);
+        psa_reset_key_attributes(&attributes);
+        if (status != PSA_SUCCESS) {
+            return PSA_TO_MBEDTLS_ERR(status);
+        }
+
+#if defined(MBEDTLS_THREADING_C)
+        if ((ret = mbedtls_mutex_lock(&pool->mutex)) != 0) {
+            psa_destroy_key(key);
+            return ret;
+        }
+#endif
+
+        /* Another thread may have filled the slot in the meantime. */
+        if (slot->count < pool->size) {
+            slot->keys[slot->count++] = key;
+            key = MBEDTLS_SVC_KEY_ID_INIT;
+        }
+
+#if defined(MBEDTLS_THREADING_C)
+        if (mbedtls_mutex_unlock(&pool->mutex) != 0) {
+            psa_destroy_key(key);
+            return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+        }
+#endif
+
+        if (!mbedtls_svc_key_id_is_null(key)) {
+            psa_destroy_key(key);
+            continue;
+        }
+        generated++;
+    }
+
+    return generated > INT_MAX ? INT_MAX : (int) generated;
+}
+
+int mbedtls_ssl_key_share_pool_take(mbedtls_ssl_key_share_pool *pool,
+                                    const psa_key_attributes_t *attributes,
+                                    mbedtls_svc_key_id_t *key)
+{
+    int ret = MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    mbedtls_ssl_key_share_pool_slot *slot;
+    size_t i;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&pool->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    for (i = 0; i < pool->slot_count; i++) {
+        slot = &pool->slots[i];
+        if (slot->type != psa_get_key_type(attributes) ||
+            slot->bits != psa_get_key_bits(attributes) ||
+            slot->alg != psa_get_key_algorithm(attributes)) {
+            continue;
+        }
+
+        if (slot->count > 0) {
+            *key = slot->keys[--slot->count];
+            slot->keys[slot->count] = MBEDTLS_SVC_KEY_ID_INIT;
+            pool->taken++;
+            ret = 0;
+        }
+        break;
+    }
+
+    if (ret != 0) {
+        pool->misses++;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    /* A key that was handed out must not be lost to an unlock error. */
+    (void) mbedtls_mutex_unlock(&pool->mutex);
+#endif
+
+    return ret;
+}
+
+size_t mbedtls_ssl_key_share_pool_get_count(mbedtls_ssl_key_share_pool *pool,
+                                            uint16_t tls_id)
+{
+    size_t count = 0, i;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&pool->mutex) != 0) {
+        return 0;
+    }
+#endif
+
+    for (i = 0; i < pool->slot_count; i++) {
+        if (pool->slots[i].tls_id == tls_id) {
+            count = pool->slots[i].count;
+            break;
+        }
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    (void) mbedtls_mutex_unlock(&pool->mutex);
+#endif
+
+    return count;
+}
+
+void mbedtls_ssl_key_share_pool_get_stats(mbedtls_ssl_key_share_pool *pool,
+                                          size_t *taken, size_t *misses)
+{
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&pool->mutex) != 0) {
+        return;
+    }
+#endif
+
+    if (taken != NULL) {
+        *taken = pool->taken;
+    }
+    if (misses != NULL) {
+        *misses = pool->misses;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    (void) mbedtls_mutex_unlock(&pool->mutex);
+#endif
+}
+
+void mbedtls_ssl_key_share_pool_free(mbedtls_ssl_key_share_pool *pool)
+{
+    size_t i, j;
+
+    if (pool == NULL) {
+        return;
+    }
+
+    for (i = 0; i < pool->slot_count; i++) {
+        for (j = 0; j < pool->slots[i].count; j++) {
+            psa_destroy_key(pool->slots[i].keys[j]);
+        }
+        mbedtls_free(pool->slots[i].keys);
+    }
+    mbedtls_free(pool->slots);
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_free(&pool->mutex);
+#endif
+
+    mbedtls_platform_zeroize(pool, sizeof(mbedtls_ssl_key_share_pool));
+}
+
+#endif /* MBEDTLS_SSL_KEY_SHARE_POOL_C */
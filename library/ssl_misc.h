@@ -14,6 +14,7 @@
 #include "mbedtls/build_info.h"
 
 #include "mbedtls/error.h"
+#include "mbedtls/platform.h"
 
 #include "mbedtls/ssl.h"
 #include "mbedtls/cipher.h"
@@ -93,6 +94,7 @@ extern const mbedtls_error_pair_t psa_to_ssl_errors[7];
 #define MBEDTLS_SSL_EXT_ID_EXTENDED_MASTER_SECRET     26
 #define MBEDTLS_SSL_EXT_ID_SESSION_TICKET             27
 #define MBEDTLS_SSL_EXT_ID_RECORD_SIZE_LIMIT          28
+#define MBEDTLS_SSL_EXT_ID_COMPRESS_CERTIFICATE       29
 
 /* Utility for translating IANA extension type. */
 uint32_t mbedtls_ssl_get_extension_id(unsigned int extension_type);
@@ -154,6 +156,7 @@ uint32_t mbedtls_ssl_get_extension_mask(unsigned int extension_type);
      MBEDTLS_SSL_EXT_MASK(POST_HANDSHAKE_AUTH)                    | \
      MBEDTLS_SSL_EXT_MASK(SIG_ALG_CERT)                           | \
      MBEDTLS_SSL_EXT_MASK(RECORD_SIZE_LIMIT)                      | \
+     MBEDTLS_SSL_EXT_MASK(COMPRESS_CERTIFICATE)                   | \
      MBEDTLS_SSL_TLS1_3_EXT_MASK_UNRECOGNIZED)
 
 /* RFC 8446 section 4.2. Allowed extensions for EncryptedExtensions */
@@ -177,6 +180,7 @@ uint32_t mbedtls_ssl_get_extension_mask(unsigned int extension_type);
      MBEDTLS_SSL_EXT_MASK(CERT_AUTH)                              | \
      MBEDTLS_SSL_EXT_MASK(OID_FILTERS)                            | \
      MBEDTLS_SSL_EXT_MASK(SIG_ALG_CERT)                           | \
+     MBEDTLS_SSL_EXT_MASK(COMPRESS_CERTIFICATE)                   | \
      MBEDTLS_SSL_TLS1_3_EXT_MASK_UNRECOGNIZED)
 
 /* RFC 8446 section 4.2. Allowed extensions for Certificate */
@@ -629,6 +633,53 @@ typedef struct {
     unsigned char server_handshake_traffic_secret[MBEDTLS_TLS1_3_MD_MAX_SIZE];
 } mbedtls_ssl_tls13_handshake_secrets;
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+/*
+ * States of an asynchronous crypto job (mbedtls_ssl_async_job::state).
+ */
+#define MBEDTLS_SSL_ASYNC_JOB_IDLE      0   /*!< no operation            */
+#define MBEDTLS_SSL_ASYNC_JOB_QUEUED    1   /*!< accepted by f_async_job_start */
+#define MBEDTLS_SSL_ASYNC_JOB_DONE      2   /*!< result not yet consumed */
+
+/*
+ * An operation that the handshake hands over to the application's
+ * asynchronous crypto callbacks. It only holds copies of, or pointers to,
+ * data that stays untouched while the handshake is suspended, so that
+ * mbedtls_ssl_async_job_run() does not need the SSL context.
+ */
+struct mbedtls_ssl_async_job {
+    mbedtls_ssl_async_job_type type;
+    int state;
+    int ret;                            /*!< outcome of the operation     */
+
+    /* KEY_GENERATION: attributes in, key out.
+     * KEY_AGREEMENT: alg, key, peer in, output out. */
+    psa_key_attributes_t attributes;
+    mbedtls_svc_key_id_t key;
+    psa_algorithm_t alg;
+    const unsigned char *peer;
+    size_t peer_len;
+    unsigned char *output;
+    size_t output_size;
+    size_t output_len;
+
+    /* VERIFY */
+    mbedtls_pk_context *pk;
+    mbedtls_pk_type_t pk_type;
+#if defined(MBEDTLS_X509_RSASSA_PSS_SUPPORT)
+    mbedtls_pk_rsassa_pss_options pss_options;
+#endif
+    int use_pss_options;
+    mbedtls_md_type_t md_alg;
+    unsigned char hash[PSA_HASH_MAX_SIZE];
+    size_t hash_len;
+    unsigned char *sig;                 /*!< copy of the signature        */
+    size_t sig_len;
+
+    void *backend_data;
+};
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
+
 /*
  * This structure contains the parameters only needed during handshake.
  */
@@ -654,6 +705,14 @@ struct mbedtls_ssl_handshake_params {
 
 #if defined(MBEDTLS_SSL_SESSION_TICKETS)
     uint8_t new_session_ticket;         /*!< use NewSessionTicket?    */
+#if defined(MBEDTLS_SSL_SRV_C)
+    /** Decrypted ticket of the session being resumed. The ticket parser may
+     *  load the session without copying it out of this buffer, see
+     *  mbedtls_ssl_session_load_borrowed(), so it is kept until the end of
+     *  the handshake. */
+    unsigned char *ticket_buf;
+    size_t ticket_buf_len;
+#endif /* MBEDTLS_SSL_SRV_C */
 #endif /* MBEDTLS_SSL_SESSION_TICKETS */
 
 #if defined(MBEDTLS_SSL_CLI_C)
@@ -684,6 +743,10 @@ struct mbedtls_ssl_handshake_params {
 
 #if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
     uint8_t async_in_progress; /*!< an asynchronous operation is in progress */
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3)
+    uint16_t async_sig_alg;    /*!< TLS 1.3 SignatureScheme of the pending
+                                    CertificateVerify signature */
+#endif
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
@@ -741,6 +804,15 @@ struct mbedtls_ssl_handshake_params {
     uint8_t ccs_sent;
 #endif
 
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    /**
+     * Length of the handshake messages written before ssl->out_msg and not
+     * sent yet: they go out in the record of the next handshake message, or
+     * through mbedtls_ssl_write_coalesced_handshake().
+     */
+    size_t out_coalesced;
+#endif
+
 #if defined(MBEDTLS_SSL_SRV_C)
 #if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_PSK_ENABLED)
     uint8_t tls13_kex_modes; /*!< Key exchange modes supported by the client */
@@ -749,6 +821,8 @@ struct mbedtls_ssl_handshake_params {
     uint16_t hrr_selected_group;
 #if defined(MBEDTLS_SSL_SESSION_TICKETS)
     uint16_t new_session_tickets_count;         /*!< number of session tickets */
+    uint8_t new_session_tickets_deferred;       /*!< tickets wait for the first
+                                                     application data write */
 #endif
 #endif /* MBEDTLS_SSL_SRV_C */
 
@@ -873,6 +947,16 @@ struct mbedtls_ssl_handshake_params {
     unsigned int in_msg_seq;            /*!<  Incoming handshake sequence number */
 
     uint32_t retransmit_timeout;        /*!<  Current value of timeout       */
+    unsigned char retransmit_count;     /*!<  Timeouts of the current flight */
+#if defined(MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT)
+    mbedtls_ms_time_t flight_start;     /*!<  First transmission of the
+                                              current outgoing flight        */
+    uint32_t srtt;                      /*!<  Smoothed flight RTT, in ms     */
+    uint32_t rttvar;                    /*!<  Flight RTT variation, in ms    */
+    unsigned char rtt_valid;            /*!<  srtt and rttvar are set        */
+    unsigned char rtt_pending;          /*!<  Next incoming flight completes
+                                              an RTT sample (Karn's rule)    */
+#endif
     mbedtls_ssl_flight_item *flight;    /*!<  Current outgoing flight        */
     mbedtls_ssl_flight_item *cur_msg;   /*!<  Current message in flight      */
     unsigned char *cur_msg_p;           /*!<  Position in current message    */
@@ -896,6 +980,10 @@ struct mbedtls_ssl_handshake_params {
 #endif /* MBEDTLS_SSL_DTLS_CONNECTION_ID */
 
     uint16_t mtu;                       /*!<  Handshake mtu, used to fragment outgoing messages */
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+    size_t flight_max_dgram;            /*!<  Largest datagram of the last
+                                              transmission of our flight */
+#endif
 #endif /* MBEDTLS_SSL_PROTO_DTLS */
 
     /*
@@ -971,6 +1059,12 @@ struct mbedtls_ssl_handshake_params {
     unsigned char *certificate_request_context;
 #endif
 
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+    /* Server: 1 + index in conf->cert_compression of the algorithm to
+     * compress the Certificate message with, 0 to send it uncompressed. */
+    unsigned char cert_compression;
+#endif
+
     /** TLS 1.3 transform for encrypted handshake messages. */
     mbedtls_ssl_transform *transform_handshake;
     union {
@@ -995,6 +1089,11 @@ struct mbedtls_ssl_handshake_params {
     void *user_async_ctx;
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+    /** Public key operation handed over to mbedtls_ssl_config::f_async_job_start. */
+    mbedtls_ssl_async_job async_job;
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
+
 #if defined(MBEDTLS_SSL_SERVER_NAME_INDICATION)
     const unsigned char *sni_name;      /*!< raw SNI                        */
     size_t sni_name_len;                /*!< raw SNI len                    */
@@ -1002,8 +1101,70 @@ struct mbedtls_ssl_handshake_params {
     const mbedtls_x509_crt *dn_hints;   /*!< acceptable client cert issuers */
 #endif
 #endif /* MBEDTLS_SSL_SERVER_NAME_INDICATION */
+
+#if defined(MBEDTLS_SSL_HANDSHAKE_ARENA)
+    /** Bytes in use in the arena, which follows this structure in the same
+     * heap block and holds MBEDTLS_SSL_HANDSHAKE_ARENA_SIZE bytes. */
+    size_t arena_used;
+#endif
 };
 
+/*
+ * Allocate zeroed memory that is released at the latest with the handshake
+ * context, and release it. With MBEDTLS_SSL_HANDSHAKE_ARENA, the memory
+ * comes from the arena of the handshake when it fits, and releasing it
+ * there is a no-op: the whole arena goes at once.
+ */
+#if defined(MBEDTLS_SSL_HANDSHAKE_ARENA)
+void *mbedtls_ssl_hs_calloc(mbedtls_ssl_handshake_params *handshake,
+                            size_t n, size_t size);
+void mbedtls_ssl_hs_free(mbedtls_ssl_handshake_params *handshake, void *ptr);
+#else
+static inline void *mbedtls_ssl_hs_calloc(
+    mbedtls_ssl_handshake_params *handshake, size_t n, size_t size)
+{
+    ((void) handshake);
+    return mbedtls_calloc(n, size);
+}
+
+static inline void mbedtls_ssl_hs_free(mbedtls_ssl_handshake_params *handshake,
+                                       void *ptr)
+{
+    ((void) handshake);
+    mbedtls_free(ptr);
+}
+#endif /* MBEDTLS_SSL_HANDSHAKE_ARENA */
+
+/*
+ * Check that len more bytes keep a connection within the memory limit of its
+ * configuration, see mbedtls_ssl_conf_memory_limit(). The error is
+ * MBEDTLS_ERR_SSL_ALLOC_FAILED, so that callers handle it as a failed
+ * allocation, and mbedtls_ssl_calloc() returns NULL.
+ */
+#if defined(MBEDTLS_SSL_MEMORY_ACCOUNTING)
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_check_memory(const mbedtls_ssl_context *ssl, size_t len);
+#else
+static inline int mbedtls_ssl_check_memory(const mbedtls_ssl_context *ssl,
+                                           size_t len)
+{
+    ((void) ssl);
+    ((void) len);
+    return 0;
+}
+#endif /* MBEDTLS_SSL_MEMORY_ACCOUNTING */
+
+static inline void *mbedtls_ssl_calloc(const mbedtls_ssl_context *ssl,
+                                       size_t n, size_t size)
+{
+    if (n != 0 && size <= SIZE_MAX / n &&
+        mbedtls_ssl_check_memory(ssl, n * size) != 0) {
+        return NULL;
+    }
+
+    return mbedtls_calloc(n, size);
+}
+
 typedef struct mbedtls_ssl_hs_buffer mbedtls_ssl_hs_buffer;
 
 /*
@@ -1209,6 +1370,28 @@ struct mbedtls_ssl_key_cert {
     mbedtls_x509_crt *cert;                 /*!< cert                       */
     mbedtls_pk_context *key;                /*!< private key                */
     mbedtls_ssl_key_cert *next;             /*!< next key/cert pair         */
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS)
+    /* Encoded certificate_list of the Certificate message, without its
+     * length, see mbedtls_ssl_conf_preencode_certs(). */
+#if defined(MBEDTLS_SSL_PROTO_TLS1_2)
+    unsigned char *tls12_list;              /*!< ASN.1Cert entries          */
+    size_t tls12_list_len;                  /*!< length of tls12_list       */
+#endif
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3)
+    unsigned char *tls13_list;              /*!< CertificateEntry entries   */
+    size_t tls13_list_len;                  /*!< length of tls13_list       */
+#endif
+#endif /* MBEDTLS_SSL_PREENCODE_CERTS */
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+    /* Compressed Certificate message, with an empty
+     * certificate_request_context, for each algorithm of the configuration,
+     * see mbedtls_ssl_conf_compress_certs(). */
+    struct {
+        unsigned char *data;                /*!< compressed message         */
+        size_t len;                         /*!< length of data             */
+        size_t uncompressed_len;            /*!< length before compression  */
+    } compressed[MBEDTLS_SSL_CERT_COMPRESSION_MAX_ALGS];
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
 };
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
 
@@ -1285,8 +1468,9 @@ void mbedtls_ssl_set_inbound_transform(mbedtls_ssl_context *ssl,
                                        mbedtls_ssl_transform *transform);
 
 /* set outbound transform of ssl context */
-void mbedtls_ssl_set_outbound_transform(mbedtls_ssl_context *ssl,
-                                        mbedtls_ssl_transform *transform);
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_set_outbound_transform(mbedtls_ssl_context *ssl,
+                                       mbedtls_ssl_transform *transform);
 
 MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_handshake_client_step(mbedtls_ssl_context *ssl);
@@ -1406,6 +1590,16 @@ MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_start_handshake_msg(mbedtls_ssl_context *ssl, unsigned char hs_type,
                                     unsigned char **buf, size_t *buf_len);
 
+/*
+ * Write handshake message header, for a message of at most `need` bytes
+ * including the header. The handshake messages that wait to be coalesced are
+ * sent first if the current record has less room left than that.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_start_handshake_msg_ext(mbedtls_ssl_context *ssl,
+                                        unsigned char hs_type, size_t need,
+                                        unsigned char **buf, size_t *buf_len);
+
 MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_write_handshake_msg_ext(mbedtls_ssl_context *ssl,
                                         int update_checksum,
@@ -1422,6 +1616,15 @@ MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_finish_handshake_msg(mbedtls_ssl_context *ssl,
                                      size_t buf_len, size_t msg_len);
 
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+/*
+ * Send the handshake messages that are waiting for the next one, before
+ * something else is written or read, or the keys change.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_write_coalesced_handshake(mbedtls_ssl_context *ssl);
+#endif
+
 MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_write_record(mbedtls_ssl_context *ssl, int force_flush);
 MBEDTLS_CHECK_RETURN_CRITICAL
@@ -1574,28 +1777,26 @@ static inline mbedtls_ssl_srtp_profile mbedtls_ssl_check_srtp_profile_value
 #endif
 
 #if defined(MBEDTLS_X509_CRT_PARSE_C)
-static inline mbedtls_pk_context *mbedtls_ssl_own_key(mbedtls_ssl_context *ssl)
+static inline mbedtls_ssl_key_cert *mbedtls_ssl_own_key_cert(
+    mbedtls_ssl_context *ssl)
 {
-    mbedtls_ssl_key_cert *key_cert;
-
     if (ssl->handshake != NULL && ssl->handshake->key_cert != NULL) {
-        key_cert = ssl->handshake->key_cert;
-    } else {
-        key_cert = ssl->conf->key_cert;
+        return ssl->handshake->key_cert;
     }
 
+    return ssl->conf->key_cert;
+}
+
+static inline mbedtls_pk_context *mbedtls_ssl_own_key(mbedtls_ssl_context *ssl)
+{
+    mbedtls_ssl_key_cert *key_cert = mbedtls_ssl_own_key_cert(ssl);
+
     return key_cert == NULL ? NULL : key_cert->key;
 }
 
 static inline mbedtls_x509_crt *mbedtls_ssl_own_cert(mbedtls_ssl_context *ssl)
 {
-    mbedtls_ssl_key_cert *key_cert;
-
-    if (ssl->handshake != NULL && ssl->handshake->key_cert != NULL) {
-        key_cert = ssl->handshake->key_cert;
-    } else {
-        key_cert = ssl->conf->key_cert;
-    }
+    mbedtls_ssl_key_cert *key_cert = mbedtls_ssl_own_key_cert(ssl);
 
     return key_cert == NULL ? NULL : key_cert->cert;
 }
@@ -1797,7 +1998,8 @@ int mbedtls_ssl_start_renegotiation(mbedtls_ssl_context *ssl);
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
 size_t mbedtls_ssl_get_current_mtu(const mbedtls_ssl_context *ssl);
 void mbedtls_ssl_buffering_free(mbedtls_ssl_context *ssl);
-void mbedtls_ssl_flight_free(mbedtls_ssl_flight_item *flight);
+void mbedtls_ssl_flight_free(mbedtls_ssl_handshake_params *handshake,
+                             mbedtls_ssl_flight_item *flight);
 #endif /* MBEDTLS_SSL_PROTO_DTLS */
 
 /**
@@ -1859,7 +2061,8 @@ MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_tls13_process_finished_message(mbedtls_ssl_context *ssl);
 MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_tls13_write_finished_message(mbedtls_ssl_context *ssl);
-void mbedtls_ssl_tls13_handshake_wrapup(mbedtls_ssl_context *ssl);
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_tls13_handshake_wrapup(mbedtls_ssl_context *ssl);
 
 /**
  * \brief Given an SSL context and its associated configuration, write the TLS
@@ -2060,6 +2263,71 @@ int mbedtls_ssl_tls13_is_supported_versions_ext_present_in_exts(
     const unsigned char **supported_versions_data,
     const unsigned char **supported_versions_data_end);
 
+/*
+ * Location of the extensions of a handshake message, by internal extension
+ * identifier (MBEDTLS_SSL_EXT_ID_XXX). Offsets and lengths are those of the
+ * extension data, relative to the start of the extension list. All
+ * unrecognized extensions share MBEDTLS_SSL_EXT_ID_UNRECOGNIZED: only their
+ * presence is meaningful. When a recognized extension is present more than
+ * once, its first occurrence is indexed.
+ */
+typedef struct {
+    const unsigned char *exts;     /* start of the extension list */
+    const unsigned char *end;      /* end of the extension list */
+    uint32_t present;              /* mask of the extensions in the list */
+    uint32_t duplicated;           /* mask of the recognized extensions
+                                    * present more than once */
+    uint32_t last;                 /* identifier of the last extension */
+    uint16_t offset[MBEDTLS_SSL_EXT_ID_COMPRESS_CERTIFICATE + 1];
+    uint16_t len[MBEDTLS_SSL_EXT_ID_COMPRESS_CERTIFICATE + 1];
+    /* Recognized extensions, in the order of their first occurrence */
+    uint8_t order[MBEDTLS_SSL_EXT_ID_COMPRESS_CERTIFICATE];
+    uint8_t count;
+} mbedtls_ssl_tls13_ext_index;
+
+/**
+ * \brief Check the encoding of a list of extensions and index it, in a single
+ *        pass over the list.
+ *
+ * \param[in] ssl          SSL context
+ * \param[in] hs_msg_type  Type of the handshake message of the extensions
+ * \param[in] buf          Address of the first byte of the extensions vector.
+ * \param[in] end          End of the buffer containing the list of
+ *                         extensions.
+ * \param[out] index       The index of the list.
+ *
+ * \note         Repeated extensions are not an error here, as they are
+ *               only forbidden by TLS 1.3 (RFC 8446 section 4.2) and the
+ *               version is not known yet when indexing a ClientHello. They
+ *               are reported in \c index->duplicated.
+ *
+ * \return 0 on success.
+ * \return MBEDTLS_ERR_SSL_DECODE_ERROR if the list is not well-formed.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_tls13_index_extensions(mbedtls_ssl_context *ssl,
+                                       int hs_msg_type,
+                                       const unsigned char *buf,
+                                       const unsigned char *end,
+                                       mbedtls_ssl_tls13_ext_index *index);
+
+/*
+ * Get the data of an extension from an index. Return 1 if the extension is
+ * present, 0 otherwise.
+ */
+static inline int mbedtls_ssl_tls13_ext_index_get(
+    const mbedtls_ssl_tls13_ext_index *index, uint32_t id,
+    const unsigned char **data, const unsigned char **data_end)
+{
+    if (id == MBEDTLS_SSL_EXT_ID_UNRECOGNIZED ||
+        (index->present & (1u << id)) == 0) {
+        return 0;
+    }
+    *data = index->exts + index->offset[id];
+    *data_end = *data + index->len[id];
+    return 1;
+}
+
 /*
  * Handler of TLS 1.3 server certificate message
  */
@@ -2093,6 +2361,28 @@ int mbedtls_ssl_tls13_process_certificate_verify(mbedtls_ssl_context *ssl);
 MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_tls13_write_change_cipher_spec(mbedtls_ssl_context *ssl);
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+/*
+ * States of the KeyUpdate we send (mbedtls_ssl_context::key_update_state).
+ */
+#define MBEDTLS_SSL_KEY_UPDATE_STATE_NONE       0   /*!< nothing to send      */
+#define MBEDTLS_SSL_KEY_UPDATE_STATE_PENDING    1   /*!< not written yet      */
+#define MBEDTLS_SSL_KEY_UPDATE_STATE_FLUSH      2   /*!< written, key updated,
+                                                         not flushed yet     */
+
+/*
+ * Handler of a KeyUpdate received after the handshake
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_tls13_process_key_update(mbedtls_ssl_context *ssl);
+
+/*
+ * Write the pending KeyUpdate, if any, and switch to the next sending key
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_tls13_write_key_update(mbedtls_ssl_context *ssl);
+#endif /* MBEDTLS_SSL_TLS1_3_KEY_UPDATE */
+
 MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_reset_transcript_for_hrr(mbedtls_ssl_context *ssl);
 
@@ -2106,6 +2396,38 @@ int mbedtls_ssl_tls13_generate_and_write_xxdh_key_exchange(
     size_t *out_len);
 #endif /* PSA_WANT_ALG_ECDH || PSA_WANT_ALG_FFDH */
 
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+/*
+ * Compress the Certificate message of chain, with an empty
+ * certificate_request_context, into a buffer allocated with
+ * mbedtls_calloc(). Returns MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL if compression
+ * does not save space.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_tls13_compress_cert_chain(const mbedtls_ssl_cert_compression *comp,
+                                          const mbedtls_x509_crt *chain,
+                                          unsigned char **out, size_t *out_len,
+                                          size_t *uncompressed_len);
+
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_tls13_write_compress_certificate_ext(mbedtls_ssl_context *ssl,
+                                                     unsigned char *buf,
+                                                     const unsigned char *end,
+                                                     size_t *out_len);
+
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_tls13_parse_compress_certificate_ext(mbedtls_ssl_context *ssl,
+                                                     const unsigned char *buf,
+                                                     const unsigned char *end);
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
+
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED) && \
+    defined(PSA_WANT_ALG_FFDH)
+/* Return the PSA key type and size of a TLS 1.3 FFDH group. */
+psa_status_t mbedtls_ssl_get_psa_ffdh_info_from_tls_id(
+    uint16_t tls_id, size_t *bits, psa_key_type_t *key_type);
+#endif
+
 #if defined(MBEDTLS_SSL_EARLY_DATA)
 int mbedtls_ssl_tls13_write_early_data_ext(mbedtls_ssl_context *ssl,
                                            int in_new_session_ticket,
@@ -2233,6 +2555,56 @@ static inline int mbedtls_ssl_tls13_named_group_is_ffdh(uint16_t named_group)
            named_group <= MBEDTLS_SSL_IANA_TLS_GROUP_FFDHE8192;
 }
 
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+/*
+ * Lookup tables of a configuration, built by mbedtls_ssl_conf_finalize().
+ * They have a power of two size, at least twice the number of identifiers,
+ * and use linear probing. An identifier of 0 marks a free entry.
+ */
+struct mbedtls_ssl_suite_slot {
+    const mbedtls_ssl_ciphersuite_t *info;  /*!< NULL if the entry is free  */
+    uint16_t id;                            /*!< ciphersuite identifier     */
+    uint16_t pref;                          /*!< index in ciphersuite_list  */
+};
+
+static inline size_t mbedtls_ssl_conf_table_index(uint16_t id,
+                                                  unsigned char bits)
+{
+    /* Fibonacci hashing: identifiers are clustered in a few ranges. */
+    return (size_t) (((uint32_t) id * 0x9E3779B1u) >> (32 - bits));
+}
+
+static inline int mbedtls_ssl_conf_table_contains(const uint16_t *table,
+                                                  unsigned char bits,
+                                                  uint16_t id)
+{
+    size_t mask = ((size_t) 1 << bits) - 1;
+    size_t i = mbedtls_ssl_conf_table_index(id, bits);
+
+    for (; table[i] != 0; i = (i + 1) & mask) {
+        if (table[i] == id) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_CONF_FINALIZE */
+
+/**
+ * \brief Find a ciphersuite in the list of a configuration.
+ *
+ * \param conf       SSL configuration
+ * \param suite_id   Ciphersuite identifier
+ * \param pref       If not \c NULL, set to the index of the ciphersuite in
+ *                   the list of \p conf, where 0 is the most preferred one.
+ *
+ * \return           The ciphersuite if it is in the list of \p conf and
+ *                   supported, \c NULL otherwise.
+ */
+const mbedtls_ssl_ciphersuite_t *mbedtls_ssl_conf_get_ciphersuite(
+    const mbedtls_ssl_config *conf, int suite_id, size_t *pref);
+
 static inline int mbedtls_ssl_named_group_is_offered(
     const mbedtls_ssl_context *ssl, uint16_t named_group)
 {
@@ -2242,6 +2614,14 @@ static inline int mbedtls_ssl_named_group_is_offered(
         return 0;
     }
 
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+    if (group_list == ssl->conf->group_table_src) {
+        return mbedtls_ssl_conf_table_contains(ssl->conf->group_table,
+                                               ssl->conf->group_table_bits,
+                                               named_group);
+    }
+#endif
+
     for (; *group_list != 0; group_list++) {
         if (*group_list == named_group) {
             return 1;
@@ -2305,6 +2685,34 @@ static inline const void *mbedtls_ssl_get_sig_algs(
 #endif /* MBEDTLS_SSL_HANDSHAKE_WITH_CERT_ENABLED */
 }
 
+/*
+ * Signature algorithms supported by the build, indexed by the hash (high)
+ * byte then the signature (low) byte of their identifier, with a
+ * combination of the flags below.
+ */
+#define MBEDTLS_SSL_SIG_ALG_TLS12               0x01 /* usable in TLS 1.2 */
+#define MBEDTLS_SSL_SIG_ALG_TLS13               0x02 /* usable in TLS 1.3 */
+#define MBEDTLS_SSL_SIG_ALG_TLS13_CERT_VERIFY   0x04 /* and in CertificateVerify */
+
+#define MBEDTLS_SSL_SIG_ALG_TABLE_HASHES        9
+#define MBEDTLS_SSL_SIG_ALG_TABLE_SIGS          7
+
+extern const unsigned char
+    mbedtls_ssl_sig_alg_table[MBEDTLS_SSL_SIG_ALG_TABLE_HASHES][MBEDTLS_SSL_SIG_ALG_TABLE_SIGS];
+
+static inline unsigned char mbedtls_ssl_sig_alg_flags(uint16_t sig_alg)
+{
+    unsigned char hash = MBEDTLS_BYTE_1(sig_alg);
+    unsigned char sig = MBEDTLS_BYTE_0(sig_alg);
+
+    if (hash >= MBEDTLS_SSL_SIG_ALG_TABLE_HASHES ||
+        sig >= MBEDTLS_SSL_SIG_ALG_TABLE_SIGS) {
+        return 0;
+    }
+
+    return mbedtls_ssl_sig_alg_table[hash][sig];
+}
+
 #if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED)
 static inline int mbedtls_ssl_sig_alg_is_received(const mbedtls_ssl_context *ssl,
                                                   uint16_t own_sig_alg)
@@ -2325,66 +2733,15 @@ static inline int mbedtls_ssl_sig_alg_is_received(const mbedtls_ssl_context *ssl
 static inline int mbedtls_ssl_tls13_sig_alg_for_cert_verify_is_supported(
     const uint16_t sig_alg)
 {
-    switch (sig_alg) {
-#if defined(PSA_HAVE_ALG_SOME_ECDSA)
-#if defined(PSA_WANT_ALG_SHA_256) && defined(PSA_WANT_ECC_SECP_R1_256)
-        case MBEDTLS_TLS1_3_SIG_ECDSA_SECP256R1_SHA256:
-            break;
-#endif /* PSA_WANT_ALG_SHA_256 && MBEDTLS_ECP_DP_SECP256R1_ENABLED */
-#if defined(PSA_WANT_ALG_SHA_384) && defined(PSA_WANT_ECC_SECP_R1_384)
-        case MBEDTLS_TLS1_3_SIG_ECDSA_SECP384R1_SHA384:
-            break;
-#endif /* PSA_WANT_ALG_SHA_384 && MBEDTLS_ECP_DP_SECP384R1_ENABLED */
-#if defined(PSA_WANT_ALG_SHA_512) && defined(PSA_WANT_ECC_SECP_R1_521)
-        case MBEDTLS_TLS1_3_SIG_ECDSA_SECP521R1_SHA512:
-            break;
-#endif /* PSA_WANT_ALG_SHA_512 && MBEDTLS_ECP_DP_SECP521R1_ENABLED */
-#endif /* PSA_HAVE_ALG_SOME_ECDSA */
-
-#if defined(MBEDTLS_PKCS1_V21)
-#if defined(PSA_WANT_ALG_SHA_256)
-        case MBEDTLS_TLS1_3_SIG_RSA_PSS_RSAE_SHA256:
-            break;
-#endif /* PSA_WANT_ALG_SHA_256  */
-#if defined(PSA_WANT_ALG_SHA_384)
-        case MBEDTLS_TLS1_3_SIG_RSA_PSS_RSAE_SHA384:
-            break;
-#endif /* PSA_WANT_ALG_SHA_384 */
-#if defined(PSA_WANT_ALG_SHA_512)
-        case MBEDTLS_TLS1_3_SIG_RSA_PSS_RSAE_SHA512:
-            break;
-#endif /* PSA_WANT_ALG_SHA_512 */
-#endif /* MBEDTLS_PKCS1_V21 */
-        default:
-            return 0;
-    }
-    return 1;
-
+    return (mbedtls_ssl_sig_alg_flags(sig_alg) &
+            MBEDTLS_SSL_SIG_ALG_TLS13_CERT_VERIFY) != 0;
 }
 
 static inline int mbedtls_ssl_tls13_sig_alg_is_supported(
     const uint16_t sig_alg)
 {
-    switch (sig_alg) {
-#if defined(MBEDTLS_PKCS1_V15)
-#if defined(PSA_WANT_ALG_SHA_256)
-        case MBEDTLS_TLS1_3_SIG_RSA_PKCS1_SHA256:
-            break;
-#endif /* PSA_WANT_ALG_SHA_256 */
-#if defined(PSA_WANT_ALG_SHA_384)
-        case MBEDTLS_TLS1_3_SIG_RSA_PKCS1_SHA384:
-            break;
-#endif /* PSA_WANT_ALG_SHA_384 */
-#if defined(PSA_WANT_ALG_SHA_512)
-        case MBEDTLS_TLS1_3_SIG_RSA_PKCS1_SHA512:
-            break;
-#endif /* PSA_WANT_ALG_SHA_512 */
-#endif /* MBEDTLS_PKCS1_V15 */
-        default:
-            return mbedtls_ssl_tls13_sig_alg_for_cert_verify_is_supported(
-                sig_alg);
-    }
-    return 1;
+    return (mbedtls_ssl_sig_alg_flags(sig_alg) &
+            MBEDTLS_SSL_SIG_ALG_TLS13) != 0;
 }
 
 MBEDTLS_CHECK_RETURN_CRITICAL
@@ -2401,6 +2758,14 @@ static inline int mbedtls_ssl_sig_alg_is_offered(const mbedtls_ssl_context *ssl,
         return 0;
     }
 
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+    if (sig_alg == ssl->conf->sig_alg_table_src) {
+        return mbedtls_ssl_conf_table_contains(ssl->conf->sig_alg_table,
+                                               ssl->conf->sig_alg_table_bits,
+                                               proposed_sig_alg);
+    }
+#endif
+
     for (; *sig_alg != MBEDTLS_TLS_SIG_NONE; sig_alg++) {
         if (*sig_alg == proposed_sig_alg) {
             return 1;
@@ -2450,61 +2815,8 @@ static inline int mbedtls_ssl_get_pk_type_and_md_alg_from_sig_alg(
 static inline int mbedtls_ssl_tls12_sig_alg_is_supported(
     const uint16_t sig_alg)
 {
-    /* High byte is hash */
-    unsigned char hash = MBEDTLS_BYTE_1(sig_alg);
-    unsigned char sig = MBEDTLS_BYTE_0(sig_alg);
-
-    switch (hash) {
-#if defined(PSA_WANT_ALG_MD5)
-        case MBEDTLS_SSL_HASH_MD5:
-            break;
-#endif
-
-#if defined(PSA_WANT_ALG_SHA_1)
-        case MBEDTLS_SSL_HASH_SHA1:
-            break;
-#endif
-
-#if defined(PSA_WANT_ALG_SHA_224)
-        case MBEDTLS_SSL_HASH_SHA224:
-            break;
-#endif
-
-#if defined(PSA_WANT_ALG_SHA_256)
-        case MBEDTLS_SSL_HASH_SHA256:
-            break;
-#endif
-
-#if defined(PSA_WANT_ALG_SHA_384)
-        case MBEDTLS_SSL_HASH_SHA384:
-            break;
-#endif
-
-#if defined(PSA_WANT_ALG_SHA_512)
-        case MBEDTLS_SSL_HASH_SHA512:
-            break;
-#endif
-
-        default:
-            return 0;
-    }
-
-    switch (sig) {
-#if defined(MBEDTLS_RSA_C)
-        case MBEDTLS_SSL_SIG_RSA:
-            break;
-#endif
-
-#if defined(MBEDTLS_KEY_EXCHANGE_ECDSA_CERT_REQ_ALLOWED_ENABLED)
-        case MBEDTLS_SSL_SIG_ECDSA:
-            break;
-#endif
-
-        default:
-            return 0;
-    }
-
-    return 1;
+    return (mbedtls_ssl_sig_alg_flags(sig_alg) &
+            MBEDTLS_SSL_SIG_ALG_TLS12) != 0;
 }
 #endif /* MBEDTLS_SSL_PROTO_TLS1_2 */
 
@@ -2672,6 +2984,13 @@ static inline int mbedtls_ssl_tls13_cipher_suite_is_offered(
 {
     const int *ciphersuite_list = ssl->conf->ciphersuite_list;
 
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+    if (ciphersuite_list == ssl->conf->suite_table_src) {
+        return mbedtls_ssl_conf_get_ciphersuite(ssl->conf, cipher_suite,
+                                                NULL) != NULL;
+    }
+#endif
+
     /* Check whether we have offered this ciphersuite */
     for (size_t i = 0; ciphersuite_list[i] != 0; i++) {
         if (ciphersuite_list[i] == cipher_suite) {
@@ -2735,9 +3054,26 @@ int mbedtls_ssl_write_alpn_ext(mbedtls_ssl_context *ssl,
                                size_t *out_len);
 #endif /* MBEDTLS_SSL_ALPN */
 
-#if defined(MBEDTLS_TEST_HOOKS)
+#if defined(MBEDTLS_TEST_HOOKS) && defined(MBEDTLS_SSL_PROTO_DTLS)
+int mbedtls_ssl_double_retransmit_timeout(mbedtls_ssl_context *ssl);
+#if defined(MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT)
+void mbedtls_ssl_dtls_rtt_update(mbedtls_ssl_context *ssl, uint32_t rtt);
+#endif
+#endif /* MBEDTLS_TEST_HOOKS && MBEDTLS_SSL_PROTO_DTLS */
+
+#if (defined(MBEDTLS_SSL_DTLS_CLIENT_PORT_REUSE) || \
+    defined(MBEDTLS_SSL_DTLS_DEMUX_C)) && defined(MBEDTLS_SSL_SRV_C)
+/*
+ * Check whether a datagram from the client \p cli_id is a ClientHello with
+ * a valid cookie, using the cookie callbacks of \p conf. Returns
+ * MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED with the HelloVerifyRequest to send
+ * in \p obuf if it is a ClientHello without one. \p ssl is only used for
+ * debug output and may be NULL.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_check_dtls_clihlo_cookie(
-    mbedtls_ssl_context *ssl,
+    const mbedtls_ssl_config *conf,
+    const mbedtls_ssl_context *ssl,
     const unsigned char *cli_id, size_t cli_id_len,
     const unsigned char *in, size_t in_len,
     unsigned char *obuf, size_t buf_len, size_t *olen);
@@ -2855,6 +3191,115 @@ static inline void mbedtls_ssl_tls13_session_clear_ticket_flags(
 int mbedtls_ssl_tls13_finalize_client_hello(mbedtls_ssl_context *ssl);
 #endif
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+/*
+ * Asynchronous public key operations, see mbedtls_ssl_conf_async_crypto_cb().
+ *
+ * Each of these functions performs the operation inline when no callbacks
+ * are configured. Otherwise the first call hands the operation over to the
+ * callbacks and returns MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS; the handshake
+ * must then return and, when resumed, call the same function again, which
+ * returns the result once the operation is done. The arguments of the
+ * later calls are ignored: the job keeps what it needs.
+ */
+
+/* Generate the (EC)DHE private key described by attributes into *key. */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_async_generate_key(mbedtls_ssl_context *ssl,
+                                   const psa_key_attributes_t *attributes,
+                                   mbedtls_svc_key_id_t *key);
+
+/* Compute the raw (EC)DHE shared secret of key and the peer's public key
+ * into a buffer allocated with mbedtls_calloc() and returned in *secret.
+ * If secret is NULL, only make sure that the computation is started or
+ * complete, and keep the result for a later call. The peer's public key
+ * must remain unchanged until the result has been consumed. */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_async_key_agreement(mbedtls_ssl_context *ssl,
+                                    psa_algorithm_t alg,
+                                    mbedtls_svc_key_id_t key,
+                                    const unsigned char *peer, size_t peer_len,
+                                    unsigned char **secret, size_t *secret_len);
+
+/* Verify a signature made with the public key pk, as
+ * mbedtls_pk_verify_ext(). The signature is copied; pk must remain valid
+ * until the result has been consumed. */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_async_verify(mbedtls_ssl_context *ssl,
+                             mbedtls_pk_type_t type, const void *options,
+                             mbedtls_pk_context *pk, mbedtls_md_type_t md_alg,
+                             const unsigned char *hash, size_t hash_len,
+                             const unsigned char *sig, size_t sig_len);
+
+/* Whether an operation of the given type has been started and its result
+ * not consumed yet, i.e. whether the current handshake step is resuming. */
+int mbedtls_ssl_async_job_is_pending(const mbedtls_ssl_context *ssl,
+                                     mbedtls_ssl_async_job_type type);
+
+/* Cancel or discard the job of the handshake and free its resources. */
+void mbedtls_ssl_async_job_free(mbedtls_ssl_context *ssl);
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
+
+#if defined(MBEDTLS_SSL_KEY_SHARE_POOL_C)
+/* Move a pre-generated key pair matching the type, bits and algorithm of
+ * attributes from the pool into *key. Returns 0 on success, or
+ * MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND if the pool has none, which is
+ * counted as a miss. */
+int mbedtls_ssl_key_share_pool_take(mbedtls_ssl_key_share_pool *pool,
+                                    const psa_key_attributes_t *attributes,
+                                    mbedtls_svc_key_id_t *key);
+#endif /* MBEDTLS_SSL_KEY_SHARE_POOL_C */
+
+#if defined(MBEDTLS_SSL_GROUP_CACHE_C)
+/* Return the group last selected by the server hostname, or 0. */
+uint16_t mbedtls_ssl_group_cache_get(mbedtls_ssl_group_cache *cache,
+                                     const char *hostname);
+
+/* Remember the group selected by the server hostname. */
+void mbedtls_ssl_group_cache_set(mbedtls_ssl_group_cache *cache,
+                                 const char *hostname,
+                                 uint16_t group);
+#endif /* MBEDTLS_SSL_GROUP_CACHE_C */
+
+#if defined(MBEDTLS_SSL_VERIFY_CACHE_C)
+/* Look up a chain verified against the given trust anchors, CRLs and
+ * profile. Returns 0 if found, or MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND,
+ * which is counted as a miss. */
+int mbedtls_ssl_verify_cache_get(mbedtls_ssl_verify_cache *cache,
+                                 const mbedtls_x509_crt *chain,
+                                 const mbedtls_x509_crt *ca_chain,
+                                 const mbedtls_x509_crl *ca_crl,
+                                 const mbedtls_x509_crt_profile *profile);
+
+/* Remember a chain that verified successfully. */
+int mbedtls_ssl_verify_cache_set(mbedtls_ssl_verify_cache *cache,
+                                 const mbedtls_x509_crt *chain,
+                                 const mbedtls_x509_crt *ca_chain,
+                                 const mbedtls_x509_crl *ca_crl,
+                                 const mbedtls_x509_crt_profile *profile);
+#endif /* MBEDTLS_SSL_VERIFY_CACHE_C */
+
+/*
+ * Generate the ephemeral (EC)DH key pair described by attributes into *key,
+ * taking it from the key share pool of the configuration if there is one.
+ */
+static inline psa_status_t mbedtls_ssl_generate_ephemeral_key(
+    const mbedtls_ssl_context *ssl,
+    const psa_key_attributes_t *attributes,
+    mbedtls_svc_key_id_t *key)
+{
+#if defined(MBEDTLS_SSL_KEY_SHARE_POOL_C)
+    if (ssl->conf->key_share_pool != NULL &&
+        mbedtls_ssl_key_share_pool_take(ssl->conf->key_share_pool,
+                                        attributes, key) == 0) {
+        return PSA_SUCCESS;
+    }
+#else
+    (void) ssl;
+#endif
+    return psa_generate_key(attributes, key);
+}
+
 #if defined(MBEDTLS_TEST_HOOKS) && defined(MBEDTLS_SSL_SOME_SUITES_USE_MAC)
 
 /** Compute the HMAC of variable-length data with constant flow.
@@ -270,6 +270,12 @@ exit:
 #define SSL_DONT_FORCE_FLUSH 0
 #define SSL_FORCE_FLUSH      1
 
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+/* Room, header included, that a handshake message which does not announce
+ * its length gets behind the messages that wait for it in a record. */
+#define SSL_COALESCE_MIN_ROOM 1024
+#endif
+
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
 
 /* Forward declarations for functions related to message buffering. */
@@ -374,12 +380,83 @@ static int ssl_get_remaining_payload_in_datagram(mbedtls_ssl_context const *ssl)
     return (int) remaining;
 }
 
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+/*
+ * Lower the path MTU estimate after a datagram of size `failed` did not get
+ * through. If the transport told us so, sizes from `failed` up are ruled out
+ * for the rest of the connection; after timeouts, which may be plain loss,
+ * only the current estimate is lowered. Either way the new estimate is
+ * halfway between the largest confirmed size and the failed one.
+ */
+static void ssl_pmtu_lower(mbedtls_ssl_context *ssl, size_t failed,
+                           int known_too_big)
+{
+    size_t ceiling, target;
+
+    if (ssl->pmtu_min == 0 || failed == 0) {
+        return;
+    }
+
+    ceiling = failed - 1;
+    if (ceiling < ssl->pmtu_min) {
+        ceiling = ssl->pmtu_min;
+    }
+
+    if (known_too_big && ceiling < ssl->pmtu_ceiling) {
+        ssl->pmtu_ceiling = (uint16_t) ceiling;
+        if (ssl->pmtu_confirmed > ceiling) {
+            /* The path has changed under us */
+            ssl->pmtu_confirmed = ssl->pmtu_min;
+        }
+    }
+
+    if (ceiling > ssl->pmtu_ceiling) {
+        ceiling = ssl->pmtu_ceiling;
+    }
+
+    if (ceiling <= ssl->pmtu_confirmed) {
+        target = ssl->pmtu_confirmed;
+    } else {
+        target = ssl->pmtu_confirmed + (ceiling - ssl->pmtu_confirmed) / 2;
+    }
+
+    if (ssl->mtu == 0 || target < ssl->mtu) {
+        ssl->mtu = (uint16_t) target;
+        MBEDTLS_SSL_DEBUG_MSG(2, ("pmtu lowered to %u bytes",
+                                  (unsigned) ssl->mtu));
+    }
+}
+
+/*
+ * Our last flight was answered, so all of its datagrams got through.
+ */
+static void ssl_pmtu_confirm(mbedtls_ssl_context *ssl)
+{
+    size_t size = ssl->handshake->flight_max_dgram;
+
+    ssl->handshake->flight_max_dgram = 0;
+
+    if (ssl->pmtu_min == 0 || size <= ssl->pmtu_confirmed ||
+        size > ssl->pmtu_ceiling) {
+        return;
+    }
+
+    ssl->pmtu_confirmed = (uint16_t) size;
+    if (ssl->mtu < ssl->pmtu_confirmed) {
+        ssl->mtu = ssl->pmtu_confirmed;
+    }
+    MBEDTLS_SSL_DEBUG_MSG(2, ("pmtu confirmed at %u bytes",
+                              (unsigned) ssl->pmtu_confirmed));
+}
+#endif /* MBEDTLS_SSL_DTLS_PMTU_DISCOVERY */
+
 /*
  * Double the retransmit timeout value, within the allowed range,
  * returning -1 if the maximum value has already been reached.
  */
 MBEDTLS_CHECK_RETURN_CRITICAL
-static int ssl_double_retransmit_timeout(mbedtls_ssl_context *ssl)
+MBEDTLS_STATIC_TESTABLE
+int mbedtls_ssl_double_retransmit_timeout(mbedtls_ssl_context *ssl)
 {
     uint32_t new_timeout;
 
@@ -393,9 +470,22 @@ static int ssl_double_retransmit_timeout(mbedtls_ssl_context *ssl)
      * This value is guaranteed to be deliverable (if not guaranteed to be
      * delivered) of any compliant IPv4 (and IPv6) network, and should work
      * on most non-IP stacks too. */
-    if (ssl->handshake->retransmit_timeout != ssl->conf->hs_timeout_min) {
-        ssl->handshake->mtu = 508;
-        MBEDTLS_SSL_DEBUG_MSG(2, ("mtu autoreduction to %d bytes", ssl->handshake->mtu));
+    if (ssl->handshake->retransmit_count != 0) {
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+        if (ssl->pmtu_min != 0) {
+            /* Path MTU discovery replaces the fixed fallback */
+            if (ssl->handshake->flight_max_dgram > ssl->pmtu_confirmed) {
+                ssl_pmtu_lower(ssl, ssl->handshake->flight_max_dgram, 0);
+            }
+        } else
+#endif
+        {
+            ssl->handshake->mtu = 508;
+            MBEDTLS_SSL_DEBUG_MSG(2, ("mtu autoreduction to %d bytes", ssl->handshake->mtu));
+        }
+    }
+    if (ssl->handshake->retransmit_count < 255) {
+        ssl->handshake->retransmit_count++;
     }
 
     new_timeout = 2 * ssl->handshake->retransmit_timeout;
@@ -413,9 +503,88 @@ static int ssl_double_retransmit_timeout(mbedtls_ssl_context *ssl)
     return 0;
 }
 
+#if defined(MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT)
+/*
+ * Feed a flight round-trip time of `rtt` milliseconds into the estimate.
+ * This follows RFC 6298 section 2 with alpha = 1/8 and beta = 1/4, at
+ * flight granularity.
+ */
+MBEDTLS_STATIC_TESTABLE
+void mbedtls_ssl_dtls_rtt_update(mbedtls_ssl_context *ssl, uint32_t rtt)
+{
+    mbedtls_ssl_handshake_params * const hs = ssl->handshake;
+    uint64_t r = rtt, delta;
+
+    if (r > ssl->conf->hs_timeout_max) {
+        r = ssl->conf->hs_timeout_max;
+    }
+
+    if (hs->rtt_valid == 0) {
+        hs->srtt = (uint32_t) r;
+        hs->rttvar = (uint32_t) (r / 2);
+        hs->rtt_valid = 1;
+    } else {
+        delta = hs->srtt > r ? hs->srtt - r : r - hs->srtt;
+        hs->rttvar = (uint32_t) ((3 * (uint64_t) hs->rttvar + delta + 2) / 4);
+        hs->srtt = (uint32_t) ((7 * (uint64_t) hs->srtt + r + 4) / 8);
+    }
+
+    MBEDTLS_SSL_DEBUG_MSG(3, ("flight rtt %lu ms, srtt %lu ms, rttvar %lu ms",
+                              (unsigned long) r, (unsigned long) hs->srtt,
+                              (unsigned long) hs->rttvar));
+}
+
+/*
+ * Feed the time since our last flight was first sent, which has just been
+ * answered, into the round-trip time estimate. Flights that were
+ * retransmitted give ambiguous samples and are skipped (Karn's rule).
+ */
+static void ssl_update_flight_rtt(mbedtls_ssl_context *ssl)
+{
+    mbedtls_ssl_handshake_params * const hs = ssl->handshake;
+    mbedtls_ms_time_t elapsed;
+
+    if (hs->rtt_pending == 0) {
+        return;
+    }
+    hs->rtt_pending = 0;
+
+    elapsed = mbedtls_ms_time() - hs->flight_start;
+    if (elapsed < 0) {
+        return;
+    }
+
+    mbedtls_ssl_dtls_rtt_update(ssl, elapsed > (mbedtls_ms_time_t) UINT32_MAX ?
+                                UINT32_MAX : (uint32_t) elapsed);
+}
+#endif /* MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT */
+
+/*
+ * Set the timeout for the first transmission of a flight: the configured
+ * minimum, or SRTT + 4 * RTTVAR once a round trip has been measured,
+ * within the configured range.
+ */
 static void ssl_reset_retransmit_timeout(mbedtls_ssl_context *ssl)
 {
-    ssl->handshake->retransmit_timeout = ssl->conf->hs_timeout_min;
+    uint32_t timeout = ssl->conf->hs_timeout_min;
+
+#if defined(MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT)
+    if (ssl->handshake->rtt_valid != 0) {
+        uint64_t rto = (uint64_t) ssl->handshake->srtt +
+                       (ssl->handshake->rttvar != 0 ?
+                        4 * (uint64_t) ssl->handshake->rttvar : 1);
+
+        if (rto > ssl->conf->hs_timeout_max) {
+            rto = ssl->conf->hs_timeout_max;
+        }
+        if (rto > timeout) {
+            timeout = (uint32_t) rto;
+        }
+    }
+#endif
+
+    ssl->handshake->retransmit_timeout = timeout;
+    ssl->handshake->retransmit_count = 0;
     MBEDTLS_SSL_DEBUG_MSG(3, ("update timeout value to %lu millisecs",
                               (unsigned long) ssl->handshake->retransmit_timeout));
 }
@@ -2000,7 +2169,7 @@ int mbedtls_ssl_fetch_input(mbedtls_ssl_context *ssl, size_t nb_want)
             mbedtls_ssl_set_timer(ssl, 0);
 
             if (ssl->state != MBEDTLS_SSL_HANDSHAKE_OVER) {
-                if (ssl_double_retransmit_timeout(ssl) != 0) {
+                if (mbedtls_ssl_double_retransmit_timeout(ssl) != 0) {
                     MBEDTLS_SSL_DEBUG_MSG(1, ("handshake timeout"));
                     return MBEDTLS_ERR_SSL_TIMEOUT;
                 }
@@ -2091,6 +2260,9 @@ int mbedtls_ssl_flush_output(mbedtls_ssl_context *ssl)
 {
     int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
     unsigned char *buf;
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+    int too_big = 0;
+#endif
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("=> flush output"));
 
@@ -2111,10 +2283,31 @@ int mbedtls_ssl_flush_output(mbedtls_ssl_context *ssl)
                                   mbedtls_ssl_out_hdr_len(ssl) + ssl->out_msglen, ssl->out_left));
 
         buf = ssl->out_hdr - ssl->out_left;
+
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+        if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM &&
+            ssl->handshake != NULL &&
+            ssl->out_left > ssl->handshake->flight_max_dgram) {
+            ssl->handshake->flight_max_dgram = ssl->out_left;
+        }
+#endif
+
         ret = ssl->f_send(ssl->p_bio, buf, ssl->out_left);
 
         MBEDTLS_SSL_DEBUG_RET(2, "ssl->f_send", ret);
 
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+        if (ret == MBEDTLS_ERR_SSL_DATAGRAM_TOO_BIG &&
+            ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM &&
+            ssl->pmtu_min != 0) {
+            /* Drop the datagram, as the network would have */
+            ssl_pmtu_lower(ssl, ssl->out_left, 1);
+            ssl->out_left = 0;
+            too_big = 1;
+            break;
+        }
+#endif
+
         if (ret <= 0) {
             return ret;
         }
@@ -2133,6 +2326,7 @@ int mbedtls_ssl_flush_output(mbedtls_ssl_context *ssl)
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
     if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
         ssl->out_hdr = ssl->out_buf;
+        ssl->app_data_held_len = 0;
     } else
 #endif
     {
@@ -2142,6 +2336,14 @@ int mbedtls_ssl_flush_output(mbedtls_ssl_context *ssl)
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("<= flush output"));
 
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+    /* Handshake messages are recovered by retransmission; whoever wrote
+     * anything else needs to know that it was lost. */
+    if (too_big && ssl->handshake == NULL) {
+        return MBEDTLS_ERR_SSL_DATAGRAM_TOO_BIG;
+    }
+#endif
+
     return 0;
 }
 
@@ -2149,28 +2351,64 @@ int mbedtls_ssl_flush_output(mbedtls_ssl_context *ssl)
  * Functions to handle the DTLS retransmission state machine
  */
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
+/*
+ * Whether the pending output only consists of application records held back
+ * by datagram packing.
+ */
+static int ssl_app_data_only_held(const mbedtls_ssl_context *ssl)
+{
+    return ssl->app_data_packing && ssl->out_left == ssl->app_data_held_len;
+}
+
+/*
+ * Send the application records held back by datagram packing if the oldest
+ * of them has waited for the configured maximum delay.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_flush_app_data_if_due(mbedtls_ssl_context *ssl)
+{
+#if defined(MBEDTLS_HAVE_TIME)
+    if (mbedtls_ssl_get_flush_timeout(ssl) == 0) {
+        MBEDTLS_SSL_DEBUG_MSG(3, ("packed application data is due"));
+        return mbedtls_ssl_flush_output(ssl);
+    }
+#else
+    (void) ssl;
+#endif
+    return 0;
+}
+
 /*
  * Append current handshake message to current outgoing flight
  */
 MBEDTLS_CHECK_RETURN_CRITICAL
 static int ssl_flight_append(mbedtls_ssl_context *ssl)
 {
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
     mbedtls_ssl_flight_item *msg;
     MBEDTLS_SSL_DEBUG_MSG(2, ("=> ssl_flight_append"));
     MBEDTLS_SSL_DEBUG_BUF(4, "message appended to flight",
                           ssl->out_msg, ssl->out_msglen);
 
+    ret = mbedtls_ssl_check_memory(ssl, sizeof(mbedtls_ssl_flight_item) +
+                                   ssl->out_msglen);
+    if (ret != 0) {
+        return ret;
+    }
+
     /* Allocate space for current message */
-    if ((msg = mbedtls_calloc(1, sizeof(mbedtls_ssl_flight_item))) == NULL) {
+    if ((msg = mbedtls_ssl_hs_calloc(ssl->handshake, 1,
+                                     sizeof(mbedtls_ssl_flight_item))) == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("alloc %" MBEDTLS_PRINTF_SIZET " bytes failed",
                                   sizeof(mbedtls_ssl_flight_item)));
         return MBEDTLS_ERR_SSL_ALLOC_FAILED;
     }
 
-    if ((msg->p = mbedtls_calloc(1, ssl->out_msglen)) == NULL) {
+    if ((msg->p = mbedtls_ssl_hs_calloc(ssl->handshake, 1,
+                                        ssl->out_msglen)) == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("alloc %" MBEDTLS_PRINTF_SIZET " bytes failed",
                                   ssl->out_msglen));
-        mbedtls_free(msg);
+        mbedtls_ssl_hs_free(ssl->handshake, msg);
         return MBEDTLS_ERR_SSL_ALLOC_FAILED;
     }
 
@@ -2198,7 +2436,8 @@ static int ssl_flight_append(mbedtls_ssl_context *ssl)
 /*
  * Free the current flight of handshake messages
  */
-void mbedtls_ssl_flight_free(mbedtls_ssl_flight_item *flight)
+void mbedtls_ssl_flight_free(mbedtls_ssl_handshake_params *handshake,
+                             mbedtls_ssl_flight_item *flight)
 {
     mbedtls_ssl_flight_item *cur = flight;
     mbedtls_ssl_flight_item *next;
@@ -2206,8 +2445,8 @@ void mbedtls_ssl_flight_free(mbedtls_ssl_flight_item *flight)
     while (cur != NULL) {
         next = cur->next;
 
-        mbedtls_free(cur->p);
-        mbedtls_free(cur);
+        mbedtls_ssl_hs_free(handshake, cur->p);
+        mbedtls_ssl_hs_free(handshake, cur);
 
         cur = next;
     }
@@ -2256,6 +2495,11 @@ int mbedtls_ssl_resend(mbedtls_ssl_context *ssl)
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("=> mbedtls_ssl_resend"));
 
+#if defined(MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT)
+    /* The answer could be to either transmission: no RTT sample */
+    ssl->handshake->rtt_pending = 0;
+#endif
+
     ret = mbedtls_ssl_flight_transmit(ssl);
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("<= mbedtls_ssl_resend"));
@@ -2278,6 +2522,10 @@ int mbedtls_ssl_flight_transmit(mbedtls_ssl_context *ssl)
     if (ssl->handshake->retransmit_state != MBEDTLS_SSL_RETRANS_SENDING) {
         MBEDTLS_SSL_DEBUG_MSG(2, ("initialise flight transmission"));
 
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+        ssl->handshake->flight_max_dgram = 0;
+#endif
+
         ssl->handshake->cur_msg = ssl->handshake->flight;
         ssl->handshake->cur_msg_p = ssl->handshake->flight->p + 12;
         ret = ssl_swap_epochs(ssl);
@@ -2428,8 +2676,15 @@ int mbedtls_ssl_flight_transmit(mbedtls_ssl_context *ssl)
  */
 void mbedtls_ssl_recv_flight_completed(mbedtls_ssl_context *ssl)
 {
+#if defined(MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT)
+    ssl_update_flight_rtt(ssl);
+#endif
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+    ssl_pmtu_confirm(ssl);
+#endif
+
     /* We won't need to resend that one any more */
-    mbedtls_ssl_flight_free(ssl->handshake->flight);
+    mbedtls_ssl_flight_free(ssl->handshake, ssl->handshake->flight);
     ssl->handshake->flight = NULL;
     ssl->handshake->cur_msg = NULL;
 
@@ -2458,6 +2713,11 @@ void mbedtls_ssl_recv_flight_completed(mbedtls_ssl_context *ssl)
  */
 void mbedtls_ssl_send_flight_completed(mbedtls_ssl_context *ssl)
 {
+#if defined(MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT)
+    ssl->handshake->flight_start = mbedtls_ms_time();
+    ssl->handshake->rtt_pending = 1;
+#endif
+
     ssl_reset_retransmit_timeout(ssl);
     mbedtls_ssl_set_timer(ssl, ssl->handshake->retransmit_timeout);
 
@@ -2473,9 +2733,88 @@ void mbedtls_ssl_send_flight_completed(mbedtls_ssl_context *ssl)
 /*
  * Handshake layer functions
  */
-int mbedtls_ssl_start_handshake_msg(mbedtls_ssl_context *ssl, unsigned char hs_type,
-                                    unsigned char **buf, size_t *buf_len)
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+/*
+ * TLS 1.3 handshake messages are coalesced until the application keys are in
+ * use. Before that, nothing else is written while handshake messages wait.
+ */
+static int ssl_can_coalesce_handshake(const mbedtls_ssl_context *ssl)
 {
+    return ssl->handshake != NULL &&
+           ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_STREAM &&
+           ssl->tls_version == MBEDTLS_SSL_VERSION_TLS1_3 &&
+           ssl->transform_out != ssl->transform_application;
+}
+
+/*
+ * Room left for a handshake message, including its header, in the record
+ * that is being filled.
+ */
+static int ssl_get_coalesce_room(mbedtls_ssl_context *ssl, size_t *room)
+{
+    int ret = mbedtls_ssl_get_max_out_record_payload(ssl);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    *room = MBEDTLS_SSL_OUT_CONTENT_LEN;
+    if ((size_t) ret < *room) {
+        *room = (size_t) ret;
+    }
+    *room = *room > ssl->handshake->out_coalesced ?
+            *room - ssl->handshake->out_coalesced : 0;
+
+    return 0;
+}
+
+int mbedtls_ssl_write_coalesced_handshake(mbedtls_ssl_context *ssl)
+{
+    if (ssl->handshake == NULL || ssl->handshake->out_coalesced == 0) {
+        return 0;
+    }
+
+    MBEDTLS_SSL_DEBUG_MSG(3, ("send %" MBEDTLS_PRINTF_SIZET
+                              " bytes of coalesced handshake messages",
+                              ssl->handshake->out_coalesced));
+
+    ssl->out_msg -= ssl->handshake->out_coalesced;
+    ssl->out_msglen = ssl->handshake->out_coalesced;
+    ssl->out_msgtype = MBEDTLS_SSL_MSG_HANDSHAKE;
+    ssl->handshake->out_coalesced = 0;
+
+    return mbedtls_ssl_write_record(ssl, SSL_FORCE_FLUSH);
+}
+#endif /* MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE */
+
+int mbedtls_ssl_start_handshake_msg_ext(mbedtls_ssl_context *ssl,
+                                        unsigned char hs_type, size_t need,
+                                        unsigned char **buf, size_t *buf_len)
+{
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    size_t room = MBEDTLS_SSL_OUT_CONTENT_LEN;
+
+    if (ssl->handshake != NULL && ssl->handshake->out_coalesced != 0) {
+        if ((ret = ssl_get_coalesce_room(ssl, &room)) != 0) {
+            return ret;
+        }
+
+        /* The message may not fit behind the ones that wait for it: send
+         * them, and start the message in a record of its own. */
+        if (room < need) {
+            if ((ret = mbedtls_ssl_write_coalesced_handshake(ssl)) != 0) {
+                MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_write_coalesced_handshake",
+                                      ret);
+                return ret;
+            }
+            room = MBEDTLS_SSL_OUT_CONTENT_LEN;
+        }
+    }
+#else
+    ((void) need);
+#endif /* MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE */
+
     /*
      * Reserve 4 bytes for handshake header. ( Section 4,RFC 8446 )
      *    ...
@@ -2484,7 +2823,11 @@ int mbedtls_ssl_start_handshake_msg(mbedtls_ssl_context *ssl, unsigned char hs_t
      *    ...
      */
     *buf = ssl->out_msg + 4;
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    *buf_len = room - 4;
+#else
     *buf_len = MBEDTLS_SSL_OUT_CONTENT_LEN - 4;
+#endif
 
     ssl->out_msgtype = MBEDTLS_SSL_MSG_HANDSHAKE;
     ssl->out_msg[0]  = hs_type;
@@ -2492,6 +2835,18 @@ int mbedtls_ssl_start_handshake_msg(mbedtls_ssl_context *ssl, unsigned char hs_t
     return 0;
 }
 
+int mbedtls_ssl_start_handshake_msg(mbedtls_ssl_context *ssl, unsigned char hs_type,
+                                    unsigned char **buf, size_t *buf_len)
+{
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    return mbedtls_ssl_start_handshake_msg_ext(ssl, hs_type,
+                                               SSL_COALESCE_MIN_ROOM,
+                                               buf, buf_len);
+#else
+    return mbedtls_ssl_start_handshake_msg_ext(ssl, hs_type, 0, buf, buf_len);
+#endif
+}
+
 /*
  * Write (DTLS: or queue) current handshake (including CCS) message.
  *
@@ -2625,6 +2980,35 @@ int mbedtls_ssl_write_handshake_msg_ext(mbedtls_ssl_context *ssl,
         }
     }
 
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    /*
+     * Keep the message behind the ones already waiting, unless it has to go
+     * now. Otherwise, send the waiting messages in the same record.
+     */
+    if (ssl->out_msgtype == MBEDTLS_SSL_MSG_HANDSHAKE &&
+        ssl_can_coalesce_handshake(ssl)) {
+        size_t room;
+
+        if ((ret = ssl_get_coalesce_room(ssl, &room)) != 0) {
+            return ret;
+        }
+
+        if (force_flush == SSL_DONT_FORCE_FLUSH && ssl->out_left == 0 &&
+            ssl->out_msglen <= room) {
+            ssl->handshake->out_coalesced += ssl->out_msglen;
+            ssl->out_msg += ssl->out_msglen;
+            ssl->out_msglen = 0;
+
+            MBEDTLS_SSL_DEBUG_MSG(2, ("<= write handshake message (coalesced)"));
+            return 0;
+        }
+
+        ssl->out_msg -= ssl->handshake->out_coalesced;
+        ssl->out_msglen += ssl->handshake->out_coalesced;
+        ssl->handshake->out_coalesced = 0;
+    }
+#endif /* MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE */
+
     /* Either send now, or just save to be sent (and resent) later */
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
     if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM &&
@@ -2684,6 +3068,23 @@ int mbedtls_ssl_write_record(mbedtls_ssl_context *ssl, int force_flush)
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("=> write record"));
 
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    /* The handshake messages that wait for the next one must go first: a
+     * handshake message written directly joins them in the same record,
+     * anything else must have sent them beforehand. */
+    if (ssl->handshake != NULL && ssl->handshake->out_coalesced != 0) {
+        if (ssl->out_msgtype != MBEDTLS_SSL_MSG_HANDSHAKE) {
+            MBEDTLS_SSL_DEBUG_MSG(1, ("should never happen"));
+            return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+        }
+
+        ssl->out_msg -= ssl->handshake->out_coalesced;
+        ssl->out_msglen += ssl->handshake->out_coalesced;
+        ssl->handshake->out_coalesced = 0;
+        len = ssl->out_msglen;
+    }
+#endif
+
     if (!done) {
         unsigned i;
         size_t protected_record_size;
@@ -3197,7 +3598,8 @@ void mbedtls_ssl_dtls_replay_update(mbedtls_ssl_context *ssl)
 }
 #endif /* MBEDTLS_SSL_DTLS_ANTI_REPLAY */
 
-#if defined(MBEDTLS_SSL_DTLS_CLIENT_PORT_REUSE) && defined(MBEDTLS_SSL_SRV_C)
+#if (defined(MBEDTLS_SSL_DTLS_CLIENT_PORT_REUSE) || \
+    defined(MBEDTLS_SSL_DTLS_DEMUX_C)) && defined(MBEDTLS_SSL_SRV_C)
 /*
  * Check if a datagram looks like a ClientHello with a valid cookie,
  * and if it doesn't, generate a HelloVerifyRequest message.
@@ -3209,10 +3611,9 @@ void mbedtls_ssl_dtls_replay_update(mbedtls_ssl_context *ssl)
  *   return MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED
  * - otherwise return a specific error code
  */
-MBEDTLS_CHECK_RETURN_CRITICAL
-MBEDTLS_STATIC_TESTABLE
 int mbedtls_ssl_check_dtls_clihlo_cookie(
-    mbedtls_ssl_context *ssl,
+    const mbedtls_ssl_config *conf,
+    const mbedtls_ssl_context *ssl,
     const unsigned char *cli_id, size_t cli_id_len,
     const unsigned char *in, size_t in_len,
     unsigned char *obuf, size_t buf_len, size_t *olen)
@@ -3286,9 +3687,9 @@ int mbedtls_ssl_check_dtls_clihlo_cookie(
 
     MBEDTLS_SSL_DEBUG_BUF(4, "cookie received from network",
                           in + sid_len + 61, cookie_len);
-    if (ssl->conf->f_cookie_check(ssl->conf->p_cookie,
-                                  in + sid_len + 61, cookie_len,
-                                  cli_id, cli_id_len) == 0) {
+    if (conf->f_cookie_check(conf->p_cookie,
+                             in + sid_len + 61, cookie_len,
+                             cli_id, cli_id_len) == 0) {
         MBEDTLS_SSL_DEBUG_MSG(4, ("check cookie: valid"));
         return 0;
     }
@@ -3325,9 +3726,9 @@ int mbedtls_ssl_check_dtls_clihlo_cookie(
 
     /* Generate and write actual cookie */
     p = obuf + 28;
-    if (ssl->conf->f_cookie_write(ssl->conf->p_cookie,
-                                  &p, obuf + buf_len,
-                                  cli_id, cli_id_len) != 0) {
+    if (conf->f_cookie_write(conf->p_cookie,
+                             &p, obuf + buf_len,
+                             cli_id, cli_id_len) != 0) {
         return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
     }
 
@@ -3345,6 +3746,10 @@ int mbedtls_ssl_check_dtls_clihlo_cookie(
     return MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED;
 }
 
+#endif /* (MBEDTLS_SSL_DTLS_CLIENT_PORT_REUSE || MBEDTLS_SSL_DTLS_DEMUX_C) &&
+          MBEDTLS_SSL_SRV_C */
+
+#if defined(MBEDTLS_SSL_DTLS_CLIENT_PORT_REUSE) && defined(MBEDTLS_SSL_SRV_C)
 /*
  * Handle possible client reconnect with the same UDP quadruplet
  * (RFC 6347 Section 4.2.8).
@@ -3381,7 +3786,7 @@ static int ssl_handle_possible_reconnect(mbedtls_ssl_context *ssl)
     }
 
     ret = mbedtls_ssl_check_dtls_clihlo_cookie(
-        ssl,
+        ssl->conf, ssl,
         ssl->cli_id, ssl->cli_id_len,
         ssl->in_buf, ssl->in_left,
         ssl->out_buf, MBEDTLS_SSL_OUT_CONTENT_LEN, &len);
@@ -3930,6 +4335,14 @@ int mbedtls_ssl_read_record(mbedtls_ssl_context *ssl,
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("=> read record"));
 
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    /* The peer may be waiting for our last handshake messages. */
+    if ((ret = mbedtls_ssl_write_coalesced_handshake(ssl)) != 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_write_coalesced_handshake", ret);
+        return ret;
+    }
+#endif
+
     if (ssl->keep_current_message == 0) {
         do {
 
@@ -4276,7 +4689,10 @@ static int ssl_buffer_message(mbedtls_ssl_context *ssl)
                                        MBEDTLS_PRINTF_SIZET,
                                        msg_len));
 
-                hs_buf->data = mbedtls_calloc(1, reassembly_buf_sz);
+                if (mbedtls_ssl_check_memory(ssl, reassembly_buf_sz) == 0) {
+                    hs_buf->data = mbedtls_ssl_hs_calloc(hs, 1,
+                                                         reassembly_buf_sz);
+                }
                 if (hs_buf->data == NULL) {
                     ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
                     goto exit;
@@ -4451,7 +4867,7 @@ static void ssl_free_buffered_record(mbedtls_ssl_context *ssl)
         hs->buffering.total_bytes_buffered -=
             hs->buffering.future_record.len;
 
-        mbedtls_free(hs->buffering.future_record.data);
+        mbedtls_ssl_hs_free(hs, hs->buffering.future_record.data);
         hs->buffering.future_record.data = NULL;
     }
 }
@@ -4560,8 +4976,10 @@ static int ssl_buffer_future_record(mbedtls_ssl_context *ssl,
     hs->buffering.future_record.epoch = ssl->in_epoch + 1;
     hs->buffering.future_record.len   = rec->buf_len;
 
-    hs->buffering.future_record.data =
-        mbedtls_calloc(1, hs->buffering.future_record.len);
+    if (mbedtls_ssl_check_memory(ssl, rec->buf_len) == 0) {
+        hs->buffering.future_record.data =
+            mbedtls_ssl_hs_calloc(hs, 1, hs->buffering.future_record.len);
+    }
     if (hs->buffering.future_record.data == NULL) {
         /* If we run out of RAM trying to buffer a
          * record from the next epoch, just ignore. */
@@ -4901,6 +5319,12 @@ int mbedtls_ssl_send_alert_message(mbedtls_ssl_context *ssl,
         return mbedtls_ssl_flush_output(ssl);
     }
 
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    if ((ret = mbedtls_ssl_write_coalesced_handshake(ssl)) != 0) {
+        return ret;
+    }
+#endif
+
     MBEDTLS_SSL_DEBUG_MSG(2, ("=> send alert message"));
     MBEDTLS_SSL_DEBUG_MSG(3, ("send alert level=%u message=%u", level, message));
 
@@ -5288,6 +5712,16 @@ static int ssl_tls13_handle_hs_message_post_handshake(mbedtls_ssl_context *ssl)
 
     MBEDTLS_SSL_DEBUG_MSG(3, ("received post-handshake message"));
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+    if (ssl->in_msg[0] == MBEDTLS_SSL_HS_KEY_UPDATE) {
+        int ret = mbedtls_ssl_tls13_process_key_update(ssl);
+        if (ret != 0) {
+            (void) mbedtls_ssl_handle_pending_alert(ssl);
+        }
+        return ret;
+    }
+#endif /* MBEDTLS_SSL_TLS1_3_KEY_UPDATE */
+
 #if defined(MBEDTLS_SSL_CLI_C)
     if (ssl->conf->endpoint == MBEDTLS_SSL_IS_CLIENT) {
         if (ssl_tls13_is_new_session_ticket(ssl)) {
@@ -5484,7 +5918,20 @@ int mbedtls_ssl_read(mbedtls_ssl_context *ssl, unsigned char *buf, size_t len)
 
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
     if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
-        if ((ret = mbedtls_ssl_flush_output(ssl)) != 0) {
+        /* Records held back by application data packing only go out
+         * here once their delay has expired. Anything else left over from
+         * an earlier WANT_WRITE, such as alerts or handshake records, is
+         * always sent, as are held records without a delay bound. */
+        if (ssl_app_data_only_held(ssl)
+#if defined(MBEDTLS_HAVE_TIME)
+            && ssl->app_data_max_delay != 0
+#endif
+            ) {
+            ret = ssl_flush_app_data_if_due(ssl);
+        } else {
+            ret = mbedtls_ssl_flush_output(ssl);
+        }
+        if (ret != 0) {
             return ret;
         }
 
@@ -5666,6 +6113,75 @@ int mbedtls_ssl_read_early_data(mbedtls_ssl_context *ssl,
 }
 #endif /* MBEDTLS_SSL_SRV_C && MBEDTLS_SSL_EARLY_DATA */
 
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+/*
+ * Append an application record to the current datagram without sending it,
+ * unless it does not fit or the oldest record in the datagram is due.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_write_app_data_packed(mbedtls_ssl_context *ssl,
+                                     const unsigned char *buf, size_t len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    size_t held = ssl->out_left;
+
+    if (held != 0) {
+        ret = ssl_get_remaining_payload_in_datagram(ssl);
+        if (ret < 0) {
+            MBEDTLS_SSL_DEBUG_RET(1, "ssl_get_remaining_payload_in_datagram",
+                                  ret);
+            return ret;
+        }
+
+        if ((size_t) ret < len) {
+            /* Nothing has been consumed yet: on WANT_WRITE, the caller
+             * retries with the same data as for an unpacked write. */
+            if ((ret = mbedtls_ssl_flush_output(ssl)) != 0) {
+                MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_flush_output", ret);
+                return ret;
+            }
+            held = 0;
+        }
+    }
+
+    ssl->out_msglen  = len;
+    ssl->out_msgtype = MBEDTLS_SSL_MSG_APPLICATION_DATA;
+    if (len > 0) {
+        memcpy(ssl->out_msg, buf, len);
+    }
+
+    /* The record is in the output buffer by the time sending the datagram
+     * can fail with WANT_WRITE, so the data counts as written and goes out
+     * with the next flush. */
+    ret = mbedtls_ssl_write_record(ssl, SSL_DONT_FORCE_FLUSH);
+    if (ret != 0 && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_write_record", ret);
+        return ret;
+    }
+
+    /* Unless it has just been sent, the new record is pending with the
+     * earlier ones. */
+    if (ssl->out_left > held) {
+        ssl->app_data_held_len += ssl->out_left - held;
+    }
+
+#if defined(MBEDTLS_HAVE_TIME)
+    if (held == 0) {
+        ssl->app_data_held_since = mbedtls_ms_time();
+    }
+#endif
+
+    if (ret == 0) {
+        ret = ssl_flush_app_data_if_due(ssl);
+        if (ret != 0 && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            return ret;
+        }
+    }
+
+    return (int) len;
+}
+#endif /* MBEDTLS_SSL_PROTO_DTLS */
+
 /*
  * Send application data to be encrypted by the SSL layer, taking care of max
  * fragment length and buffer size.
@@ -5703,6 +6219,23 @@ static int ssl_write_real(mbedtls_ssl_context *ssl,
         len = max_len;
     }
 
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+    if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM &&
+        ssl->app_data_packing) {
+        return ssl_write_app_data_packed(ssl, buf, len);
+    }
+
+    if (ssl->app_data_held_len != 0) {
+        /* Records of earlier packed writes are still in the output buffer
+         * after packing was disabled: they are not a partial write of this
+         * data, so send them before starting a new record. */
+        if ((ret = mbedtls_ssl_flush_output(ssl)) != 0) {
+            MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_flush_output", ret);
+            return ret;
+        }
+    }
+#endif
+
     if (ssl->out_left != 0) {
         /*
          * The user has previously tried to send the data and
@@ -5720,6 +6253,14 @@ static int ssl_write_real(mbedtls_ssl_context *ssl,
          * copy the data into the internal buffers and setup the data structure
          * to keep track of partial writes
          */
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+        /* Early data must not overwrite handshake messages that wait. */
+        if ((ret = mbedtls_ssl_write_coalesced_handshake(ssl)) != 0) {
+            MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_write_coalesced_handshake", ret);
+            return ret;
+        }
+#endif
+
         ssl->out_msglen  = len;
         ssl->out_msgtype = MBEDTLS_SSL_MSG_APPLICATION_DATA;
         if (len > 0) {
@@ -5735,6 +6276,109 @@ static int ssl_write_real(mbedtls_ssl_context *ssl,
     return (int) len;
 }
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+/*
+ * Send the KeyUpdate that is due before the next application record, if any:
+ * the answer to a request of the peer, or an automatic update.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_tls13_key_update_if_due(mbedtls_ssl_context *ssl)
+{
+    const mbedtls_ssl_config *conf = ssl->conf;
+
+    if (ssl->tls_version != MBEDTLS_SSL_VERSION_TLS1_3) {
+        return 0;
+    }
+
+    if (ssl->key_update_state == MBEDTLS_SSL_KEY_UPDATE_STATE_NONE &&
+        ((conf->key_update_max_records != 0 &&
+          ssl->key_update_records >= conf->key_update_max_records) ||
+         (conf->key_update_max_bytes != 0 &&
+          ssl->key_update_bytes >= conf->key_update_max_bytes))) {
+        MBEDTLS_SSL_DEBUG_MSG(2, ("traffic key usage limit reached"));
+        ssl->key_update_state = MBEDTLS_SSL_KEY_UPDATE_STATE_PENDING;
+        ssl->key_update_request = MBEDTLS_SSL_KEY_UPDATE_NOT_REQUESTED;
+    }
+
+    /* A partially sent record of application data must be completed with
+     * the data of the retried call first. */
+    if (ssl->key_update_state == MBEDTLS_SSL_KEY_UPDATE_STATE_NONE ||
+        (ssl->key_update_state == MBEDTLS_SSL_KEY_UPDATE_STATE_PENDING &&
+         ssl->out_left != 0)) {
+        return 0;
+    }
+
+    return mbedtls_ssl_tls13_write_key_update(ssl);
+}
+
+int mbedtls_ssl_key_update(mbedtls_ssl_context *ssl, int request)
+{
+    if (ssl == NULL || ssl->conf == NULL ||
+        !mbedtls_ssl_is_handshake_over(ssl) ||
+        ssl->tls_version != MBEDTLS_SSL_VERSION_TLS1_3 ||
+        (request != MBEDTLS_SSL_KEY_UPDATE_NOT_REQUESTED &&
+         request != MBEDTLS_SSL_KEY_UPDATE_REQUESTED)) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    /* When retried after MBEDTLS_ERR_SSL_WANT_WRITE, only finish sending
+     * the message that was written. */
+    if (ssl->key_update_state != MBEDTLS_SSL_KEY_UPDATE_STATE_FLUSH) {
+        if (ssl->key_update_state == MBEDTLS_SSL_KEY_UPDATE_STATE_NONE ||
+            request == MBEDTLS_SSL_KEY_UPDATE_REQUESTED) {
+            ssl->key_update_request = (uint8_t) request;
+        }
+        ssl->key_update_state = MBEDTLS_SSL_KEY_UPDATE_STATE_PENDING;
+
+        /* Data of a write to be retried goes first; the next write
+         * sends the KeyUpdate. */
+        if (ssl->out_left != 0) {
+            return 0;
+        }
+    }
+
+    return mbedtls_ssl_tls13_write_key_update(ssl);
+}
+#endif /* MBEDTLS_SSL_TLS1_3_KEY_UPDATE */
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && \
+    defined(MBEDTLS_SSL_SRV_C) && \
+    defined(MBEDTLS_SSL_PROTO_TLS1_3)
+int mbedtls_ssl_send_new_session_tickets(mbedtls_ssl_context *ssl)
+{
+    if (ssl == NULL || ssl->conf == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (ssl->conf->endpoint != MBEDTLS_SSL_IS_SERVER) {
+        return 0;
+    }
+
+    /* Tickets interrupted by MBEDTLS_ERR_SSL_WANT_WRITE */
+    if (ssl->state == MBEDTLS_SSL_TLS1_3_NEW_SESSION_TICKET ||
+        ssl->state == MBEDTLS_SSL_TLS1_3_NEW_SESSION_TICKET_FLUSH) {
+        return mbedtls_ssl_handshake(ssl);
+    }
+
+    if (!mbedtls_ssl_is_handshake_over(ssl)) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (ssl->handshake == NULL ||
+        ssl->handshake->new_session_tickets_deferred == 0) {
+        return 0;
+    }
+
+    /* Run the states the handshake skipped. */
+    ssl->handshake->new_session_tickets_deferred = 0;
+    mbedtls_ssl_handshake_set_state(ssl, MBEDTLS_SSL_TLS1_3_NEW_SESSION_TICKET);
+
+    return mbedtls_ssl_handshake(ssl);
+}
+#endif /* MBEDTLS_SSL_SESSION_TICKETS &&
+          MBEDTLS_SSL_SRV_C &&
+          MBEDTLS_SSL_PROTO_TLS1_3 */
+
 /*
  * Write application data (public-facing wrapper)
  */
@@ -5762,13 +6406,82 @@ int mbedtls_ssl_write(mbedtls_ssl_context *ssl, const unsigned char *buf, size_t
         }
     }
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+    if ((ret = ssl_tls13_key_update_if_due(ssl)) != 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "ssl_tls13_key_update_if_due", ret);
+        return ret;
+    }
+#endif
+
     ret = ssl_write_real(ssl, buf, len);
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+    if (ret >= 0) {
+        ssl->key_update_records++;
+        ssl->key_update_bytes += (size_t) ret;
+    }
+#endif
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && \
+    defined(MBEDTLS_SSL_SRV_C) && \
+    defined(MBEDTLS_SSL_PROTO_TLS1_3)
+    /* Deferred tickets follow the first answer of the server. The data is
+     * written by now, so tickets that could not be sent yet go out with the
+     * next call. */
+    if (ret >= 0 && ssl->handshake != NULL &&
+        ssl->conf->endpoint == MBEDTLS_SSL_IS_SERVER &&
+        ssl->handshake->new_session_tickets_deferred) {
+        int ticket_ret = mbedtls_ssl_send_new_session_tickets(ssl);
+        if (ticket_ret != 0 && ticket_ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_send_new_session_tickets",
+                                  ticket_ret);
+            return ticket_ret;
+        }
+    }
+#endif
+
     MBEDTLS_SSL_DEBUG_MSG(2, ("<= write"));
 
     return ret;
 }
 
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+int mbedtls_ssl_flush(mbedtls_ssl_context *ssl)
+{
+    if (ssl == NULL || ssl->conf == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (ssl->out_left == 0) {
+        return 0;
+    }
+
+    return mbedtls_ssl_flush_output(ssl);
+}
+
+int mbedtls_ssl_get_flush_timeout(const mbedtls_ssl_context *ssl)
+{
+#if defined(MBEDTLS_HAVE_TIME)
+    mbedtls_ms_time_t elapsed;
+
+    if (!ssl->app_data_packing || ssl->app_data_max_delay == 0 ||
+        ssl->app_data_held_len == 0) {
+        return -1;
+    }
+
+    elapsed = mbedtls_ms_time() - ssl->app_data_held_since;
+    if (elapsed >= (mbedtls_ms_time_t) ssl->app_data_max_delay) {
+        return 0;
+    }
+
+    return (int) (ssl->app_data_max_delay - (uint32_t) elapsed);
+#else
+    (void) ssl;
+    return -1;
+#endif /* MBEDTLS_HAVE_TIME */
+}
+#endif /* MBEDTLS_SSL_PROTO_DTLS */
+
 #if defined(MBEDTLS_SSL_EARLY_DATA) && defined(MBEDTLS_SSL_CLI_C)
 int mbedtls_ssl_write_early_data(mbedtls_ssl_context *ssl,
                                  const unsigned char *buf, size_t len)
@@ -5925,11 +6638,23 @@ void mbedtls_ssl_set_inbound_transform(mbedtls_ssl_context *ssl,
     memset(ssl->in_ctr, 0, MBEDTLS_SSL_SEQUENCE_NUMBER_LEN);
 }
 
-void mbedtls_ssl_set_outbound_transform(mbedtls_ssl_context *ssl,
-                                        mbedtls_ssl_transform *transform)
+int mbedtls_ssl_set_outbound_transform(mbedtls_ssl_context *ssl,
+                                       mbedtls_ssl_transform *transform)
 {
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+
+    /* Records do not span a change of keys. */
+    if ((ret = mbedtls_ssl_write_coalesced_handshake(ssl)) != 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_write_coalesced_handshake", ret);
+        return ret;
+    }
+#endif
+
     ssl->transform_out = transform;
     memset(ssl->cur_out_ctr, 0, sizeof(ssl->cur_out_ctr));
+
+    return 0;
 }
 
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
@@ -5962,7 +6687,8 @@ static void ssl_buffering_free_slot(mbedtls_ssl_context *ssl,
 
     if (hs_buf->is_valid == 1) {
         hs->buffering.total_bytes_buffered -= hs_buf->data_len;
-        mbedtls_zeroize_and_free(hs_buf->data, hs_buf->data_len);
+        mbedtls_platform_zeroize(hs_buf->data, hs_buf->data_len);
+        mbedtls_ssl_hs_free(hs, hs_buf->data);
         memset(hs_buf, 0, sizeof(mbedtls_ssl_hs_buffer));
     }
 }
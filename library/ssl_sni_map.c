@@ -0,0 +1,311 @@
+/*
+ *  Map of server names to certificates
+ *
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+
+#include "ssl_misc.h"
+
+#if defined(MBEDTLS_SSL_SNI_MAP_C)
+
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/ssl_sni_map.h"
+#include "mbedtls/error.h"
+
+#include <string.h>
+
+void mbedtls_ssl_sni_map_init(mbedtls_ssl_sni_map *map)
+{
+    memset(map, 0, sizeof(mbedtls_ssl_sni_map));
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_init(&map->mutex);
+#endif
+}
+
+int mbedtls_ssl_sni_map_setup(mbedtls_ssl_sni_map *map, size_t buckets)
+{
+    mbedtls_ssl_sni_map_entry **table;
+
+    if (map->buckets != NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (buckets == 0) {
+        buckets = MBEDTLS_SSL_SNI_MAP_DEFAULT_BUCKETS;
+    }
+
+    table = mbedtls_calloc(buckets, sizeof(mbedtls_ssl_sni_map_entry *));
+    if (table == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&map->mutex) != 0) {
+        mbedtls_free(table);
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    map->buckets = table;
+    map->bucket_count = buckets;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_unlock(&map->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    return 0;
+}
+
+static unsigned char ssl_sni_map_lower(unsigned char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (unsigned char) (c + ('a' - 'A')) : c;
+}
+
+/*
+ * FNV-1a over the lower-case name.
+ */
+static uint32_t ssl_sni_map_hash(const unsigned char *name, size_t len)
+{
+    uint32_t hash = 0x811c9dc5;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        hash ^= ssl_sni_map_lower(name[i]);
+        hash *= 0x01000193;
+    }
+
+    return hash;
+}
+
+static int ssl_sni_map_name_eq(const mbedtls_ssl_sni_map_entry *entry,
+                               uint32_t hash,
+                               const unsigned char *name, size_t len)
+{
+    size_t i;
+
+    if (entry->hash != hash || entry->name_len != len) {
+        return 0;
+    }
+    for (i = 0; i < len; i++) {
+        if ((unsigned char) entry->name[i] != ssl_sni_map_lower(name[i])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * Find the link to the entry of a name, or to the end of its bucket.
+ */
+static mbedtls_ssl_sni_map_entry **ssl_sni_map_find(mbedtls_ssl_sni_map *map,
+                                                    const unsigned char *name,
+                                                    size_t len)
+{
+    uint32_t hash = ssl_sni_map_hash(name, len);
+    mbedtls_ssl_sni_map_entry **link = &map->buckets[hash % map->bucket_count];
+
+    while (*link != NULL && !ssl_sni_map_name_eq(*link, hash, name, len)) {
+        link = &(*link)->next;
+    }
+
+    return link;
+}
+
+int mbedtls_ssl_sni_map_add(mbedtls_ssl_sni_map *map,
+                            const char *name,
+                            mbedtls_x509_crt *cert,
+                            mbedtls_pk_context *key,
+                            mbedtls_x509_crt *ca_chain,
+                            mbedtls_x509_crl *ca_crl,
+                            int authmode)
+{
+    mbedtls_ssl_sni_map_entry *entry, *old, **link;
+    size_t len, i;
+
+    if (map->buckets == NULL || name == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    len = strlen(name);
+    if (len == 0 || len > MBEDTLS_SSL_MAX_HOST_NAME_LEN) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    /* Prepare the entry outside of the lock. */
+    entry = mbedtls_calloc(1, sizeof(mbedtls_ssl_sni_map_entry));
+    if (entry == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+    entry->name = mbedtls_calloc(1, len + 1);
+    if (entry->name == NULL) {
+        mbedtls_free(entry);
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+    for (i = 0; i < len; i++) {
+        entry->name[i] = (char) ssl_sni_map_lower((unsigned char) name[i]);
+    }
+    entry->name_len = len;
+    entry->hash = ssl_sni_map_hash((const unsigned char *) name, len);
+    entry->cert = cert;
+    entry->key = key;
+    entry->ca_chain = ca_chain;
+    entry->ca_crl = ca_crl;
+    entry->authmode = authmode;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&map->mutex) != 0) {
+        mbedtls_free(entry->name);
+        mbedtls_free(entry);
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    /* Replace an existing entry in place, and free it after unlocking. */
+    link = ssl_sni_map_find(map, (const unsigned char *) name, len);
+    old = *link;
+    if (old != NULL) {
+        entry->next = old->next;
+    } else {
+        map->count++;
+    }
+    *link = entry;
+
+#if defined(MBEDTLS_THREADING_C)
+    (void) mbedtls_mutex_unlock(&map->mutex);
+#endif
+
+    if (old != NULL) {
+        mbedtls_free(old->name);
+        mbedtls_free(old);
+    }
+
+    return 0;
+}
+
+int mbedtls_ssl_sni_map_remove(mbedtls_ssl_sni_map *map, const char *name)
+{
+    int ret = MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    mbedtls_ssl_sni_map_entry *entry = NULL, **link;
+
+    if (map->buckets == NULL || name == NULL) {
+        return MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&map->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    link = ssl_sni_map_find(map, (const unsigned char *) name, strlen(name));
+    if (*link != NULL) {
+        entry = *link;
+        *link = entry->next;
+        map->count--;
+        ret = 0;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    (void) mbedtls_mutex_unlock(&map->mutex);
+#endif
+
+    if (entry != NULL) {
+        mbedtls_free(entry->name);
+        mbedtls_free(entry);
+    }
+
+    return ret;
+}
+
+int mbedtls_ssl_sni_map_callback(void *p_map, mbedtls_ssl_context *ssl,
+                                 const unsigned char *name, size_t name_len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_sni_map *map = p_map;
+    mbedtls_ssl_sni_map_entry *entry, found;
+    unsigned char wildcard[MBEDTLS_SSL_MAX_HOST_NAME_LEN + 2];
+    size_t dot;
+
+    if (map->buckets == NULL || name_len == 0 ||
+        name_len > MBEDTLS_SSL_MAX_HOST_NAME_LEN) {
+        return 0;
+    }
+
+    /* The wildcard candidate replaces the first label with "*". */
+    for (dot = 0; dot < name_len && name[dot] != '.'; dot++) {
+        ;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&map->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    entry = *ssl_sni_map_find(map, name, name_len);
+    if (entry == NULL && dot > 0 && dot + 1 < name_len) {
+        wildcard[0] = '*';
+        memcpy(wildcard + 1, name + dot, name_len - dot);
+        entry = *ssl_sni_map_find(map, wildcard, name_len - dot + 1);
+    }
+
+    /* Copy the settings so that they can be applied without the lock. */
+    if (entry != NULL) {
+        found = *entry;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_unlock(&map->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    if (entry == NULL) {
+        return 0;
+    }
+
+    if ((ret = mbedtls_ssl_set_hs_own_cert(ssl, found.cert, found.key)) != 0) {
+        return ret;
+    }
+    if (found.ca_chain != NULL) {
+        mbedtls_ssl_set_hs_ca_chain(ssl, found.ca_chain, found.ca_crl);
+    }
+    if (found.authmode != MBEDTLS_SSL_VERIFY_UNSET) {
+        mbedtls_ssl_set_hs_authmode(ssl, found.authmode);
+    }
+
+    return 0;
+}
+
+void mbedtls_ssl_sni_map_free(mbedtls_ssl_sni_map *map)
+{
+    mbedtls_ssl_sni_map_entry *entry, *next;
+    size_t i;
+
+    if (map == NULL) {
+        return;
+    }
+
+    for (i = 0; i < map->bucket_count; i++) {
+        for (entry = map->buckets[i]; entry != NULL; entry = next) {
+            next = entry->next;
+            mbedtls_free(entry->name);
+            mbedtls_free(entry);
+        }
+    }
+    mbedtls_free(map->buckets);
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_free(&map->mutex);
+#endif
+
+    mbedtls_platform_zeroize(map, sizeof(mbedtls_ssl_sni_map));
+}
+
+#endif /* MBEDTLS_SSL_SNI_MAP_C */
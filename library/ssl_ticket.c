@@ -402,8 +402,10 @@ int mbedtls_ssl_ticket_parse(void *p_ticket,
         goto cleanup;
     }
 
-    /* Actually load session */
-    if ((ret = mbedtls_ssl_session_load(session, ticket, clear_len)) != 0) {
+    /* Actually load session, borrowing from the decrypted ticket: the
+     * server keeps buf for the whole handshake. */
+    if ((ret = mbedtls_ssl_session_load_borrowed(session, ticket,
+                                                 clear_len)) != 0) {
         goto cleanup;
     }
 
@@ -225,6 +225,7 @@ int mbedtls_ssl_session_copy(mbedtls_ssl_session *dst,
 {
     mbedtls_ssl_session_free(dst);
     memcpy(dst, src, sizeof(mbedtls_ssl_session));
+    dst->borrowed = 0;
 #if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
     dst->ticket = NULL;
 #if defined(MBEDTLS_SSL_PROTO_TLS1_3) && \
@@ -313,9 +314,17 @@ int mbedtls_ssl_session_copy(mbedtls_ssl_session *dst,
 
 #if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
 MBEDTLS_CHECK_RETURN_CRITICAL
-static int resize_buffer(unsigned char **buffer, size_t len_new, size_t *len_old)
+static int resize_buffer(const mbedtls_ssl_context *ssl,
+                         unsigned char **buffer, size_t len_new, size_t *len_old)
 {
-    unsigned char *resized_buffer = mbedtls_calloc(1, len_new);
+    unsigned char *resized_buffer;
+
+    /* Downsizing frees memory, so it is not subject to the memory limit. */
+    if (len_new > *len_old && mbedtls_ssl_check_memory(ssl, len_new) != 0) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    resized_buffer = mbedtls_calloc(1, len_new);
     if (resized_buffer == NULL) {
         return MBEDTLS_ERR_SSL_ALLOC_FAILED;
     }
@@ -348,7 +357,8 @@ static void handle_buffer_resizing(mbedtls_ssl_context *ssl, int downsizing,
         if (downsizing ?
             ssl->in_buf_len > in_buf_new_len && ssl->in_left < in_buf_new_len :
             ssl->in_buf_len < in_buf_new_len) {
-            if (resize_buffer(&ssl->in_buf, in_buf_new_len, &ssl->in_buf_len) != 0) {
+            if (resize_buffer(ssl, &ssl->in_buf, in_buf_new_len,
+                              &ssl->in_buf_len) != 0) {
                 MBEDTLS_SSL_DEBUG_MSG(1, ("input buffer resizing failed - out of memory"));
             } else {
                 MBEDTLS_SSL_DEBUG_MSG(2, ("Reallocating in_buf to %" MBEDTLS_PRINTF_SIZET,
@@ -365,7 +375,8 @@ static void handle_buffer_resizing(mbedtls_ssl_context *ssl, int downsizing,
         if (downsizing ?
             ssl->out_buf_len > out_buf_new_len && ssl->out_left < out_buf_new_len :
             ssl->out_buf_len < out_buf_new_len) {
-            if (resize_buffer(&ssl->out_buf, out_buf_new_len, &ssl->out_buf_len) != 0) {
+            if (resize_buffer(ssl, &ssl->out_buf, out_buf_new_len,
+                              &ssl->out_buf_len) != 0) {
                 MBEDTLS_SSL_DEBUG_MSG(1, ("output buffer resizing failed - out of memory"));
             } else {
                 MBEDTLS_SSL_DEBUG_MSG(2, ("Reallocating out_buf to %" MBEDTLS_PRINTF_SIZET,
@@ -498,7 +509,9 @@ static void ssl_clear_peer_cert(mbedtls_ssl_session *session)
 #else /* MBEDTLS_SSL_KEEP_PEER_CERTIFICATE */
     if (session->peer_cert_digest != NULL) {
         /* Zeroization is not necessary. */
-        mbedtls_free(session->peer_cert_digest);
+        if (!session->borrowed) {
+            mbedtls_free(session->peer_cert_digest);
+        }
         session->peer_cert_digest      = NULL;
         session->peer_cert_digest_type = MBEDTLS_MD_NONE;
         session->peer_cert_digest_len  = 0;
@@ -507,98 +520,163 @@ static void ssl_clear_peer_cert(mbedtls_ssl_session *session)
 }
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
 
+/*
+ * Internal identifiers of the extensions, indexed by extension type. The
+ * types of the extensions that the library knows are all small.
+ */
+static const unsigned char ssl_extension_id_table[] = {
+    [MBEDTLS_TLS_EXT_SERVERNAME] = MBEDTLS_SSL_EXT_ID_SERVERNAME,
+    [MBEDTLS_TLS_EXT_MAX_FRAGMENT_LENGTH] = MBEDTLS_SSL_EXT_ID_MAX_FRAGMENT_LENGTH,
+    [MBEDTLS_TLS_EXT_STATUS_REQUEST] = MBEDTLS_SSL_EXT_ID_STATUS_REQUEST,
+    [MBEDTLS_TLS_EXT_SUPPORTED_GROUPS] = MBEDTLS_SSL_EXT_ID_SUPPORTED_GROUPS,
+    [MBEDTLS_TLS_EXT_SIG_ALG] = MBEDTLS_SSL_EXT_ID_SIG_ALG,
+    [MBEDTLS_TLS_EXT_USE_SRTP] = MBEDTLS_SSL_EXT_ID_USE_SRTP,
+    [MBEDTLS_TLS_EXT_HEARTBEAT] = MBEDTLS_SSL_EXT_ID_HEARTBEAT,
+    [MBEDTLS_TLS_EXT_ALPN] = MBEDTLS_SSL_EXT_ID_ALPN,
+    [MBEDTLS_TLS_EXT_SCT] = MBEDTLS_SSL_EXT_ID_SCT,
+    [MBEDTLS_TLS_EXT_CLI_CERT_TYPE] = MBEDTLS_SSL_EXT_ID_CLI_CERT_TYPE,
+    [MBEDTLS_TLS_EXT_SERV_CERT_TYPE] = MBEDTLS_SSL_EXT_ID_SERV_CERT_TYPE,
+    [MBEDTLS_TLS_EXT_PADDING] = MBEDTLS_SSL_EXT_ID_PADDING,
+    [MBEDTLS_TLS_EXT_PRE_SHARED_KEY] = MBEDTLS_SSL_EXT_ID_PRE_SHARED_KEY,
+    [MBEDTLS_TLS_EXT_EARLY_DATA] = MBEDTLS_SSL_EXT_ID_EARLY_DATA,
+    [MBEDTLS_TLS_EXT_SUPPORTED_VERSIONS] = MBEDTLS_SSL_EXT_ID_SUPPORTED_VERSIONS,
+    [MBEDTLS_TLS_EXT_COOKIE] = MBEDTLS_SSL_EXT_ID_COOKIE,
+    [MBEDTLS_TLS_EXT_PSK_KEY_EXCHANGE_MODES] = MBEDTLS_SSL_EXT_ID_PSK_KEY_EXCHANGE_MODES,
+    [MBEDTLS_TLS_EXT_CERT_AUTH] = MBEDTLS_SSL_EXT_ID_CERT_AUTH,
+    [MBEDTLS_TLS_EXT_OID_FILTERS] = MBEDTLS_SSL_EXT_ID_OID_FILTERS,
+    [MBEDTLS_TLS_EXT_POST_HANDSHAKE_AUTH] = MBEDTLS_SSL_EXT_ID_POST_HANDSHAKE_AUTH,
+    [MBEDTLS_TLS_EXT_SIG_ALG_CERT] = MBEDTLS_SSL_EXT_ID_SIG_ALG_CERT,
+    [MBEDTLS_TLS_EXT_KEY_SHARE] = MBEDTLS_SSL_EXT_ID_KEY_SHARE,
+    [MBEDTLS_TLS_EXT_TRUNCATED_HMAC] = MBEDTLS_SSL_EXT_ID_TRUNCATED_HMAC,
+    [MBEDTLS_TLS_EXT_SUPPORTED_POINT_FORMATS] = MBEDTLS_SSL_EXT_ID_SUPPORTED_POINT_FORMATS,
+    [MBEDTLS_TLS_EXT_ENCRYPT_THEN_MAC] = MBEDTLS_SSL_EXT_ID_ENCRYPT_THEN_MAC,
+    [MBEDTLS_TLS_EXT_EXTENDED_MASTER_SECRET] = MBEDTLS_SSL_EXT_ID_EXTENDED_MASTER_SECRET,
+    [MBEDTLS_TLS_EXT_RECORD_SIZE_LIMIT] = MBEDTLS_SSL_EXT_ID_RECORD_SIZE_LIMIT,
+    [MBEDTLS_TLS_EXT_COMPRESS_CERTIFICATE] = MBEDTLS_SSL_EXT_ID_COMPRESS_CERTIFICATE,
+    [MBEDTLS_TLS_EXT_SESSION_TICKET] = MBEDTLS_SSL_EXT_ID_SESSION_TICKET,
+};
+
 uint32_t mbedtls_ssl_get_extension_id(unsigned int extension_type)
 {
-    switch (extension_type) {
-        case MBEDTLS_TLS_EXT_SERVERNAME:
-            return MBEDTLS_SSL_EXT_ID_SERVERNAME;
-
-        case MBEDTLS_TLS_EXT_MAX_FRAGMENT_LENGTH:
-            return MBEDTLS_SSL_EXT_ID_MAX_FRAGMENT_LENGTH;
-
-        case MBEDTLS_TLS_EXT_STATUS_REQUEST:
-            return MBEDTLS_SSL_EXT_ID_STATUS_REQUEST;
-
-        case MBEDTLS_TLS_EXT_SUPPORTED_GROUPS:
-            return MBEDTLS_SSL_EXT_ID_SUPPORTED_GROUPS;
-
-        case MBEDTLS_TLS_EXT_SIG_ALG:
-            return MBEDTLS_SSL_EXT_ID_SIG_ALG;
-
-        case MBEDTLS_TLS_EXT_USE_SRTP:
-            return MBEDTLS_SSL_EXT_ID_USE_SRTP;
-
-        case MBEDTLS_TLS_EXT_HEARTBEAT:
-            return MBEDTLS_SSL_EXT_ID_HEARTBEAT;
-
-        case MBEDTLS_TLS_EXT_ALPN:
-            return MBEDTLS_SSL_EXT_ID_ALPN;
-
-        case MBEDTLS_TLS_EXT_SCT:
-            return MBEDTLS_SSL_EXT_ID_SCT;
-
-        case MBEDTLS_TLS_EXT_CLI_CERT_TYPE:
-            return MBEDTLS_SSL_EXT_ID_CLI_CERT_TYPE;
-
-        case MBEDTLS_TLS_EXT_SERV_CERT_TYPE:
-            return MBEDTLS_SSL_EXT_ID_SERV_CERT_TYPE;
-
-        case MBEDTLS_TLS_EXT_PADDING:
-            return MBEDTLS_SSL_EXT_ID_PADDING;
-
-        case MBEDTLS_TLS_EXT_PRE_SHARED_KEY:
-            return MBEDTLS_SSL_EXT_ID_PRE_SHARED_KEY;
-
-        case MBEDTLS_TLS_EXT_EARLY_DATA:
-            return MBEDTLS_SSL_EXT_ID_EARLY_DATA;
-
-        case MBEDTLS_TLS_EXT_SUPPORTED_VERSIONS:
-            return MBEDTLS_SSL_EXT_ID_SUPPORTED_VERSIONS;
-
-        case MBEDTLS_TLS_EXT_COOKIE:
-            return MBEDTLS_SSL_EXT_ID_COOKIE;
-
-        case MBEDTLS_TLS_EXT_PSK_KEY_EXCHANGE_MODES:
-            return MBEDTLS_SSL_EXT_ID_PSK_KEY_EXCHANGE_MODES;
-
-        case MBEDTLS_TLS_EXT_CERT_AUTH:
-            return MBEDTLS_SSL_EXT_ID_CERT_AUTH;
-
-        case MBEDTLS_TLS_EXT_OID_FILTERS:
-            return MBEDTLS_SSL_EXT_ID_OID_FILTERS;
-
-        case MBEDTLS_TLS_EXT_POST_HANDSHAKE_AUTH:
-            return MBEDTLS_SSL_EXT_ID_POST_HANDSHAKE_AUTH;
-
-        case MBEDTLS_TLS_EXT_SIG_ALG_CERT:
-            return MBEDTLS_SSL_EXT_ID_SIG_ALG_CERT;
-
-        case MBEDTLS_TLS_EXT_KEY_SHARE:
-            return MBEDTLS_SSL_EXT_ID_KEY_SHARE;
-
-        case MBEDTLS_TLS_EXT_TRUNCATED_HMAC:
-            return MBEDTLS_SSL_EXT_ID_TRUNCATED_HMAC;
-
-        case MBEDTLS_TLS_EXT_SUPPORTED_POINT_FORMATS:
-            return MBEDTLS_SSL_EXT_ID_SUPPORTED_POINT_FORMATS;
-
-        case MBEDTLS_TLS_EXT_ENCRYPT_THEN_MAC:
-            return MBEDTLS_SSL_EXT_ID_ENCRYPT_THEN_MAC;
-
-        case MBEDTLS_TLS_EXT_EXTENDED_MASTER_SECRET:
-            return MBEDTLS_SSL_EXT_ID_EXTENDED_MASTER_SECRET;
-
-        case MBEDTLS_TLS_EXT_RECORD_SIZE_LIMIT:
-            return MBEDTLS_SSL_EXT_ID_RECORD_SIZE_LIMIT;
-
-        case MBEDTLS_TLS_EXT_SESSION_TICKET:
-            return MBEDTLS_SSL_EXT_ID_SESSION_TICKET;
-
+    if (extension_type < sizeof(ssl_extension_id_table)) {
+        return ssl_extension_id_table[extension_type];
     }
 
     return MBEDTLS_SSL_EXT_ID_UNRECOGNIZED;
 }
 
+/*
+ * Components of the entries of mbedtls_ssl_sig_alg_table: the flags for
+ * each family of signature algorithms, and masks that are all ones if the
+ * hash or curve is supported.
+ */
+#if defined(MBEDTLS_SSL_PROTO_TLS1_2) && defined(MBEDTLS_RSA_C)
+#define SSL_SIG_TLS12_RSA       MBEDTLS_SSL_SIG_ALG_TLS12
+#else
+#define SSL_SIG_TLS12_RSA       0
+#endif
+#if defined(MBEDTLS_SSL_PROTO_TLS1_2) && \
+    defined(MBEDTLS_KEY_EXCHANGE_ECDSA_CERT_REQ_ALLOWED_ENABLED)
+#define SSL_SIG_TLS12_ECDSA     MBEDTLS_SSL_SIG_ALG_TLS12
+#else
+#define SSL_SIG_TLS12_ECDSA     0
+#endif
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED) && \
+    defined(MBEDTLS_PKCS1_V15)
+#define SSL_SIG_TLS13_PKCS1     MBEDTLS_SSL_SIG_ALG_TLS13
+#else
+#define SSL_SIG_TLS13_PKCS1     0
+#endif
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED) && \
+    defined(PSA_HAVE_ALG_SOME_ECDSA)
+#define SSL_SIG_TLS13_ECDSA     (MBEDTLS_SSL_SIG_ALG_TLS13 | \
+                                 MBEDTLS_SSL_SIG_ALG_TLS13_CERT_VERIFY)
+#else
+#define SSL_SIG_TLS13_ECDSA     0
+#endif
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED) && \
+    defined(MBEDTLS_PKCS1_V21)
+#define SSL_SIG_TLS13_PSS       (MBEDTLS_SSL_SIG_ALG_TLS13 | \
+                                 MBEDTLS_SSL_SIG_ALG_TLS13_CERT_VERIFY)
+#else
+#define SSL_SIG_TLS13_PSS       0
+#endif
+
+#if defined(PSA_WANT_ALG_MD5)
+#define SSL_SIG_MD5             0xFF
+#else
+#define SSL_SIG_MD5             0
+#endif
+#if defined(PSA_WANT_ALG_SHA_1)
+#define SSL_SIG_SHA1            0xFF
+#else
+#define SSL_SIG_SHA1            0
+#endif
+#if defined(PSA_WANT_ALG_SHA_224)
+#define SSL_SIG_SHA224          0xFF
+#else
+#define SSL_SIG_SHA224          0
+#endif
+#if defined(PSA_WANT_ALG_SHA_256)
+#define SSL_SIG_SHA256          0xFF
+#else
+#define SSL_SIG_SHA256          0
+#endif
+#if defined(PSA_WANT_ALG_SHA_384)
+#define SSL_SIG_SHA384          0xFF
+#else
+#define SSL_SIG_SHA384          0
+#endif
+#if defined(PSA_WANT_ALG_SHA_512)
+#define SSL_SIG_SHA512          0xFF
+#else
+#define SSL_SIG_SHA512          0
+#endif
+#if defined(PSA_WANT_ECC_SECP_R1_256)
+#define SSL_SIG_SECP256R1       0xFF
+#else
+#define SSL_SIG_SECP256R1       0
+#endif
+#if defined(PSA_WANT_ECC_SECP_R1_384)
+#define SSL_SIG_SECP384R1       0xFF
+#else
+#define SSL_SIG_SECP384R1       0
+#endif
+#if defined(PSA_WANT_ECC_SECP_R1_521)
+#define SSL_SIG_SECP521R1       0xFF
+#else
+#define SSL_SIG_SECP521R1       0
+#endif
+
+#define SSL_SIG_ALG_ENTRY(sig_alg) \
+    [MBEDTLS_BYTE_1(sig_alg)][MBEDTLS_BYTE_0(sig_alg)]
+
+const unsigned char
+    mbedtls_ssl_sig_alg_table[MBEDTLS_SSL_SIG_ALG_TABLE_HASHES][MBEDTLS_SSL_SIG_ALG_TABLE_SIGS] =
+{
+    [MBEDTLS_SSL_HASH_MD5][MBEDTLS_SSL_SIG_RSA] = SSL_SIG_TLS12_RSA & SSL_SIG_MD5,
+    [MBEDTLS_SSL_HASH_MD5][MBEDTLS_SSL_SIG_ECDSA] = SSL_SIG_TLS12_ECDSA & SSL_SIG_MD5,
+    [MBEDTLS_SSL_HASH_SHA1][MBEDTLS_SSL_SIG_RSA] = SSL_SIG_TLS12_RSA & SSL_SIG_SHA1,
+    [MBEDTLS_SSL_HASH_SHA1][MBEDTLS_SSL_SIG_ECDSA] = SSL_SIG_TLS12_ECDSA & SSL_SIG_SHA1,
+    [MBEDTLS_SSL_HASH_SHA224][MBEDTLS_SSL_SIG_RSA] = SSL_SIG_TLS12_RSA & SSL_SIG_SHA224,
+    [MBEDTLS_SSL_HASH_SHA224][MBEDTLS_SSL_SIG_ECDSA] = SSL_SIG_TLS12_ECDSA & SSL_SIG_SHA224,
+    SSL_SIG_ALG_ENTRY(MBEDTLS_TLS1_3_SIG_RSA_PKCS1_SHA256) =
+        (SSL_SIG_TLS12_RSA | SSL_SIG_TLS13_PKCS1) & SSL_SIG_SHA256,
+    SSL_SIG_ALG_ENTRY(MBEDTLS_TLS1_3_SIG_ECDSA_SECP256R1_SHA256) =
+        (SSL_SIG_TLS12_ECDSA | (SSL_SIG_TLS13_ECDSA & SSL_SIG_SECP256R1)) & SSL_SIG_SHA256,
+    SSL_SIG_ALG_ENTRY(MBEDTLS_TLS1_3_SIG_RSA_PKCS1_SHA384) =
+        (SSL_SIG_TLS12_RSA | SSL_SIG_TLS13_PKCS1) & SSL_SIG_SHA384,
+    SSL_SIG_ALG_ENTRY(MBEDTLS_TLS1_3_SIG_ECDSA_SECP384R1_SHA384) =
+        (SSL_SIG_TLS12_ECDSA | (SSL_SIG_TLS13_ECDSA & SSL_SIG_SECP384R1)) & SSL_SIG_SHA384,
+    SSL_SIG_ALG_ENTRY(MBEDTLS_TLS1_3_SIG_RSA_PKCS1_SHA512) =
+        (SSL_SIG_TLS12_RSA | SSL_SIG_TLS13_PKCS1) & SSL_SIG_SHA512,
+    SSL_SIG_ALG_ENTRY(MBEDTLS_TLS1_3_SIG_ECDSA_SECP521R1_SHA512) =
+        (SSL_SIG_TLS12_ECDSA | (SSL_SIG_TLS13_ECDSA & SSL_SIG_SECP521R1)) & SSL_SIG_SHA512,
+    SSL_SIG_ALG_ENTRY(MBEDTLS_TLS1_3_SIG_RSA_PSS_RSAE_SHA256) = SSL_SIG_TLS13_PSS & SSL_SIG_SHA256,
+    SSL_SIG_ALG_ENTRY(MBEDTLS_TLS1_3_SIG_RSA_PSS_RSAE_SHA384) = SSL_SIG_TLS13_PSS & SSL_SIG_SHA384,
+    SSL_SIG_ALG_ENTRY(MBEDTLS_TLS1_3_SIG_RSA_PSS_RSAE_SHA512) = SSL_SIG_TLS13_PSS & SSL_SIG_SHA512,
+};
+
 uint32_t mbedtls_ssl_get_extension_mask(unsigned int extension_type)
 {
     return 1 << mbedtls_ssl_get_extension_id(extension_type);
@@ -634,7 +712,8 @@ static const char *extension_name_table[] = {
     [MBEDTLS_SSL_EXT_ID_ENCRYPT_THEN_MAC] = "encrypt_then_mac",
     [MBEDTLS_SSL_EXT_ID_EXTENDED_MASTER_SECRET] = "extended_master_secret",
     [MBEDTLS_SSL_EXT_ID_SESSION_TICKET] = "session_ticket",
-    [MBEDTLS_SSL_EXT_ID_RECORD_SIZE_LIMIT] = "record_size_limit"
+    [MBEDTLS_SSL_EXT_ID_RECORD_SIZE_LIMIT] = "record_size_limit",
+    [MBEDTLS_SSL_EXT_ID_COMPRESS_CERTIFICATE] = "compress_certificate"
 };
 
 static const unsigned int extension_type_table[] = {
@@ -666,7 +745,8 @@ static const unsigned int extension_type_table[] = {
     [MBEDTLS_SSL_EXT_ID_ENCRYPT_THEN_MAC] = MBEDTLS_TLS_EXT_ENCRYPT_THEN_MAC,
     [MBEDTLS_SSL_EXT_ID_EXTENDED_MASTER_SECRET] = MBEDTLS_TLS_EXT_EXTENDED_MASTER_SECRET,
     [MBEDTLS_SSL_EXT_ID_SESSION_TICKET] = MBEDTLS_TLS_EXT_SESSION_TICKET,
-    [MBEDTLS_SSL_EXT_ID_RECORD_SIZE_LIMIT] = MBEDTLS_TLS_EXT_RECORD_SIZE_LIMIT
+    [MBEDTLS_SSL_EXT_ID_RECORD_SIZE_LIMIT] = MBEDTLS_TLS_EXT_RECORD_SIZE_LIMIT,
+    [MBEDTLS_SSL_EXT_ID_COMPRESS_CERTIFICATE] = MBEDTLS_TLS_EXT_COMPRESS_CERTIFICATE
 };
 
 const char *mbedtls_ssl_get_extension_name(unsigned int extension_type)
@@ -692,6 +772,8 @@ static const char *ssl_tls13_get_hs_msg_name(int hs_msg_type)
             return "Certificate";
         case MBEDTLS_SSL_HS_CERTIFICATE_REQUEST:
             return "CertificateRequest";
+        case MBEDTLS_SSL_HS_COMPRESSED_CERTIFICATE:
+            return "CompressedCertificate";
     }
     return "Unknown";
 }
@@ -937,6 +1019,233 @@ static void ssl_handshake_params_init(mbedtls_ssl_handshake_params *handshake)
 #endif
 }
 
+#if defined(MBEDTLS_SSL_HANDSHAKE_ARENA)
+/* Alignment of the allocations from the arena, as for malloc() on common
+ * platforms. */
+#define SSL_HS_ARENA_ALIGN      (2 * sizeof(void *))
+
+/* Size of the heap block of a handshake context, which starts with the
+ * structure and continues with the arena. */
+#define SSL_HS_BLOCK_SIZE                                                 \
+    (((sizeof(mbedtls_ssl_handshake_params) + SSL_HS_ARENA_ALIGN - 1) /  \
+      SSL_HS_ARENA_ALIGN) * SSL_HS_ARENA_ALIGN +                         \
+     MBEDTLS_SSL_HANDSHAKE_ARENA_SIZE)
+
+static unsigned char *ssl_hs_arena(mbedtls_ssl_handshake_params *handshake)
+{
+    return (unsigned char *) handshake + SSL_HS_BLOCK_SIZE -
+           MBEDTLS_SSL_HANDSHAKE_ARENA_SIZE;
+}
+
+void *mbedtls_ssl_hs_calloc(mbedtls_ssl_handshake_params *handshake,
+                            size_t n, size_t size)
+{
+    size_t len;
+
+    if (n == 0 || size == 0 || n > SIZE_MAX / size) {
+        return mbedtls_calloc(n, size);
+    }
+    len = ((n * size + SSL_HS_ARENA_ALIGN - 1) / SSL_HS_ARENA_ALIGN) *
+          SSL_HS_ARENA_ALIGN;
+
+    /* Fall back to the heap when the arena is full. The arena is still
+     * zero where it has not been handed out yet. */
+    if (len < n * size ||
+        len > MBEDTLS_SSL_HANDSHAKE_ARENA_SIZE - handshake->arena_used) {
+        return mbedtls_calloc(n, size);
+    }
+
+    handshake->arena_used += len;
+    return ssl_hs_arena(handshake) + handshake->arena_used - len;
+}
+
+static int ssl_hs_in_arena(mbedtls_ssl_handshake_params *handshake,
+                           const void *ptr)
+{
+    const unsigned char *arena = ssl_hs_arena(handshake);
+
+    return (const unsigned char *) ptr >= arena &&
+           (const unsigned char *) ptr < arena + MBEDTLS_SSL_HANDSHAKE_ARENA_SIZE;
+}
+
+void mbedtls_ssl_hs_free(mbedtls_ssl_handshake_params *handshake, void *ptr)
+{
+    if (ssl_hs_in_arena(handshake, ptr)) {
+        return;
+    }
+
+    mbedtls_free(ptr);
+}
+#else
+#define SSL_HS_BLOCK_SIZE       sizeof(mbedtls_ssl_handshake_params)
+#define ssl_hs_in_arena(handshake, ptr)     ((void) (handshake), (void) (ptr), 0)
+#endif /* MBEDTLS_SSL_HANDSHAKE_ARENA */
+
+#if defined(MBEDTLS_SSL_MEMORY_ACCOUNTING)
+/* Size of a heap allocation of the handshake, 0 if it is in the arena. */
+static size_t ssl_hs_heap_size(mbedtls_ssl_handshake_params *handshake,
+                               const void *ptr, size_t len)
+{
+    if (ptr == NULL || ssl_hs_in_arena(handshake, ptr)) {
+        return 0;
+    }
+
+    return len;
+}
+
+static size_t ssl_handshake_memory(mbedtls_ssl_handshake_params *handshake)
+{
+    size_t len = SSL_HS_BLOCK_SIZE;
+
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+    const mbedtls_ssl_flight_item *cur;
+    size_t i;
+
+    for (cur = handshake->flight; cur != NULL; cur = cur->next) {
+        len += ssl_hs_heap_size(handshake, cur,
+                                sizeof(mbedtls_ssl_flight_item));
+        len += ssl_hs_heap_size(handshake, cur->p, cur->len);
+    }
+
+    for (i = 0; i < MBEDTLS_SSL_MAX_BUFFERED_HS; i++) {
+        len += ssl_hs_heap_size(handshake, handshake->buffering.hs[i].data,
+                                handshake->buffering.hs[i].data_len);
+    }
+
+    len += ssl_hs_heap_size(handshake, handshake->buffering.future_record.data,
+                            handshake->buffering.future_record.len);
+#endif /* MBEDTLS_SSL_PROTO_DTLS */
+
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3)
+    len += ssl_hs_heap_size(handshake, handshake->transform_handshake,
+                            sizeof(mbedtls_ssl_transform));
+#if defined(MBEDTLS_SSL_EARLY_DATA)
+    len += ssl_hs_heap_size(handshake, handshake->transform_earlydata,
+                            sizeof(mbedtls_ssl_transform));
+#endif
+#endif /* MBEDTLS_SSL_PROTO_TLS1_3 */
+
+    return len;
+}
+
+static size_t ssl_session_memory(const mbedtls_ssl_session *session)
+{
+    size_t len = sizeof(mbedtls_ssl_session);
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+#if defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+    const mbedtls_x509_crt *crt;
+
+    for (crt = session->peer_cert; crt != NULL; crt = crt->next) {
+        len += sizeof(mbedtls_x509_crt) + crt->raw.len;
+    }
+#else
+    len += session->peer_cert_digest_len;
+#endif /* MBEDTLS_SSL_KEEP_PEER_CERTIFICATE */
+#endif /* MBEDTLS_X509_CRT_PARSE_C */
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+    len += session->ticket_len;
+#endif
+
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3) && defined(MBEDTLS_SSL_SESSION_TICKETS)
+#if defined(MBEDTLS_SSL_SERVER_NAME_INDICATION) && defined(MBEDTLS_SSL_CLI_C)
+    if (session->hostname != NULL) {
+        len += strlen(session->hostname) + 1;
+    }
+#endif
+#if defined(MBEDTLS_SSL_EARLY_DATA) && defined(MBEDTLS_SSL_ALPN) && \
+    defined(MBEDTLS_SSL_SRV_C)
+    if (session->ticket_alpn != NULL) {
+        len += strlen(session->ticket_alpn) + 1;
+    }
+#endif
+#endif /* MBEDTLS_SSL_PROTO_TLS1_3 && MBEDTLS_SSL_SESSION_TICKETS */
+
+    return len;
+}
+
+size_t mbedtls_ssl_get_memory_usage(const mbedtls_ssl_context *ssl)
+{
+    size_t len = 0;
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+    size_t in_buf_len = ssl->in_buf_len;
+    size_t out_buf_len = ssl->out_buf_len;
+#else
+    size_t in_buf_len = MBEDTLS_SSL_IN_BUFFER_LEN;
+    size_t out_buf_len = MBEDTLS_SSL_OUT_BUFFER_LEN;
+#endif
+
+    if (ssl->in_buf != NULL) {
+        len += in_buf_len;
+    }
+    if (ssl->out_buf != NULL) {
+        len += out_buf_len;
+    }
+
+    if (ssl->handshake != NULL) {
+        len += ssl_handshake_memory(ssl->handshake);
+    }
+
+    /* The transforms and sessions move from the handshake to the connection
+     * when it completes, so only count each of them once. */
+    if (ssl->transform != NULL) {
+        len += sizeof(mbedtls_ssl_transform);
+    }
+    if (ssl->transform_negotiate != NULL &&
+        ssl->transform_negotiate != ssl->transform) {
+        len += sizeof(mbedtls_ssl_transform);
+    }
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3)
+    if (ssl->transform_application != NULL &&
+        ssl->transform_application != ssl->transform) {
+        len += sizeof(mbedtls_ssl_transform);
+    }
+#endif
+
+    if (ssl->session != NULL) {
+        len += ssl_session_memory(ssl->session);
+    }
+    if (ssl->session_negotiate != NULL &&
+        ssl->session_negotiate != ssl->session) {
+        len += ssl_session_memory(ssl->session_negotiate);
+    }
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+    if (ssl->hostname != NULL) {
+        len += strlen(ssl->hostname) + 1;
+    }
+#endif
+
+#if defined(MBEDTLS_SSL_DTLS_HELLO_VERIFY) && defined(MBEDTLS_SSL_SRV_C)
+    len += ssl->cli_id_len;
+#endif
+
+    return len;
+}
+
+int mbedtls_ssl_check_memory(const mbedtls_ssl_context *ssl, size_t len)
+{
+    size_t limit = ssl->conf->memory_limit;
+    size_t used;
+
+    if (limit == 0) {
+        return 0;
+    }
+
+    used = mbedtls_ssl_get_memory_usage(ssl);
+    if (used > limit || len > limit - used) {
+        MBEDTLS_SSL_DEBUG_MSG(1, ("memory limit of %" MBEDTLS_PRINTF_SIZET
+                                  " bytes reached: %" MBEDTLS_PRINTF_SIZET
+                                  " bytes used, %" MBEDTLS_PRINTF_SIZET
+                                  " more requested", limit, used, len));
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_MEMORY_ACCOUNTING */
+
 void mbedtls_ssl_transform_init(mbedtls_ssl_transform *transform)
 {
     memset(transform, 0, sizeof(mbedtls_ssl_transform));
@@ -979,16 +1288,18 @@ static int ssl_handshake_init(mbedtls_ssl_context *ssl)
      * Now allocate missing structures.
      */
     if (ssl->transform_negotiate == NULL) {
-        ssl->transform_negotiate = mbedtls_calloc(1, sizeof(mbedtls_ssl_transform));
+        ssl->transform_negotiate = mbedtls_ssl_calloc(ssl, 1,
+                                                      sizeof(mbedtls_ssl_transform));
     }
 #endif /* MBEDTLS_SSL_PROTO_TLS1_2 */
 
     if (ssl->session_negotiate == NULL) {
-        ssl->session_negotiate = mbedtls_calloc(1, sizeof(mbedtls_ssl_session));
+        ssl->session_negotiate = mbedtls_ssl_calloc(ssl, 1,
+                                                    sizeof(mbedtls_ssl_session));
     }
 
     if (ssl->handshake == NULL) {
-        ssl->handshake = mbedtls_calloc(1, sizeof(mbedtls_ssl_handshake_params));
+        ssl->handshake = mbedtls_ssl_calloc(ssl, 1, SSL_HS_BLOCK_SIZE);
     }
 #if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
     /* If the buffers are too small - reallocate */
@@ -1062,6 +1373,13 @@ static int ssl_handshake_init(mbedtls_ssl_context *ssl)
         }
 
         mbedtls_ssl_set_timer(ssl, 0);
+
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+        /* Let the flights of this handshake probe for a larger path MTU */
+        if (ssl->pmtu_min != 0) {
+            ssl->mtu = ssl->pmtu_ceiling;
+        }
+#endif
     }
 #endif
 
@@ -1101,8 +1419,9 @@ static int ssl_handshake_init(mbedtls_ssl_context *ssl)
             return MBEDTLS_ERR_SSL_BAD_CONFIG;
         }
 
-        ssl->handshake->sig_algs = mbedtls_calloc(1, sig_algs_len +
-                                                  sizeof(uint16_t));
+        ssl->handshake->sig_algs = mbedtls_ssl_hs_calloc(ssl->handshake, 1,
+                                                         sig_algs_len +
+                                                         sizeof(uint16_t));
         if (ssl->handshake->sig_algs == NULL) {
             return MBEDTLS_ERR_SSL_ALLOC_FAILED;
         }
@@ -1260,7 +1579,7 @@ int mbedtls_ssl_setup(mbedtls_ssl_context *ssl,
 #if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
     ssl->in_buf_len = in_buf_len;
 #endif
-    ssl->in_buf = mbedtls_calloc(1, in_buf_len);
+    ssl->in_buf = mbedtls_ssl_calloc(ssl, 1, in_buf_len);
     if (ssl->in_buf == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("alloc(%" MBEDTLS_PRINTF_SIZET " bytes) failed", in_buf_len));
         ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
@@ -1270,7 +1589,7 @@ int mbedtls_ssl_setup(mbedtls_ssl_context *ssl,
 #if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
     ssl->out_buf_len = out_buf_len;
 #endif
-    ssl->out_buf = mbedtls_calloc(1, out_buf_len);
+    ssl->out_buf = mbedtls_ssl_calloc(ssl, 1, out_buf_len);
     if (ssl->out_buf == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("alloc(%" MBEDTLS_PRINTF_SIZET " bytes) failed", out_buf_len));
         ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
@@ -1370,6 +1689,9 @@ void mbedtls_ssl_session_reset_msg_layer(mbedtls_ssl_context *ssl,
     ssl->out_msgtype = 0;
     ssl->out_msglen  = 0;
     ssl->out_left    = 0;
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+    ssl->app_data_held_len = 0;
+#endif
     memset(ssl->out_buf, 0, out_buf_len);
     memset(ssl->cur_out_ctr, 0, sizeof(ssl->cur_out_ctr));
     ssl->transform_out = NULL;
@@ -1391,15 +1713,23 @@ void mbedtls_ssl_session_reset_msg_layer(mbedtls_ssl_context *ssl,
     mbedtls_free(ssl->transform_application);
     ssl->transform_application = NULL;
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+    ssl->key_update_state = MBEDTLS_SSL_KEY_UPDATE_STATE_NONE;
+    ssl->key_update_records = 0;
+    ssl->key_update_bytes = 0;
+#endif
+
     if (ssl->handshake != NULL) {
 #if defined(MBEDTLS_SSL_EARLY_DATA)
         mbedtls_ssl_transform_free(ssl->handshake->transform_earlydata);
-        mbedtls_free(ssl->handshake->transform_earlydata);
+        mbedtls_ssl_hs_free(ssl->handshake,
+                            ssl->handshake->transform_earlydata);
         ssl->handshake->transform_earlydata = NULL;
 #endif
 
         mbedtls_ssl_transform_free(ssl->handshake->transform_handshake);
-        mbedtls_free(ssl->handshake->transform_handshake);
+        mbedtls_ssl_hs_free(ssl->handshake,
+                            ssl->handshake->transform_handshake);
         ssl->handshake->transform_handshake = NULL;
     }
 
@@ -1438,6 +1768,12 @@ int mbedtls_ssl_session_reset_int(mbedtls_ssl_context *ssl, int partial)
     ssl->alpn_chosen = NULL;
 #endif
 
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+    /* The next connection may take another path */
+    ssl->pmtu_ceiling = ssl->pmtu_max;
+    ssl->pmtu_confirmed = ssl->pmtu_min;
+#endif
+
 #if defined(MBEDTLS_SSL_DTLS_HELLO_VERIFY) && defined(MBEDTLS_SSL_SRV_C)
     int free_cli_id = 1;
 #if defined(MBEDTLS_SSL_DTLS_CLIENT_PORT_REUSE)
@@ -1491,6 +1827,63 @@ void mbedtls_ssl_conf_dtls_badmac_limit(mbedtls_ssl_config *conf, unsigned limit
     conf->badmac_limit = limit;
 }
 
+#if defined(MBEDTLS_SSL_MEMORY_ACCOUNTING)
+void mbedtls_ssl_conf_memory_limit(mbedtls_ssl_config *conf, size_t limit)
+{
+    conf->memory_limit = limit;
+}
+
+size_t mbedtls_ssl_conf_get_memory_usage(const mbedtls_ssl_config *conf)
+{
+    size_t len = 0;
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+    const mbedtls_ssl_key_cert *cur;
+
+    for (cur = conf->key_cert; cur != NULL; cur = cur->next) {
+        len += sizeof(mbedtls_ssl_key_cert);
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS)
+#if defined(MBEDTLS_SSL_PROTO_TLS1_2)
+        len += cur->tls12_list_len;
+#endif
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3)
+        len += cur->tls13_list_len;
+#endif
+#endif /* MBEDTLS_SSL_PREENCODE_CERTS */
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+        for (size_t i = 0; i < MBEDTLS_SSL_CERT_COMPRESSION_MAX_ALGS; i++) {
+            len += cur->compressed[i].len;
+        }
+#endif
+    }
+#endif /* MBEDTLS_X509_CRT_PARSE_C */
+
+#if defined(MBEDTLS_KEY_EXCHANGE_CERT_REQ_ALLOWED_ENABLED) && \
+    defined(MBEDTLS_SSL_PREENCODE_CERTS) && defined(MBEDTLS_SSL_SRV_C)
+    len += conf->dn_list_len;
+#endif
+
+#if defined(MBEDTLS_SSL_HANDSHAKE_WITH_PSK_ENABLED)
+    len += conf->psk_len + conf->psk_identity_len;
+#endif
+
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+    if (conf->suite_table != NULL) {
+        len += ((size_t) 1 << conf->suite_table_bits) *
+               sizeof(mbedtls_ssl_suite_slot);
+    }
+    if (conf->group_table != NULL) {
+        len += ((size_t) 1 << conf->group_table_bits) * sizeof(uint16_t);
+    }
+    if (conf->sig_alg_table != NULL) {
+        len += ((size_t) 1 << conf->sig_alg_table_bits) * sizeof(uint16_t);
+    }
+#endif /* MBEDTLS_SSL_CONF_FINALIZE */
+
+    return len;
+}
+#endif /* MBEDTLS_SSL_MEMORY_ACCOUNTING */
+
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
 
 void mbedtls_ssl_set_datagram_packing(mbedtls_ssl_context *ssl,
@@ -1499,6 +1892,18 @@ void mbedtls_ssl_set_datagram_packing(mbedtls_ssl_context *ssl,
     ssl->disable_datagram_packing = !allow_packing;
 }
 
+void mbedtls_ssl_set_app_data_packing(mbedtls_ssl_context *ssl,
+                                      unsigned allow_packing,
+                                      uint32_t max_delay)
+{
+    ssl->app_data_packing = allow_packing != 0;
+#if defined(MBEDTLS_HAVE_TIME)
+    ssl->app_data_max_delay = max_delay;
+#else
+    (void) max_delay;
+#endif
+}
+
 void mbedtls_ssl_conf_handshake_timeout(mbedtls_ssl_config *conf,
                                         uint32_t min, uint32_t max)
 {
@@ -1555,6 +1960,26 @@ void mbedtls_ssl_set_mtu(mbedtls_ssl_context *ssl, uint16_t mtu)
 {
     ssl->mtu = mtu;
 }
+
+#if defined(MBEDTLS_SSL_DTLS_PMTU_DISCOVERY)
+int mbedtls_ssl_set_pmtu_discovery(mbedtls_ssl_context *ssl,
+                                   uint16_t min_mtu, uint16_t max_mtu)
+{
+    if (min_mtu != 0 && max_mtu < min_mtu) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    ssl->pmtu_min = min_mtu;
+    ssl->pmtu_max = max_mtu;
+    ssl->pmtu_ceiling = max_mtu;
+    ssl->pmtu_confirmed = min_mtu;
+    if (min_mtu != 0) {
+        ssl->mtu = max_mtu;
+    }
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_DTLS_PMTU_DISCOVERY */
 #endif
 
 void mbedtls_ssl_conf_read_timeout(mbedtls_ssl_config *conf, uint32_t timeout)
@@ -1588,6 +2013,43 @@ void mbedtls_ssl_conf_session_cache(mbedtls_ssl_config *conf,
 #endif /* MBEDTLS_SSL_SRV_C */
 
 #if defined(MBEDTLS_SSL_CLI_C)
+/*
+ * Copy a session loaded with mbedtls_ssl_session_load_borrowed(): the copy
+ * borrows its variable-length fields from the same buffer.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_session_copy_borrowed(mbedtls_ssl_session *dst,
+                                     const mbedtls_ssl_session *src)
+{
+    mbedtls_ssl_session_free(dst);
+    memcpy(dst, src, sizeof(mbedtls_ssl_session));
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C) && \
+    defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+    if (src->peer_cert != NULL) {
+        int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+
+        dst->peer_cert = mbedtls_calloc(1, sizeof(mbedtls_x509_crt));
+        if (dst->peer_cert == NULL) {
+            return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+        }
+
+        mbedtls_x509_crt_init(dst->peer_cert);
+
+        if ((ret = mbedtls_x509_crt_parse_der_nocopy(dst->peer_cert,
+                                                     src->peer_cert->raw.p,
+                                                     src->peer_cert->raw.len)) != 0) {
+            mbedtls_x509_crt_free(dst->peer_cert);
+            mbedtls_free(dst->peer_cert);
+            dst->peer_cert = NULL;
+            return ret;
+        }
+    }
+#endif /* MBEDTLS_X509_CRT_PARSE_C && MBEDTLS_SSL_KEEP_PEER_CERTIFICATE */
+
+    return 0;
+}
+
 int mbedtls_ssl_set_session(mbedtls_ssl_context *ssl, const mbedtls_ssl_session *session)
 {
     int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
@@ -1627,8 +2089,14 @@ int mbedtls_ssl_set_session(mbedtls_ssl_context *ssl, const mbedtls_ssl_session
     }
 #endif /* MBEDTLS_SSL_PROTO_TLS1_3 */
 
-    if ((ret = mbedtls_ssl_session_copy(ssl->session_negotiate,
-                                        session)) != 0) {
+    /* A borrowed session keeps borrowing until the handshake stores it, see
+     * mbedtls_ssl_session_detach(). */
+    if (session->borrowed) {
+        ret = ssl_session_copy_borrowed(ssl->session_negotiate, session);
+    } else {
+        ret = mbedtls_ssl_session_copy(ssl->session_negotiate, session);
+    }
+    if (ret != 0) {
         return ret;
     }
 
@@ -1644,6 +2112,188 @@ void mbedtls_ssl_conf_ciphersuites(mbedtls_ssl_config *conf,
     conf->ciphersuite_list = ciphersuites;
 }
 
+const mbedtls_ssl_ciphersuite_t *mbedtls_ssl_conf_get_ciphersuite(
+    const mbedtls_ssl_config *conf, int suite_id, size_t *pref)
+{
+    const int *list = conf->ciphersuite_list;
+    size_t i;
+
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+    if (conf->suite_table != NULL && list == conf->suite_table_src) {
+        size_t mask = ((size_t) 1 << conf->suite_table_bits) - 1;
+
+        if (suite_id <= 0 || suite_id > 0xFFFF) {
+            return NULL;
+        }
+
+        for (i = mbedtls_ssl_conf_table_index((uint16_t) suite_id,
+                                              conf->suite_table_bits);
+             conf->suite_table[i].info != NULL; i = (i + 1) & mask) {
+            if (conf->suite_table[i].id == suite_id) {
+                if (pref != NULL) {
+                    *pref = conf->suite_table[i].pref;
+                }
+                return conf->suite_table[i].info;
+            }
+        }
+
+        return NULL;
+    }
+#endif /* MBEDTLS_SSL_CONF_FINALIZE */
+
+    for (i = 0; list[i] != 0; i++) {
+        if (list[i] == suite_id) {
+            if (pref != NULL) {
+                *pref = i;
+            }
+            return mbedtls_ssl_ciphersuite_from_id(suite_id);
+        }
+    }
+
+    return NULL;
+}
+
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+static unsigned char ssl_conf_table_bits(size_t count)
+{
+    unsigned char bits = 1;
+
+    while (((size_t) 1 << bits) < 2 * count) {
+        bits++;
+    }
+
+    return bits;
+}
+
+static void ssl_conf_tables_free(mbedtls_ssl_config *conf)
+{
+    mbedtls_free(conf->suite_table);
+    conf->suite_table = NULL;
+    conf->suite_table_src = NULL;
+    mbedtls_free(conf->group_table);
+    conf->group_table = NULL;
+    conf->group_table_src = NULL;
+    mbedtls_free(conf->sig_alg_table);
+    conf->sig_alg_table = NULL;
+    conf->sig_alg_table_src = NULL;
+}
+
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_conf_build_suite_table(mbedtls_ssl_config *conf)
+{
+    const int *list = conf->ciphersuite_list;
+    const mbedtls_ssl_ciphersuite_t *info;
+    mbedtls_ssl_suite_slot *table;
+    size_t count, mask, i, n;
+    unsigned char bits;
+
+    for (count = 0; list[count] != 0; count++) {
+        ;
+    }
+    if (count > 0xFFFF) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    bits = ssl_conf_table_bits(count);
+    mask = ((size_t) 1 << bits) - 1;
+    table = mbedtls_calloc(mask + 1, sizeof(mbedtls_ssl_suite_slot));
+    if (table == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    for (n = 0; n < count; n++) {
+        /* Unknown identifiers can never be negotiated: leave them out. */
+        if (list[n] <= 0 || list[n] > 0xFFFF ||
+            (info = mbedtls_ssl_ciphersuite_from_id(list[n])) == NULL) {
+            continue;
+        }
+
+        i = mbedtls_ssl_conf_table_index((uint16_t) list[n], bits);
+        while (table[i].info != NULL && table[i].id != list[n]) {
+            i = (i + 1) & mask;
+        }
+        /* Keep the most preferred position of a duplicate. */
+        if (table[i].info == NULL) {
+            table[i].info = info;
+            table[i].id = (uint16_t) list[n];
+            table[i].pref = (uint16_t) n;
+        }
+    }
+
+    conf->suite_table = table;
+    conf->suite_table_bits = bits;
+    conf->suite_table_src = list;
+
+    return 0;
+}
+
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_conf_build_id_table(const uint16_t *list,
+                                   uint16_t **table,
+                                   unsigned char *bits)
+{
+    size_t count, mask, i;
+
+    for (count = 0; list[count] != 0; count++) {
+        ;
+    }
+
+    *bits = ssl_conf_table_bits(count);
+    mask = ((size_t) 1 << *bits) - 1;
+    *table = mbedtls_calloc(mask + 1, sizeof(uint16_t));
+    if (*table == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    for (; *list != 0; list++) {
+        i = mbedtls_ssl_conf_table_index(*list, *bits);
+        while ((*table)[i] != 0 && (*table)[i] != *list) {
+            i = (i + 1) & mask;
+        }
+        (*table)[i] = *list;
+    }
+
+    return 0;
+}
+
+int mbedtls_ssl_conf_finalize(mbedtls_ssl_config *conf)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+
+    ssl_conf_tables_free(conf);
+
+    if ((ret = ssl_conf_build_suite_table(conf)) != 0) {
+        goto cleanup;
+    }
+
+    if (conf->group_list != NULL) {
+        ret = ssl_conf_build_id_table(conf->group_list, &conf->group_table,
+                                      &conf->group_table_bits);
+        if (ret != 0) {
+            goto cleanup;
+        }
+        conf->group_table_src = conf->group_list;
+    }
+
+#if defined(MBEDTLS_SSL_HANDSHAKE_WITH_CERT_ENABLED)
+    if (conf->sig_algs != NULL) {
+        ret = ssl_conf_build_id_table(conf->sig_algs, &conf->sig_alg_table,
+                                      &conf->sig_alg_table_bits);
+        if (ret != 0) {
+            goto cleanup;
+        }
+        conf->sig_alg_table_src = conf->sig_algs;
+    }
+#endif
+
+    return 0;
+
+cleanup:
+    ssl_conf_tables_free(conf);
+    return ret;
+}
+#endif /* MBEDTLS_SSL_CONF_FINALIZE */
+
 #if defined(MBEDTLS_SSL_PROTO_TLS1_3)
 void mbedtls_ssl_conf_tls13_key_exchange_modes(mbedtls_ssl_config *conf,
                                                const int kex_modes)
@@ -1682,6 +2332,19 @@ static void ssl_key_cert_free(mbedtls_ssl_key_cert *key_cert)
 
     while (cur != NULL) {
         next = cur->next;
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS)
+#if defined(MBEDTLS_SSL_PROTO_TLS1_2)
+        mbedtls_free(cur->tls12_list);
+#endif
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3)
+        mbedtls_free(cur->tls13_list);
+#endif
+#endif /* MBEDTLS_SSL_PREENCODE_CERTS */
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+        for (size_t i = 0; i < MBEDTLS_SSL_CERT_COMPRESSION_MAX_ALGS; i++) {
+            mbedtls_free(cur->compressed[i].data);
+        }
+#endif
         mbedtls_free(cur);
         cur = next;
     }
@@ -1719,18 +2382,212 @@ static int ssl_append_key_cert(mbedtls_ssl_key_cert **head,
         while (cur->next != NULL) {
             cur = cur->next;
         }
-        cur->next = new_cert;
+        cur->next = new_cert;
+    }
+
+    return 0;
+}
+
+int mbedtls_ssl_conf_own_cert(mbedtls_ssl_config *conf,
+                              mbedtls_x509_crt *own_cert,
+                              mbedtls_pk_context *pk_key)
+{
+    return ssl_append_key_cert(&conf->key_cert, own_cert, pk_key);
+}
+
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS)
+/*
+ * Encode each certificate of a chain as a 24-bit length, the DER data and
+ * ext_len zero bytes (an empty extension block in TLS 1.3).
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_encode_cert_list(const mbedtls_x509_crt *chain, size_t ext_len,
+                                unsigned char **list, size_t *list_len)
+{
+    const mbedtls_x509_crt *crt;
+    unsigned char *p;
+    size_t len = 0;
+
+    mbedtls_free(*list);
+    *list = NULL;
+    *list_len = 0;
+
+    for (crt = chain; crt != NULL; crt = crt->next) {
+        if (len > 0xFFFFFF - 3 - ext_len ||
+            crt->raw.len > 0xFFFFFF - 3 - ext_len - len) {
+            return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+        }
+        len += 3 + crt->raw.len + ext_len;
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    p = mbedtls_calloc(1, len);
+    if (p == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+    *list = p;
+    *list_len = len;
+
+    for (crt = chain; crt != NULL; crt = crt->next) {
+        MBEDTLS_PUT_UINT24_BE(crt->raw.len, p, 0);
+        p += 3;
+        memcpy(p, crt->raw.p, crt->raw.len);
+        p += crt->raw.len + ext_len;
+    }
+
+    return 0;
+}
+
+#if defined(MBEDTLS_KEY_EXCHANGE_CERT_REQ_ALLOWED_ENABLED) && \
+    defined(MBEDTLS_SSL_SRV_C)
+/*
+ * Encode the DistinguishedName entries of a CertificateRequest, as
+ * ssl_write_certificate_request() does.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_encode_dn_list(mbedtls_ssl_config *conf,
+                              const mbedtls_x509_crt *chain)
+{
+    const mbedtls_x509_crt *crt;
+    unsigned char *p;
+    size_t len = 0;
+
+    mbedtls_free(conf->dn_list);
+    conf->dn_list = NULL;
+    conf->dn_list_len = 0;
+    conf->dn_list_src = NULL;
+
+    for (crt = chain; crt != NULL && crt->version != 0; crt = crt->next) {
+        len += 2 + crt->subject_raw.len;
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    p = mbedtls_calloc(1, len);
+    if (p == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+    conf->dn_list = p;
+    conf->dn_list_len = len;
+    conf->dn_list_src = chain;
+
+    for (crt = chain; crt != NULL && crt->version != 0; crt = crt->next) {
+        MBEDTLS_PUT_UINT16_BE(crt->subject_raw.len, p, 0);
+        p += 2;
+        memcpy(p, crt->subject_raw.p, crt->subject_raw.len);
+        p += crt->subject_raw.len;
+    }
+
+    return 0;
+}
+#endif /* MBEDTLS_KEY_EXCHANGE_CERT_REQ_ALLOWED_ENABLED && MBEDTLS_SSL_SRV_C */
+
+int mbedtls_ssl_conf_preencode_certs(mbedtls_ssl_config *conf)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_key_cert *key_cert;
+
+    for (key_cert = conf->key_cert; key_cert != NULL; key_cert = key_cert->next) {
+#if defined(MBEDTLS_SSL_PROTO_TLS1_2)
+        ret = ssl_encode_cert_list(key_cert->cert, 0,
+                                   &key_cert->tls12_list,
+                                   &key_cert->tls12_list_len);
+        if (ret != 0) {
+            return ret;
+        }
+#endif
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3)
+        ret = ssl_encode_cert_list(key_cert->cert, 2,
+                                   &key_cert->tls13_list,
+                                   &key_cert->tls13_list_len);
+        if (ret != 0) {
+            return ret;
+        }
+#endif
+    }
+
+#if defined(MBEDTLS_KEY_EXCHANGE_CERT_REQ_ALLOWED_ENABLED) && \
+    defined(MBEDTLS_SSL_SRV_C)
+    if (conf->endpoint == MBEDTLS_SSL_IS_SERVER) {
+        ret = ssl_encode_dn_list(conf, conf->dn_hints != NULL ?
+                                 conf->dn_hints : conf->ca_chain);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+#endif
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_PREENCODE_CERTS */
+
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+int mbedtls_ssl_conf_cert_compression(mbedtls_ssl_config *conf,
+                                      uint16_t alg,
+                                      mbedtls_ssl_cert_compress_t *f_compress,
+                                      mbedtls_ssl_cert_decompress_t *f_decompress,
+                                      void *p_ctx)
+{
+    mbedtls_ssl_cert_compression *comp;
+
+    if (f_compress == NULL && f_decompress == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    for (size_t i = 0; i < conf->cert_compression_count; i++) {
+        if (conf->cert_compression[i].alg == alg) {
+            return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+        }
+    }
+
+    if (conf->cert_compression_count == MBEDTLS_SSL_CERT_COMPRESSION_MAX_ALGS) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    comp = &conf->cert_compression[conf->cert_compression_count++];
+    comp->alg = alg;
+    comp->f_compress = f_compress;
+    comp->f_decompress = f_decompress;
+    comp->p_ctx = p_ctx;
+
+    return 0;
+}
+
+int mbedtls_ssl_conf_compress_certs(mbedtls_ssl_config *conf)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_key_cert *key_cert;
+
+    for (key_cert = conf->key_cert; key_cert != NULL; key_cert = key_cert->next) {
+        for (size_t i = 0; i < conf->cert_compression_count; i++) {
+            if (conf->cert_compression[i].f_compress == NULL ||
+                key_cert->compressed[i].data != NULL) {
+                continue;
+            }
+
+            ret = mbedtls_ssl_tls13_compress_cert_chain(
+                &conf->cert_compression[i], key_cert->cert,
+                &key_cert->compressed[i].data,
+                &key_cert->compressed[i].len,
+                &key_cert->compressed[i].uncompressed_len);
+            /* Not worth compressing: the handshake will not try again. */
+            if (ret == MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL) {
+                continue;
+            }
+            if (ret != 0) {
+                return ret;
+            }
+        }
     }
 
     return 0;
 }
-
-int mbedtls_ssl_conf_own_cert(mbedtls_ssl_config *conf,
-                              mbedtls_x509_crt *own_cert,
-                              mbedtls_pk_context *pk_key)
-{
-    return ssl_append_key_cert(&conf->key_cert, own_cert, pk_key);
-}
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
 
 void mbedtls_ssl_conf_ca_chain(mbedtls_ssl_config *conf,
                                mbedtls_x509_crt *ca_chain,
@@ -1761,6 +2618,14 @@ void mbedtls_ssl_conf_ca_cb(mbedtls_ssl_config *conf,
     conf->ca_crl     = NULL;
 }
 #endif /* MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK */
+
+#if defined(MBEDTLS_SSL_VERIFY_CACHE_C)
+void mbedtls_ssl_conf_verify_cache(mbedtls_ssl_config *conf,
+                                   mbedtls_ssl_verify_cache *cache)
+{
+    conf->verify_cache = cache;
+}
+#endif /* MBEDTLS_SSL_VERIFY_CACHE_C */
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
 
 #if defined(MBEDTLS_SSL_SERVER_NAME_INDICATION)
@@ -2514,6 +3379,22 @@ void mbedtls_ssl_conf_groups(mbedtls_ssl_config *conf,
     conf->group_list = group_list;
 }
 
+#if defined(MBEDTLS_SSL_KEY_SHARE_POOL_C)
+void mbedtls_ssl_conf_key_share_pool(mbedtls_ssl_config *conf,
+                                     mbedtls_ssl_key_share_pool *pool)
+{
+    conf->key_share_pool = pool;
+}
+#endif /* MBEDTLS_SSL_KEY_SHARE_POOL_C */
+
+#if defined(MBEDTLS_SSL_GROUP_CACHE_C)
+void mbedtls_ssl_conf_group_cache(mbedtls_ssl_config *conf,
+                                  mbedtls_ssl_group_cache *cache)
+{
+    conf->group_cache = cache;
+}
+#endif /* MBEDTLS_SSL_GROUP_CACHE_C */
+
 #if defined(MBEDTLS_X509_CRT_PARSE_C)
 int mbedtls_ssl_set_hostname(mbedtls_ssl_context *ssl, const char *hostname)
 {
@@ -2742,6 +3623,16 @@ void mbedtls_ssl_conf_renegotiation_period(mbedtls_ssl_config *conf,
 }
 #endif /* MBEDTLS_SSL_RENEGOTIATION */
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+void mbedtls_ssl_conf_key_update_interval(mbedtls_ssl_config *conf,
+                                          uint64_t max_records,
+                                          uint64_t max_bytes)
+{
+    conf->key_update_max_records = max_records;
+    conf->key_update_max_bytes = max_bytes;
+}
+#endif /* MBEDTLS_SSL_TLS1_3_KEY_UPDATE */
+
 #if defined(MBEDTLS_SSL_SESSION_TICKETS)
 #if defined(MBEDTLS_SSL_CLI_C)
 void mbedtls_ssl_conf_session_tickets(mbedtls_ssl_config *conf, int use_tickets)
@@ -2758,6 +3649,12 @@ void mbedtls_ssl_conf_new_session_tickets(mbedtls_ssl_config *conf,
 {
     conf->new_session_tickets_count = num_tickets;
 }
+
+void mbedtls_ssl_conf_new_session_tickets_mode(mbedtls_ssl_config *conf,
+                                               int mode)
+{
+    conf->new_session_tickets_mode = (uint8_t) mode;
+}
 #endif
 
 void mbedtls_ssl_conf_session_tickets_cb(mbedtls_ssl_config *conf,
@@ -2819,6 +3716,20 @@ void mbedtls_ssl_set_async_operation_data(mbedtls_ssl_context *ssl,
 }
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+void mbedtls_ssl_conf_async_crypto_cb(mbedtls_ssl_config *conf,
+                                      mbedtls_ssl_async_job_start_t *f_start,
+                                      mbedtls_ssl_async_job_poll_t *f_poll,
+                                      mbedtls_ssl_async_job_cancel_t *f_cancel,
+                                      void *p_ctx)
+{
+    conf->f_async_job_start = f_start;
+    conf->f_async_job_poll = f_poll;
+    conf->f_async_job_cancel = f_cancel;
+    conf->p_async_job = p_ctx;
+}
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
+
 /*
  * SSL get accessors
  */
@@ -3127,6 +4038,35 @@ int mbedtls_ssl_get_session(const mbedtls_ssl_context *ssl,
 }
 #endif /* MBEDTLS_SSL_CLI_C */
 
+#if (defined(MBEDTLS_SSL_PROTO_TLS1_2) &&                    \
+    defined(MBEDTLS_X509_CRT_PARSE_C) &&                     \
+    !defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)) ||          \
+    (defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C))
+/*
+ * Return a pointer to a variable-length session field of len bytes found at
+ * p in a serialized session: p itself when the session borrows from the
+ * serialized buffer, or a heap copy otherwise. Return NULL if the copy
+ * cannot be allocated.
+ */
+static unsigned char *ssl_session_load_field(const mbedtls_ssl_session *session,
+                                             const unsigned char *p,
+                                             size_t len)
+{
+    unsigned char *field;
+
+    if (session->borrowed) {
+        return (unsigned char *) p;
+    }
+
+    field = mbedtls_calloc(1, len);
+    if (field != NULL) {
+        memcpy(field, p, len);
+    }
+
+    return field;
+}
+#endif
+
 #if defined(MBEDTLS_SSL_PROTO_TLS1_2)
 
 /* Serialization of TLS 1.2 sessions
@@ -3372,8 +4312,13 @@ static int ssl_tls12_session_load(mbedtls_ssl_session *session,
 
         mbedtls_x509_crt_init(session->peer_cert);
 
-        if ((ret = mbedtls_x509_crt_parse_der(session->peer_cert,
-                                              p, cert_len)) != 0) {
+        if (session->borrowed) {
+            ret = mbedtls_x509_crt_parse_der_nocopy(session->peer_cert,
+                                                    p, cert_len);
+        } else {
+            ret = mbedtls_x509_crt_parse_der(session->peer_cert, p, cert_len);
+        }
+        if (ret != 0) {
             mbedtls_x509_crt_free(session->peer_cert);
             mbedtls_free(session->peer_cert);
             session->peer_cert = NULL;
@@ -3406,13 +4351,10 @@ static int ssl_tls12_session_load(mbedtls_ssl_session *session,
         }
 
         session->peer_cert_digest =
-            mbedtls_calloc(1, session->peer_cert_digest_len);
+            ssl_session_load_field(session, p, session->peer_cert_digest_len);
         if (session->peer_cert_digest == NULL) {
             return MBEDTLS_ERR_SSL_ALLOC_FAILED;
         }
-
-        memcpy(session->peer_cert_digest, p,
-               session->peer_cert_digest_len);
         p += session->peer_cert_digest_len;
     }
 #endif /* MBEDTLS_SSL_KEEP_PEER_CERTIFICATE */
@@ -3436,12 +4378,11 @@ static int ssl_tls12_session_load(mbedtls_ssl_session *session,
                 return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
             }
 
-            session->ticket = mbedtls_calloc(1, session->ticket_len);
+            session->ticket =
+                ssl_session_load_field(session, p, session->ticket_len);
             if (session->ticket == NULL) {
                 return MBEDTLS_ERR_SSL_ALLOC_FAILED;
             }
-
-            memcpy(session->ticket, p, session->ticket_len);
             p += session->ticket_len;
         }
 
@@ -3709,9 +4650,18 @@ static int ssl_tls13_session_load(mbedtls_ssl_session *session,
         }
 
         if (alpn_len > 0) {
-            int ret = mbedtls_ssl_session_set_ticket_alpn(session, (char *) p);
-            if (ret != 0) {
-                return ret;
+            if (session->borrowed) {
+                /* The ALPN is serialized with its terminating NUL. */
+                if (p[alpn_len - 1] != '\0') {
+                    return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+                }
+                session->ticket_alpn = (char *) p;
+            } else {
+                int ret = mbedtls_ssl_session_set_ticket_alpn(session,
+                                                              (char *) p);
+                if (ret != 0) {
+                    return ret;
+                }
             }
             p += alpn_len;
         }
@@ -3734,11 +4684,15 @@ static int ssl_tls13_session_load(mbedtls_ssl_session *session,
             return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
         }
         if (hostname_len > 0) {
-            session->hostname = mbedtls_calloc(1, hostname_len);
+            /* A borrowed host name must carry its own terminating NUL. */
+            if (session->borrowed && p[hostname_len - 1] != '\0') {
+                return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+            }
+            session->hostname =
+                (char *) ssl_session_load_field(session, p, hostname_len);
             if (session->hostname == NULL) {
                 return MBEDTLS_ERR_SSL_ALLOC_FAILED;
             }
-            memcpy(session->hostname, p, hostname_len);
             p += hostname_len;
         }
 #endif /* MBEDTLS_SSL_SERVER_NAME_INDICATION */
@@ -3766,11 +4720,11 @@ static int ssl_tls13_session_load(mbedtls_ssl_session *session,
             return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
         }
         if (session->ticket_len > 0) {
-            session->ticket = mbedtls_calloc(1, session->ticket_len);
+            session->ticket =
+                ssl_session_load_field(session, p, session->ticket_len);
             if (session->ticket == NULL) {
                 return MBEDTLS_ERR_SSL_ALLOC_FAILED;
             }
-            memcpy(session->ticket, p, session->ticket_len);
             p += session->ticket_len;
         }
     }
@@ -4201,6 +5155,59 @@ int mbedtls_ssl_session_load(mbedtls_ssl_session *session,
     return ret;
 }
 
+/*
+ * Deserialize a session without copying its variable-length fields
+ */
+int mbedtls_ssl_session_load_borrowed(mbedtls_ssl_session *session,
+                                      const unsigned char *buf,
+                                      size_t len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+
+    if (session == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    session->borrowed = 1;
+    ret = ssl_session_load(session, 0, buf, len);
+
+    if (ret != 0) {
+        mbedtls_ssl_session_free(session);
+    }
+
+    return ret;
+}
+
+/*
+ * Give a borrowed session its own copy of the fields it borrows
+ */
+int mbedtls_ssl_session_detach(mbedtls_ssl_session *session)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_session owned;
+
+    if (session == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (!session->borrowed) {
+        return 0;
+    }
+
+    mbedtls_ssl_session_init(&owned);
+
+    if ((ret = mbedtls_ssl_session_copy(&owned, session)) != 0) {
+        mbedtls_ssl_session_free(&owned);
+        return ret;
+    }
+
+    mbedtls_ssl_session_free(session);
+    memcpy(session, &owned, sizeof(mbedtls_ssl_session));
+    mbedtls_platform_zeroize(&owned, sizeof(mbedtls_ssl_session));
+
+    return 0;
+}
+
 /*
  * Perform a single step of the SSL handshake
  */
@@ -4219,10 +5226,12 @@ static int ssl_prepare_handshake_step(mbedtls_ssl_context *ssl)
      * the case here by calling `mbedtls_ssl_flush_output()`. The function may
      * return with the #MBEDTLS_ERR_SSL_WANT_WRITE error code in which case
      * we have to wait before to go ahead.
-     * In the case of TLS 1.3, handshake step handlers do not send data to the
-     * peer. Data are only sent here and through
-     * `mbedtls_ssl_handle_pending_alert` in case an error that triggered an
-     * alert occurred.
+     * In the case of TLS 1.3, handshake step handlers send data to the peer
+     * only through `mbedtls_ssl_write_coalesced_handshake()`, when the
+     * handshake messages they coalesced have to go before the next one, a
+     * record of another type or a change of keys. Otherwise, data are only
+     * sent here and through `mbedtls_ssl_handle_pending_alert` in case an
+     * error that triggered an alert occurred.
      */
     if ((ret = mbedtls_ssl_flush_output(ssl)) != 0) {
         return ret;
@@ -4512,13 +5521,14 @@ void mbedtls_ssl_handshake_free(mbedtls_ssl_context *ssl)
 #if defined(MBEDTLS_SSL_HANDSHAKE_WITH_CERT_ENABLED)
 #if !defined(MBEDTLS_DEPRECATED_REMOVED)
     if (ssl->handshake->sig_algs_heap_allocated) {
-        mbedtls_free((void *) handshake->sig_algs);
+        mbedtls_ssl_hs_free(handshake, (void *) handshake->sig_algs);
     }
     handshake->sig_algs = NULL;
 #endif /* MBEDTLS_DEPRECATED_REMOVED */
 #if defined(MBEDTLS_SSL_PROTO_TLS1_3)
     if (ssl->handshake->certificate_request_context) {
-        mbedtls_free((void *) handshake->certificate_request_context);
+        mbedtls_ssl_hs_free(handshake,
+                            (void *) handshake->certificate_request_context);
     }
 #endif /* MBEDTLS_SSL_PROTO_TLS1_3 */
 #endif /* MBEDTLS_SSL_HANDSHAKE_WITH_CERT_ENABLED */
@@ -4530,6 +5540,10 @@ void mbedtls_ssl_handshake_free(mbedtls_ssl_context *ssl)
     }
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+    mbedtls_ssl_async_job_free(ssl);
+#endif
+
 #if defined(PSA_WANT_ALG_SHA_256)
     psa_hash_abort(&handshake->fin_sha256_psa);
 #endif
@@ -4553,7 +5567,7 @@ void mbedtls_ssl_handshake_free(mbedtls_ssl_context *ssl)
     }
     handshake->psa_pake_password = MBEDTLS_SVC_KEY_ID_INIT;
 #if defined(MBEDTLS_SSL_CLI_C)
-    mbedtls_free(handshake->ecjpake_cache);
+    mbedtls_ssl_hs_free(handshake, handshake->ecjpake_cache);
     handshake->ecjpake_cache = NULL;
     handshake->ecjpake_cache_len = 0;
 #endif
@@ -4563,7 +5577,7 @@ void mbedtls_ssl_handshake_free(mbedtls_ssl_context *ssl)
     defined(MBEDTLS_KEY_EXCHANGE_WITH_ECDSA_ANY_ENABLED) || \
     defined(MBEDTLS_KEY_EXCHANGE_ECJPAKE_ENABLED)
     /* explicit void pointer cast for buggy MS compiler */
-    mbedtls_free((void *) handshake->curves_tls_id);
+    mbedtls_ssl_hs_free(handshake, (void *) handshake->curves_tls_id);
 #endif
 
 #if defined(MBEDTLS_SSL_HANDSHAKE_WITH_PSK_ENABLED)
@@ -4602,12 +5616,20 @@ void mbedtls_ssl_handshake_free(mbedtls_ssl_context *ssl)
 
 #if defined(MBEDTLS_SSL_CLI_C) && \
     (defined(MBEDTLS_SSL_PROTO_DTLS) || defined(MBEDTLS_SSL_PROTO_TLS1_3))
-    mbedtls_free(handshake->cookie);
+    mbedtls_ssl_hs_free(handshake, handshake->cookie);
 #endif /* MBEDTLS_SSL_CLI_C &&
           ( MBEDTLS_SSL_PROTO_DTLS || MBEDTLS_SSL_PROTO_TLS1_3 ) */
 
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_SRV_C)
+    if (handshake->ticket_buf != NULL) {
+        mbedtls_platform_zeroize(handshake->ticket_buf,
+                                 handshake->ticket_buf_len);
+        mbedtls_ssl_hs_free(handshake, handshake->ticket_buf);
+    }
+#endif /* MBEDTLS_SSL_SESSION_TICKETS && MBEDTLS_SSL_SRV_C */
+
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
-    mbedtls_ssl_flight_free(handshake->flight);
+    mbedtls_ssl_flight_free(handshake, handshake->flight);
     mbedtls_ssl_buffering_free(ssl);
 #endif /* MBEDTLS_SSL_PROTO_DTLS */
 
@@ -4619,10 +5641,10 @@ void mbedtls_ssl_handshake_free(mbedtls_ssl_context *ssl)
 
 #if defined(MBEDTLS_SSL_PROTO_TLS1_3)
     mbedtls_ssl_transform_free(handshake->transform_handshake);
-    mbedtls_free(handshake->transform_handshake);
+    mbedtls_ssl_hs_free(handshake, handshake->transform_handshake);
 #if defined(MBEDTLS_SSL_EARLY_DATA)
     mbedtls_ssl_transform_free(handshake->transform_earlydata);
-    mbedtls_free(handshake->transform_earlydata);
+    mbedtls_ssl_hs_free(handshake, handshake->transform_earlydata);
 #endif
 #endif /* MBEDTLS_SSL_PROTO_TLS1_3 */
 
@@ -4637,8 +5659,7 @@ void mbedtls_ssl_handshake_free(mbedtls_ssl_context *ssl)
 #endif
 
     /* mbedtls_platform_zeroize MUST be last one in this function */
-    mbedtls_platform_zeroize(handshake,
-                             sizeof(mbedtls_ssl_handshake_params));
+    mbedtls_platform_zeroize(handshake, SSL_HS_BLOCK_SIZE);
 }
 
 void mbedtls_ssl_session_free(mbedtls_ssl_session *session)
@@ -4651,18 +5672,22 @@ void mbedtls_ssl_session_free(mbedtls_ssl_session *session)
     ssl_clear_peer_cert(session);
 #endif
 
+    /* Fields loaded by mbedtls_ssl_session_load_borrowed() point into
+     * the caller's buffer and are not ours to free. */
+    if (!session->borrowed) {
 #if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
 #if defined(MBEDTLS_SSL_PROTO_TLS1_3) && \
-    defined(MBEDTLS_SSL_SERVER_NAME_INDICATION)
-    mbedtls_free(session->hostname);
+        defined(MBEDTLS_SSL_SERVER_NAME_INDICATION)
+        mbedtls_free(session->hostname);
 #endif
-    mbedtls_free(session->ticket);
+        mbedtls_free(session->ticket);
 #endif
 
 #if defined(MBEDTLS_SSL_EARLY_DATA) && defined(MBEDTLS_SSL_ALPN) && \
-    defined(MBEDTLS_SSL_SRV_C)
-    mbedtls_free(session->ticket_alpn);
+        defined(MBEDTLS_SSL_SRV_C)
+        mbedtls_free(session->ticket_alpn);
 #endif
+    }
 
     mbedtls_platform_zeroize(session, sizeof(mbedtls_ssl_session));
 }
@@ -4693,6 +5718,9 @@ void mbedtls_ssl_session_free(mbedtls_ssl_session *session)
 #define SSL_SERIALIZED_CONTEXT_CONFIG_DTLS_BADMAC_LIMIT_BIT     1
 #define SSL_SERIALIZED_CONTEXT_CONFIG_DTLS_ANTI_REPLAY_BIT      2
 #define SSL_SERIALIZED_CONTEXT_CONFIG_ALPN_BIT                  3
+/* Not a configuration option: set for a connection over TLS rather than
+ * DTLS, whose serialized context carries the incoming state as well. */
+#define SSL_SERIALIZED_CONTEXT_STREAM_BIT                       4
 
 #define SSL_SERIALIZED_CONTEXT_CONFIG_BITFLAG   \
     ((uint32_t) (                              \
@@ -4716,6 +5744,21 @@ static const unsigned char ssl_serialized_context_header[] = {
     MBEDTLS_BYTE_0(SSL_SERIALIZED_CONTEXT_CONFIG_BITFLAG),
 };
 
+/*
+ * Version and format identifier of a context, including its transport
+ */
+static void ssl_get_context_header(const mbedtls_ssl_context *ssl,
+                                   unsigned char *header)
+{
+    memcpy(header, ssl_serialized_context_header,
+           sizeof(ssl_serialized_context_header));
+
+    if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_STREAM) {
+        header[sizeof(ssl_serialized_context_header) - 1] |=
+            1u << SSL_SERIALIZED_CONTEXT_STREAM_BIT;
+    }
+}
+
 /*
  * Serialize a full SSL context
  *
@@ -4726,7 +5769,8 @@ static const unsigned char ssl_serialized_context_header[] = {
  *  opaque mbedtls_version[3];   // major, minor, patch
  *  opaque context_format[5];    // version-specific field determining
  *                               // the format of the remaining
- *                               // serialized data.
+ *                               // serialized data. Bit 4 of the
+ *                               // last byte is set for TLS contexts.
  *  Note: When updating the format, remember to keep these
  *        version+format bytes. (We may make their size part of the API.)
  *
@@ -4744,6 +5788,10 @@ static const unsigned char ssl_serialized_context_header[] = {
  *  uint64 cur_out_ctr;         // Record layer: outgoing sequence number
  *  uint16 mtu;                 // DTLS: path mtu (max outgoing fragment size)
  *  uint8 alpn_chosen<0..2^8-1> // ALPN: negotiated application protocol
+ *  // TLS only
+ *  uint64 in_ctr;              // Record layer: incoming sequence number
+ *  uint8 in_left<0..2^16-1>;   // partially received record
+ *  uint8 unread<0..2^16-1>;    // unread application data
  *
  * Note that many fields of the ssl_context or sub-structures are not
  * serialized, as they fall in one of the following categories:
@@ -4786,20 +5834,23 @@ int mbedtls_ssl_context_save(mbedtls_ssl_context *ssl,
         MBEDTLS_SSL_DEBUG_MSG(1, ("Serialised structures aren't ready"));
         return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
     }
-    /* There must be no pending incoming or outgoing data */
-    if (mbedtls_ssl_check_pending(ssl) != 0) {
-        MBEDTLS_SSL_DEBUG_MSG(1, ("There is pending incoming data"));
+    /* There must be no pending incoming or outgoing data, except, over
+     * TLS, unread application data and a partially received record, which
+     * are saved with the context. */
+    if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
+        if (mbedtls_ssl_check_pending(ssl) != 0) {
+            MBEDTLS_SSL_DEBUG_MSG(1, ("There is pending incoming data"));
+            return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+        }
+    } else if (ssl->keep_current_message != 0 ||
+               (ssl->in_hslen > 0 && ssl->in_hslen < ssl->in_msglen)) {
+        MBEDTLS_SSL_DEBUG_MSG(1, ("There is a pending incoming message"));
         return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
     }
     if (ssl->out_left != 0) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("There is pending outgoing data"));
         return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
     }
-    /* Protocol must be DTLS, not TLS */
-    if (ssl->conf->transport != MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
-        MBEDTLS_SSL_DEBUG_MSG(1, ("Only DTLS is supported"));
-        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
-    }
     /* Version must be 1.2 */
     if (ssl->tls_version != MBEDTLS_SSL_VERSION_TLS1_2) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("Only version 1.2 supported"));
@@ -4824,8 +5875,7 @@ int mbedtls_ssl_context_save(mbedtls_ssl_context *ssl,
     used += sizeof(ssl_serialized_context_header);
 
     if (used <= buf_len) {
-        memcpy(p, ssl_serialized_context_header,
-               sizeof(ssl_serialized_context_header));
+        ssl_get_context_header(ssl, p);
         p += sizeof(ssl_serialized_context_header);
     }
 
@@ -4933,6 +5983,35 @@ int mbedtls_ssl_context_save(mbedtls_ssl_context *ssl,
     }
 #endif /* MBEDTLS_SSL_ALPN */
 
+    /*
+     * Incoming state of a TLS connection: the implicit record sequence
+     * number, the bytes of a partially received record and the application
+     * data that was received but not read yet. Over DTLS, the sequence
+     * number is explicit and partial input is discarded.
+     */
+    if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_STREAM) {
+        const size_t unread_len = ssl->in_offt != NULL ? ssl->in_msglen : 0;
+
+        used += MBEDTLS_SSL_SEQUENCE_NUMBER_LEN + 2 + ssl->in_left +
+                2 + unread_len;
+        if (used <= buf_len) {
+            memcpy(p, ssl->in_ctr, MBEDTLS_SSL_SEQUENCE_NUMBER_LEN);
+            p += MBEDTLS_SSL_SEQUENCE_NUMBER_LEN;
+
+            MBEDTLS_PUT_UINT16_BE(ssl->in_left, p, 0);
+            p += 2;
+            memcpy(p, ssl->in_hdr, ssl->in_left);
+            p += ssl->in_left;
+
+            MBEDTLS_PUT_UINT16_BE(unread_len, p, 0);
+            p += 2;
+            if (unread_len != 0) {
+                memcpy(p, ssl->in_offt, unread_len);
+                p += unread_len;
+            }
+        }
+    }
+
     /*
      * Done
      */
@@ -4961,6 +6040,7 @@ static int ssl_context_load(mbedtls_ssl_context *ssl,
     const unsigned char *p = buf;
     const unsigned char * const end = buf + len;
     size_t session_len;
+    unsigned char header[sizeof(ssl_serialized_context_header)];
     int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
 #if defined(MBEDTLS_SSL_PROTO_TLS1_2)
     tls_prf_fn prf_func = NULL;
@@ -4985,7 +6065,6 @@ static int ssl_context_load(mbedtls_ssl_context *ssl,
 #if defined(MBEDTLS_SSL_RENEGOTIATION)
         ssl->conf->disable_renegotiation != MBEDTLS_SSL_RENEGOTIATION_DISABLED ||
 #endif
-        ssl->conf->transport != MBEDTLS_SSL_TRANSPORT_DATAGRAM ||
         ssl->conf->max_tls_version < MBEDTLS_SSL_VERSION_TLS1_2 ||
         ssl->conf->min_tls_version > MBEDTLS_SSL_VERSION_TLS1_2
         ) {
@@ -5001,11 +6080,19 @@ static int ssl_context_load(mbedtls_ssl_context *ssl,
         return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
     }
 
-    if (memcmp(p, ssl_serialized_context_header,
-               sizeof(ssl_serialized_context_header)) != 0) {
+    ssl_get_context_header(ssl, header);
+
+    if (memcmp(p, header, sizeof(header) - 1) != 0 ||
+        ((p[sizeof(header) - 1] ^ header[sizeof(header) - 1]) &
+         ~(1u << SSL_SERIALIZED_CONTEXT_STREAM_BIT)) != 0) {
         return MBEDTLS_ERR_SSL_VERSION_MISMATCH;
     }
-    p += sizeof(ssl_serialized_context_header);
+
+    /* Saved from a connection over the other transport */
+    if (p[sizeof(header) - 1] != header[sizeof(header) - 1]) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    p += sizeof(header);
 
     /*
      * Session
@@ -5178,6 +6265,54 @@ static int ssl_context_load(mbedtls_ssl_context *ssl,
     }
 #endif /* MBEDTLS_SSL_ALPN */
 
+    if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_STREAM) {
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+        const size_t in_buf_len = ssl->in_buf_len;
+#else
+        const size_t in_buf_len = MBEDTLS_SSL_IN_BUFFER_LEN;
+#endif
+        size_t in_left, unread_len;
+
+        if ((size_t) (end - p) < MBEDTLS_SSL_SEQUENCE_NUMBER_LEN + 2) {
+            return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+        }
+
+        memcpy(ssl->in_ctr, p, MBEDTLS_SSL_SEQUENCE_NUMBER_LEN);
+        p += MBEDTLS_SSL_SEQUENCE_NUMBER_LEN;
+
+        in_left = MBEDTLS_GET_UINT16_BE(p, 0);
+        p += 2;
+
+        if ((size_t) (end - p) < in_left + 2 ||
+            in_left > in_buf_len - (size_t) (ssl->in_hdr - ssl->in_buf)) {
+            return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+        }
+
+        memcpy(ssl->in_hdr, p, in_left);
+        ssl->in_left = in_left;
+        p += in_left;
+
+        unread_len = MBEDTLS_GET_UINT16_BE(p, 0);
+        p += 2;
+
+        /* A record is only partially received before it is decrypted, so
+         * there cannot be both unread application data and a partial
+         * record. */
+        if ((size_t) (end - p) < unread_len ||
+            (unread_len != 0 && in_left != 0) ||
+            unread_len > in_buf_len - (size_t) (ssl->in_msg - ssl->in_buf)) {
+            return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+        }
+
+        if (unread_len != 0) {
+            memcpy(ssl->in_msg, p, unread_len);
+            ssl->in_msgtype = MBEDTLS_SSL_MSG_APPLICATION_DATA;
+            ssl->in_msglen = unread_len;
+            ssl->in_offt = ssl->in_msg;
+            p += unread_len;
+        }
+    }
+
     /*
      * Forced fields from top-level ssl_context structure
      *
@@ -5777,6 +6912,16 @@ void mbedtls_ssl_config_free(mbedtls_ssl_config *conf)
     ssl_key_cert_free(conf->key_cert);
 #endif
 
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS) && \
+    defined(MBEDTLS_KEY_EXCHANGE_CERT_REQ_ALLOWED_ENABLED) && \
+    defined(MBEDTLS_SSL_SRV_C)
+    mbedtls_free(conf->dn_list);
+#endif
+
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+    ssl_conf_tables_free(conf);
+#endif
+
     mbedtls_platform_zeroize(conf, sizeof(mbedtls_ssl_config));
 }
 
@@ -5938,6 +7083,10 @@ int mbedtls_ssl_check_curve(const mbedtls_ssl_context *ssl, mbedtls_ecp_group_id
 }
 #endif /* PSA_WANT_KEY_TYPE_ECC_PUBLIC_KEY */
 
+/*
+ * The groups that the ECC code supports, indexed by TLS identifier, with
+ * a tls_id of 0 for the other identifiers.
+ */
 static const struct {
     uint16_t tls_id;
     mbedtls_ecp_group_id ecp_group_id;
@@ -5946,117 +7095,150 @@ static const struct {
 } tls_id_match_table[] =
 {
 #if defined(PSA_WANT_ECC_SECP_R1_521)
-    { 25, MBEDTLS_ECP_DP_SECP521R1, PSA_ECC_FAMILY_SECP_R1, 521 },
+    [25] = { 25, MBEDTLS_ECP_DP_SECP521R1, PSA_ECC_FAMILY_SECP_R1, 521 },
+#endif
+#if defined(PSA_WANT_ECC_BRAINPOOL_P_R1_512)
+    [28] = { 28, MBEDTLS_ECP_DP_BP512R1, PSA_ECC_FAMILY_BRAINPOOL_P_R1, 512 },
+#endif
+#if defined(PSA_WANT_ECC_SECP_R1_384)
+    [24] = { 24, MBEDTLS_ECP_DP_SECP384R1, PSA_ECC_FAMILY_SECP_R1, 384 },
+#endif
+#if defined(PSA_WANT_ECC_BRAINPOOL_P_R1_384)
+    [27] = { 27, MBEDTLS_ECP_DP_BP384R1, PSA_ECC_FAMILY_BRAINPOOL_P_R1, 384 },
+#endif
+#if defined(PSA_WANT_ECC_SECP_R1_256)
+    [23] = { 23, MBEDTLS_ECP_DP_SECP256R1, PSA_ECC_FAMILY_SECP_R1, 256 },
+#endif
+#if defined(PSA_WANT_ECC_SECP_K1_256)
+    [22] = { 22, MBEDTLS_ECP_DP_SECP256K1, PSA_ECC_FAMILY_SECP_K1, 256 },
+#endif
+#if defined(PSA_WANT_ECC_BRAINPOOL_P_R1_256)
+    [26] = { 26, MBEDTLS_ECP_DP_BP256R1, PSA_ECC_FAMILY_BRAINPOOL_P_R1, 256 },
+#endif
+#if defined(PSA_WANT_ECC_SECP_R1_224)
+    [21] = { 21, MBEDTLS_ECP_DP_SECP224R1, PSA_ECC_FAMILY_SECP_R1, 224 },
+#endif
+#if defined(PSA_WANT_ECC_SECP_R1_192)
+    [19] = { 19, MBEDTLS_ECP_DP_SECP192R1, PSA_ECC_FAMILY_SECP_R1, 192 },
+#endif
+#if defined(PSA_WANT_ECC_SECP_K1_192)
+    [18] = { 18, MBEDTLS_ECP_DP_SECP192K1, PSA_ECC_FAMILY_SECP_K1, 192 },
+#endif
+#if defined(PSA_WANT_ECC_MONTGOMERY_255)
+    [29] = { 29, MBEDTLS_ECP_DP_CURVE25519, PSA_ECC_FAMILY_MONTGOMERY, 255 },
+#endif
+#if defined(PSA_WANT_ECC_MONTGOMERY_448)
+    [30] = { 30, MBEDTLS_ECP_DP_CURVE448, PSA_ECC_FAMILY_MONTGOMERY, 448 },
+#endif
+    [0] = { 0, MBEDTLS_ECP_DP_NONE, 0, 0 },
+};
+
+/* The TLS identifiers of the same groups, indexed by ECP group. */
+static const uint16_t tls_id_from_ecp_group_table[] =
+{
+#if defined(PSA_WANT_ECC_SECP_R1_521)
+    [MBEDTLS_ECP_DP_SECP521R1] = 25,
 #endif
 #if defined(PSA_WANT_ECC_BRAINPOOL_P_R1_512)
-    { 28, MBEDTLS_ECP_DP_BP512R1, PSA_ECC_FAMILY_BRAINPOOL_P_R1, 512 },
+    [MBEDTLS_ECP_DP_BP512R1] = 28,
 #endif
 #if defined(PSA_WANT_ECC_SECP_R1_384)
-    { 24, MBEDTLS_ECP_DP_SECP384R1, PSA_ECC_FAMILY_SECP_R1, 384 },
+    [MBEDTLS_ECP_DP_SECP384R1] = 24,
 #endif
 #if defined(PSA_WANT_ECC_BRAINPOOL_P_R1_384)
-    { 27, MBEDTLS_ECP_DP_BP384R1, PSA_ECC_FAMILY_BRAINPOOL_P_R1, 384 },
+    [MBEDTLS_ECP_DP_BP384R1] = 27,
 #endif
 #if defined(PSA_WANT_ECC_SECP_R1_256)
-    { 23, MBEDTLS_ECP_DP_SECP256R1, PSA_ECC_FAMILY_SECP_R1, 256 },
+    [MBEDTLS_ECP_DP_SECP256R1] = 23,
 #endif
 #if defined(PSA_WANT_ECC_SECP_K1_256)
-    { 22, MBEDTLS_ECP_DP_SECP256K1, PSA_ECC_FAMILY_SECP_K1, 256 },
+    [MBEDTLS_ECP_DP_SECP256K1] = 22,
 #endif
 #if defined(PSA_WANT_ECC_BRAINPOOL_P_R1_256)
-    { 26, MBEDTLS_ECP_DP_BP256R1, PSA_ECC_FAMILY_BRAINPOOL_P_R1, 256 },
+    [MBEDTLS_ECP_DP_BP256R1] = 26,
 #endif
 #if defined(PSA_WANT_ECC_SECP_R1_224)
-    { 21, MBEDTLS_ECP_DP_SECP224R1, PSA_ECC_FAMILY_SECP_R1, 224 },
+    [MBEDTLS_ECP_DP_SECP224R1] = 21,
 #endif
 #if defined(PSA_WANT_ECC_SECP_R1_192)
-    { 19, MBEDTLS_ECP_DP_SECP192R1, PSA_ECC_FAMILY_SECP_R1, 192 },
+    [MBEDTLS_ECP_DP_SECP192R1] = 19,
 #endif
 #if defined(PSA_WANT_ECC_SECP_K1_192)
-    { 18, MBEDTLS_ECP_DP_SECP192K1, PSA_ECC_FAMILY_SECP_K1, 192 },
+    [MBEDTLS_ECP_DP_SECP192K1] = 18,
 #endif
 #if defined(PSA_WANT_ECC_MONTGOMERY_255)
-    { 29, MBEDTLS_ECP_DP_CURVE25519, PSA_ECC_FAMILY_MONTGOMERY, 255 },
+    [MBEDTLS_ECP_DP_CURVE25519] = 29,
 #endif
 #if defined(PSA_WANT_ECC_MONTGOMERY_448)
-    { 30, MBEDTLS_ECP_DP_CURVE448, PSA_ECC_FAMILY_MONTGOMERY, 448 },
+    [MBEDTLS_ECP_DP_CURVE448] = 30,
 #endif
-    { 0, MBEDTLS_ECP_DP_NONE, 0, 0 },
+    [MBEDTLS_ECP_DP_NONE] = 0,
 };
 
 int mbedtls_ssl_get_psa_curve_info_from_tls_id(uint16_t tls_id,
                                                psa_key_type_t *type,
                                                size_t *bits)
 {
-    for (int i = 0; tls_id_match_table[i].tls_id != 0; i++) {
-        if (tls_id_match_table[i].tls_id == tls_id) {
-            if (type != NULL) {
-                *type = PSA_KEY_TYPE_ECC_KEY_PAIR(tls_id_match_table[i].psa_family);
-            }
-            if (bits != NULL) {
-                *bits = tls_id_match_table[i].bits;
-            }
-            return PSA_SUCCESS;
-        }
+    if (tls_id >= ARRAY_LENGTH(tls_id_match_table) ||
+        tls_id_match_table[tls_id].tls_id == 0) {
+        return PSA_ERROR_NOT_SUPPORTED;
     }
 
-    return PSA_ERROR_NOT_SUPPORTED;
+    if (type != NULL) {
+        *type = PSA_KEY_TYPE_ECC_KEY_PAIR(tls_id_match_table[tls_id].psa_family);
+    }
+    if (bits != NULL) {
+        *bits = tls_id_match_table[tls_id].bits;
+    }
+
+    return PSA_SUCCESS;
 }
 
 mbedtls_ecp_group_id mbedtls_ssl_get_ecp_group_id_from_tls_id(uint16_t tls_id)
 {
-    for (int i = 0; tls_id_match_table[i].tls_id != 0; i++) {
-        if (tls_id_match_table[i].tls_id == tls_id) {
-            return tls_id_match_table[i].ecp_group_id;
-        }
+    if (tls_id >= ARRAY_LENGTH(tls_id_match_table)) {
+        return MBEDTLS_ECP_DP_NONE;
     }
 
-    return MBEDTLS_ECP_DP_NONE;
+    /* Unsupported identifiers have MBEDTLS_ECP_DP_NONE, which is 0. */
+    return tls_id_match_table[tls_id].ecp_group_id;
 }
 
 uint16_t mbedtls_ssl_get_tls_id_from_ecp_group_id(mbedtls_ecp_group_id grp_id)
 {
-    for (int i = 0; tls_id_match_table[i].ecp_group_id != MBEDTLS_ECP_DP_NONE;
-         i++) {
-        if (tls_id_match_table[i].ecp_group_id == grp_id) {
-            return tls_id_match_table[i].tls_id;
-        }
+    if ((size_t) grp_id >= ARRAY_LENGTH(tls_id_from_ecp_group_table)) {
+        return 0;
     }
 
-    return 0;
+    return tls_id_from_ecp_group_table[grp_id];
 }
 
 #if defined(MBEDTLS_DEBUG_C)
-static const struct {
-    uint16_t tls_id;
-    const char *name;
-} tls_id_curve_name_table[] =
-{
-    { MBEDTLS_SSL_IANA_TLS_GROUP_SECP521R1, "secp521r1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_BP512R1, "brainpoolP512r1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_SECP384R1, "secp384r1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_BP384R1, "brainpoolP384r1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_SECP256R1, "secp256r1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_SECP256K1, "secp256k1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_BP256R1, "brainpoolP256r1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_SECP224R1, "secp224r1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_SECP224K1, "secp224k1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_SECP192R1, "secp192r1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_SECP192K1, "secp192k1" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_X25519, "x25519" },
-    { MBEDTLS_SSL_IANA_TLS_GROUP_X448, "x448" },
-    { 0, NULL },
+/* Names of the ECC groups, indexed by TLS identifier. */
+static const char *const tls_id_curve_name_table[] =
+{
+    [MBEDTLS_SSL_IANA_TLS_GROUP_SECP521R1] = "secp521r1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_BP512R1] = "brainpoolP512r1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_SECP384R1] = "secp384r1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_BP384R1] = "brainpoolP384r1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_SECP256R1] = "secp256r1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_SECP256K1] = "secp256k1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_BP256R1] = "brainpoolP256r1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_SECP224R1] = "secp224r1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_SECP224K1] = "secp224k1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_SECP192R1] = "secp192r1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_SECP192K1] = "secp192k1",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_X25519] = "x25519",
+    [MBEDTLS_SSL_IANA_TLS_GROUP_X448] = "x448",
 };
 
 const char *mbedtls_ssl_get_curve_name_from_tls_id(uint16_t tls_id)
 {
-    for (int i = 0; tls_id_curve_name_table[i].tls_id != 0; i++) {
-        if (tls_id_curve_name_table[i].tls_id == tls_id) {
-            return tls_id_curve_name_table[i].name;
-        }
+    if (tls_id >= ARRAY_LENGTH(tls_id_curve_name_table)) {
+        return NULL;
     }
 
-    return NULL;
+    return tls_id_curve_name_table[tls_id];
 }
 #endif
 
@@ -6873,6 +8055,24 @@ int mbedtls_ssl_write_certificate(mbedtls_ssl_context *ssl)
     i = 7;
     crt = mbedtls_ssl_own_cert(ssl);
 
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS)
+    if (crt != NULL && mbedtls_ssl_own_key_cert(ssl)->tls12_list != NULL) {
+        const mbedtls_ssl_key_cert *key_cert = mbedtls_ssl_own_key_cert(ssl);
+
+        n = key_cert->tls12_list_len;
+        if (n > MBEDTLS_SSL_OUT_CONTENT_LEN - i) {
+            MBEDTLS_SSL_DEBUG_MSG(1, ("certificate too large, %" MBEDTLS_PRINTF_SIZET
+                                      " > %" MBEDTLS_PRINTF_SIZET,
+                                      i + n, (size_t) MBEDTLS_SSL_OUT_CONTENT_LEN));
+            return MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+        }
+
+        memcpy(ssl->out_msg + i, key_cert->tls12_list, n);
+        i += n;
+        crt = NULL;
+    }
+#endif /* MBEDTLS_SSL_PREENCODE_CERTS */
+
     while (crt != NULL) {
         n = crt->raw.len;
         if (n > MBEDTLS_SSL_OUT_CONTENT_LEN - 3 - i) {
@@ -7015,6 +8215,14 @@ static int ssl_parse_certificate_chain(mbedtls_ssl_context *ssl,
         return MBEDTLS_ERR_SSL_DECODE_ERROR;
     }
 
+    /* The parsed chain keeps a copy of each certificate. */
+    ret = mbedtls_ssl_check_memory(ssl, n);
+    if (ret != 0) {
+        mbedtls_ssl_send_alert_message(ssl, MBEDTLS_SSL_ALERT_LEVEL_FATAL,
+                                       MBEDTLS_SSL_ALERT_MSG_INTERNAL_ERROR);
+        return ret;
+    }
+
     /* Make &ssl->in_msg[i] point to the beginning of the CRT chain. */
     i += 3;
 
@@ -7270,7 +8478,15 @@ int mbedtls_ssl_parse_certificate(mbedtls_ssl_context *ssl)
 #endif /* MBEDTLS_SSL_SRV_C */
 
     /* Clear existing peer CRT structure in case we tried to
-     * reuse a session but it failed, and allocate a new one. */
+     * reuse a session but it failed, and allocate a new one. The other
+     * fields of a session we tried to reuse may still be borrowed. */
+    ret = mbedtls_ssl_session_detach(ssl->session_negotiate);
+    if (ret != 0) {
+        mbedtls_ssl_send_alert_message(ssl,
+                                       MBEDTLS_SSL_ALERT_LEVEL_FATAL,
+                                       MBEDTLS_SSL_ALERT_MSG_INTERNAL_ERROR);
+        goto exit;
+    }
     ssl_clear_peer_cert(ssl->session_negotiate);
 
     chain = mbedtls_calloc(1, sizeof(mbedtls_x509_crt));
@@ -8701,6 +9917,14 @@ int mbedtls_ssl_session_set_hostname(mbedtls_ssl_session *session,
         }
     }
 
+    /* A session borrows all its variable-length fields or none of them */
+    if (session->borrowed) {
+        int ret = mbedtls_ssl_session_detach(session);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
     /* Now it's clear that we will overwrite the old hostname,
      * so we can free it safely */
     if (session->hostname != NULL) {
@@ -8742,6 +9966,13 @@ int mbedtls_ssl_session_set_ticket_alpn(mbedtls_ssl_session *session,
         }
     }
 
+    if (session->borrowed) {
+        int ret = mbedtls_ssl_session_detach(session);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
     if (session->ticket_alpn != NULL) {
         mbedtls_zeroize_and_free(session->ticket_alpn,
                                  strlen(session->ticket_alpn));
@@ -8844,6 +10075,55 @@ int mbedtls_ssl_check_cert_usage(const mbedtls_x509_crt *cert,
     return ret;
 }
 
+#if defined(MBEDTLS_SSL_VERIFY_CACHE_C)
+/*
+ * Accept a chain from the verify cache of the configuration. The checks
+ * that depend on the current time or on the expected hostname are run
+ * again; if one fails, the chain goes through a full verification, which
+ * reports all the problems.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_verify_cache_lookup(mbedtls_ssl_context *ssl,
+                                   const mbedtls_x509_crt *chain,
+                                   const mbedtls_x509_crt *ca_chain,
+                                   const mbedtls_x509_crl *ca_crl)
+{
+    const mbedtls_x509_crt *crt;
+    uint32_t flags = 0;
+
+    if (ssl->conf->verify_cache == NULL) {
+        return MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    }
+
+    for (crt = chain; crt != NULL; crt = crt->next) {
+        if (mbedtls_x509_time_is_past(&crt->valid_to)) {
+            flags |= MBEDTLS_X509_BADCERT_EXPIRED;
+        }
+        if (mbedtls_x509_time_is_future(&crt->valid_from)) {
+            flags |= MBEDTLS_X509_BADCERT_FUTURE;
+        }
+    }
+
+    if (ssl->hostname != NULL) {
+        mbedtls_x509_crt_verify_name(chain, ssl->hostname, &flags);
+    }
+
+    if (flags != 0) {
+        return MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    }
+
+    if (mbedtls_ssl_verify_cache_get(ssl->conf->verify_cache, chain,
+                                     ca_chain, ca_crl,
+                                     ssl->conf->cert_profile) != 0) {
+        return MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    }
+
+    ssl->session_negotiate->verify_result = 0;
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_VERIFY_CACHE_C */
+
 int mbedtls_ssl_verify_certificate(mbedtls_ssl_context *ssl,
                                    int authmode,
                                    mbedtls_x509_crt *chain,
@@ -8905,13 +10185,31 @@ int mbedtls_ssl_verify_certificate(mbedtls_ssl_context *ssl,
             have_ca_chain_or_callback = 1;
         }
 
-        ret = mbedtls_x509_crt_verify_restartable(
-            chain,
-            ca_chain, ca_crl,
-            ssl->conf->cert_profile,
-            ssl->hostname,
-            &ssl->session_negotiate->verify_result,
-            f_vrfy, p_vrfy, rs_ctx);
+#if defined(MBEDTLS_SSL_VERIFY_CACHE_C)
+        if (f_vrfy == NULL && ca_chain != NULL &&
+            ssl_verify_cache_lookup(ssl, chain, ca_chain, ca_crl) == 0) {
+            MBEDTLS_SSL_DEBUG_MSG(3, ("peer certificate chain found in verify cache"));
+            ret = 0;
+        } else
+#endif /* MBEDTLS_SSL_VERIFY_CACHE_C */
+        {
+            ret = mbedtls_x509_crt_verify_restartable(
+                chain,
+                ca_chain, ca_crl,
+                ssl->conf->cert_profile,
+                ssl->hostname,
+                &ssl->session_negotiate->verify_result,
+                f_vrfy, p_vrfy, rs_ctx);
+
+#if defined(MBEDTLS_SSL_VERIFY_CACHE_C)
+            if (ret == 0 && f_vrfy == NULL && ssl->conf->verify_cache != NULL) {
+                /* Not remembering the chain only costs a later verification. */
+                (void) mbedtls_ssl_verify_cache_set(ssl->conf->verify_cache, chain,
+                                                    ca_chain, ca_crl,
+                                                    ssl->conf->cert_profile);
+            }
+#endif /* MBEDTLS_SSL_VERIFY_CACHE_C */
+        }
     }
 
     if (ret != 0) {
@@ -165,7 +165,8 @@ static int ssl_write_ecjpake_kkpp_ext(mbedtls_ssl_context *ssl,
             return ret;
         }
 
-        ssl->handshake->ecjpake_cache = mbedtls_calloc(1, kkpp_len);
+        ssl->handshake->ecjpake_cache = mbedtls_ssl_hs_calloc(ssl->handshake,
+                                                              1, kkpp_len);
         if (ssl->handshake->ecjpake_cache == NULL) {
             MBEDTLS_SSL_DEBUG_MSG(1, ("allocation failed"));
             return MBEDTLS_ERR_SSL_ALLOC_FAILED;
@@ -841,7 +842,7 @@ static int ssl_parse_ecjpake_kkpp(mbedtls_ssl_context *ssl,
     }
 
     /* If we got here, we no longer need our cached extension */
-    mbedtls_free(ssl->handshake->ecjpake_cache);
+    mbedtls_ssl_hs_free(ssl->handshake, ssl->handshake->ecjpake_cache);
     ssl->handshake->ecjpake_cache = NULL;
     ssl->handshake->ecjpake_cache_len = 0;
 
@@ -1106,9 +1107,10 @@ static int ssl_parse_hello_verify_request(mbedtls_ssl_context *ssl)
     }
     MBEDTLS_SSL_DEBUG_BUF(3, "cookie", p, cookie_len);
 
-    mbedtls_free(ssl->handshake->cookie);
+    mbedtls_ssl_hs_free(ssl->handshake, ssl->handshake->cookie);
 
-    ssl->handshake->cookie = mbedtls_calloc(1, cookie_len);
+    ssl->handshake->cookie = mbedtls_ssl_hs_calloc(ssl->handshake, 1,
+                                                   cookie_len);
     if (ssl->handshake->cookie  == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("alloc failed (%d bytes)", cookie_len));
         return MBEDTLS_ERR_SSL_ALLOC_FAILED;
@@ -1193,7 +1195,7 @@ static int ssl_parse_server_hello(mbedtls_ssl_context *ssl)
             return ssl_parse_hello_verify_request(ssl);
         } else {
             /* We made it through the verification process */
-            mbedtls_free(ssl->handshake->cookie);
+            mbedtls_ssl_hs_free(ssl->handshake, ssl->handshake->cookie);
             ssl->handshake->cookie = NULL;
             ssl->handshake->cookie_len = 0;
         }
@@ -1940,6 +1942,12 @@ static int ssl_parse_server_key_exchange(mbedtls_ssl_context *ssl)
         goto start_processing;
     }
 #endif
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+    /* Resuming an asynchronous signature verification */
+    if (mbedtls_ssl_async_job_is_pending(ssl, MBEDTLS_SSL_ASYNC_JOB_VERIFY)) {
+        goto start_processing;
+    }
+#endif
 
     if ((ret = mbedtls_ssl_read_record(ssl, 1)) != 0) {
         MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_read_record", ret);
@@ -1981,7 +1989,10 @@ static int ssl_parse_server_key_exchange(mbedtls_ssl_context *ssl)
     if (ssl->handshake->ecrs_enabled) {
         ssl->handshake->ecrs_state = ssl_ecrs_ske_start_processing;
     }
+#endif
 
+#if defined(MBEDTLS_SSL_ECP_RESTARTABLE_ENABLED) || \
+    defined(MBEDTLS_SSL_ASYNC_CRYPTO)
 start_processing:
 #endif
     p   = ssl->in_msg + mbedtls_ssl_hs_hdr_len(ssl);
@@ -2195,12 +2206,28 @@ start_processing:
                 return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
             }
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+            ret = mbedtls_ssl_async_verify(ssl, pk_alg, &rsassa_pss_options,
+                                           peer_pk,
+                                           md_alg, hash, hashlen,
+                                           p, sig_len);
+#else
             ret = mbedtls_pk_verify_ext(pk_alg, &rsassa_pss_options,
                                         peer_pk,
                                         md_alg, hash, hashlen,
                                         p, sig_len);
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
         } else
 #endif /* MBEDTLS_X509_RSASSA_PSS_SUPPORT */
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+        /* Restartable ECC takes precedence: it already lets the
+         * application interleave the verification with other work. */
+        if (rs_ctx == NULL) {
+            ret = mbedtls_ssl_async_verify(ssl, pk_alg, NULL, peer_pk,
+                                           md_alg, hash, hashlen,
+                                           p, sig_len);
+        } else
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
         ret = mbedtls_pk_verify_restartable(peer_pk,
                                             md_alg, hash, hashlen, p, sig_len, rs_ctx);
 
@@ -2208,6 +2235,11 @@ start_processing:
             int send_alert_msg = 1;
 #if defined(MBEDTLS_SSL_ECP_RESTARTABLE_ENABLED)
             send_alert_msg = (ret != MBEDTLS_ERR_ECP_IN_PROGRESS);
+#endif
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+            if (ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
+                return ret;
+            }
 #endif
             if (send_alert_msg) {
                 mbedtls_ssl_send_alert_message(
@@ -2529,8 +2561,8 @@ static int ssl_write_client_key_exchange(mbedtls_ssl_context *ssl)
         psa_set_key_bits(&key_attributes, handshake->xxdh_psa_bits);
 
         /* Generate ECDH private key. */
-        status = psa_generate_key(&key_attributes,
-                                  &handshake->xxdh_psa_privkey);
+        status = mbedtls_ssl_generate_ephemeral_key(ssl, &key_attributes,
+                                                    &handshake->xxdh_psa_privkey);
         if (status != PSA_SUCCESS) {
             return MBEDTLS_ERR_SSL_HW_ACCEL_FAILED;
         }
@@ -2639,8 +2671,8 @@ static int ssl_write_client_key_exchange(mbedtls_ssl_context *ssl)
         psa_set_key_bits(&key_attributes, handshake->xxdh_psa_bits);
 
         /* Generate ECDH private key. */
-        status = psa_generate_key(&key_attributes,
-                                  &handshake->xxdh_psa_privkey);
+        status = mbedtls_ssl_generate_ephemeral_key(ssl, &key_attributes,
+                                                    &handshake->xxdh_psa_privkey);
         if (status != PSA_SUCCESS) {
             return PSA_TO_MBEDTLS_ERR(status);
         }
@@ -3030,12 +3062,20 @@ static int ssl_parse_new_session_ticket(mbedtls_ssl_context *ssl)
         ssl->session->ticket_len = 0;
     }
 
+    /* The new ticket is stored in the session, which must own its fields
+     * from now on. */
+    if ((ret = mbedtls_ssl_session_detach(ssl->session_negotiate)) != 0) {
+        mbedtls_ssl_send_alert_message(ssl, MBEDTLS_SSL_ALERT_LEVEL_FATAL,
+                                       MBEDTLS_SSL_ALERT_MSG_INTERNAL_ERROR);
+        return ret;
+    }
+
     mbedtls_zeroize_and_free(ssl->session_negotiate->ticket,
                              ssl->session_negotiate->ticket_len);
     ssl->session_negotiate->ticket = NULL;
     ssl->session_negotiate->ticket_len = 0;
 
-    if ((ticket = mbedtls_calloc(1, ticket_len)) == NULL) {
+    if ((ticket = mbedtls_ssl_calloc(ssl, 1, ticket_len)) == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("ticket alloc failed"));
         mbedtls_ssl_send_alert_message(ssl, MBEDTLS_SSL_ALERT_LEVEL_FATAL,
                                        MBEDTLS_SSL_ALERT_MSG_INTERNAL_ERROR);
@@ -3169,6 +3209,12 @@ int mbedtls_ssl_handshake_client_step(mbedtls_ssl_context *ssl)
             break;
 
         case MBEDTLS_SSL_HANDSHAKE_WRAPUP:
+            /* The session is stored from here on, it must not borrow from
+             * the buffer passed to mbedtls_ssl_set_session() anymore. */
+            ret = mbedtls_ssl_session_detach(ssl->session_negotiate);
+            if (ret != 0) {
+                break;
+            }
             mbedtls_ssl_handshake_wrapup(ssl);
             break;
 
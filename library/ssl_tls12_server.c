@@ -52,7 +52,7 @@ int mbedtls_ssl_set_client_transport_id(mbedtls_ssl_context *ssl,
 
     mbedtls_free(ssl->cli_id);
 
-    if ((ssl->cli_id = mbedtls_calloc(1, ilen)) == NULL) {
+    if ((ssl->cli_id = mbedtls_ssl_calloc(ssl, 1, ilen)) == NULL) {
         return MBEDTLS_ERR_SSL_ALLOC_FAILED;
     }
 
@@ -211,8 +211,8 @@ static int ssl_parse_supported_groups_ext(mbedtls_ssl_context *ssl,
         our_size = MBEDTLS_ECP_DP_MAX;
     }
 
-    if ((curves_tls_id = mbedtls_calloc(our_size,
-                                        sizeof(*curves_tls_id))) == NULL) {
+    if ((curves_tls_id = mbedtls_ssl_hs_calloc(ssl->handshake, our_size,
+                                               sizeof(*curves_tls_id))) == NULL) {
         mbedtls_ssl_send_alert_message(ssl, MBEDTLS_SSL_ALERT_LEVEL_FATAL,
                                        MBEDTLS_SSL_ALERT_MSG_INTERNAL_ERROR);
         return MBEDTLS_ERR_SSL_ALLOC_FAILED;
@@ -444,6 +444,7 @@ static int ssl_parse_session_ticket_ext(mbedtls_ssl_context *ssl,
 {
     int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
     mbedtls_ssl_session session;
+    unsigned char *ticket_buf;
 
     mbedtls_ssl_session_init(&session);
 
@@ -468,12 +469,25 @@ static int ssl_parse_session_ticket_ext(mbedtls_ssl_context *ssl,
     }
 #endif /* MBEDTLS_SSL_RENEGOTIATION */
 
+    /* Decrypt the ticket out of the message buffer, which does not outlive
+     * the ClientHello: the session may be loaded without copying it out of
+     * the decrypted ticket, see mbedtls_ssl_session_load_borrowed(). */
+    if ((ret = mbedtls_ssl_check_memory(ssl, len)) != 0) {
+        return ret;
+    }
+    if ((ticket_buf = mbedtls_ssl_hs_calloc(ssl->handshake, 1, len)) == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+    memcpy(ticket_buf, buf, len);
+
     /*
      * Failures are ok: just ignore the ticket and proceed.
      */
     if ((ret = ssl->conf->f_ticket_parse(ssl->conf->p_ticket, &session,
-                                         buf, len)) != 0) {
+                                         ticket_buf, len)) != 0) {
         mbedtls_ssl_session_free(&session);
+        mbedtls_platform_zeroize(ticket_buf, len);
+        mbedtls_ssl_hs_free(ssl->handshake, ticket_buf);
 
         if (ret == MBEDTLS_ERR_SSL_INVALID_MAC) {
             MBEDTLS_SSL_DEBUG_MSG(3, ("ticket is not authentic"));
@@ -486,6 +500,16 @@ static int ssl_parse_session_ticket_ext(mbedtls_ssl_context *ssl,
         return 0;
     }
 
+    /* The session may borrow from the decrypted ticket: keep it until the
+     * end of the handshake. The session is detached before it is stored. */
+    if (ssl->handshake->ticket_buf != NULL) {
+        mbedtls_platform_zeroize(ssl->handshake->ticket_buf,
+                                 ssl->handshake->ticket_buf_len);
+        mbedtls_ssl_hs_free(ssl->handshake, ssl->handshake->ticket_buf);
+    }
+    ssl->handshake->ticket_buf = ticket_buf;
+    ssl->handshake->ticket_buf_len = len;
+
     /*
      * Keep the session ID sent by the client, since we MUST send it back to
      * inform them we're accepting the ticket  (RFC 5077 section 3.4)
@@ -858,8 +882,14 @@ static int ssl_parse_client_hello(mbedtls_ssl_context *ssl)
     int renegotiation_info_seen = 0;
 #endif
     int handshake_failure = 0;
-    const int *ciphersuites;
     const mbedtls_ssl_ciphersuite_t *ciphersuite_info;
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+    const mbedtls_ssl_ciphersuite_t *suite_info, *candidate;
+    size_t pref, best_pref;
+    int last_matched = 0;
+#else
+    const int *ciphersuites;
+#endif
 
     /* If there is no signature-algorithm extension present,
      * we need to fall back to the default values for allowed
@@ -1554,6 +1584,52 @@ read_record_header:
      * or certificate from server certificate selection callback.)
      */
     got_common_suite = 0;
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+    ciphersuite_info = NULL;
+    best_pref = SIZE_MAX;
+
+    /*
+     * Look up each ciphersuite of the client in our list. In server order,
+     * keep looking for a more preferred one, and try a ciphersuite only if
+     * it would be preferred, so that the last successful match is the one
+     * selected (ssl_ciphersuite_match() also picks the certificate).
+     */
+    for (j = 0, p = buf + ciph_offset + 2; j < ciph_len; j += 2, p += 2) {
+        suite_info = mbedtls_ssl_conf_get_ciphersuite(
+            ssl->conf, MBEDTLS_GET_UINT16_BE(p, 0), &pref);
+        if (suite_info == NULL || pref >= best_pref) {
+            continue;
+        }
+
+        got_common_suite = 1;
+        candidate = NULL;
+
+        if ((ret = ssl_ciphersuite_match(ssl, suite_info->id,
+                                         &candidate)) != 0) {
+            return ret;
+        }
+
+        last_matched = candidate != NULL;
+        if (candidate != NULL) {
+            ciphersuite_info = candidate;
+            if (ssl->conf->respect_cli_pref ==
+                MBEDTLS_SSL_SRV_CIPHERSUITE_ORDER_CLIENT || pref == 0) {
+                break;
+            }
+            best_pref = pref;
+        }
+    }
+
+    if (ciphersuite_info != NULL) {
+        /* A later attempt that failed may have picked another certificate. */
+        if (!last_matched &&
+            (ret = ssl_ciphersuite_match(ssl, ciphersuite_info->id,
+                                         &ciphersuite_info)) != 0) {
+            return ret;
+        }
+        goto have_ciphersuite;
+    }
+#else /* MBEDTLS_SSL_CONF_FINALIZE */
     ciphersuites = ssl->conf->ciphersuite_list;
     ciphersuite_info = NULL;
 
@@ -1596,6 +1672,7 @@ read_record_header:
             }
         }
     }
+#endif /* MBEDTLS_SSL_CONF_FINALIZE */
 
     if (got_common_suite) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("got ciphersuites in common, "
@@ -1613,7 +1690,11 @@ read_record_header:
 have_ciphersuite:
     MBEDTLS_SSL_DEBUG_MSG(2, ("selected ciphersuite: %s", ciphersuite_info->name));
 
+#if defined(MBEDTLS_SSL_CONF_FINALIZE)
+    ssl->session_negotiate->ciphersuite = ciphersuite_info->id;
+#else
     ssl->session_negotiate->ciphersuite = ciphersuites[i];
+#endif
     ssl->handshake->ciphersuite_info = ciphersuite_info;
 
     ssl->state++;
@@ -2497,6 +2578,16 @@ static int ssl_write_certificate_request(mbedtls_ssl_context *ssl)
 #endif
         crt = ssl->conf->ca_chain;
 
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS)
+        if (crt != NULL && crt == ssl->conf->dn_list_src &&
+            end >= p && (size_t) (end - p) >= ssl->conf->dn_list_len) {
+            memcpy(p, ssl->conf->dn_list, ssl->conf->dn_list_len);
+            p += ssl->conf->dn_list_len;
+            total_dn_size = (uint16_t) ssl->conf->dn_list_len;
+            crt = NULL;
+        }
+#endif /* MBEDTLS_SSL_PREENCODE_CERTS */
+
         while (crt != NULL && crt->version != 0) {
             /* It follows from RFC 5280 A.1 that this length
              * can be represented in at most 11 bits. */
@@ -2885,11 +2976,11 @@ curve_matching_done:
         p += 2;
 
         /* Generate ECDH private key. */
-        status = psa_generate_key(&key_attributes,
-                                  &handshake->xxdh_psa_privkey);
+        status = mbedtls_ssl_generate_ephemeral_key(ssl, &key_attributes,
+                                                    &handshake->xxdh_psa_privkey);
         if (status != PSA_SUCCESS) {
             ret = PSA_TO_MBEDTLS_ERR(status);
-            MBEDTLS_SSL_DEBUG_RET(1, "psa_generate_key", ret);
+            MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_generate_ephemeral_key", ret);
             return ret;
         }
 
@@ -4034,6 +4125,12 @@ int mbedtls_ssl_handshake_server_step(mbedtls_ssl_context *ssl)
             break;
 
         case MBEDTLS_SSL_HANDSHAKE_WRAPUP:
+            /* The session is stored from here on, it must not borrow from
+             * the handshake anymore. */
+            ret = mbedtls_ssl_session_detach(ssl->session_negotiate);
+            if (ret != 0) {
+                break;
+            }
             mbedtls_ssl_handshake_wrapup(ssl);
             break;
 
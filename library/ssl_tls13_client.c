@@ -208,21 +208,18 @@ static int ssl_tls13_reset_key_share(mbedtls_ssl_context *ssl)
  * Functions for writing key_share extension.
  */
 #if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED)
+#if defined(PSA_WANT_ALG_ECDH) || defined(PSA_WANT_ALG_FFDH)
+/* Pick the first group of group_list compatible with TLS 1.3, restricted to
+ * wanted if it is not 0. */
 MBEDTLS_CHECK_RETURN_CRITICAL
-static int ssl_tls13_get_default_group_id(mbedtls_ssl_context *ssl,
-                                          uint16_t *group_id)
+static int ssl_tls13_find_group_id(const uint16_t *group_list,
+                                   uint16_t wanted,
+                                   uint16_t *group_id)
 {
-    int ret = MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE;
-
-
-#if defined(PSA_WANT_ALG_ECDH) || defined(PSA_WANT_ALG_FFDH)
-    const uint16_t *group_list = ssl->conf->group_list;
-    /* Pick first available ECDHE group compatible with TLS 1.3 */
-    if (group_list == NULL) {
-        return MBEDTLS_ERR_SSL_BAD_CONFIG;
-    }
-
     for (; *group_list != 0; group_list++) {
+        if (wanted != 0 && *group_list != wanted) {
+            continue;
+        }
 #if defined(PSA_WANT_ALG_ECDH)
         if ((mbedtls_ssl_get_psa_curve_info_from_tls_id(
                  *group_list, NULL, NULL) == PSA_SUCCESS) &&
@@ -238,12 +235,44 @@ static int ssl_tls13_get_default_group_id(mbedtls_ssl_context *ssl,
         }
 #endif
     }
+
+    return MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE;
+}
+#endif /* PSA_WANT_ALG_ECDH || PSA_WANT_ALG_FFDH */
+
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_tls13_get_default_group_id(mbedtls_ssl_context *ssl,
+                                          uint16_t *group_id)
+{
+#if defined(PSA_WANT_ALG_ECDH) || defined(PSA_WANT_ALG_FFDH)
+    const uint16_t *group_list = ssl->conf->group_list;
+    if (group_list == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_CONFIG;
+    }
+
+#if defined(MBEDTLS_SSL_GROUP_CACHE_C)
+    /* Start with the group this server asked for last time, if we still
+     * allow it. */
+    if (ssl->conf->group_cache != NULL && ssl->hostname != NULL) {
+        uint16_t predicted = mbedtls_ssl_group_cache_get(ssl->conf->group_cache,
+                                                         ssl->hostname);
+        if (predicted != 0 &&
+            ssl_tls13_find_group_id(group_list, predicted, group_id) == 0) {
+            MBEDTLS_SSL_DEBUG_MSG(3, ("predicted key share group: %s",
+                                      mbedtls_ssl_named_group_to_str(predicted)));
+            return 0;
+        }
+    }
+#endif /* MBEDTLS_SSL_GROUP_CACHE_C */
+
+    /* Pick first available ECDHE group compatible with TLS 1.3 */
+    return ssl_tls13_find_group_id(group_list, 0, group_id);
 #else
     ((void) ssl);
     ((void) group_id);
-#endif /* PSA_WANT_ALG_ECDH || PSA_WANT_ALG_FFDH */
 
-    return ret;
+    return MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE;
+#endif /* PSA_WANT_ALG_ECDH || PSA_WANT_ALG_FFDH */
 }
 
 /*
@@ -498,6 +527,16 @@ static int ssl_tls13_parse_key_share_ext(mbedtls_ssl_context *ssl,
         if (ret != 0) {
             return ret;
         }
+
+#if defined(MBEDTLS_SSL_GROUP_CACHE_C)
+        /* The server asked for this group with a HelloRetryRequest:
+         * offer it first next time. */
+        if (ssl->handshake->hello_retry_request_flag &&
+            ssl->conf->group_cache != NULL && ssl->hostname != NULL) {
+            mbedtls_ssl_group_cache_set(ssl->conf->group_cache,
+                                        ssl->hostname, group);
+        }
+#endif /* MBEDTLS_SSL_GROUP_CACHE_C */
     } else
 #endif /* MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED */
     if (0 /* other KEMs? */) {
@@ -542,9 +581,9 @@ static int ssl_tls13_parse_cookie_ext(mbedtls_ssl_context *ssl,
     MBEDTLS_SSL_CHK_BUF_READ_PTR(p, end, cookie_len);
     MBEDTLS_SSL_DEBUG_BUF(3, "cookie extension", p, cookie_len);
 
-    mbedtls_free(handshake->cookie);
+    mbedtls_ssl_hs_free(handshake, handshake->cookie);
     handshake->cookie_len = 0;
-    handshake->cookie = mbedtls_calloc(1, cookie_len);
+    handshake->cookie = mbedtls_ssl_hs_calloc(handshake, 1, cookie_len);
     if (handshake->cookie == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1,
                               ("alloc failed ( %ud bytes )",
@@ -1169,6 +1208,15 @@ int mbedtls_ssl_tls13_write_client_hello_exts(mbedtls_ssl_context *ssl,
     p += ext_len;
 #endif
 
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+    ret = mbedtls_ssl_tls13_write_compress_certificate_ext(
+        ssl, p, end, &ext_len);
+    if (ret != 0) {
+        return ret;
+    }
+    p += ext_len;
+#endif
+
 #if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED)
     if (mbedtls_ssl_conf_tls13_is_some_ephemeral_enabled(ssl)) {
         ret = ssl_tls13_write_key_share_ext(ssl, p, end, &ext_len);
@@ -1300,8 +1348,11 @@ int mbedtls_ssl_tls13_finalize_client_hello(mbedtls_ssl_context *ssl)
 #else
         MBEDTLS_SSL_DEBUG_MSG(
             1, ("Switch to early data keys for outbound traffic"));
-        mbedtls_ssl_set_outbound_transform(
+        ret = mbedtls_ssl_set_outbound_transform(
             ssl, ssl->handshake->transform_earlydata);
+        if (ret != 0) {
+            return ret;
+        }
         ssl->early_data_state = MBEDTLS_SSL_EARLY_DATA_STATE_CAN_WRITE;
 #endif
     }
@@ -1945,7 +1996,7 @@ static int ssl_tls13_postprocess_server_hello(mbedtls_ssl_context *ssl)
     ssl->session_in = ssl->session_negotiate;
 
 cleanup:
-    if (ret != 0) {
+    if (ret != 0 && ret != MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
         MBEDTLS_SSL_PEND_FATAL_ALERT(
             MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE,
             MBEDTLS_ERR_SSL_HANDSHAKE_FAILURE);
@@ -1997,6 +2048,15 @@ static int ssl_tls13_process_server_hello(mbedtls_ssl_context *ssl)
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("=> %s", __func__));
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+    /* Resuming an asynchronous key agreement: the ServerHello has already
+     * been parsed and added to the transcript. */
+    if (mbedtls_ssl_async_job_is_pending(ssl,
+                                         MBEDTLS_SSL_ASYNC_JOB_KEY_AGREEMENT)) {
+        goto postprocess;
+    }
+#endif
+
     MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_tls13_fetch_handshake_msg(
                              ssl, MBEDTLS_SSL_HS_SERVER_HELLO, &buf, &buf_len));
 
@@ -2035,6 +2095,9 @@ static int ssl_tls13_process_server_hello(mbedtls_ssl_context *ssl)
         mbedtls_ssl_handshake_set_state(ssl, MBEDTLS_SSL_CLIENT_HELLO);
 #endif /* MBEDTLS_SSL_TLS1_3_COMPATIBILITY_MODE */
     } else {
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+postprocess:
+#endif
         MBEDTLS_SSL_PROC_CHK(ssl_tls13_postprocess_server_hello(ssl));
         mbedtls_ssl_handshake_set_state(ssl, MBEDTLS_SSL_ENCRYPTED_EXTENSIONS);
     }
@@ -2414,7 +2477,8 @@ static int ssl_tls13_parse_certificate_request(mbedtls_ssl_context *ssl,
                               p, certificate_request_context_len);
 
         handshake->certificate_request_context =
-            mbedtls_calloc(1, certificate_request_context_len);
+            mbedtls_ssl_hs_calloc(handshake, 1,
+                                  certificate_request_context_len);
         if (handshake->certificate_request_context == NULL) {
             MBEDTLS_SSL_DEBUG_MSG(1, ("buffer too small"));
             return MBEDTLS_ERR_SSL_ALLOC_FAILED;
@@ -2629,10 +2693,15 @@ MBEDTLS_CHECK_RETURN_CRITICAL
 static int ssl_tls13_write_client_certificate(mbedtls_ssl_context *ssl)
 {
     int non_empty_certificate_msg = 0;
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
 
     MBEDTLS_SSL_DEBUG_MSG(1,
                           ("Switch to handshake traffic keys for outbound traffic"));
-    mbedtls_ssl_set_outbound_transform(ssl, ssl->handshake->transform_handshake);
+    ret = mbedtls_ssl_set_outbound_transform(ssl,
+                                             ssl->handshake->transform_handshake);
+    if (ret != 0) {
+        return ret;
+    }
 
 #if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED)
     if (ssl->handshake->client_auth) {
@@ -2707,6 +2776,13 @@ static int ssl_tls13_write_client_finished(mbedtls_ssl_context *ssl)
 MBEDTLS_CHECK_RETURN_CRITICAL
 static int ssl_tls13_flush_buffers(mbedtls_ssl_context *ssl)
 {
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    int ret = mbedtls_ssl_write_coalesced_handshake(ssl);
+    if (ret != 0) {
+        return ret;
+    }
+#endif
+
     MBEDTLS_SSL_DEBUG_MSG(2, ("handshake: done"));
     mbedtls_ssl_handshake_set_state(ssl, MBEDTLS_SSL_HANDSHAKE_WRAPUP);
     return 0;
@@ -2718,8 +2794,10 @@ static int ssl_tls13_flush_buffers(mbedtls_ssl_context *ssl)
 MBEDTLS_CHECK_RETURN_CRITICAL
 static int ssl_tls13_handshake_wrapup(mbedtls_ssl_context *ssl)
 {
-
-    mbedtls_ssl_tls13_handshake_wrapup(ssl);
+    int ret = mbedtls_ssl_tls13_handshake_wrapup(ssl);
+    if (ret != 0) {
+        return ret;
+    }
 
     mbedtls_ssl_handshake_set_state(ssl, MBEDTLS_SSL_HANDSHAKE_OVER);
     return 0;
@@ -2889,7 +2967,7 @@ static int ssl_tls13_parse_new_session_ticket(mbedtls_ssl_context *ssl,
         session->ticket_len = 0;
     }
 
-    if ((ticket = mbedtls_calloc(1, ticket_len)) == NULL) {
+    if ((ticket = mbedtls_ssl_calloc(ssl, 1, ticket_len)) == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("ticket alloc failed"));
         return MBEDTLS_ERR_SSL_ALLOC_FAILED;
     }
@@ -3156,8 +3234,11 @@ int mbedtls_ssl_tls13_handshake_client_step(mbedtls_ssl_context *ssl)
 
                 MBEDTLS_SSL_DEBUG_MSG(
                     1, ("Switch to early data keys for outbound traffic"));
-                mbedtls_ssl_set_outbound_transform(
+                ret = mbedtls_ssl_set_outbound_transform(
                     ssl, ssl->handshake->transform_earlydata);
+                if (ret != 0) {
+                    break;
+                }
                 ssl->early_data_state = MBEDTLS_SSL_EARLY_DATA_STATE_CAN_WRITE;
             }
             break;
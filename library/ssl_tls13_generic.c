@@ -136,6 +136,68 @@ int mbedtls_ssl_tls13_is_supported_versions_ext_present_in_exts(
     return 0;
 }
 
+int mbedtls_ssl_tls13_index_extensions(mbedtls_ssl_context *ssl,
+                                       int hs_msg_type,
+                                       const unsigned char *buf,
+                                       const unsigned char *end,
+                                       mbedtls_ssl_tls13_ext_index *index)
+{
+    const unsigned char *p = buf;
+    size_t extensions_len;
+
+    ((void) hs_msg_type);
+
+    memset(index, 0, sizeof(*index));
+    index->exts = buf;
+    index->end = buf;
+
+    /* Case of no extension */
+    if (p == end) {
+        return 0;
+    }
+
+    MBEDTLS_SSL_CHK_BUF_READ_PTR(p, end, 2);
+    extensions_len = MBEDTLS_GET_UINT16_BE(p, 0);
+    p += 2;
+
+    MBEDTLS_SSL_CHK_BUF_READ_PTR(p, end, extensions_len);
+    index->exts = p;
+    index->end = p + extensions_len;
+
+    while (p < index->end) {
+        unsigned int extension_type;
+        size_t extension_data_len;
+        uint32_t id;
+
+        MBEDTLS_SSL_CHK_BUF_READ_PTR(p, index->end, 4);
+        extension_type = MBEDTLS_GET_UINT16_BE(p, 0);
+        extension_data_len = MBEDTLS_GET_UINT16_BE(p, 2);
+        p += 4;
+        MBEDTLS_SSL_CHK_BUF_READ_PTR(p, index->end, extension_data_len);
+
+        MBEDTLS_SSL_PRINT_EXT(3, hs_msg_type, extension_type, "received");
+
+        id = mbedtls_ssl_get_extension_id(extension_type);
+        index->last = id;
+        if (id == MBEDTLS_SSL_EXT_ID_UNRECOGNIZED) {
+            index->present |= 1u << id;
+        } else if ((index->present & (1u << id)) != 0) {
+            /* Keep the first occurrence, the caller decides whether
+             * repeated extensions are acceptable. */
+            index->duplicated |= 1u << id;
+        } else {
+            index->present |= 1u << id;
+            index->offset[id] = (uint16_t) (p - index->exts);
+            index->len[id] = (uint16_t) extension_data_len;
+            index->order[index->count++] = (uint8_t) id;
+        }
+
+        p += extension_data_len;
+    }
+
+    return 0;
+}
+
 #if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED)
 /*
  * STATE HANDLING: Read CertificateVerify
@@ -313,12 +375,22 @@ static int ssl_tls13_parse_certificate_verify(mbedtls_ssl_context *ssl,
     }
 #endif /* MBEDTLS_X509_RSASSA_PSS_SUPPORT */
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+    ret = mbedtls_ssl_async_verify(ssl, sig_alg, options,
+                                   &ssl->session_negotiate->peer_cert->pk,
+                                   md_alg, verify_hash, verify_hash_len,
+                                   p, signature_len);
+    if (ret == 0 || ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
+        return ret;
+    }
+#else
     if ((ret = mbedtls_pk_verify_ext(sig_alg, options,
                                      &ssl->session_negotiate->peer_cert->pk,
                                      md_alg, verify_hash, verify_hash_len,
                                      p, signature_len)) == 0) {
         return 0;
     }
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
     MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_pk_verify_ext", ret);
 
 error:
@@ -348,6 +420,14 @@ int mbedtls_ssl_tls13_process_certificate_verify(mbedtls_ssl_context *ssl)
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("=> parse certificate verify"));
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+    /* Resuming an asynchronous verification: the message is still the
+     * current one and has not been added to the transcript yet. */
+    if (mbedtls_ssl_async_job_is_pending(ssl, MBEDTLS_SSL_ASYNC_JOB_VERIFY)) {
+        buf = ssl->in_msg + 4;
+        buf_len = ssl->in_hslen - 4;
+    } else
+#endif
     MBEDTLS_SSL_PROC_CHK(
         mbedtls_ssl_tls13_fetch_handshake_msg(
             ssl, MBEDTLS_SSL_HS_CERTIFICATE_VERIFY, &buf, &buf_len));
@@ -478,6 +558,15 @@ int mbedtls_ssl_tls13_parse_certificate(mbedtls_ssl_context *ssl,
         goto exit;
     }
 
+    /* The parsed chain keeps a copy of each certificate. */
+    ret = mbedtls_ssl_check_memory(ssl, certificate_list_len);
+    if (ret != 0) {
+        ssl->session_negotiate->peer_cert = NULL;
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_INTERNAL_ERROR,
+                                     ret);
+        return ret;
+    }
+
     if ((ssl->session_negotiate->peer_cert =
              mbedtls_calloc(1, sizeof(mbedtls_x509_crt))) == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("alloc( %" MBEDTLS_PRINTF_SIZET " bytes ) failed",
@@ -692,6 +781,178 @@ static int ssl_tls13_validate_certificate(mbedtls_ssl_context *ssl)
 #endif /* MBEDTLS_SSL_KEEP_PEER_CERTIFICATE */
 #endif /* MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED */
 
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+/*
+ * Compress a Certificate message into a buffer allocated with
+ * mbedtls_calloc(). Compression must save at least one byte.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_tls13_compress_certificate(const mbedtls_ssl_cert_compression *comp,
+                                          const unsigned char *msg,
+                                          size_t msg_len,
+                                          unsigned char **out,
+                                          size_t *out_len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    unsigned char *compressed;
+    size_t compressed_len = 0;
+
+    compressed = mbedtls_calloc(1, msg_len);
+    if (compressed == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    ret = comp->f_compress(comp->p_ctx, msg, msg_len,
+                           compressed, msg_len, &compressed_len);
+    if (ret == 0 && (compressed_len == 0 || compressed_len >= msg_len)) {
+        ret = MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+    }
+    if (ret != 0) {
+        mbedtls_free(compressed);
+        return ret;
+    }
+
+    *out = compressed;
+    *out_len = compressed_len;
+
+    return 0;
+}
+
+int mbedtls_ssl_tls13_compress_cert_chain(const mbedtls_ssl_cert_compression *comp,
+                                          const mbedtls_x509_crt *chain,
+                                          unsigned char **out, size_t *out_len,
+                                          size_t *uncompressed_len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    const mbedtls_x509_crt *crt;
+    unsigned char *msg, *p;
+    size_t msg_len = 1 + 3;
+
+    for (crt = chain; crt != NULL; crt = crt->next) {
+        if (crt->raw.len > 0xFFFFFF - 3 - 2 - msg_len) {
+            return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+        }
+        msg_len += 3 + crt->raw.len + 2;
+    }
+
+    msg = mbedtls_calloc(1, msg_len);
+    if (msg == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    /* Empty certificate_request_context, as sent by a server. */
+    p = msg;
+    *p++ = 0;
+    MBEDTLS_PUT_UINT24_BE(msg_len - 4, p, 0);
+    p += 3;
+    for (crt = chain; crt != NULL; crt = crt->next) {
+        MBEDTLS_PUT_UINT24_BE(crt->raw.len, p, 0);
+        p += 3;
+        memcpy(p, crt->raw.p, crt->raw.len);
+        p += crt->raw.len;
+        MBEDTLS_PUT_UINT16_BE(0, p, 0);
+        p += 2;
+    }
+
+    ret = ssl_tls13_compress_certificate(comp, msg, msg_len, out, out_len);
+    if (ret == 0) {
+        *uncompressed_len = msg_len;
+    }
+
+    mbedtls_free(msg);
+
+    return ret;
+}
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
+
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION) && \
+    defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED)
+/* RFC 8879, section 4:
+ *
+ * struct {
+ *      CertificateCompressionAlgorithm algorithm;
+ *      uint24 uncompressed_length;
+ *      opaque compressed_certificate_message<1..2^24-1>;
+ * } CompressedCertificate;
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_tls13_decompress_certificate(mbedtls_ssl_context *ssl,
+                                            const unsigned char *buf,
+                                            const unsigned char *end,
+                                            unsigned char **out,
+                                            size_t *out_len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    const unsigned char *p = buf;
+    const mbedtls_ssl_cert_compression *comp = NULL;
+    uint16_t alg;
+    size_t uncompressed_len, compressed_len;
+    unsigned char *msg;
+
+    MBEDTLS_SSL_CHK_BUF_READ_PTR(p, end, 8);
+    alg = MBEDTLS_GET_UINT16_BE(p, 0);
+    uncompressed_len = MBEDTLS_GET_UINT24_BE(p, 2);
+    compressed_len = MBEDTLS_GET_UINT24_BE(p, 5);
+    p += 8;
+
+    if (compressed_len == 0 || compressed_len != (size_t) (end - p)) {
+        MBEDTLS_SSL_DEBUG_MSG(1, ("bad compressed certificate message"));
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_DECODE_ERROR,
+                                     MBEDTLS_ERR_SSL_DECODE_ERROR);
+        return MBEDTLS_ERR_SSL_DECODE_ERROR;
+    }
+
+    for (size_t i = 0; i < ssl->conf->cert_compression_count; i++) {
+        if (ssl->conf->cert_compression[i].alg == alg &&
+            ssl->conf->cert_compression[i].f_decompress != NULL) {
+            comp = &ssl->conf->cert_compression[i];
+            break;
+        }
+    }
+
+    if (comp == NULL) {
+        MBEDTLS_SSL_DEBUG_MSG(1, ("certificate compressed with an algorithm "
+                                  "that was not offered: %u", alg));
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_ILLEGAL_PARAMETER,
+                                     MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER);
+        return MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER;
+    }
+
+    MBEDTLS_SSL_DEBUG_MSG(3, ("certificate compressed with algorithm %u: %"
+                              MBEDTLS_PRINTF_SIZET " -> %" MBEDTLS_PRINTF_SIZET,
+                              alg, compressed_len, uncompressed_len));
+
+    if (uncompressed_len == 0 ||
+        uncompressed_len > MBEDTLS_SSL_CERT_COMPRESSION_MAX_LEN) {
+        MBEDTLS_SSL_DEBUG_MSG(1, ("bad uncompressed certificate length"));
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_BAD_CERT,
+                                     MBEDTLS_ERR_SSL_BAD_CERTIFICATE);
+        return MBEDTLS_ERR_SSL_BAD_CERTIFICATE;
+    }
+
+    msg = mbedtls_ssl_calloc(ssl, 1, uncompressed_len);
+    if (msg == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    ret = comp->f_decompress(comp->p_ctx, p, compressed_len,
+                             msg, uncompressed_len);
+    if (ret != 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "f_decompress", ret);
+        mbedtls_free(msg);
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_BAD_CERT,
+                                     MBEDTLS_ERR_SSL_BAD_CERTIFICATE);
+        return MBEDTLS_ERR_SSL_BAD_CERTIFICATE;
+    }
+
+    *out = msg;
+    *out_len = uncompressed_len;
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION &&
+          MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED */
+
 int mbedtls_ssl_tls13_process_certificate(mbedtls_ssl_context *ssl)
 {
     int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
@@ -700,21 +961,56 @@ int mbedtls_ssl_tls13_process_certificate(mbedtls_ssl_context *ssl)
 #if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED)
     unsigned char *buf;
     size_t buf_len;
+    const unsigned char *msg;
+    size_t msg_len;
+    unsigned hs_type = MBEDTLS_SSL_HS_CERTIFICATE;
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+    unsigned char *decompressed = NULL;
+
+    /* The peer may only compress its certificate if we offered it. */
+    if (ssl->handshake->sent_extensions &
+        MBEDTLS_SSL_EXT_MASK(COMPRESS_CERTIFICATE)) {
+        if ((ret = mbedtls_ssl_read_record(ssl, 0)) != 0) {
+            MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_read_record", ret);
+            goto cleanup;
+        }
+        ssl->keep_current_message = 1;
+
+        if (ssl->in_msgtype == MBEDTLS_SSL_MSG_HANDSHAKE &&
+            ssl->in_msg[0] == MBEDTLS_SSL_HS_COMPRESSED_CERTIFICATE) {
+            hs_type = MBEDTLS_SSL_HS_COMPRESSED_CERTIFICATE;
+        }
+    }
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
 
     MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_tls13_fetch_handshake_msg(
-                             ssl, MBEDTLS_SSL_HS_CERTIFICATE,
-                             &buf, &buf_len));
+                             ssl, hs_type, &buf, &buf_len));
+    msg = buf;
+    msg_len = buf_len;
+
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+    if (hs_type == MBEDTLS_SSL_HS_COMPRESSED_CERTIFICATE) {
+        MBEDTLS_SSL_PROC_CHK(ssl_tls13_decompress_certificate(
+                                 ssl, buf, buf + buf_len,
+                                 &decompressed, &msg_len));
+        msg = decompressed;
+    }
+#endif
 
     /* Parse the certificate chain sent by the peer. */
-    MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_tls13_parse_certificate(ssl, buf,
-                                                             buf + buf_len));
+    MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_tls13_parse_certificate(ssl, msg,
+                                                             msg + msg_len));
     /* Validate the certificate chain and set the verification results. */
     MBEDTLS_SSL_PROC_CHK(ssl_tls13_validate_certificate(ssl));
 
+    /* The transcript covers the message as sent. */
     MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_add_hs_msg_to_checksum(
-                             ssl, MBEDTLS_SSL_HS_CERTIFICATE, buf, buf_len));
+                             ssl, hs_type, buf, buf_len));
 
 cleanup:
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+    mbedtls_free(decompressed);
+#endif
 #else /* MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED */
     (void) ssl;
 #endif /* MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED */
@@ -783,6 +1079,17 @@ static int ssl_tls13_write_certificate_body(mbedtls_ssl_context *ssl,
 
     MBEDTLS_SSL_DEBUG_CRT(3, "own certificate", crt);
 
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS)
+    if (crt != NULL && mbedtls_ssl_own_key_cert(ssl)->tls13_list != NULL) {
+        const mbedtls_ssl_key_cert *key_cert = mbedtls_ssl_own_key_cert(ssl);
+
+        MBEDTLS_SSL_CHK_BUF_PTR(p, end, key_cert->tls13_list_len);
+        memcpy(p, key_cert->tls13_list, key_cert->tls13_list_len);
+        p += key_cert->tls13_list_len;
+        crt = NULL;
+    }
+#endif /* MBEDTLS_SSL_PREENCODE_CERTS */
+
     while (crt != NULL) {
         size_t cert_data_len = crt->raw.len;
 
@@ -812,24 +1119,142 @@ static int ssl_tls13_write_certificate_body(mbedtls_ssl_context *ssl,
     return 0;
 }
 
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+/*
+ * Write a CompressedCertificate message body, see
+ * ssl_tls13_decompress_certificate(). Returns
+ * MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL if the Certificate message is to be sent
+ * uncompressed instead.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_tls13_write_compressed_certificate_body(mbedtls_ssl_context *ssl,
+                                                       unsigned char *buf,
+                                                       unsigned char *end,
+                                                       size_t *out_len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    size_t idx = ssl->handshake->cert_compression - 1;
+    const mbedtls_ssl_cert_compression *comp = &ssl->conf->cert_compression[idx];
+    const mbedtls_ssl_key_cert *key_cert = mbedtls_ssl_own_key_cert(ssl);
+    const unsigned char *data;
+    unsigned char *compressed = NULL;
+    size_t len, uncompressed_len;
+
+    if (key_cert != NULL && key_cert->compressed[idx].data != NULL) {
+        data = key_cert->compressed[idx].data;
+        len = key_cert->compressed[idx].len;
+        uncompressed_len = key_cert->compressed[idx].uncompressed_len;
+    } else {
+        /* Encode the message in place, then compress it aside. */
+        ret = ssl_tls13_write_certificate_body(ssl, buf, end, &uncompressed_len);
+        if (ret != 0) {
+            return ret;
+        }
+
+        ret = ssl_tls13_compress_certificate(comp, buf, uncompressed_len,
+                                             &compressed, &len);
+        if (ret != 0) {
+            return ret;
+        }
+        data = compressed;
+    }
+
+    if ((size_t) (end - buf) < 8 || len > (size_t) (end - buf) - 8) {
+        mbedtls_free(compressed);
+        return MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+    }
+
+    MBEDTLS_PUT_UINT16_BE(comp->alg, buf, 0);
+    MBEDTLS_PUT_UINT24_BE(uncompressed_len, buf, 2);
+    MBEDTLS_PUT_UINT24_BE(len, buf, 5);
+    memcpy(buf + 8, data, len);
+    *out_len = 8 + len;
+
+    MBEDTLS_SSL_DEBUG_MSG(3, ("certificate compressed with algorithm %u: %"
+                              MBEDTLS_PRINTF_SIZET " -> %" MBEDTLS_PRINTF_SIZET,
+                              comp->alg, uncompressed_len, len));
+
+    mbedtls_free(compressed);
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
+
+/*
+ * Length of the Certificate message, header included, that
+ * ssl_tls13_write_certificate_body() writes. A CompressedCertificate message
+ * is encoded in place of it first, so this bounds both.
+ */
+static size_t ssl_tls13_certificate_msg_len(mbedtls_ssl_context *ssl)
+{
+    const mbedtls_x509_crt *crt = mbedtls_ssl_own_cert(ssl);
+    size_t len = 4 + 1 + ssl->handshake->certificate_request_context_len + 3;
+
+#if defined(MBEDTLS_SSL_PREENCODE_CERTS)
+    if (crt != NULL && mbedtls_ssl_own_key_cert(ssl)->tls13_list != NULL) {
+        return len + mbedtls_ssl_own_key_cert(ssl)->tls13_list_len;
+    }
+#endif /* MBEDTLS_SSL_PREENCODE_CERTS */
+
+    for (; crt != NULL; crt = crt->next) {
+        len += 3 + crt->raw.len + 2;
+    }
+
+    return len;
+}
+
+/*
+ * Write a CompressedCertificate message if the peer supports it and it
+ * fits, or a Certificate message.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_tls13_write_certificate_msg_body(mbedtls_ssl_context *ssl,
+                                                unsigned char *buf,
+                                                unsigned char *end,
+                                                unsigned *hs_type,
+                                                size_t *out_len)
+{
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+    if (ssl->handshake->cert_compression != 0) {
+        int ret = ssl_tls13_write_compressed_certificate_body(ssl, buf, end,
+                                                              out_len);
+        if (ret == 0) {
+            *hs_type = MBEDTLS_SSL_HS_COMPRESSED_CERTIFICATE;
+            ssl->out_msg[0] = MBEDTLS_SSL_HS_COMPRESSED_CERTIFICATE;
+        }
+        if (ret != MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL) {
+            return ret;
+        }
+    }
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
+
+    *hs_type = MBEDTLS_SSL_HS_CERTIFICATE;
+    return ssl_tls13_write_certificate_body(ssl, buf, end, out_len);
+}
+
 int mbedtls_ssl_tls13_write_certificate(mbedtls_ssl_context *ssl)
 {
     int ret;
     unsigned char *buf;
     size_t buf_len, msg_len;
+    unsigned hs_type = MBEDTLS_SSL_HS_CERTIFICATE;
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("=> write certificate"));
 
-    MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_start_handshake_msg(
-                             ssl, MBEDTLS_SSL_HS_CERTIFICATE, &buf, &buf_len));
+    MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_start_handshake_msg_ext(
+                             ssl, MBEDTLS_SSL_HS_CERTIFICATE,
+                             ssl_tls13_certificate_msg_len(ssl),
+                             &buf, &buf_len));
+
+    ret = ssl_tls13_write_certificate_msg_body(ssl, buf, buf + buf_len,
+                                               &hs_type, &msg_len);
 
-    MBEDTLS_SSL_PROC_CHK(ssl_tls13_write_certificate_body(ssl,
-                                                          buf,
-                                                          buf + buf_len,
-                                                          &msg_len));
+    if (ret != 0) {
+        goto cleanup;
+    }
 
     MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_add_hs_msg_to_checksum(
-                             ssl, MBEDTLS_SSL_HS_CERTIFICATE, buf, msg_len));
+                             ssl, hs_type, buf, msg_len));
 
     MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_finish_handshake_msg(
                              ssl, buf_len, msg_len));
@@ -886,6 +1311,50 @@ int mbedtls_ssl_tls13_check_sig_alg_cert_key_match(uint16_t sig_alg,
     return 0;
 }
 
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+/* Collect the signature of an asynchronous operation started by
+ * ssl_tls13_write_certificate_verify_body() and write the
+ * CertificateVerify body around it. */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_tls13_resume_certificate_verify(mbedtls_ssl_context *ssl,
+                                               unsigned char *buf,
+                                               unsigned char *end,
+                                               size_t *out_len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    size_t signature_len = 0;
+
+    MBEDTLS_SSL_CHK_BUF_PTR(buf, end, 4);
+
+    ret = ssl->conf->f_async_resume(ssl, buf + 4, &signature_len,
+                                    (size_t) (end - (buf + 4)));
+    if (ret != MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
+        ssl->handshake->async_in_progress = 0;
+        mbedtls_ssl_set_async_operation_data(ssl, NULL);
+    }
+    MBEDTLS_SSL_DEBUG_RET(2, "ssl_tls13_resume_certificate_verify", ret);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (signature_len > (size_t) (end - (buf + 4))) {
+        MBEDTLS_SSL_DEBUG_MSG(1, ("f_async_resume returned too long a signature"));
+        return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("CertificateVerify signature with %s",
+                              mbedtls_ssl_sig_alg_to_str(
+                                  ssl->handshake->async_sig_alg)));
+
+    MBEDTLS_PUT_UINT16_BE(ssl->handshake->async_sig_alg, buf, 0);
+    MBEDTLS_PUT_UINT16_BE(signature_len, buf, 2);
+
+    *out_len = 4 + signature_len;
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
+
 MBEDTLS_CHECK_RETURN_CRITICAL
 static int ssl_tls13_write_certificate_verify_body(mbedtls_ssl_context *ssl,
                                                    unsigned char *buf,
@@ -906,6 +1375,15 @@ static int ssl_tls13_write_certificate_verify_body(mbedtls_ssl_context *ssl,
 
     *out_len = 0;
 
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+    /* If the signature was started asynchronously in a previous call,
+     * the transcript and algorithm are already fixed: only collect it. */
+    if (ssl->handshake->async_in_progress != 0) {
+        MBEDTLS_SSL_DEBUG_MSG(2, ("resuming signature operation"));
+        return ssl_tls13_resume_certificate_verify(ssl, buf, end, out_len);
+    }
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
+
     own_key = mbedtls_ssl_own_key(ssl);
     if (own_key == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("should never happen"));
@@ -976,6 +1454,32 @@ static int ssl_tls13_write_certificate_verify_body(mbedtls_ssl_context *ssl,
 
         MBEDTLS_SSL_DEBUG_BUF(3, "verify hash", verify_hash, verify_hash_len);
 
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+        if (ssl->conf->f_async_sign_start != NULL) {
+            ret = ssl->conf->f_async_sign_start(ssl,
+                                                mbedtls_ssl_own_cert(ssl),
+                                                md_alg, verify_hash,
+                                                verify_hash_len);
+            switch (ret) {
+                case MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH:
+                    /* act as if f_async_sign was null */
+                    break;
+                case 0:
+                    ssl->handshake->async_in_progress = 1;
+                    ssl->handshake->async_sig_alg = *sig_alg;
+                    return ssl_tls13_resume_certificate_verify(ssl, buf, end,
+                                                               out_len);
+                case MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS:
+                    ssl->handshake->async_in_progress = 1;
+                    ssl->handshake->async_sig_alg = *sig_alg;
+                    return MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS;
+                default:
+                    MBEDTLS_SSL_DEBUG_RET(1, "f_async_sign_start", ret);
+                    return ret;
+            }
+        }
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
+
         if ((ret = mbedtls_pk_sign_ext(pk_type, own_key,
                                        md_alg, verify_hash, verify_hash_len,
                                        p + 4, (size_t) (end - (p + 4)), &signature_len,
@@ -1218,16 +1722,28 @@ cleanup:
     return ret;
 }
 
-void mbedtls_ssl_tls13_handshake_wrapup(mbedtls_ssl_context *ssl)
+int mbedtls_ssl_tls13_handshake_wrapup(mbedtls_ssl_context *ssl)
 {
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
 
     MBEDTLS_SSL_DEBUG_MSG(3, ("=> handshake wrapup"));
 
+    /* The session outlives the handshake, it must not borrow from the
+     * decrypted ticket or the buffer passed to mbedtls_ssl_set_session()
+     * anymore. */
+    ret = mbedtls_ssl_session_detach(ssl->session_negotiate);
+    if (ret != 0) {
+        return ret;
+    }
+
     MBEDTLS_SSL_DEBUG_MSG(1, ("Switch to application keys for inbound traffic"));
     mbedtls_ssl_set_inbound_transform(ssl, ssl->transform_application);
 
     MBEDTLS_SSL_DEBUG_MSG(1, ("Switch to application keys for outbound traffic"));
-    mbedtls_ssl_set_outbound_transform(ssl, ssl->transform_application);
+    ret = mbedtls_ssl_set_outbound_transform(ssl, ssl->transform_application);
+    if (ret != 0) {
+        return ret;
+    }
 
     /*
      * Free the previous session and switch to the current one.
@@ -1240,6 +1756,8 @@ void mbedtls_ssl_tls13_handshake_wrapup(mbedtls_ssl_context *ssl)
     ssl->session_negotiate = NULL;
 
     MBEDTLS_SSL_DEBUG_MSG(3, ("<= handshake wrapup"));
+
+    return 0;
 }
 
 /*
@@ -1275,6 +1793,11 @@ int mbedtls_ssl_tls13_write_change_cipher_spec(mbedtls_ssl_context *ssl)
         goto cleanup;
     }
 
+#if defined(MBEDTLS_SSL_TLS1_3_COALESCE_HANDSHAKE)
+    /* The CCS goes in a record of its own, after the handshake messages. */
+    MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_write_coalesced_handshake(ssl));
+#endif
+
     /* Write CCS message */
     MBEDTLS_SSL_PROC_CHK(ssl_tls13_write_change_cipher_spec_body(
                              ssl, ssl->out_msg,
@@ -1296,6 +1819,131 @@ cleanup:
 
 #endif /* MBEDTLS_SSL_TLS1_3_COMPATIBILITY_MODE */
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+/*
+ * KeyUpdate message
+ *
+ *   enum {
+ *       update_not_requested(0), update_requested(1), (255)
+ *   } KeyUpdateRequest;
+ *
+ *   struct {
+ *       KeyUpdateRequest request_update;
+ *   } KeyUpdate;
+ */
+int mbedtls_ssl_tls13_process_key_update(mbedtls_ssl_context *ssl)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    const size_t hs_hdr_len = mbedtls_ssl_hs_hdr_len(ssl);
+    unsigned char request_update;
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("=> parse key update"));
+
+    /* The records that follow a KeyUpdate are protected with the next key,
+     * so the message must end its record (RFC 8446 section 5.1). */
+    if (ssl->in_hslen != ssl->in_msglen) {
+        MBEDTLS_SSL_DEBUG_MSG(1, ("KeyUpdate not at the end of its record"));
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_UNEXPECTED_MESSAGE,
+                                     MBEDTLS_ERR_SSL_UNEXPECTED_MESSAGE);
+        return MBEDTLS_ERR_SSL_UNEXPECTED_MESSAGE;
+    }
+
+    if (ssl->in_hslen != hs_hdr_len + 1) {
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_DECODE_ERROR,
+                                     MBEDTLS_ERR_SSL_DECODE_ERROR);
+        return MBEDTLS_ERR_SSL_DECODE_ERROR;
+    }
+
+    request_update = ssl->in_msg[hs_hdr_len];
+    if (request_update != MBEDTLS_SSL_KEY_UPDATE_NOT_REQUESTED &&
+        request_update != MBEDTLS_SSL_KEY_UPDATE_REQUESTED) {
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_ILLEGAL_PARAMETER,
+                                     MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER);
+        return MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER;
+    }
+
+    ret = mbedtls_ssl_tls13_update_application_traffic_key(ssl, 0);
+    if (ret != 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_tls13_update_application_traffic_key",
+                              ret);
+        return ret;
+    }
+    mbedtls_ssl_set_inbound_transform(ssl, ssl->transform_application);
+
+    /* Answer before the next application data record. A KeyUpdate of ours
+     * that is already written updated our key as well, so there is nothing
+     * more to send in that case. */
+    if (request_update == MBEDTLS_SSL_KEY_UPDATE_REQUESTED &&
+        ssl->key_update_state == MBEDTLS_SSL_KEY_UPDATE_STATE_NONE) {
+        ssl->key_update_state = MBEDTLS_SSL_KEY_UPDATE_STATE_PENDING;
+        ssl->key_update_request = MBEDTLS_SSL_KEY_UPDATE_NOT_REQUESTED;
+    }
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("<= parse key update"));
+
+    return 0;
+}
+
+int mbedtls_ssl_tls13_write_key_update(mbedtls_ssl_context *ssl)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+
+    if (ssl->key_update_state == MBEDTLS_SSL_KEY_UPDATE_STATE_PENDING) {
+        MBEDTLS_SSL_DEBUG_MSG(2, ("=> write key update"));
+
+        /* Send anything still buffered with the current key first. */
+        if ((ret = mbedtls_ssl_flush_output(ssl)) != 0) {
+            return ret;
+        }
+
+        ssl->out_msgtype = MBEDTLS_SSL_MSG_HANDSHAKE;
+        ssl->out_msg[0] = MBEDTLS_SSL_HS_KEY_UPDATE;
+        ssl->out_msg[1] = 0;
+        ssl->out_msg[2] = 0;
+        ssl->out_msg[3] = 1;
+        ssl->out_msg[4] = ssl->key_update_request;
+        ssl->out_msglen = 5;
+
+        /* Post-handshake messages are not part of the transcript, so this
+         * bypasses mbedtls_ssl_write_handshake_msg(). */
+        ret = mbedtls_ssl_write_record(ssl, 0);
+        if (ret != 0) {
+            MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_write_record", ret);
+            return ret;
+        }
+
+        /* The message is protected by now: switch keys before anything
+         * else can be written. */
+        ret = mbedtls_ssl_tls13_update_application_traffic_key(ssl, 1);
+        if (ret != 0) {
+            MBEDTLS_SSL_DEBUG_RET(
+                1, "mbedtls_ssl_tls13_update_application_traffic_key", ret);
+            return ret;
+        }
+        ret = mbedtls_ssl_set_outbound_transform(ssl,
+                                                 ssl->transform_application);
+        if (ret != 0) {
+            return ret;
+        }
+
+        ssl->key_update_records = 0;
+        ssl->key_update_bytes = 0;
+        ssl->key_update_state = MBEDTLS_SSL_KEY_UPDATE_STATE_FLUSH;
+
+        MBEDTLS_SSL_DEBUG_MSG(2, ("<= write key update"));
+    }
+
+    if (ssl->key_update_state == MBEDTLS_SSL_KEY_UPDATE_STATE_FLUSH) {
+        if ((ret = mbedtls_ssl_flush_output(ssl)) != 0) {
+            return ret;
+        }
+        ssl->key_update_state = MBEDTLS_SSL_KEY_UPDATE_STATE_NONE;
+    }
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_TLS1_3_KEY_UPDATE */
+
 /* Early Data Indication Extension
  *
  * struct {
@@ -1483,7 +2131,7 @@ int mbedtls_ssl_tls13_read_public_xxdhe_share(mbedtls_ssl_context *ssl,
 }
 
 #if defined(PSA_WANT_ALG_FFDH)
-static psa_status_t  mbedtls_ssl_get_psa_ffdh_info_from_tls_id(
+psa_status_t mbedtls_ssl_get_psa_ffdh_info_from_tls_id(
     uint16_t tls_id, size_t *bits, psa_key_type_t *key_type)
 {
     switch (tls_id) {
@@ -1574,14 +2222,28 @@ int mbedtls_ssl_tls13_generate_and_write_xxdh_key_exchange(
     psa_set_key_bits(&key_attributes, handshake->xxdh_psa_bits);
 
     /* Generate ECDH/FFDH private key. */
-    status = psa_generate_key(&key_attributes,
-                              &handshake->xxdh_psa_privkey);
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+    /* When a message is rewritten after an asynchronous operation, the key
+     * generated in the previous attempt is still valid. The client destroys
+     * it before writing a ClientHello for a different group. */
+    if (mbedtls_svc_key_id_is_null(handshake->xxdh_psa_privkey)) {
+        ret = mbedtls_ssl_async_generate_key(ssl, &key_attributes,
+                                             &handshake->xxdh_psa_privkey);
+        if (ret != 0) {
+            MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_async_generate_key", ret);
+            return ret;
+        }
+    }
+#else
+    status = mbedtls_ssl_generate_ephemeral_key(ssl, &key_attributes,
+                                                &handshake->xxdh_psa_privkey);
     if (status != PSA_SUCCESS) {
         ret = PSA_TO_MBEDTLS_ERR(status);
-        MBEDTLS_SSL_DEBUG_RET(1, "psa_generate_key", ret);
+        MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_generate_ephemeral_key", ret);
         return ret;
 
     }
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
 
     /* Export the public part of the ECDH/FFDH private key from PSA. */
     status = psa_export_public_key(handshake->xxdh_psa_privkey,
@@ -1742,4 +2404,97 @@ int mbedtls_ssl_tls13_write_record_size_limit_ext(mbedtls_ssl_context *ssl,
 
 #endif /* MBEDTLS_SSL_RECORD_SIZE_LIMIT */
 
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+
+/* RFC 8879, section 3:
+ *
+ * struct {
+ *     CertificateCompressionAlgorithm algorithms<2..2^8-2>;
+ * } CompressCertificateExtension;
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_tls13_write_compress_certificate_ext(mbedtls_ssl_context *ssl,
+                                                     unsigned char *buf,
+                                                     const unsigned char *end,
+                                                     size_t *out_len)
+{
+    unsigned char *p = buf;
+    unsigned char *algorithms;
+    size_t algorithms_len;
+
+    *out_len = 0;
+
+    MBEDTLS_SSL_CHK_BUF_PTR(p, end, 5);
+    algorithms = p + 5;
+    p = algorithms;
+
+    for (size_t i = 0; i < ssl->conf->cert_compression_count; i++) {
+        if (ssl->conf->cert_compression[i].f_decompress == NULL) {
+            continue;
+        }
+        MBEDTLS_SSL_CHK_BUF_PTR(p, end, 2);
+        MBEDTLS_PUT_UINT16_BE(ssl->conf->cert_compression[i].alg, p, 0);
+        p += 2;
+    }
+
+    algorithms_len = p - algorithms;
+    if (algorithms_len == 0) {
+        return 0;
+    }
+
+    MBEDTLS_PUT_UINT16_BE(MBEDTLS_TLS_EXT_COMPRESS_CERTIFICATE, buf, 0);
+    MBEDTLS_PUT_UINT16_BE(algorithms_len + 1, buf, 2);
+    buf[4] = MBEDTLS_BYTE_0(algorithms_len);
+
+    *out_len = p - buf;
+
+    mbedtls_ssl_tls13_set_hs_sent_ext_mask(ssl, MBEDTLS_TLS_EXT_COMPRESS_CERTIFICATE);
+
+    return 0;
+}
+
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_tls13_parse_compress_certificate_ext(mbedtls_ssl_context *ssl,
+                                                     const unsigned char *buf,
+                                                     const unsigned char *end)
+{
+    const unsigned char *p = buf;
+    const unsigned char *algorithms_end;
+    size_t algorithms_len;
+
+    MBEDTLS_SSL_CHK_BUF_READ_PTR(p, end, 1);
+    algorithms_len = p[0];
+    p += 1;
+
+    if (algorithms_len < 2 || algorithms_len % 2 != 0 ||
+        algorithms_len != (size_t) (end - p)) {
+        MBEDTLS_SSL_DEBUG_MSG(1, ("bad compress_certificate extension"));
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_DECODE_ERROR,
+                                     MBEDTLS_ERR_SSL_DECODE_ERROR);
+        return MBEDTLS_ERR_SSL_DECODE_ERROR;
+    }
+    algorithms_end = p + algorithms_len;
+
+    /* Our order of preference wins over the client's. */
+    ssl->handshake->cert_compression = 0;
+    for (size_t i = 0; i < ssl->conf->cert_compression_count; i++) {
+        if (ssl->conf->cert_compression[i].f_compress == NULL) {
+            continue;
+        }
+        for (p = buf + 1; p < algorithms_end; p += 2) {
+            if (MBEDTLS_GET_UINT16_BE(p, 0) ==
+                ssl->conf->cert_compression[i].alg) {
+                ssl->handshake->cert_compression = (unsigned char) (i + 1);
+                MBEDTLS_SSL_DEBUG_MSG(3, ("certificate compression algorithm: %u",
+                                          ssl->conf->cert_compression[i].alg));
+                return 0;
+            }
+        }
+    }
+
+    return 0;
+}
+
+#endif /* MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION */
+
 #endif /* MBEDTLS_SSL_TLS_C && MBEDTLS_SSL_PROTO_TLS1_3 */
@@ -1197,7 +1197,8 @@ int mbedtls_ssl_tls13_compute_early_transform(mbedtls_ssl_context *ssl)
         goto cleanup;
     }
 
-    transform_earlydata = mbedtls_calloc(1, sizeof(mbedtls_ssl_transform));
+    transform_earlydata = mbedtls_ssl_hs_calloc(handshake, 1,
+                                                sizeof(mbedtls_ssl_transform));
     if (transform_earlydata == NULL) {
         ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
         goto cleanup;
@@ -1218,7 +1219,7 @@ int mbedtls_ssl_tls13_compute_early_transform(mbedtls_ssl_context *ssl)
 cleanup:
     mbedtls_platform_zeroize(&traffic_keys, sizeof(traffic_keys));
     if (ret != 0) {
-        mbedtls_free(transform_earlydata);
+        mbedtls_ssl_hs_free(handshake, transform_earlydata);
     }
 
     return ret;
@@ -1439,6 +1440,19 @@ static int ssl_tls13_key_schedule_stage_handshake(mbedtls_ssl_context *ssl)
 
             /* Compute ECDH shared secret. */
             psa_status_t status = PSA_ERROR_GENERIC_ERROR;
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO)
+            ret = mbedtls_ssl_async_key_agreement(
+                ssl, alg, handshake->xxdh_psa_privkey,
+                handshake->xxdh_psa_peerkey, handshake->xxdh_psa_peerkey_len,
+                &shared_secret, &shared_secret_len);
+            if (ret != 0) {
+                if (ret != MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
+                    MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_async_key_agreement",
+                                          ret);
+                }
+                goto cleanup;
+            }
+#else
             psa_key_attributes_t key_attributes = PSA_KEY_ATTRIBUTES_INIT;
 
             status = psa_get_key_attributes(handshake->xxdh_psa_privkey,
@@ -1463,6 +1477,7 @@ static int ssl_tls13_key_schedule_stage_handshake(mbedtls_ssl_context *ssl)
                 MBEDTLS_SSL_DEBUG_RET(1, "psa_raw_key_agreement", ret);
                 goto cleanup;
             }
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO */
 
             status = psa_destroy_key(handshake->xxdh_psa_privkey);
             if (status != PSA_SUCCESS) {
@@ -1668,7 +1683,8 @@ int mbedtls_ssl_tls13_compute_handshake_transform(mbedtls_ssl_context *ssl)
         goto cleanup;
     }
 
-    transform_handshake = mbedtls_calloc(1, sizeof(mbedtls_ssl_transform));
+    transform_handshake = mbedtls_ssl_hs_calloc(handshake, 1,
+                                                sizeof(mbedtls_ssl_transform));
     if (transform_handshake == NULL) {
         ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
         goto cleanup;
@@ -1689,7 +1705,7 @@ int mbedtls_ssl_tls13_compute_handshake_transform(mbedtls_ssl_context *ssl)
 cleanup:
     mbedtls_platform_zeroize(&traffic_keys, sizeof(traffic_keys));
     if (ret != 0) {
-        mbedtls_free(transform_handshake);
+        mbedtls_ssl_hs_free(handshake, transform_handshake);
     }
 
     return ret;
@@ -1787,6 +1803,113 @@ cleanup:
     return ret;
 }
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+/*
+ * RFC 8446 section 7.2:
+ *
+ *   application_traffic_secret_N+1 =
+ *       HKDF-Expand-Label(application_traffic_secret_N,
+ *                         "traffic upd", "", Hash.length)
+ */
+int mbedtls_ssl_tls13_update_application_traffic_key(mbedtls_ssl_context *ssl,
+                                                     int outbound)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    psa_status_t status;
+    psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+    mbedtls_ssl_transform *transform = ssl->transform_application;
+    const mbedtls_ssl_ciphersuite_t *ciphersuite_info;
+    mbedtls_svc_key_id_t *psa_key;
+    mbedtls_svc_key_id_t new_key = MBEDTLS_SVC_KEY_ID_INIT;
+    unsigned char *secret;
+    unsigned char *iv;
+    unsigned char next_secret[MBEDTLS_TLS1_3_MD_MAX_SIZE];
+    unsigned char key[MBEDTLS_SSL_MAX_KEY_LENGTH];
+    unsigned char new_iv[MBEDTLS_SSL_MAX_IV_LENGTH];
+    psa_algorithm_t hash_alg;
+    size_t hash_len, key_len, iv_len;
+
+    if (transform == NULL || ssl->session == NULL) {
+        return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+
+    ciphersuite_info = mbedtls_ssl_ciphersuite_from_id(ssl->session->ciphersuite);
+    if (ciphersuite_info == NULL) {
+        return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+
+    ret = ssl_tls13_get_cipher_key_info(ciphersuite_info, &key_len, &iv_len);
+    if (ret != 0) {
+        return ret;
+    }
+
+    hash_alg = mbedtls_md_psa_alg_from_type((mbedtls_md_type_t) ciphersuite_info->mac);
+    hash_len = PSA_HASH_LENGTH(hash_alg);
+
+    /* The client sends with the client secret, the server with the
+     * server secret. */
+    if ((ssl->conf->endpoint == MBEDTLS_SSL_IS_CLIENT) == (outbound != 0)) {
+        secret = ssl->session->app_secrets.client_application_traffic_secret_N;
+    } else {
+        secret = ssl->session->app_secrets.server_application_traffic_secret_N;
+    }
+
+    if (outbound) {
+        psa_key = &transform->psa_key_enc;
+        iv = transform->iv_enc;
+    } else {
+        psa_key = &transform->psa_key_dec;
+        iv = transform->iv_dec;
+    }
+
+    ret = mbedtls_ssl_tls13_hkdf_expand_label(
+        hash_alg, secret, hash_len,
+        MBEDTLS_SSL_TLS1_3_LBL_WITH_LEN(traffic_upd),
+        NULL, 0,
+        next_secret, hash_len);
+    if (ret != 0) {
+        goto cleanup;
+    }
+
+    ret = ssl_tls13_make_traffic_key(hash_alg, next_secret, hash_len,
+                                     key, key_len, new_iv, iv_len);
+    if (ret != 0) {
+        goto cleanup;
+    }
+
+    /* The new key has the type, algorithm and usage of the one it
+     * replaces. */
+    if (transform->psa_alg != MBEDTLS_SSL_NULL_CIPHER) {
+        status = psa_get_key_attributes(*psa_key, &attributes);
+        if (status == PSA_SUCCESS) {
+            status = psa_import_key(&attributes, key, key_len, &new_key);
+        }
+        psa_reset_key_attributes(&attributes);
+        if (status != PSA_SUCCESS) {
+            ret = PSA_TO_MBEDTLS_ERR(status);
+            MBEDTLS_SSL_DEBUG_RET(1, "psa_import_key", ret);
+            goto cleanup;
+        }
+
+        psa_destroy_key(*psa_key);
+        *psa_key = new_key;
+    }
+
+    memcpy(iv, new_iv, iv_len);
+    memcpy(secret, next_secret, hash_len);
+
+    MBEDTLS_SSL_DEBUG_BUF(4, outbound ? "updated sending traffic secret" :
+                          "updated receiving traffic secret",
+                          secret, hash_len);
+
+cleanup:
+    mbedtls_platform_zeroize(next_secret, sizeof(next_secret));
+    mbedtls_platform_zeroize(key, sizeof(key));
+    mbedtls_platform_zeroize(new_iv, sizeof(new_iv));
+    return ret;
+}
+#endif /* MBEDTLS_SSL_TLS1_3_KEY_UPDATE */
+
 #if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_PSK_ENABLED)
 int mbedtls_ssl_tls13_export_handshake_psk(mbedtls_ssl_context *ssl,
                                            unsigned char **psk,
@@ -628,6 +628,26 @@ int mbedtls_ssl_tls13_compute_handshake_transform(mbedtls_ssl_context *ssl);
 MBEDTLS_CHECK_RETURN_CRITICAL
 int mbedtls_ssl_tls13_compute_application_transform(mbedtls_ssl_context *ssl);
 
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_UPDATE)
+/**
+ * \brief Move the application traffic secret of one direction to its next
+ *        generation, and replace the matching key and IV of the
+ *        application transform (RFC 8446 section 7.2).
+ *
+ * \param ssl       The SSL context to operate on. The handshake must be over.
+ * \param outbound  Non-zero to update the key used to send records, zero to
+ *                  update the key used to receive them.
+ *
+ * \note  The caller resets the record sequence number of the direction.
+ *
+ * \returns    \c 0 on success.
+ * \returns    A negative error code on failure.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_tls13_update_application_traffic_key(mbedtls_ssl_context *ssl,
+                                                     int outbound);
+#endif /* MBEDTLS_SSL_TLS1_3_KEY_UPDATE */
+
 #if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_PSK_ENABLED)
 /**
  * \brief Export TLS 1.3 PSK from handshake context
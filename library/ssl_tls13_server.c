@@ -25,11 +25,10 @@ static const mbedtls_ssl_ciphersuite_t *ssl_tls13_validate_peer_ciphersuite(
     unsigned int cipher_suite)
 {
     const mbedtls_ssl_ciphersuite_t *ciphersuite_info;
-    if (!mbedtls_ssl_tls13_cipher_suite_is_offered(ssl, cipher_suite)) {
-        return NULL;
-    }
 
-    ciphersuite_info = mbedtls_ssl_ciphersuite_from_id(cipher_suite);
+    ciphersuite_info = mbedtls_ssl_conf_get_ciphersuite(ssl->conf,
+                                                        (int) cipher_suite,
+                                                        NULL);
     if ((mbedtls_ssl_validate_ciphersuite(ssl, ciphersuite_info,
                                           ssl->tls_version,
                                           ssl->tls_version) != 0)) {
@@ -209,7 +208,10 @@ static int ssl_tls13_offered_psks_check_identity_match_ticket(
      * (in-place decryption). We do, however, need the original buffer for
      * computing the PSK binder value.
      */
-    ticket_buffer = mbedtls_calloc(1, identity_len);
+    if ((ret = mbedtls_ssl_check_memory(ssl, identity_len)) != 0) {
+        return ret;
+    }
+    ticket_buffer = mbedtls_ssl_hs_calloc(ssl->handshake, 1, identity_len);
     if (ticket_buffer == NULL) {
         return MBEDTLS_ERR_SSL_ALLOC_FAILED;
     }
@@ -238,13 +240,32 @@ static int ssl_tls13_offered_psks_check_identity_match_ticket(
             ret = SSL_TLS1_3_PSK_IDENTITY_DOES_NOT_MATCH;
     }
 
-    /* We delete the temporary buffer */
-    mbedtls_free(ticket_buffer);
-
     if (ret != SSL_TLS1_3_PSK_IDENTITY_MATCH) {
+        mbedtls_ssl_session_free(session);
+        mbedtls_platform_zeroize(ticket_buffer, identity_len);
+        mbedtls_ssl_hs_free(ssl->handshake, ticket_buffer);
         goto exit;
     }
 
+    /* The ticket parser may have loaded the session without copying it out
+     * of the decrypted ticket, see mbedtls_ssl_session_load_borrowed(): keep
+     * it until the end of the handshake. The session negotiated after a
+     * HelloRetryRequest may still borrow from the previous one. */
+    ret = mbedtls_ssl_session_detach(ssl->session_negotiate);
+    if (ret != 0) {
+        mbedtls_ssl_session_free(session);
+        mbedtls_platform_zeroize(ticket_buffer, identity_len);
+        mbedtls_ssl_hs_free(ssl->handshake, ticket_buffer);
+        return ret;
+    }
+    if (ssl->handshake->ticket_buf != NULL) {
+        mbedtls_platform_zeroize(ssl->handshake->ticket_buf,
+                                 ssl->handshake->ticket_buf_len);
+        mbedtls_ssl_hs_free(ssl->handshake, ssl->handshake->ticket_buf);
+    }
+    ssl->handshake->ticket_buf = ticket_buffer;
+    ssl->handshake->ticket_buf_len = identity_len;
+
     /*
      * The identity matches that of a ticket. Now check that it has suitable
      * attributes and bet it will not be the case.
@@ -473,9 +494,19 @@ static int ssl_tls13_session_copy_ticket(mbedtls_ssl_session *dst,
     dst->max_early_data_size = src->max_early_data_size;
 
 #if defined(MBEDTLS_SSL_ALPN)
-    int ret = mbedtls_ssl_session_set_ticket_alpn(dst, src->ticket_alpn);
-    if (ret != 0) {
-        return ret;
+    /* A borrowed ALPN points into the decrypted ticket, which the handshake
+     * keeps: borrow it as well. */
+    if (src->borrowed) {
+        if (!dst->borrowed) {
+            mbedtls_free(dst->ticket_alpn);
+        }
+        dst->ticket_alpn = src->ticket_alpn;
+        dst->borrowed = 1;
+    } else {
+        int ret = mbedtls_ssl_session_set_ticket_alpn(dst, src->ticket_alpn);
+        if (ret != 0) {
+            return ret;
+        }
     }
 #endif /* MBEDTLS_SSL_ALPN */
 #endif /* MBEDTLS_SSL_EARLY_DATA*/
@@ -638,6 +669,9 @@ static int ssl_tls13_parse_pre_shared_key_ext(
 
         if (psk->key_exchange_mode == MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_NONE) {
             MBEDTLS_SSL_DEBUG_MSG(3, ("No suitable PSK key exchange mode"));
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+            mbedtls_ssl_session_free(&session);
+#endif
             continue;
         }
 
@@ -1209,6 +1243,71 @@ static int ssl_tls13_pick_key_cert(mbedtls_ssl_context *ssl)
  *
  */
 
+/*
+ * Parsers of the ClientHello extensions, by internal extension identifier.
+ * They are called in the order of the extensions in the message, after the
+ * extensions have been indexed. The pre_shared_key extension is parsed last,
+ * once the cipher suite is known.
+ */
+typedef int (*ssl_tls13_ext_parser_t)(mbedtls_ssl_context *ssl,
+                                      const unsigned char *buf,
+                                      const unsigned char *end);
+
+static const struct {
+    ssl_tls13_ext_parser_t parse;
+    const char *name;
+} ssl_tls13_client_hello_ext_parsers[
+    MBEDTLS_SSL_EXT_ID_COMPRESS_CERTIFICATE + 1] = {
+#if defined(MBEDTLS_SSL_SERVER_NAME_INDICATION)
+    [MBEDTLS_SSL_EXT_ID_SERVERNAME] = {
+        mbedtls_ssl_parse_server_name_ext,
+        "mbedtls_ssl_parse_servername_ext"
+    },
+#endif
+#if defined(PSA_WANT_ALG_ECDH) || defined(PSA_WANT_ALG_FFDH)
+    [MBEDTLS_SSL_EXT_ID_SUPPORTED_GROUPS] = {
+        ssl_tls13_parse_supported_groups_ext,
+        "ssl_tls13_parse_supported_groups_ext"
+    },
+#endif
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED)
+    [MBEDTLS_SSL_EXT_ID_KEY_SHARE] = {
+        ssl_tls13_parse_key_shares_ext,
+        "ssl_tls13_parse_key_shares_ext"
+    },
+#endif
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_PSK_ENABLED)
+    [MBEDTLS_SSL_EXT_ID_PSK_KEY_EXCHANGE_MODES] = {
+        ssl_tls13_parse_key_exchange_modes_ext,
+        "ssl_tls13_parse_key_exchange_modes_ext"
+    },
+#endif
+#if defined(MBEDTLS_SSL_ALPN)
+    [MBEDTLS_SSL_EXT_ID_ALPN] = {
+        mbedtls_ssl_parse_alpn_ext,
+        "mbedtls_ssl_parse_alpn_ext"
+    },
+#endif
+#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED)
+    [MBEDTLS_SSL_EXT_ID_SIG_ALG] = {
+        mbedtls_ssl_parse_sig_alg_ext,
+        "mbedtls_ssl_parse_sig_alg_ext"
+    },
+#endif
+#if defined(MBEDTLS_SSL_RECORD_SIZE_LIMIT)
+    [MBEDTLS_SSL_EXT_ID_RECORD_SIZE_LIMIT] = {
+        mbedtls_ssl_tls13_parse_record_size_limit_ext,
+        "mbedtls_ssl_tls13_parse_record_size_limit_ext"
+    },
+#endif
+#if defined(MBEDTLS_SSL_TLS1_3_CERT_COMPRESSION)
+    [MBEDTLS_SSL_EXT_ID_COMPRESS_CERTIFICATE] = {
+        mbedtls_ssl_tls13_parse_compress_certificate_ext,
+        "mbedtls_ssl_tls13_parse_compress_certificate_ext"
+    },
+#endif
+};
+
 /*
  * Structure of this message:
  *
@@ -1243,10 +1342,11 @@ static int ssl_tls13_parse_client_hello(mbedtls_ssl_context *ssl,
     size_t cipher_suites_len;
     const unsigned char *cipher_suites;
     const unsigned char *cipher_suites_end;
-    size_t extensions_len;
-    const unsigned char *extensions_end;
+    mbedtls_ssl_tls13_ext_index ext_index;
     const unsigned char *supported_versions_data;
     const unsigned char *supported_versions_data_end;
+    uint32_t allowed_exts = MBEDTLS_SSL_TLS1_3_ALLOWED_EXTS_OF_CH;
+    size_t i;
     mbedtls_ssl_handshake_params *handshake = ssl->handshake;
     int hrr_required = 0;
     int no_usable_share_for_key_agreement = 0;
@@ -1351,43 +1451,51 @@ static int ssl_tls13_parse_client_hello(mbedtls_ssl_context *ssl,
      */
     MBEDTLS_SSL_CHK_BUF_READ_PTR(p + 1, end, p[0] + 2);
 
-    /*
-     * Search for the supported versions extension and parse it to determine
-     * if the client supports TLS 1.3.
+    /* ...
+     * Extension extensions<8..2^16-1>;
+     * ...
+     * with Extension defined as:
+     * struct {
+     *    ExtensionType extension_type;
+     *    opaque extension_data<0..2^16-1>;
+     * } Extension;
+     *
+     * Index the extensions in a single pass, then look for the supported
+     * versions extension and parse it to determine if the client supports
+     * TLS 1.3.
      */
-    ret = mbedtls_ssl_tls13_is_supported_versions_ext_present_in_exts(
-        ssl, p + 1 + p[0], end,
-        &supported_versions_data, &supported_versions_data_end);
-    if (ret < 0) {
-        MBEDTLS_SSL_DEBUG_RET(1,
-                              ("mbedtls_ssl_tls13_is_supported_versions_ext_present_in_exts"), ret);
+    ret = mbedtls_ssl_tls13_index_extensions(ssl, MBEDTLS_SSL_HS_CLIENT_HELLO,
+                                             p + 1 + p[0], end, &ext_index);
+    if (ret != 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_tls13_index_extensions", ret);
         return ret;
     }
 
-    if (ret == 0) {
+    if (!mbedtls_ssl_tls13_ext_index_get(&ext_index,
+                                         MBEDTLS_SSL_EXT_ID_SUPPORTED_VERSIONS,
+                                         &supported_versions_data,
+                                         &supported_versions_data_end)) {
         return SSL_CLIENT_HELLO_TLS1_2;
     }
 
-    if (ret == 1) {
-        ret = ssl_tls13_parse_supported_versions_ext(ssl,
-                                                     supported_versions_data,
-                                                     supported_versions_data_end);
-        if (ret < 0) {
-            MBEDTLS_SSL_DEBUG_RET(1,
-                                  ("ssl_tls13_parse_supported_versions_ext"), ret);
-            return ret;
-        }
+    ret = ssl_tls13_parse_supported_versions_ext(ssl,
+                                                 supported_versions_data,
+                                                 supported_versions_data_end);
+    if (ret < 0) {
+        MBEDTLS_SSL_DEBUG_RET(1,
+                              ("ssl_tls13_parse_supported_versions_ext"), ret);
+        return ret;
+    }
 
-        /*
-         * The supported versions extension was parsed successfully as the
-         * value returned by ssl_tls13_parse_supported_versions_ext() is
-         * positive. The return value is then equal to
-         * MBEDTLS_SSL_VERSION_TLS1_2 or MBEDTLS_SSL_VERSION_TLS1_3, defining
-         * the TLS version to negotiate.
-         */
-        if (MBEDTLS_SSL_VERSION_TLS1_2 == ret) {
-            return SSL_CLIENT_HELLO_TLS1_2;
-        }
+    /*
+     * The supported versions extension was parsed successfully as the
+     * value returned by ssl_tls13_parse_supported_versions_ext() is
+     * positive. The return value is then equal to
+     * MBEDTLS_SSL_VERSION_TLS1_2 or MBEDTLS_SSL_VERSION_TLS1_3, defining
+     * the TLS version to negotiate.
+     */
+    if (MBEDTLS_SSL_VERSION_TLS1_2 == ret) {
+        return SSL_CLIENT_HELLO_TLS1_2;
     }
 
     /*
@@ -1448,42 +1556,48 @@ static int ssl_tls13_parse_client_hello(mbedtls_ssl_context *ssl,
     }
     p += 2;
 
-    /* ...
-     * Extension extensions<8..2^16-1>;
-     * ...
-     * with Extension defined as:
-     * struct {
-     *    ExtensionType extension_type;
-     *    opaque extension_data<0..2^16-1>;
-     * } Extension;
-     */
-    extensions_len = MBEDTLS_GET_UINT16_BE(p, 0);
-    p += 2;
-    MBEDTLS_SSL_CHK_BUF_READ_PTR(p, end, extensions_len);
-    extensions_end = p + extensions_len;
+    MBEDTLS_SSL_DEBUG_BUF(3, "client hello extensions",
+                          ext_index.exts, ext_index.end - ext_index.exts);
 
-    MBEDTLS_SSL_DEBUG_BUF(3, "client hello extensions", p, extensions_len);
-    handshake->received_extensions = MBEDTLS_SSL_EXT_MASK_NONE;
+    if (ssl->handshake->hello_retry_request_flag) {
+        /* Do not accept early data extension in 2nd ClientHello */
+        allowed_exts &= ~MBEDTLS_SSL_EXT_MASK(EARLY_DATA);
+    }
 
-    while (p < extensions_end) {
-        unsigned int extension_type;
-        size_t extension_data_len;
-        const unsigned char *extension_data_end;
-        uint32_t allowed_exts = MBEDTLS_SSL_TLS1_3_ALLOWED_EXTS_OF_CH;
+    /* RFC 8446 section 4.2
+     *
+     * If an implementation receives an extension which it recognizes and
+     * which is not specified for the message in which it appears, it MUST
+     * abort the handshake with an "illegal_parameter" alert.
+     */
+    if ((ext_index.present & ~allowed_exts) != 0) {
+        MBEDTLS_SSL_DEBUG_MSG(3, ("illegal extension in ClientHello"));
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_ILLEGAL_PARAMETER,
+                                     MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER);
+        return MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER;
+    }
 
-        if (ssl->handshake->hello_retry_request_flag) {
-            /* Do not accept early data extension in 2nd ClientHello */
-            allowed_exts &= ~MBEDTLS_SSL_EXT_MASK(EARLY_DATA);
-        }
+    /* RFC 8446 section 4.2
+     *
+     * There MUST NOT be more than one extension of the same type in a
+     * given extension block.
+     */
+    if (ext_index.duplicated != 0) {
+        MBEDTLS_SSL_DEBUG_MSG(3, ("duplicated extension in ClientHello"));
+        MBEDTLS_SSL_PEND_FATAL_ALERT(MBEDTLS_SSL_ALERT_MSG_ILLEGAL_PARAMETER,
+                                     MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER);
+        return MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER;
+    }
 
-        /* RFC 8446, section 4.2.11
-         *
-         * The "pre_shared_key" extension MUST be the last extension in the
-         * ClientHello (this facilitates implementation as described below).
-         * Servers MUST check that it is the last extension and otherwise fail
-         * the handshake with an "illegal_parameter" alert.
-         */
-        if (handshake->received_extensions & MBEDTLS_SSL_EXT_MASK(PRE_SHARED_KEY)) {
+    /* RFC 8446, section 4.2.11
+     *
+     * The "pre_shared_key" extension MUST be the last extension in the
+     * ClientHello (this facilitates implementation as described below).
+     * Servers MUST check that it is the last extension and otherwise fail
+     * the handshake with an "illegal_parameter" alert.
+     */
+    if ((ext_index.present & MBEDTLS_SSL_EXT_MASK(PRE_SHARED_KEY)) != 0) {
+        if (ext_index.last != MBEDTLS_SSL_EXT_ID_PRE_SHARED_KEY) {
             MBEDTLS_SSL_DEBUG_MSG(
                 3, ("pre_shared_key is not last extension."));
             MBEDTLS_SSL_PEND_FATAL_ALERT(
@@ -1491,173 +1605,52 @@ static int ssl_tls13_parse_client_hello(mbedtls_ssl_context *ssl,
                 MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER);
             return MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER;
         }
-
-        MBEDTLS_SSL_CHK_BUF_READ_PTR(p, extensions_end, 4);
-        extension_type = MBEDTLS_GET_UINT16_BE(p, 0);
-        extension_data_len = MBEDTLS_GET_UINT16_BE(p, 2);
-        p += 4;
-
-        MBEDTLS_SSL_CHK_BUF_READ_PTR(p, extensions_end, extension_data_len);
-        extension_data_end = p + extension_data_len;
-
-        ret = mbedtls_ssl_tls13_check_received_extension(
-            ssl, MBEDTLS_SSL_HS_CLIENT_HELLO, extension_type,
-            allowed_exts);
-        if (ret != 0) {
-            return ret;
+        if ((ext_index.present &
+             MBEDTLS_SSL_EXT_MASK(PSK_KEY_EXCHANGE_MODES)) == 0) {
+            MBEDTLS_SSL_PEND_FATAL_ALERT(
+                MBEDTLS_SSL_ALERT_MSG_ILLEGAL_PARAMETER,
+                MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER);
+            return MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER;
         }
+    }
 
-        switch (extension_type) {
-#if defined(MBEDTLS_SSL_SERVER_NAME_INDICATION)
-            case MBEDTLS_TLS_EXT_SERVERNAME:
-                MBEDTLS_SSL_DEBUG_MSG(3, ("found ServerName extension"));
-                ret = mbedtls_ssl_parse_server_name_ext(ssl, p,
-                                                        extension_data_end);
-                if (ret != 0) {
-                    MBEDTLS_SSL_DEBUG_RET(
-                        1, "mbedtls_ssl_parse_servername_ext", ret);
-                    return ret;
-                }
-                break;
-#endif /* MBEDTLS_SSL_SERVER_NAME_INDICATION */
-
-#if defined(PSA_WANT_ALG_ECDH) || defined(PSA_WANT_ALG_FFDH)
-            case MBEDTLS_TLS_EXT_SUPPORTED_GROUPS:
-                MBEDTLS_SSL_DEBUG_MSG(3, ("found supported group extension"));
-
-                /* Supported Groups Extension
-                 *
-                 * When sent by the client, the "supported_groups" extension
-                 * indicates the named groups which the client supports,
-                 * ordered from most preferred to least preferred.
-                 */
-                ret = ssl_tls13_parse_supported_groups_ext(
-                    ssl, p, extension_data_end);
-                if (ret != 0) {
-                    MBEDTLS_SSL_DEBUG_RET(
-                        1, "ssl_tls13_parse_supported_groups_ext", ret);
-                    return ret;
-                }
-
-                break;
-#endif /* PSA_WANT_ALG_ECDH || PSA_WANT_ALG_FFDH*/
-
-#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED)
-            case MBEDTLS_TLS_EXT_KEY_SHARE:
-                MBEDTLS_SSL_DEBUG_MSG(3, ("found key share extension"));
-
-                /*
-                 * Key Share Extension
-                 *
-                 * When sent by the client, the "key_share" extension
-                 * contains the endpoint's cryptographic parameters for
-                 * ECDHE/DHE key establishment methods.
-                 */
-                ret = ssl_tls13_parse_key_shares_ext(
-                    ssl, p, extension_data_end);
-                if (ret == SSL_TLS1_3_PARSE_KEY_SHARES_EXT_NO_MATCH) {
-                    MBEDTLS_SSL_DEBUG_MSG(2, ("No usable share for key agreement."));
-                    no_usable_share_for_key_agreement = 1;
-                }
-
-                if (ret < 0) {
-                    MBEDTLS_SSL_DEBUG_RET(
-                        1, "ssl_tls13_parse_key_shares_ext", ret);
-                    return ret;
-                }
-
-                break;
-#endif /* MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED */
+    handshake->received_extensions = ext_index.present;
 
-            case MBEDTLS_TLS_EXT_SUPPORTED_VERSIONS:
-                /* Already parsed */
-                break;
+    for (i = 0; i < ext_index.count; i++) {
+        uint32_t id = ext_index.order[i];
+        const unsigned char *extension_data;
+        const unsigned char *extension_data_end;
 
-#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_PSK_ENABLED)
-            case MBEDTLS_TLS_EXT_PSK_KEY_EXCHANGE_MODES:
-                MBEDTLS_SSL_DEBUG_MSG(
-                    3, ("found psk key exchange modes extension"));
-
-                ret = ssl_tls13_parse_key_exchange_modes_ext(
-                    ssl, p, extension_data_end);
-                if (ret != 0) {
-                    MBEDTLS_SSL_DEBUG_RET(
-                        1, "ssl_tls13_parse_key_exchange_modes_ext", ret);
-                    return ret;
-                }
+        if (ssl_tls13_client_hello_ext_parsers[id].parse == NULL) {
+            continue;
+        }
 
-                break;
-#endif
+        (void) mbedtls_ssl_tls13_ext_index_get(&ext_index, id,
+                                               &extension_data,
+                                               &extension_data_end);
+        ret = ssl_tls13_client_hello_ext_parsers[id].parse(
+            ssl, extension_data, extension_data_end);
+        if (ret == SSL_TLS1_3_PARSE_KEY_SHARES_EXT_NO_MATCH) {
+            MBEDTLS_SSL_DEBUG_MSG(2, ("No usable share for key agreement."));
+            no_usable_share_for_key_agreement = 1;
+        } else if (ret != 0) {
+            MBEDTLS_SSL_DEBUG_RET(
+                1, ssl_tls13_client_hello_ext_parsers[id].name, ret);
+            return ret;
+        }
+    }
 
-            case MBEDTLS_TLS_EXT_PRE_SHARED_KEY:
-                MBEDTLS_SSL_DEBUG_MSG(3, ("found pre_shared_key extension"));
-                if ((handshake->received_extensions &
-                     MBEDTLS_SSL_EXT_MASK(PSK_KEY_EXCHANGE_MODES)) == 0) {
-                    MBEDTLS_SSL_PEND_FATAL_ALERT(
-                        MBEDTLS_SSL_ALERT_MSG_ILLEGAL_PARAMETER,
-                        MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER);
-                    return MBEDTLS_ERR_SSL_ILLEGAL_PARAMETER;
-                }
 #if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_PSK_ENABLED)
-                /* Delay processing of the PSK identity once we have
-                 * found out which algorithms to use. We keep a pointer
-                 * to the buffer and the size for later processing.
-                 */
-                pre_shared_key_ext = p;
-                pre_shared_key_ext_end = extension_data_end;
+    /* Delay processing of the PSK identity once we have found out which
+     * algorithms to use.
+     */
+    (void) mbedtls_ssl_tls13_ext_index_get(&ext_index,
+                                           MBEDTLS_SSL_EXT_ID_PRE_SHARED_KEY,
+                                           &pre_shared_key_ext,
+                                           &pre_shared_key_ext_end);
 #endif /* MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_PSK_ENABLED */
-                break;
 
-#if defined(MBEDTLS_SSL_ALPN)
-            case MBEDTLS_TLS_EXT_ALPN:
-                MBEDTLS_SSL_DEBUG_MSG(3, ("found alpn extension"));
-
-                ret = mbedtls_ssl_parse_alpn_ext(ssl, p, extension_data_end);
-                if (ret != 0) {
-                    MBEDTLS_SSL_DEBUG_RET(
-                        1, ("mbedtls_ssl_parse_alpn_ext"), ret);
-                    return ret;
-                }
-                break;
-#endif /* MBEDTLS_SSL_ALPN */
-
-#if defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED)
-            case MBEDTLS_TLS_EXT_SIG_ALG:
-                MBEDTLS_SSL_DEBUG_MSG(3, ("found signature_algorithms extension"));
-
-                ret = mbedtls_ssl_parse_sig_alg_ext(
-                    ssl, p, extension_data_end);
-                if (ret != 0) {
-                    MBEDTLS_SSL_DEBUG_RET(
-                        1, "mbedtls_ssl_parse_sig_alg_ext", ret);
-                    return ret;
-                }
-                break;
-#endif /* MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED */
-
-#if defined(MBEDTLS_SSL_RECORD_SIZE_LIMIT)
-            case MBEDTLS_TLS_EXT_RECORD_SIZE_LIMIT:
-                MBEDTLS_SSL_DEBUG_MSG(3, ("found record_size_limit extension"));
-
-                ret = mbedtls_ssl_tls13_parse_record_size_limit_ext(
-                    ssl, p, extension_data_end);
-                if (ret != 0) {
-                    MBEDTLS_SSL_DEBUG_RET(
-                        1, ("mbedtls_ssl_tls13_parse_record_size_limit_ext"), ret);
-                    return ret;
-                }
-                break;
-#endif /* MBEDTLS_SSL_RECORD_SIZE_LIMIT */
-
-            default:
-                MBEDTLS_SSL_PRINT_EXT(
-                    3, MBEDTLS_SSL_HS_CLIENT_HELLO,
-                    extension_type, "( ignored )");
-                break;
-        }
-
-        p += extension_data_len;
-    }
+    p = ext_index.end;
 
     MBEDTLS_SSL_PRINT_EXTS(3, MBEDTLS_SSL_HS_CLIENT_HELLO,
                            handshake->received_extensions);
@@ -2390,6 +2383,41 @@ static int ssl_tls13_finalize_server_hello(mbedtls_ssl_context *ssl)
     return ret;
 }
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO) && \
+    defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED)
+/*
+ * With asynchronous crypto callbacks, the (EC)DHE shared secret is computed
+ * while the ServerHello may still be rewritten, so that the key schedule in
+ * ssl_tls13_finalize_server_hello() does not have to wait for it.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_tls13_prepare_shared_secret(mbedtls_ssl_context *ssl)
+{
+    mbedtls_ssl_handshake_params *handshake = ssl->handshake;
+    uint16_t group = handshake->offered_group_id;
+    psa_algorithm_t alg;
+
+    if (!mbedtls_ssl_tls13_key_exchange_mode_with_ephemeral(ssl)) {
+        return 0;
+    }
+
+    if (mbedtls_ssl_tls13_named_group_is_ecdhe(group)) {
+        alg = PSA_ALG_ECDH;
+    } else if (mbedtls_ssl_tls13_named_group_is_ffdh(group)) {
+        alg = PSA_ALG_FFDH;
+    } else {
+        return 0;
+    }
+
+    return mbedtls_ssl_async_key_agreement(ssl, alg,
+                                           handshake->xxdh_psa_privkey,
+                                           handshake->xxdh_psa_peerkey,
+                                           handshake->xxdh_psa_peerkey_len,
+                                           NULL, NULL);
+}
+#endif /* MBEDTLS_SSL_ASYNC_CRYPTO &&
+          MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED */
+
 MBEDTLS_CHECK_RETURN_CRITICAL
 static int ssl_tls13_write_server_hello(mbedtls_ssl_context *ssl)
 {
@@ -2409,6 +2437,13 @@ static int ssl_tls13_write_server_hello(mbedtls_ssl_context *ssl)
                                                            &msg_len,
                                                            0));
 
+#if defined(MBEDTLS_SSL_ASYNC_CRYPTO) && \
+    defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED)
+    /* Until this returns 0, the whole message is rewritten on each call,
+     * reusing the key share generated by the first one. */
+    MBEDTLS_SSL_PROC_CHK(ssl_tls13_prepare_shared_secret(ssl));
+#endif
+
     MBEDTLS_SSL_PROC_CHK(mbedtls_ssl_add_hs_msg_to_checksum(
                              ssl, MBEDTLS_SSL_HS_SERVER_HELLO, buf, msg_len));
 
@@ -2589,8 +2624,11 @@ static int ssl_tls13_write_encrypted_extensions(mbedtls_ssl_context *ssl)
     unsigned char *buf;
     size_t buf_len, msg_len;
 
-    mbedtls_ssl_set_outbound_transform(ssl,
-                                       ssl->handshake->transform_handshake);
+    ret = mbedtls_ssl_set_outbound_transform(ssl,
+                                             ssl->handshake->transform_handshake);
+    if (ret != 0) {
+        return ret;
+    }
     MBEDTLS_SSL_DEBUG_MSG(
         3, ("switching to handshake transform for outbound data"));
 
@@ -3075,9 +3113,14 @@ static int ssl_tls13_process_client_finished(mbedtls_ssl_context *ssl)
 MBEDTLS_CHECK_RETURN_CRITICAL
 static int ssl_tls13_handshake_wrapup(mbedtls_ssl_context *ssl)
 {
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+
     MBEDTLS_SSL_DEBUG_MSG(2, ("handshake: done"));
 
-    mbedtls_ssl_tls13_handshake_wrapup(ssl);
+    ret = mbedtls_ssl_tls13_handshake_wrapup(ssl);
+    if (ret != 0) {
+        return ret;
+    }
 
 #if defined(MBEDTLS_SSL_SESSION_TICKETS) && \
     defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_PSK_ENABLED)
@@ -3087,8 +3130,16 @@ static int ssl_tls13_handshake_wrapup(mbedtls_ssl_context *ssl)
  */
     /* Sent NewSessionTicket message only when client supports PSK */
     if (mbedtls_ssl_tls13_is_some_psk_supported(ssl)) {
-        mbedtls_ssl_handshake_set_state(
-            ssl, MBEDTLS_SSL_TLS1_3_NEW_SESSION_TICKET);
+        if (ssl->conf->new_session_tickets_mode ==
+            MBEDTLS_SSL_NEW_SESSION_TICKETS_DEFERRED) {
+            /* Sent by mbedtls_ssl_send_new_session_tickets() */
+            MBEDTLS_SSL_DEBUG_MSG(2, ("NewSessionTicket: deferred"));
+            ssl->handshake->new_session_tickets_deferred = 1;
+            mbedtls_ssl_handshake_set_state(ssl, MBEDTLS_SSL_HANDSHAKE_OVER);
+        } else {
+            mbedtls_ssl_handshake_set_state(
+                ssl, MBEDTLS_SSL_TLS1_3_NEW_SESSION_TICKET);
+        }
     } else
 #endif
     {
@@ -0,0 +1,344 @@
+/*
+ *  Cache of verified peer certificate chains
+ *
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+
+#include "ssl_misc.h"
+
+#if defined(MBEDTLS_SSL_VERIFY_CACHE_C)
+
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/ssl_verify_cache.h"
+#include "mbedtls/error.h"
+#include "psa_util_internal.h"
+
+#include <string.h>
+
+void mbedtls_ssl_verify_cache_init(mbedtls_ssl_verify_cache *cache)
+{
+    memset(cache, 0, sizeof(mbedtls_ssl_verify_cache));
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_init(&cache->mutex);
+#endif
+}
+
+int mbedtls_ssl_verify_cache_setup(mbedtls_ssl_verify_cache *cache,
+                                   size_t size)
+{
+    mbedtls_ssl_verify_cache_entry *entries;
+
+    if (cache->entries != NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (size == 0) {
+        size = MBEDTLS_SSL_VERIFY_CACHE_DEFAULT_SIZE;
+    }
+
+    entries = mbedtls_calloc(size, sizeof(mbedtls_ssl_verify_cache_entry));
+    if (entries == NULL) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&cache->mutex) != 0) {
+        mbedtls_free(entries);
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    cache->entries = entries;
+    cache->size = size;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_unlock(&cache->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    return 0;
+}
+
+/* Hash a DER object prefixed with its length. */
+static psa_status_t ssl_verify_cache_hash_buf(psa_hash_operation_t *operation,
+                                              const mbedtls_x509_buf *buf)
+{
+    psa_status_t status;
+    unsigned char len[4];
+
+    MBEDTLS_PUT_UINT32_BE(buf->len, len, 0);
+    status = psa_hash_update(operation, len, sizeof(len));
+    if (status == PSA_SUCCESS) {
+        status = psa_hash_update(operation, buf->p, buf->len);
+    }
+
+    return status;
+}
+
+/*
+ * Hash the DER encoding of the certificates of a chain.
+ */
+static int ssl_verify_cache_digest(const mbedtls_x509_crt *chain,
+                                   unsigned char *digest)
+{
+    psa_status_t status;
+    psa_hash_operation_t operation = PSA_HASH_OPERATION_INIT;
+    const mbedtls_x509_crt *crt;
+    size_t digest_len;
+
+    status = psa_hash_setup(&operation, PSA_ALG_SHA_256);
+    for (crt = chain; status == PSA_SUCCESS && crt != NULL; crt = crt->next) {
+        status = ssl_verify_cache_hash_buf(&operation, &crt->raw);
+    }
+    if (status == PSA_SUCCESS) {
+        status = psa_hash_finish(&operation, digest,
+                                 MBEDTLS_SSL_VERIFY_CACHE_DIGEST_LEN,
+                                 &digest_len);
+    }
+    psa_hash_abort(&operation);
+
+    return PSA_TO_MBEDTLS_ERR(status);
+}
+
+/*
+ * Whether a trusted certificate can anchor the chain: it issued one of the
+ * certificates of the chain, or it is one of them.
+ */
+static int ssl_verify_cache_is_anchor(const mbedtls_x509_crt *ca,
+                                      const mbedtls_x509_crt *chain)
+{
+    const mbedtls_x509_crt *crt;
+
+    for (crt = chain; crt != NULL; crt = crt->next) {
+        if ((crt->issuer_raw.len == ca->subject_raw.len &&
+             memcmp(crt->issuer_raw.p, ca->subject_raw.p,
+                    ca->subject_raw.len) == 0) ||
+            (crt->raw.len == ca->raw.len &&
+             memcmp(crt->raw.p, ca->raw.p, ca->raw.len) == 0)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Hash what the verification of a chain depended on besides the chain
+ * itself: the trusted certificates that can anchor it, the CRLs and the
+ * profile. Entries are keyed on the contents rather than on the addresses
+ * of these objects, which may be reused for other ones once freed.
+ *
+ * If valid_to is not NULL, it is lowered to the earliest expiry of the
+ * anchors.
+ */
+static int ssl_verify_cache_trust_digest(const mbedtls_x509_crt *chain,
+                                         const mbedtls_x509_crt *ca_chain,
+                                         const mbedtls_x509_crl *ca_crl,
+                                         const mbedtls_x509_crt_profile *profile,
+                                         unsigned char *digest,
+                                         const mbedtls_x509_time **valid_to)
+{
+    psa_status_t status;
+    psa_hash_operation_t operation = PSA_HASH_OPERATION_INIT;
+    const mbedtls_x509_crt *ca;
+    const mbedtls_x509_crl *crl;
+    unsigned char buf[16];
+    size_t digest_len;
+
+    status = psa_hash_setup(&operation, PSA_ALG_SHA_256);
+    for (ca = ca_chain; status == PSA_SUCCESS && ca != NULL; ca = ca->next) {
+        if (ca->raw.len == 0 || !ssl_verify_cache_is_anchor(ca, chain)) {
+            continue;
+        }
+        status = ssl_verify_cache_hash_buf(&operation, &ca->raw);
+        if (valid_to != NULL &&
+            mbedtls_x509_time_cmp(&ca->valid_to, *valid_to) < 0) {
+            *valid_to = &ca->valid_to;
+        }
+    }
+    for (crl = ca_crl; status == PSA_SUCCESS && crl != NULL; crl = crl->next) {
+        status = ssl_verify_cache_hash_buf(&operation, &crl->raw);
+    }
+    if (status == PSA_SUCCESS && profile != NULL) {
+        MBEDTLS_PUT_UINT32_BE(profile->allowed_mds, buf, 0);
+        MBEDTLS_PUT_UINT32_BE(profile->allowed_pks, buf, 4);
+        MBEDTLS_PUT_UINT32_BE(profile->allowed_curves, buf, 8);
+        MBEDTLS_PUT_UINT32_BE(profile->rsa_min_bitlen, buf, 12);
+        status = psa_hash_update(&operation, buf, sizeof(buf));
+    }
+    if (status == PSA_SUCCESS) {
+        status = psa_hash_finish(&operation, digest,
+                                 MBEDTLS_SSL_VERIFY_CACHE_DIGEST_LEN,
+                                 &digest_len);
+    }
+    psa_hash_abort(&operation);
+
+    return PSA_TO_MBEDTLS_ERR(status);
+}
+
+static mbedtls_ssl_verify_cache_entry *ssl_verify_cache_slot(
+    mbedtls_ssl_verify_cache *cache, const unsigned char *digest)
+{
+    return &cache->entries[MBEDTLS_GET_UINT32_BE(digest, 0) % cache->size];
+}
+
+int mbedtls_ssl_verify_cache_get(mbedtls_ssl_verify_cache *cache,
+                                 const mbedtls_x509_crt *chain,
+                                 const mbedtls_x509_crt *ca_chain,
+                                 const mbedtls_x509_crl *ca_crl,
+                                 const mbedtls_x509_crt_profile *profile)
+{
+    int ret = MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    unsigned char digest[MBEDTLS_SSL_VERIFY_CACHE_DIGEST_LEN];
+    unsigned char trust_digest[MBEDTLS_SSL_VERIFY_CACHE_DIGEST_LEN];
+    mbedtls_ssl_verify_cache_entry *entry;
+
+    if (cache->size == 0 || ssl_verify_cache_digest(chain, digest) != 0 ||
+        ssl_verify_cache_trust_digest(chain, ca_chain, ca_crl, profile,
+                                      trust_digest, NULL) != 0) {
+        return MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&cache->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    entry = ssl_verify_cache_slot(cache, digest);
+    if (entry->in_use &&
+        memcmp(entry->digest, digest, sizeof(digest)) == 0 &&
+        memcmp(entry->trust_digest, trust_digest, sizeof(trust_digest)) == 0 &&
+        entry->trust_version == cache->trust_version) {
+        if (mbedtls_x509_time_is_past(&entry->valid_to)) {
+            entry->in_use = 0;
+        } else {
+            ret = 0;
+        }
+    }
+
+    if (ret == 0) {
+        cache->hits++;
+    } else {
+        cache->misses++;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_unlock(&cache->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    return ret;
+}
+
+int mbedtls_ssl_verify_cache_set(mbedtls_ssl_verify_cache *cache,
+                                 const mbedtls_x509_crt *chain,
+                                 const mbedtls_x509_crt *ca_chain,
+                                 const mbedtls_x509_crl *ca_crl,
+                                 const mbedtls_x509_crt_profile *profile)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    unsigned char digest[MBEDTLS_SSL_VERIFY_CACHE_DIGEST_LEN];
+    unsigned char trust_digest[MBEDTLS_SSL_VERIFY_CACHE_DIGEST_LEN];
+    mbedtls_ssl_verify_cache_entry *entry;
+    const mbedtls_x509_crt *crt;
+    const mbedtls_x509_time *valid_to = &chain->valid_to;
+
+    if (cache->size == 0) {
+        return 0;
+    }
+
+    /* The entry is not valid beyond the first expiry in the chain, trust
+     * anchor included. */
+    for (crt = chain->next; crt != NULL; crt = crt->next) {
+        if (mbedtls_x509_time_cmp(&crt->valid_to, valid_to) < 0) {
+            valid_to = &crt->valid_to;
+        }
+    }
+
+    if ((ret = ssl_verify_cache_digest(chain, digest)) != 0 ||
+        (ret = ssl_verify_cache_trust_digest(chain, ca_chain, ca_crl, profile,
+                                             trust_digest, &valid_to)) != 0) {
+        return ret;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    if ((ret = mbedtls_mutex_lock(&cache->mutex)) != 0) {
+        return ret;
+    }
+#endif
+
+    entry = ssl_verify_cache_slot(cache, digest);
+    memcpy(entry->digest, digest, sizeof(digest));
+    memcpy(entry->trust_digest, trust_digest, sizeof(trust_digest));
+    entry->trust_version = cache->trust_version;
+    entry->valid_to = *valid_to;
+    entry->in_use = 1;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_unlock(&cache->mutex) != 0) {
+        return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    return 0;
+}
+
+void mbedtls_ssl_verify_cache_set_trust_version(mbedtls_ssl_verify_cache *cache,
+                                                uint32_t version)
+{
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&cache->mutex) != 0) {
+        return;
+    }
+#endif
+
+    cache->trust_version = version;
+
+#if defined(MBEDTLS_THREADING_C)
+    (void) mbedtls_mutex_unlock(&cache->mutex);
+#endif
+}
+
+void mbedtls_ssl_verify_cache_get_stats(mbedtls_ssl_verify_cache *cache,
+                                        size_t *hits, size_t *misses)
+{
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_lock(&cache->mutex) != 0) {
+        return;
+    }
+#endif
+
+    if (hits != NULL) {
+        *hits = cache->hits;
+    }
+    if (misses != NULL) {
+        *misses = cache->misses;
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    (void) mbedtls_mutex_unlock(&cache->mutex);
+#endif
+}
+
+void mbedtls_ssl_verify_cache_free(mbedtls_ssl_verify_cache *cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+
+    mbedtls_free(cache->entries);
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_free(&cache->mutex);
+#endif
+
+    mbedtls_platform_zeroize(cache, sizeof(mbedtls_ssl_verify_cache));
+}
+
+#endif /* MBEDTLS_SSL_VERIFY_CACHE_C */
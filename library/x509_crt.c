@@ -2950,9 +2950,9 @@ static int x509_crt_check_san(const mbedtls_x509_sequence *san,
 /*
  * Verify the requested CN - only call this if cn is not NULL!
  */
-static void x509_crt_verify_name(const mbedtls_x509_crt *crt,
-                                 const char *cn,
-                                 uint32_t *flags)
+void mbedtls_x509_crt_verify_name(const mbedtls_x509_crt *crt,
+                                  const char *cn,
+                                  uint32_t *flags)
 {
     const mbedtls_x509_name *name;
     size_t cn_len = strlen(cn);
@@ -3051,7 +3051,7 @@ static int x509_crt_verify_restartable_ca_cb(mbedtls_x509_crt *crt,
 
     /* check name if requested */
     if (cn != NULL) {
-        x509_crt_verify_name(crt, cn, &ee_flags);
+        mbedtls_x509_crt_verify_name(crt, cn, &ee_flags);
     }
 
     /* Check the type and size of the key */
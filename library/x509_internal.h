@@ -84,4 +84,14 @@ int mbedtls_x509_info_key_usage(char **buf, size_t *size,
 int mbedtls_x509_write_set_san_common(mbedtls_asn1_named_data **extensions,
                                       const mbedtls_x509_san_list *san_list);
 
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+struct mbedtls_x509_crt;
+
+/* Set MBEDTLS_X509_BADCERT_CN_MISMATCH in *flags unless the subjectAltName
+ * or CN of crt matches cn, as mbedtls_x509_crt_verify() does. */
+void mbedtls_x509_crt_verify_name(const struct mbedtls_x509_crt *crt,
+                                  const char *cn,
+                                  uint32_t *flags);
+#endif /* MBEDTLS_X509_CRT_PARSE_C */
+
 #endif /* MBEDTLS_X509_INTERNAL_H */
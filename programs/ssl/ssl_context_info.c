@@ -61,6 +61,7 @@ int main(void)
 #define CONTEXT_CONFIG_DTLS_BADMAC_LIMIT_BIT     (1 << 1)
 #define CONTEXT_CONFIG_DTLS_ANTI_REPLAY_BIT      (1 << 2)
 #define CONTEXT_CONFIG_ALPN_BIT                  (1 << 3)
+#define CONTEXT_STREAM_BIT                       (1 << 4)
 
 #define TRANSFORM_RANDBYTE_LEN  64
 
@@ -723,7 +724,7 @@ static void print_deserialized_ssl_session(const uint8_t *ssl, uint32_t len,
  * The data structure in the buffer:
  *  // header
  *  uint8 version[3];
- *  uint8 configuration[5];
+ *  uint8 configuration[5];     // bit 4 of the last byte set for TLS
  *  // session sub-structure
  *  uint32_t session_len;
  *  opaque session<1..2^32-1>;  // see mbedtls_ssl_session_save()
@@ -742,6 +743,12 @@ static void print_deserialized_ssl_session(const uint8_t *ssl, uint32_t len,
  *  uint16 mtu;                 // DTLS: path mtu (max outgoing fragment size)
  *  uint8 alpn_chosen_len;
  *  uint8 alpn_chosen<0..2^8-1> // ALPN: negotiated application protocol
+ *  // TLS only: incoming state
+ *  uint64 in_ctr;              // Record layer: incoming sequence number
+ *  uint16 in_left;
+ *  uint8 in_partial<0..2^16-1> // bytes of a partially received record
+ *  uint16 unread_len;
+ *  uint8 unread<0..2^16-1>     // application data not read yet
  *
  * /p ssl   pointer to serialized session
  * /p len   number of bytes in the buffer
@@ -791,6 +798,9 @@ static void print_deserialized_ssl_context(const uint8_t *ssl, size_t len)
                  context_cfg_flag);
     print_if_bit("MBEDTLS_SSL_ALPN", CONTEXT_CONFIG_ALPN_BIT, context_cfg_flag);
 
+    printf("\tTransport: %s\n",
+           (CONTEXT_STREAM_BIT & context_cfg_flag) ? "TLS" : "DTLS");
+
     CHECK_SSL_END(4);
     session_len = ((uint32_t) ssl[0] << 24) |
                   ((uint32_t) ssl[1] << 16) |
@@ -908,6 +918,27 @@ static void print_deserialized_ssl_context(const uint8_t *ssl, size_t len)
         }
     }
 
+    if (CONTEXT_STREAM_BIT & context_cfg_flag) {
+        uint16_t in_left, unread_len;
+
+        CHECK_SSL_END(8 + 2);
+        printf("\tincoming record sequence no.       : ");
+        print_hex(ssl, 8, 20, "");
+        ssl += 8;
+
+        in_left = (ssl[0] << 8) | ssl[1];
+        ssl += 2;
+        CHECK_SSL_END(in_left + 2);
+        printf("\tpartially received record          : %u bytes\n", in_left);
+        ssl += in_left;
+
+        unread_len = (ssl[0] << 8) | ssl[1];
+        ssl += 2;
+        CHECK_SSL_END(unread_len);
+        printf("\tunread application data            : %u bytes\n", unread_len);
+        ssl += unread_len;
+    }
+
     if (0 != (end - ssl)) {
         printf_err("%i bytes left to analyze from context\n", (int32_t) (end - ssl));
     }
@@ -0,0 +1,484 @@
+/*
+ *  SSL server demonstration program handing established connections over
+ *  to a worker process
+ *
+ *  Copyright The Mbed TLS Contributors
+ *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
+ */
+
+#include "mbedtls/build_info.h"
+
+#include "mbedtls/platform.h"
+
+#if !defined(MBEDTLS_ENTROPY_C) || !defined(MBEDTLS_CTR_DRBG_C) ||      \
+    !defined(MBEDTLS_NET_C) || !defined(MBEDTLS_SSL_SRV_C) ||           \
+    !defined(MBEDTLS_PEM_PARSE_C) || !defined(MBEDTLS_X509_CRT_PARSE_C) || \
+    !defined(MBEDTLS_SSL_PROTO_TLS1_2) ||                               \
+    !defined(MBEDTLS_SSL_CONTEXT_SERIALIZATION)
+int main(void)
+{
+    mbedtls_printf("MBEDTLS_ENTROPY_C and/or MBEDTLS_CTR_DRBG_C and/or "
+                   "MBEDTLS_NET_C and/or MBEDTLS_SSL_SRV_C and/or "
+                   "MBEDTLS_PEM_PARSE_C and/or MBEDTLS_X509_CRT_PARSE_C and/or "
+                   "MBEDTLS_SSL_PROTO_TLS1_2 and/or "
+                   "MBEDTLS_SSL_CONTEXT_SERIALIZATION not defined.\n");
+    mbedtls_exit(0);
+}
+#elif defined(_WIN32)
+int main(void)
+{
+    mbedtls_printf("_WIN32 defined. This application requires fork() and "
+                   "Unix domain sockets to work correctly.\n");
+    mbedtls_exit(0);
+}
+#else
+
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+#include "test/certs.h"
+#include "mbedtls/x509.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/net_sockets.h"
+
+#include <string.h>
+#include <signal.h>
+#include <sys/socket.h>
+
+#if !defined(_MSC_VER) || defined(EFIX64) || defined(EFI32)
+#include <unistd.h>
+#endif
+
+#define HTTP_RESPONSE \
+    "HTTP/1.0 200 OK\r\nContent-Type: text/html\r\n\r\n" \
+    "<h2>Mbed TLS Test Server</h2>\r\n" \
+    "<p>Successful connection using: %s</p>\r\n" \
+    "<p>Handshake done by pid %d, response sent by pid %d</p>\r\n"
+
+/* Room for a serialized context: the session, and the application data
+ * that the acceptor has received but not read. */
+#define CONTEXT_BUF_LEN (MBEDTLS_SSL_IN_CONTENT_LEN + 1024)
+
+#define DEBUG_LEVEL 0
+
+
+static void my_debug(void *ctx, int level,
+                     const char *file, int line,
+                     const char *str)
+{
+    ((void) level);
+
+    mbedtls_fprintf((FILE *) ctx, "%s:%04d: %s", file, line, str);
+    fflush((FILE *) ctx);
+}
+
+/*
+ * Worker: take over connections from the acceptor and answer them.
+ */
+static int run_worker(mbedtls_net_context *channel, mbedtls_ssl_config *conf)
+{
+    int ret = 1, len;
+    int pid = getpid();
+    mbedtls_net_context client_fd;
+    mbedtls_ssl_context ssl;
+    unsigned char buf[1024];
+    static unsigned char context_buf[CONTEXT_BUF_LEN];
+    size_t context_len;
+    int acceptor_pid = getppid();
+
+    while (1) {
+        mbedtls_net_init(&client_fd);
+        mbedtls_ssl_init(&ssl);
+
+        /*
+         * W1. Receive the connection and its serialized context
+         */
+        ret = mbedtls_net_recv_fd(channel, &client_fd, context_buf,
+                                  sizeof(context_buf), &context_len);
+        if (ret == MBEDTLS_ERR_NET_CONN_RESET) {
+            mbedtls_printf("pid %d: acceptor has gone away\n", pid);
+            ret = 0;
+            break;
+        }
+        if (ret != 0) {
+            mbedtls_printf("pid %d: mbedtls_net_recv_fd returned %d\n", pid, ret);
+            break;
+        }
+
+        /*
+         * W2. Restore the connection
+         */
+        if ((ret = mbedtls_ssl_setup(&ssl, conf)) != 0) {
+            mbedtls_printf("pid %d: mbedtls_ssl_setup returned %d\n", pid, ret);
+            break;
+        }
+
+        mbedtls_ssl_set_bio(&ssl, &client_fd, mbedtls_net_send, mbedtls_net_recv, NULL);
+
+        ret = mbedtls_ssl_context_load(&ssl, context_buf, context_len);
+        /* The serialized context must never be loaded twice. */
+        mbedtls_platform_zeroize(context_buf, context_len);
+        if (ret != 0) {
+            mbedtls_printf("pid %d: mbedtls_ssl_context_load returned %d\n",
+                           pid, ret);
+            mbedtls_net_free(&client_fd);
+            continue;
+        }
+
+        mbedtls_printf("pid %d: connection taken over\n", pid);
+        fflush(stdout);
+
+        /*
+         * W3. Read the rest of the HTTP request
+         */
+        do {
+            len = sizeof(buf) - 1;
+            memset(buf, 0, sizeof(buf));
+            ret = mbedtls_ssl_read(&ssl, buf, len);
+        } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+
+        if (ret <= 0) {
+            mbedtls_printf("pid %d: mbedtls_ssl_read returned %d\n", pid, ret);
+            goto next;
+        }
+
+        len = ret;
+        mbedtls_printf("pid %d: %d bytes read\n\n%s", pid, len, (char *) buf);
+        fflush(stdout);
+
+        /*
+         * W4. Write the 200 Response
+         */
+        len = sprintf((char *) buf, HTTP_RESPONSE,
+                      mbedtls_ssl_get_ciphersuite(&ssl), acceptor_pid, pid);
+
+        while ((ret = mbedtls_ssl_write(&ssl, buf, len)) <= 0) {
+            if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+                mbedtls_printf("pid %d: mbedtls_ssl_write returned %d\n", pid, ret);
+                goto next;
+            }
+        }
+
+        mbedtls_printf("pid %d: %d bytes written\n\n%s\n", pid, ret, (char *) buf);
+        fflush(stdout);
+
+        mbedtls_ssl_close_notify(&ssl);
+
+next:
+        mbedtls_net_free(&client_fd);
+        mbedtls_ssl_free(&ssl);
+    }
+
+    mbedtls_net_free(&client_fd);
+    mbedtls_ssl_free(&ssl);
+
+    return ret;
+}
+
+int main(void)
+{
+    int ret = 1, len, pid;
+    int exit_code = MBEDTLS_EXIT_FAILURE;
+    int channel_fds[2];
+    mbedtls_net_context listen_fd, client_fd, channel;
+    unsigned char buf[4];
+    unsigned char *context_buf = NULL;
+    size_t context_len;
+    const char *pers = "ssl_handoff_server";
+
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context ctr_drbg;
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_config conf;
+    mbedtls_x509_crt srvcert;
+    mbedtls_pk_context pkey;
+
+    mbedtls_net_init(&listen_fd);
+    mbedtls_net_init(&client_fd);
+    mbedtls_net_init(&channel);
+    mbedtls_ssl_init(&ssl);
+    mbedtls_ssl_config_init(&conf);
+    mbedtls_entropy_init(&entropy);
+    mbedtls_pk_init(&pkey);
+    mbedtls_x509_crt_init(&srvcert);
+    mbedtls_ctr_drbg_init(&ctr_drbg);
+
+    psa_status_t status = psa_crypto_init();
+    if (status != PSA_SUCCESS) {
+        mbedtls_fprintf(stderr, "Failed to initialize PSA Crypto implementation: %d\n",
+                        (int) status);
+        goto exit;
+    }
+
+    signal(SIGCHLD, SIG_IGN);
+    /* A worker that has gone away must not kill the acceptor. */
+    signal(SIGPIPE, SIG_IGN);
+
+    /*
+     * 0. Initial seeding of the RNG
+     */
+    mbedtls_printf("\n  . Initial seeding of the random generator...");
+    fflush(stdout);
+
+    if ((ret = mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy,
+                                     (const unsigned char *) pers,
+                                     strlen(pers))) != 0) {
+        mbedtls_printf(" failed!  mbedtls_ctr_drbg_seed returned %d\n\n", ret);
+        goto exit;
+    }
+
+    mbedtls_printf(" ok\n");
+
+    /*
+     * 1. Load the certificates and private RSA key
+     */
+    mbedtls_printf("  . Loading the server cert. and key...");
+    fflush(stdout);
+
+    /*
+     * This demonstration program uses embedded test certificates.
+     * Instead, you may want to use mbedtls_x509_crt_parse_file() to read the
+     * server and CA certificates, as well as mbedtls_pk_parse_keyfile().
+     */
+    ret = mbedtls_x509_crt_parse(&srvcert, (const unsigned char *) mbedtls_test_srv_crt,
+                                 mbedtls_test_srv_crt_len);
+    if (ret != 0) {
+        mbedtls_printf(" failed!  mbedtls_x509_crt_parse returned %d\n\n", ret);
+        goto exit;
+    }
+
+    ret = mbedtls_x509_crt_parse(&srvcert, (const unsigned char *) mbedtls_test_cas_pem,
+                                 mbedtls_test_cas_pem_len);
+    if (ret != 0) {
+        mbedtls_printf(" failed!  mbedtls_x509_crt_parse returned %d\n\n", ret);
+        goto exit;
+    }
+
+    ret =  mbedtls_pk_parse_key(&pkey, (const unsigned char *) mbedtls_test_srv_key,
+                                mbedtls_test_srv_key_len, NULL, 0,
+                                mbedtls_ctr_drbg_random, &ctr_drbg);
+    if (ret != 0) {
+        mbedtls_printf(" failed!  mbedtls_pk_parse_key returned %d\n\n", ret);
+        goto exit;
+    }
+
+    mbedtls_printf(" ok\n");
+
+    /*
+     * 1b. Prepare SSL configuration
+     */
+    mbedtls_printf("  . Configuring SSL...");
+    fflush(stdout);
+
+    if ((ret = mbedtls_ssl_config_defaults(&conf,
+                                           MBEDTLS_SSL_IS_SERVER,
+                                           MBEDTLS_SSL_TRANSPORT_STREAM,
+                                           MBEDTLS_SSL_PRESET_DEFAULT)) != 0) {
+        mbedtls_printf(" failed!  mbedtls_ssl_config_defaults returned %d\n\n", ret);
+        goto exit;
+    }
+
+    /* Connections can only be serialized with TLS 1.2. */
+    mbedtls_ssl_conf_max_tls_version(&conf, MBEDTLS_SSL_VERSION_TLS1_2);
+
+    mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &ctr_drbg);
+    mbedtls_ssl_conf_dbg(&conf, my_debug, stdout);
+
+    mbedtls_ssl_conf_ca_chain(&conf, srvcert.next, NULL);
+    if ((ret = mbedtls_ssl_conf_own_cert(&conf, &srvcert, &pkey)) != 0) {
+        mbedtls_printf(" failed!  mbedtls_ssl_conf_own_cert returned %d\n\n", ret);
+        goto exit;
+    }
+
+    mbedtls_printf(" ok\n");
+
+    /*
+     * 2. Start the worker, connected to us by a Unix domain socket
+     */
+    mbedtls_printf("  . Starting the worker ...");
+    fflush(stdout);
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, channel_fds) != 0) {
+        mbedtls_printf(" failed!  socketpair failed\n\n");
+        goto exit;
+    }
+
+    pid = fork();
+
+    if (pid < 0) {
+        mbedtls_printf(" failed!  fork returned %d\n\n", pid);
+        close(channel_fds[0]);
+        close(channel_fds[1]);
+        goto exit;
+    }
+
+    if (pid == 0) {
+        close(channel_fds[0]);
+        channel.fd = channel_fds[1];
+
+        if ((ret = mbedtls_ctr_drbg_reseed(&ctr_drbg,
+                                           (const unsigned char *) "worker",
+                                           6)) != 0) {
+            mbedtls_printf(" failed!  mbedtls_ctr_drbg_reseed returned %d\n\n", ret);
+            goto exit;
+        }
+
+        if (run_worker(&channel, &conf) == 0) {
+            exit_code = MBEDTLS_EXIT_SUCCESS;
+        }
+        goto exit;
+    }
+
+    close(channel_fds[1]);
+    channel.fd = channel_fds[0];
+
+    mbedtls_printf(" ok\n");
+
+    /*
+     * 3. Setup the listening TCP socket
+     */
+    mbedtls_printf("  . Bind on https://localhost:4433/ ...");
+    fflush(stdout);
+
+    if ((ret = mbedtls_net_bind(&listen_fd, NULL, "4433", MBEDTLS_NET_PROTO_TCP)) != 0) {
+        mbedtls_printf(" failed!  mbedtls_net_bind returned %d\n\n", ret);
+        goto exit;
+    }
+
+    mbedtls_printf(" ok\n");
+
+    if ((ret = mbedtls_ssl_setup(&ssl, &conf)) != 0) {
+        mbedtls_printf(" failed!  mbedtls_ssl_setup returned %d\n\n", ret);
+        goto exit;
+    }
+
+    pid = getpid();
+
+    while (1) {
+        /*
+         * 4. Wait until a client connects
+         */
+        mbedtls_net_init(&client_fd);
+
+        mbedtls_printf("  . Waiting for a remote connection ...\n");
+        fflush(stdout);
+
+        if ((ret = mbedtls_net_accept(&listen_fd, &client_fd,
+                                      NULL, 0, NULL)) != 0) {
+            mbedtls_printf(" failed!  mbedtls_net_accept returned %d\n\n", ret);
+            goto exit;
+        }
+
+        mbedtls_ssl_set_bio(&ssl, &client_fd, mbedtls_net_send, mbedtls_net_recv, NULL);
+
+        /*
+         * 5. Handshake
+         */
+        mbedtls_printf("pid %d: Performing the SSL/TLS handshake.\n", pid);
+        fflush(stdout);
+
+        while ((ret = mbedtls_ssl_handshake(&ssl)) != 0) {
+            if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+                break;
+            }
+        }
+
+        if (ret != 0) {
+            mbedtls_printf("pid %d: SSL handshake failed!  mbedtls_ssl_handshake returned %d\n\n",
+                           pid, ret);
+            goto reset;
+        }
+
+        mbedtls_printf("pid %d: SSL handshake ok\n", pid);
+
+        /*
+         * 6. Peek at the start of the request, for example to choose a
+         *    worker. The rest of it stays in the SSL context and is handed
+         *    over with it.
+         */
+        do {
+            len = sizeof(buf);
+            ret = mbedtls_ssl_read(&ssl, buf, len);
+        } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+
+        if (ret <= 0) {
+            mbedtls_printf("pid %d: mbedtls_ssl_read returned %d\n", pid, ret);
+            goto reset;
+        }
+
+        mbedtls_printf("pid %d: request starts with \"%.*s\"\n", pid, ret, (char *) buf);
+
+        /*
+         * 7. Hand the connection over to the worker. Saving the context
+         *    resets it, ready for the next connection.
+         */
+        ret = mbedtls_ssl_context_save(&ssl, NULL, 0, &context_len);
+        if (ret != MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL) {
+            mbedtls_printf("pid %d: mbedtls_ssl_context_save returned %d\n", pid, ret);
+            goto reset;
+        }
+
+        context_buf = mbedtls_calloc(1, context_len);
+        if (context_buf == NULL) {
+            mbedtls_printf("pid %d: could not allocate %u bytes\n",
+                           pid, (unsigned) context_len);
+            goto reset;
+        }
+
+        ret = mbedtls_ssl_context_save(&ssl, context_buf, context_len, &context_len);
+        if (ret != 0) {
+            mbedtls_printf("pid %d: mbedtls_ssl_context_save returned %d\n", pid, ret);
+            goto reset;
+        }
+
+        ret = mbedtls_net_send_fd(&channel, &client_fd, context_buf, context_len);
+        if (ret != 0) {
+            mbedtls_printf("pid %d: mbedtls_net_send_fd returned %d\n", pid, ret);
+            goto exit;
+        }
+
+        mbedtls_printf("pid %d: connection handed over\n", pid);
+        fflush(stdout);
+
+        /* The worker owns the connection now: close our descriptor without
+         * shutting the connection down. */
+        mbedtls_platform_zeroize(context_buf, context_len);
+        mbedtls_free(context_buf);
+        context_buf = NULL;
+        mbedtls_net_close(&client_fd);
+        continue;
+
+reset:
+        if (context_buf != NULL) {
+            mbedtls_platform_zeroize(context_buf, context_len);
+            mbedtls_free(context_buf);
+            context_buf = NULL;
+        }
+        mbedtls_net_free(&client_fd);
+        if ((ret = mbedtls_ssl_session_reset(&ssl)) != 0) {
+            mbedtls_printf(" failed!  mbedtls_ssl_session_reset returned %d\n\n", ret);
+            goto exit;
+        }
+    }
+
+exit:
+    if (context_buf != NULL) {
+        mbedtls_platform_zeroize(context_buf, context_len);
+        mbedtls_free(context_buf);
+    }
+    mbedtls_net_close(&channel);
+    mbedtls_net_free(&client_fd);
+    mbedtls_net_free(&listen_fd);
+    mbedtls_x509_crt_free(&srvcert);
+    mbedtls_pk_free(&pkey);
+    mbedtls_ssl_free(&ssl);
+    mbedtls_ssl_config_free(&conf);
+    mbedtls_ctr_drbg_free(&ctr_drbg);
+    mbedtls_entropy_free(&entropy);
+    mbedtls_psa_crypto_free();
+
+    mbedtls_exit(exit_code);
+}
+#endif /* MBEDTLS_ENTROPY_C && MBEDTLS_CTR_DRBG_C && MBEDTLS_NET_C &&
+          MBEDTLS_SSL_SRV_C && MBEDTLS_PEM_PARSE_C &&
+          MBEDTLS_X509_CRT_PARSE_C && MBEDTLS_SSL_PROTO_TLS1_2 &&
+          MBEDTLS_SSL_CONTEXT_SERIALIZATION && !_WIN32 */
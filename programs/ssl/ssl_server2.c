@@ -1269,6 +1269,18 @@ static int ssl_async_resume(mbedtls_ssl_context *ssl,
                                      config_data->f_rng, config_data->p_rng);
             break;
         case ASYNC_OP_SIGN:
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3)
+            /* TLS 1.3 only allows RSA-PSS signatures with RSA keys. */
+            if (mbedtls_ssl_get_version_number(ssl) == MBEDTLS_SSL_VERSION_TLS1_3 &&
+                mbedtls_pk_get_type(key_slot->pk) == MBEDTLS_PK_RSA) {
+                ret = mbedtls_pk_sign_ext(MBEDTLS_PK_RSASSA_PSS, key_slot->pk,
+                                          ctx->md_alg,
+                                          ctx->input, ctx->input_len,
+                                          output, output_size, output_len,
+                                          config_data->f_rng, config_data->p_rng);
+                break;
+            }
+#endif /* MBEDTLS_SSL_PROTO_TLS1_3 */
             ret = mbedtls_pk_sign(key_slot->pk,
                                   ctx->md_alg,
                                   ctx->input, ctx->input_len,
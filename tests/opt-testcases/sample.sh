@@ -218,6 +218,21 @@ run_test    "Sample: ssl_client1 with ssl_fork_server" \
             -S "error" \
             -C "error"
 
+requires_protocol_version tls12
+requires_config_enabled MBEDTLS_SSL_CONTEXT_SERIALIZATION
+run_test    "Sample: ssl_handoff_server, ssl_client2" \
+            -P 4433 \
+            "$PROGRAMS_DIR/ssl_handoff_server" \
+            "$PROGRAMS_DIR/ssl_client2" \
+            0 \
+            -s "connection taken over" \
+            -s "[1-9][0-9]* bytes read" \
+            -s "[1-9][0-9]* bytes written" \
+            -c "[1-9][0-9]* bytes read" \
+            -c "Handshake done by pid [0-9]*, response sent by pid [0-9]*" \
+            -S "error" \
+            -C "error"
+
 requires_protocol_version tls12
 run_test    "Sample: ssl_fork_server, openssl client, TLS 1.2" \
             -P 4433 \
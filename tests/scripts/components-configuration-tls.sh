@@ -242,6 +242,20 @@ component_test_small_mbedtls_ssl_dtls_max_buffering () {
     tests/ssl-opt.sh -f "DTLS reordering: Buffer encrypted Finished message, drop for fragmented NewSessionTicket"
 }
 
+component_test_ssl_handshake_arena_memory_accounting () {
+    msg "build: MBEDTLS_SSL_HANDSHAKE_ARENA and MBEDTLS_SSL_MEMORY_ACCOUNTING enabled (ASan build)"
+    scripts/config.py set MBEDTLS_SSL_HANDSHAKE_ARENA
+    scripts/config.py set MBEDTLS_SSL_MEMORY_ACCOUNTING
+    CC=$ASAN_CC cmake -D CMAKE_BUILD_TYPE:String=Asan .
+    make
+
+    msg "test: test_suite_ssl, MBEDTLS_SSL_HANDSHAKE_ARENA and MBEDTLS_SSL_MEMORY_ACCOUNTING enabled"
+    ( cd tests; ./test_suite_ssl )
+
+    msg "test: ssl-opt.sh DTLS, MBEDTLS_SSL_HANDSHAKE_ARENA and MBEDTLS_SSL_MEMORY_ACCOUNTING enabled"
+    tests/ssl-opt.sh -f "DTLS"
+}
+
 # Common helper for component_full_without_ecdhe_ecdsa() and
 # component_full_without_ecdhe_ecdsa_and_tls13() which:
 # - starts from the "full" configuration minus the list of symbols passed in
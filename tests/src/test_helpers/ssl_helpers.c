@@ -2227,8 +2227,6 @@ void mbedtls_test_ssl_perform_handshake(
     }
 #if defined(MBEDTLS_SSL_CONTEXT_SERIALIZATION)
     if (options->serialize == 1) {
-        TEST_ASSERT(options->dtls == 1);
-
         TEST_ASSERT(mbedtls_ssl_context_save(&(server.ssl), NULL,
                                              0, &context_buf_len)
                     == MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL);
@@ -2246,10 +2244,17 @@ void mbedtls_test_ssl_perform_handshake(
 
         TEST_ASSERT(mbedtls_ssl_setup(&(server.ssl), &(server.conf)) == 0);
 
-        mbedtls_ssl_set_bio(&(server.ssl), &server_context,
-                            mbedtls_test_mock_tcp_send_msg,
-                            mbedtls_test_mock_tcp_recv_msg,
-                            NULL);
+        if (options->dtls != 0) {
+            mbedtls_ssl_set_bio(&(server.ssl), &server_context,
+                                mbedtls_test_mock_tcp_send_msg,
+                                mbedtls_test_mock_tcp_recv_msg,
+                                NULL);
+        } else {
+            mbedtls_ssl_set_bio(&(server.ssl), &(server.socket),
+                                mbedtls_test_mock_tcp_send_nb,
+                                mbedtls_test_mock_tcp_recv_nb,
+                                NULL);
+        }
 
         mbedtls_ssl_set_user_data_p(&server.ssl, &server);
 
@@ -2516,7 +2521,7 @@ int mbedtls_test_ticket_parse(void *p_ticket, mbedtls_ssl_session *session,
 {
     ((void) p_ticket);
 
-    return mbedtls_ssl_session_load(session, buf, len);
+    return mbedtls_ssl_session_load_borrowed(session, buf, len);
 }
 #endif /* MBEDTLS_SSL_SESSION_TICKETS */
 
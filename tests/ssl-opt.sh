@@ -486,6 +486,7 @@ detect_required_features() {
             ;;
         *"programs/ssl/dtls_server "*|\
         *"programs/ssl/ssl_fork_server "*|\
+        *"programs/ssl/ssl_handoff_server "*|\
         *"programs/ssl/ssl_pthread_server "*|\
         *"programs/ssl/ssl_server "*)
             requires_config_enabled MBEDTLS_CTR_DRBG_C
@@ -9538,6 +9539,48 @@ run_test    "SSL async private: sign, SNI" \
             -c "issuer name *: C=NL, O=PolarSSL, CN=PolarSSL Test CA" \
             -c "subject name *: C=NL, O=PolarSSL, CN=polarssl.example"
 
+requires_config_enabled MBEDTLS_SSL_ASYNC_PRIVATE
+requires_config_enabled MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED
+run_test    "SSL async private: sign, TLS 1.3, ECDSA, delay=0" \
+            "$P_SRV force_version=tls13 \
+             crt_file=$DATA_FILES_PATH/server5.crt key_file=$DATA_FILES_PATH/server5.key \
+             async_operations=s async_private_delay1=0 async_private_delay2=0" \
+            "$P_CLI" \
+            0 \
+            -s "Async sign callback: using key slot " \
+            -s "Async resume (slot [0-9]): sign done, status=0" \
+            -s "Protocol is TLSv1.3"
+
+requires_config_enabled MBEDTLS_SSL_ASYNC_PRIVATE
+requires_config_enabled MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED
+requires_config_enabled MBEDTLS_PKCS1_V21
+run_test    "SSL async private: sign, TLS 1.3, RSA-PSS, delay=2" \
+            "$P_SRV force_version=tls13 \
+             crt_file=$DATA_FILES_PATH/server2-sha256.crt key_file=$DATA_FILES_PATH/server2.key \
+             async_operations=s async_private_delay1=2 async_private_delay2=2" \
+            "$P_CLI" \
+            0 \
+            -s "Async sign callback: using key slot " \
+            -U "Async sign callback: using key slot " \
+            -s "Async resume (slot [0-9]): call 1 more times." \
+            -s "Async resume (slot [0-9]): call 0 more times." \
+            -s "Async resume (slot [0-9]): sign done, status=0" \
+            -s "Protocol is TLSv1.3"
+
+requires_config_enabled MBEDTLS_SSL_ASYNC_PRIVATE
+requires_config_enabled MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED
+run_test    "SSL async private: sign, TLS 1.3, error in resume" \
+            "$P_SRV force_version=tls13 \
+             crt_file=$DATA_FILES_PATH/server5.crt key_file=$DATA_FILES_PATH/server5.key \
+             async_operations=s async_private_delay1=1 async_private_delay2=1 \
+             async_private_error=3" \
+            "$P_CLI" \
+            1 \
+            -s "Async sign callback: using key slot " \
+            -s "Async resume callback: sign done but injected error" \
+            -S "Async cancel" \
+            -s "! mbedtls_ssl_handshake returned"
+
 requires_config_enabled MBEDTLS_SSL_ASYNC_PRIVATE
 run_test    "SSL async private: decrypt, delay=0" \
             "$P_SRV \
@@ -11594,6 +11637,18 @@ run_test    "DTLS proxy: delay ChangeCipherSpec" \
             -s "Extra-header:" \
             -c "HTTP/1.0 200 OK"
 
+requires_config_enabled MBEDTLS_SSL_PROTO_TLS1_2
+requires_config_enabled MBEDTLS_SSL_DTLS_ADAPTIVE_RETRANSMIT
+run_test    "DTLS proxy: adaptive retransmit timeout from flight RTT" \
+            -p "$P_PXY" \
+            "$P_SRV dtls=1 debug_level=3 hs_timeout=250-10000" \
+            "$P_CLI dtls=1 debug_level=3 hs_timeout=250-10000" \
+            0 \
+            -c "flight rtt" \
+            -s "flight rtt" \
+            -s "Extra-header:" \
+            -c "HTTP/1.0 200 OK"
+
 # Tests for reordering support with DTLS
 
 requires_certificate_authentication